@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ *  Micro-benchmark of the batched central force kernels.
+ *
+ *  Measures the number of pairs per second evaluated by the scalar
+ *  and the batched kernels for a Lennard-Jones fluid and a WCA fluid.
+ *  Usage: <tt>central_force_batch [n_part] [n_repeats]</tt>
+ */
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/ParticleArrays.hpp"
+#include "forces_inline.hpp"
+#include "nonbonded_interactions/central_force_batch.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(LENNARD_JONES) and defined(WCA)
+
+namespace {
+struct Setup {
+  InteractionsNonBonded ias;
+  Cell cell;
+  ParticleArrays arrays;
+  std::vector<ParticleArrays::IndexPair> pairs;
+};
+
+/** Particles at number density 0.8 and all pairs within the
+ *  interaction range plus a Verlet skin of 0.4. */
+void make_fluid(Setup &setup, int n_part) {
+  auto const box_l = std::cbrt(n_part / 0.8);
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist_pos(0., box_l);
+  setup.cell.m_neighbors = Neighbors<Cell *>({}, {});
+  for (int pid = 0; pid < n_part; ++pid) {
+    Particle p;
+    p.id() = pid;
+    p.pos() = {dist_pos(rng), dist_pos(rng), dist_pos(rng)};
+    setup.cell.particles().insert(std::move(p));
+  }
+  auto const cells = std::vector<Cell *>{&setup.cell};
+  setup.arrays.rebuild(cells, {});
+  setup.arrays.gather();
+  auto const range = setup.ias.maximal_cutoff() + 0.4;
+  auto const &pos = setup.arrays.pos;
+  for (unsigned int i = 0; i < setup.arrays.size(); ++i) {
+    for (unsigned int j = i + 1; j < setup.arrays.size(); ++j) {
+      if ((pos[i] - pos[j]).norm() < range) {
+        setup.pairs.emplace_back(i, j);
+      }
+    }
+  }
+}
+
+template <class Kernel>
+double pairs_per_second(Setup &setup, int n_repeats, Kernel const &kernel) {
+  auto const start = std::chrono::steady_clock::now();
+  for (int k = 0; k < n_repeats; ++k) {
+    kernel();
+  }
+  std::chrono::duration<double> const elapsed =
+      std::chrono::steady_clock::now() - start;
+  return static_cast<double>(setup.pairs.size()) * n_repeats /
+         elapsed.count();
+}
+
+void run(std::string const &name, Setup &setup, int n_repeats) {
+  auto const df = detail::EuclidianDistance{};
+  auto &arrays = setup.arrays;
+  auto const &ias = setup.ias;
+  auto const scalar_kernel = [&ias](ParticleArrays &arrays, std::size_t i,
+                                    std::size_t j, Distance const &d) {
+    auto const &ia_params = ias.get_ia_param(arrays.type[i], arrays.type[j]);
+    add_non_bonded_pair_force(arrays, i, j, d.vec21, std::sqrt(d.dist2),
+                              ia_params, nullptr);
+  };
+  auto const scalar = pairs_per_second(setup, n_repeats, [&]() {
+    for (auto const &[i, j] : setup.pairs) {
+      scalar_kernel(arrays, i, j, df(arrays.pos[i], arrays.pos[j]));
+    }
+  });
+  auto const batched = pairs_per_second(setup, n_repeats, [&]() {
+    add_central_forces_batched(arrays, setup.pairs, df, ias, scalar_kernel);
+  });
+  std::cout << std::setw(6) << name << std::scientific << std::setprecision(3)
+            << std::setw(14) << scalar << std::setw(14) << batched
+            << std::fixed << std::setprecision(2) << std::setw(10)
+            << batched / scalar << "\n";
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  auto const n_part = (argc > 1) ? std::atoi(argv[1]) : 4000;
+  auto const n_repeats = (argc > 2) ? std::atoi(argv[2]) : 20;
+
+  std::cout << "  pair   scalar [1/s]  batched [1/s]   speedup\n";
+  {
+    Setup setup;
+    setup.ias.get_ia_param(0, 0).lj = LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+    setup.ias.recalc_maximal_cutoffs();
+    make_fluid(setup, n_part);
+    run("LJ", setup, n_repeats);
+  }
+  {
+    Setup setup;
+    setup.ias.get_ia_param(0, 0).wca = WCA_Parameters{1., 1.};
+    setup.ias.recalc_maximal_cutoffs();
+    make_fluid(setup, n_part);
+    run("WCA", setup, n_repeats);
+  }
+  return EXIT_SUCCESS;
+}
+
+#else // defined(LENNARD_JONES) and defined(WCA)
+
+int main() {
+  std::cout << "Missing features LENNARD_JONES and WCA\n";
+  return EXIT_SUCCESS;
+}
+
+#endif // defined(LENNARD_JONES) and defined(WCA)
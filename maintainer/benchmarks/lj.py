@@ -33,6 +33,10 @@ parser.add_argument("--volume_fraction", metavar="FRAC", action="store",
                     "particles (range: [0.01-0.74], default: 0.50)")
 parser.add_argument("--bonds", action="store_true",
                     help="Add bonds between particle pairs, default: false")
+parser.add_argument("--threads", metavar="N", action="store", nargs="+",
+                    type=int, default=[1], required=False,
+                    help="Number of threads per MPI rank; when several values "
+                    "are given, the speedup w.r.t. the first one is reported")
 group = parser.add_mutually_exclusive_group()
 group.add_argument("--output", metavar="FILEPATH", action="store",
                    type=str, required=False, default="benchmarks.csv",
@@ -54,7 +58,13 @@ if not args.visualizer:
     assert measurement_steps >= 100, \
         f"{measurement_steps} steps per tick are too short"
 
+assert min(args.threads) > 0, "threads must be positive numbers"
+if args.visualizer:
+    assert len(args.threads) == 1, "the visualizer requires a single thread count"
+
 required_features = ["LENNARD_JONES"]
+if max(args.threads) > 1:
+    required_features.append("OPENMP")
 espressomd.assert_features(required_features)
 
 # make simulation deterministic
@@ -87,6 +97,7 @@ system.box_l = 3 * (box_l,)
 #############################################################
 system.time_step = 0.01
 system.cell_system.skin = 0.5
+system.cell_system.n_threads = args.threads[0]
 
 # Interaction setup
 #############################################################
@@ -150,11 +161,25 @@ if args.visualizer:
 
 
 # time integration loop
-timings = benchmarks.get_timings(system, measurement_steps, n_iterations)
+if len(args.threads) == 1:
+    timings = benchmarks.get_timings(system, measurement_steps, n_iterations)
 
-# average time
-avg, ci = benchmarks.get_average_time(timings)
-print(f"average: {avg:.3e} +/- {ci:.3e} (95% C.I.)")
+    # average time
+    avg, ci = benchmarks.get_average_time(timings)
+    print(f"average: {avg:.3e} +/- {ci:.3e} (95% C.I.)")
 
-# write report
-benchmarks.write_report(args.output, n_proc, timings, measurement_steps)
+    # write report
+    benchmarks.write_report(args.output, n_proc, timings, measurement_steps)
+else:
+    avg_ref = None
+    for n_threads in args.threads:
+        system.cell_system.n_threads = n_threads
+        timings = benchmarks.get_timings(
+            system, measurement_steps, n_iterations)
+        avg, ci = benchmarks.get_average_time(timings)
+        if avg_ref is None:
+            avg_ref = avg
+        print(f"threads: {n_threads}, average: {avg:.3e} +/- {ci:.3e} "
+              f"(95% C.I.), speedup: {avg_ref / avg:.2f}")
+        benchmarks.write_report(args.output, n_proc, timings,
+                                measurement_steps, label=f"threads={n_threads}")
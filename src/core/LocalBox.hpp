@@ -24,12 +24,18 @@
 #include <utils/Array.hpp>
 #include <utils/Vector.hpp>
 
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
 class LocalBox {
   Utils::Vector3d m_local_box_l = {1., 1., 1.};
   Utils::Vector3d m_lower_corner = {0., 0., 0.};
   Utils::Vector3d m_upper_corner = {1., 1., 1.};
   Utils::Array<int, 6> m_boundaries = {};
   CellStructureType m_cell_structure_type;
+  std::array<std::vector<double>, 3> m_domain_bounds = {};
 
 public:
   LocalBox() = default;
@@ -61,6 +67,18 @@ public:
   /** Return cell structure type. */
   auto const &cell_structure_type() const { return m_cell_structure_type; }
 
+  /** @brief Boundaries of the domains along each Cartesian axis.
+   *
+   * For a non-uniform decomposition, this returns for each direction
+   * the absolute positions of the domain boundaries, starting at 0 and
+   * ending at the box length. For a uniform decomposition, the vectors
+   * are empty.
+   */
+  auto const &domain_bounds() const { return m_domain_bounds; }
+
+  /** Whether all domains have the same size. */
+  bool is_uniform() const { return m_domain_bounds[0].empty(); }
+
   /** Set cell structure type. */
   void set_cell_structure_type(CellStructureType cell_structure_type) {
     m_cell_structure_type = cell_structure_type;
@@ -83,4 +101,34 @@ public:
 
     return {my_left, local_length, boundaries, CellStructureType::REGULAR};
   }
+
+  /**
+   * @brief Regular decomposition with shifted domain boundaries.
+   *
+   * The domains form a tensor-product grid: along each direction,
+   * the domain boundaries are shared by all ranks and given by the
+   * fractions @p cuts of the box length, including 0 and 1.
+   */
+  static LocalBox
+  make_regular_decomposition(Utils::Vector3d const &box_l,
+                             Utils::Vector3i const &node_index,
+                             Utils::Vector3i const &node_grid,
+                             std::array<std::vector<double>, 3> const &cuts) {
+    auto local_box = make_regular_decomposition(box_l, node_index, node_grid);
+    for (unsigned int dir = 0u; dir < 3u; dir++) {
+      assert(cuts[dir].size() == static_cast<std::size_t>(node_grid[dir] + 1));
+      auto &bounds = local_box.m_domain_bounds[dir];
+      bounds.resize(cuts[dir].size());
+      for (std::size_t i = 0u; i < bounds.size(); ++i) {
+        bounds[i] = cuts[dir][i] * box_l[dir];
+      }
+      bounds.front() = 0.;
+      bounds.back() = box_l[dir];
+      auto const index = static_cast<std::size_t>(node_index[dir]);
+      local_box.m_lower_corner[dir] = bounds[index];
+      local_box.m_upper_corner[dir] = bounds[index + 1u];
+      local_box.m_local_box_l[dir] = bounds[index + 1u] - bounds[index];
+    }
+    return local_box;
+  }
 };
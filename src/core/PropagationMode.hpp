@@ -47,6 +47,7 @@ enum IntegratorSwitch : int {
   INTEG_METHOD_STEEPEST_DESCENT = 2,
   INTEG_METHOD_BD = 3,
   INTEG_METHOD_SD = 4,
+  INTEG_METHOD_RESPA = 5,
 };
 
 /** @brief Thermostat flags. */
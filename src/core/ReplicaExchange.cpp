@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ReplicaExchange.hpp"
+
+#include "config/config.hpp"
+
+#include "Observable_stat.hpp"
+#include "Particle.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "random.hpp"
+#include "system/System.hpp"
+#include "thermostat.hpp"
+
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/operations.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+ReplicaExchange::ReplicaExchange(boost::mpi::communicator world, int replica,
+                                 std::vector<double> kT, int seed)
+    : m_world{std::move(world)}, m_kT{std::move(kT)}, m_replica{replica},
+      m_n_attempts{0},
+      m_generator(Random::mt19937(std::seed_seq({seed, seed, seed}))),
+      m_uniform_real_distribution(0.0, 1.0) {
+  auto const n_replicas = static_cast<int>(m_kT.size());
+  if (replica < 0 or replica >= n_replicas) {
+    throw std::domain_error("Invalid value for 'replica'");
+  }
+  if (std::ranges::any_of(m_kT, [](double kT) { return kT <= 0.; })) {
+    throw std::domain_error("Invalid value for 'kT'");
+  }
+  std::vector<int> replicas;
+  boost::mpi::all_gather(m_world, m_replica, replicas);
+  for (int i = 0; i < n_replicas; ++i) {
+    if (std::ranges::find(replicas, i) == replicas.end()) {
+      throw std::runtime_error("Replica " + std::to_string(i) +
+                               " is not simulated by any MPI rank");
+    }
+  }
+  m_replica_kT.resize(m_kT.size());
+  for (int i = 0; i < n_replicas; ++i) {
+    m_replica_kT[i] = i;
+  }
+  m_n_swaps_attempted.resize(m_kT.size() - 1u, 0);
+  m_n_swaps_accepted.resize(m_kT.size() - 1u, 0);
+}
+
+int ReplicaExchange::exchange(double potential_energy) {
+  auto const n_replicas = static_cast<int>(m_kT.size());
+
+  // a single message per rank: all ranks of a replica agree on its energy
+  std::vector<int> replicas;
+  std::vector<double> energies_per_rank;
+  boost::mpi::all_gather(m_world, m_replica, replicas);
+  boost::mpi::all_gather(m_world, potential_energy, energies_per_rank);
+  std::vector<double> energies(m_kT.size());
+  for (std::size_t rank = 0u; rank < replicas.size(); ++rank) {
+    energies[replicas[rank]] = energies_per_rank[rank];
+  }
+
+  std::vector<int> kT_replica(m_kT.size());
+  for (int i = 0; i < n_replicas; ++i) {
+    kT_replica[m_replica_kT[i]] = i;
+  }
+
+  auto n_accepted = 0;
+  for (int i = m_n_attempts % 2; i + 1 < n_replicas; i += 2) {
+    auto const replica_lo = kT_replica[i];
+    auto const replica_hi = kT_replica[i + 1];
+    auto const exponent = (1. / m_kT[i] - 1. / m_kT[i + 1]) *
+                          (energies[replica_lo] - energies[replica_hi]);
+    ++m_n_swaps_attempted[i];
+    if (exponent >= 0. or
+        m_uniform_real_distribution(m_generator) < std::exp(exponent)) {
+      std::swap(m_replica_kT[replica_lo], m_replica_kT[replica_hi]);
+      ++m_n_swaps_accepted[i];
+      ++n_accepted;
+    }
+  }
+  ++m_n_attempts;
+  return n_accepted;
+}
+
+int ReplicaExchange::run(System::System &system, int n_cycles, int n_steps) {
+  auto &thermostat = *system.thermostat;
+  if (thermostat.kT != get_kT()) {
+    thermostat.kT = get_kT();
+    system.on_thermostat_param_change();
+  }
+  for (int cycle = 0; cycle < n_cycles; ++cycle) {
+    auto const local_retval = system.integrate_with_signal_handler(
+        n_steps, INTEG_REUSE_FORCES_CONDITIONALLY, true);
+    // make sure all replicas exit when one replica fails
+    auto const retval = boost::mpi::all_reduce(
+        m_world, std::min(local_retval, 0), boost::mpi::minimum<int>());
+    if (retval < 0) {
+      return retval;
+    }
+
+    auto const obs = system.calculate_energy();
+    auto potential_energy = obs->accumulate(-obs->kinetic[0]);
+    boost::mpi::broadcast(::comm_cart, potential_energy, 0);
+
+    auto const old_kT = get_kT();
+    exchange(potential_energy);
+    auto const new_kT = get_kT();
+    if (new_kT != old_kT) {
+      auto const scale = std::sqrt(new_kT / old_kT);
+      for (auto &p : system.cell_structure->local_particles()) {
+        p.v() *= scale;
+#ifdef ROTATION
+        p.omega() *= scale;
+#endif
+      }
+      thermostat.kT = new_kT;
+      system.on_thermostat_param_change();
+      system.on_particle_change();
+    }
+  }
+  return 0;
+}
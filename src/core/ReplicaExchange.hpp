@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "system/System.hpp"
+
+#include <boost/mpi/communicator.hpp>
+
+#include <random>
+#include <vector>
+
+/**
+ * @brief Replica exchange (parallel tempering) driver.
+ *
+ * Each replica is simulated by its own group of MPI ranks, obtained with
+ * @ref Communication::split, and integrates concurrently with the other
+ * replicas. Between two integration cycles, replicas at neighboring
+ * temperatures attempt to swap their temperatures with the Metropolis
+ * criterion; even and odd pairs of temperatures alternate between
+ * attempts. Only the potential energies are communicated between
+ * replicas; particle data never leaves its group.
+ *
+ * The swap decisions are taken independently on every rank with the same
+ * random number generator, so that all ranks agree on the temperature of
+ * each replica without further communication.
+ */
+class ReplicaExchange {
+  /** @brief Communicator spanning all replicas. */
+  boost::mpi::communicator m_world;
+  /** @brief Temperature ladder. */
+  std::vector<double> m_kT;
+  /** @brief Temperature index of each replica. */
+  std::vector<int> m_replica_kT;
+  /** @brief Replica simulated by this rank. */
+  int m_replica;
+  /** @brief Number of exchange attempts since construction. */
+  int m_n_attempts;
+  std::mt19937 m_generator;
+  std::uniform_real_distribution<double> m_uniform_real_distribution;
+  /** @brief Number of attempted swaps per pair of neighboring temperatures. */
+  std::vector<int> m_n_swaps_attempted;
+  /** @brief Number of accepted swaps per pair of neighboring temperatures. */
+  std::vector<int> m_n_swaps_accepted;
+
+public:
+  /**
+   * @param world    Communicator spanning all replicas
+   * @param replica  Index of the replica simulated by this rank
+   * @param kT       Temperature ladder, one temperature per replica;
+   *                 replica @c i starts at temperature @c kT[i]
+   * @param seed     Seed of the acceptance test, identical on all ranks
+   */
+  ReplicaExchange(boost::mpi::communicator world, int replica,
+                  std::vector<double> kT, int seed);
+
+  /** @brief Temperature of the replica simulated by this rank. */
+  double get_kT() const { return m_kT[m_replica_kT[m_replica]]; }
+  /** @brief Temperature index of each replica. */
+  auto const &get_replica_kT() const { return m_replica_kT; }
+  auto const &get_n_swaps_attempted() const { return m_n_swaps_attempted; }
+  auto const &get_n_swaps_accepted() const { return m_n_swaps_accepted; }
+
+  /**
+   * @brief Attempt temperature swaps between neighboring temperatures.
+   * Has to be called on all ranks.
+   * @param potential_energy Potential energy of the replica simulated
+   *                         by this rank
+   * @return Number of accepted swaps.
+   */
+  int exchange(double potential_energy);
+
+  /**
+   * @brief Alternate integration and exchange attempts.
+   * The thermostat temperature of @p system follows the temperature of the
+   * replica, and particle velocities are rescaled after each swap.
+   * Has to be called on all ranks.
+   * @param system    System simulated by this rank
+   * @param n_cycles  Number of exchange attempts
+   * @param n_steps   Number of time steps between two exchange attempts
+   * @return 0 on success, or the negative error code of the integrator.
+   */
+  int run(System::System &system, int n_cycles, int n_steps);
+};
@@ -23,6 +23,31 @@
 
 namespace Algorithm {
 
+/**
+ * @brief Iterates over all particles in the cell,
+ *        and over all pairs within the cell and with
+ *        its neighbors.
+ */
+template <typename Cell, typename PairKernel>
+void link_cell(Cell &cell, PairKernel &&pair_kernel) {
+  auto &local_particles = cell.particles();
+  for (auto it = local_particles.begin(); it != local_particles.end(); ++it) {
+    auto &p1 = *it;
+
+    /* Pairs in this cell */
+    for (auto jt = std::next(it); jt != local_particles.end(); ++jt) {
+      pair_kernel(p1, *jt);
+    }
+
+    /* Pairs with neighbors */
+    for (auto &neighbor : cell.neighbors().red()) {
+      for (auto &p2 : neighbor->particles()) {
+        pair_kernel(p1, p2);
+      }
+    }
+  }
+}
+
 /**
  * @brief Iterates over all particles in the cell range,
  *        and over all pairs within the cells and with
@@ -32,22 +57,7 @@ template <typename CellIterator, typename PairKernel>
 void link_cell(CellIterator first, CellIterator last,
                PairKernel &&pair_kernel) {
   for (auto cell = first; cell != last; ++cell) {
-    auto &local_particles = cell->particles();
-    for (auto it = local_particles.begin(); it != local_particles.end(); ++it) {
-      auto &p1 = *it;
-
-      /* Pairs in this cell */
-      for (auto jt = std::next(it); jt != local_particles.end(); ++jt) {
-        pair_kernel(p1, *jt);
-      }
-
-      /* Pairs with neighbors */
-      for (auto &neighbor : cell->neighbors().red()) {
-        for (auto &p2 : neighbor->particles()) {
-          pair_kernel(p1, p2);
-        }
-      }
-    }
+    link_cell(*cell, pair_kernel);
   }
 }
 
@@ -97,6 +97,10 @@ public:
     return id_to_cell(p.id());
   }
 
+  int particle_to_rank(Particle const &p) const override {
+    return id_to_rank(p.id());
+  }
+
   Utils::Vector3d max_cutoff() const override;
   Utils::Vector3d max_range() const override;
 
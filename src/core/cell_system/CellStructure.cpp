@@ -22,9 +22,11 @@
 #include "cell_system/CellStructure.hpp"
 
 #include "cell_system/AtomDecomposition.hpp"
+#include "cell_system/GhostShell.hpp"
 #include "cell_system/HybridDecomposition.hpp"
 #include "cell_system/ParticleDecomposition.hpp"
 #include "cell_system/RegularDecomposition.hpp"
+#include "cell_system/SpaceFillingCurve.hpp"
 
 #include "BoxGeometry.hpp"
 #include "LocalBox.hpp"
@@ -34,6 +36,7 @@
 #include "lees_edwards/lees_edwards.hpp"
 #include "system/System.hpp"
 
+#include <utils/Vector.hpp>
 #include <utils/contains.hpp>
 
 #include <boost/mpi/collectives/all_reduce.hpp>
@@ -42,12 +45,15 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -98,6 +104,25 @@ void CellStructure::check_particle_sorting() const {
   }
 }
 
+void CellStructure::resort_particles_if_displaced(
+    Utils::Vector3d const &additional_offset) {
+  auto const lim = Utils::sqr(m_verlet_skin / 2.) - additional_offset.norm2();
+  /* the record is only valid if no other resort is pending; with
+   * Lees-Edwards boundary conditions, the resort visits all cells */
+  if (m_resort_particles != Cells::RESORT_NONE or
+      get_system().box_geo->type() == BoxType::LEES_EDWARDS) {
+    if (check_resort_required(additional_offset)) {
+      set_resort_particles(Cells::RESORT_LOCAL);
+    }
+    return;
+  }
+  /* the record is kept even if no local particle moved too far, since
+   * the resort can be requested by another rank */
+  if (decomposition().record_displacements(lim)) {
+    m_resort_particles |= Cells::RESORT_LOCAL;
+  }
+}
+
 void CellStructure::remove_particle(int id) {
   auto remove_all_bonds_to = [id](BondList &bl) {
     for (auto it = bl.begin(); it != bl.end();) {
@@ -125,6 +150,39 @@ void CellStructure::remove_particle(int id) {
   }
 }
 
+void CellStructure::remove_particles(std::span<int const> ids) {
+  std::unordered_set<int> const removed(ids.begin(), ids.end());
+  auto const is_removed = [&removed](int id) { return removed.contains(id); };
+  auto remove_all_bonds_to_removed = [&is_removed](BondList &bl) {
+    for (auto it = bl.begin(); it != bl.end();) {
+      if (std::ranges::any_of(it->partner_ids(), is_removed)) {
+        it = bl.erase(it);
+      } else {
+        std::advance(it, 1);
+      }
+    }
+  };
+
+  for (auto c : decomposition().local_cells()) {
+    auto &parts = c->particles();
+    auto has_removed = false;
+
+    for (auto it = parts.begin(); it != parts.end();) {
+      if (is_removed(it->id())) {
+        update_particle_index(it->id(), nullptr);
+        it = parts.erase(it);
+        has_removed = true;
+      } else {
+        remove_all_bonds_to_removed(it->bonds());
+        it++;
+      }
+    }
+    if (has_removed) {
+      update_particle_index(parts);
+    }
+  }
+}
+
 Particle *CellStructure::add_local_particle(Particle &&p) {
   auto const sort_cell = particle_to_cell(p);
   if (sort_cell) {
@@ -228,8 +286,16 @@ void CellStructure::resort_particles(bool global_flag) {
     boost::apply_visitor(UpdateParticleIndexVisitor{this}, d);
   }
 
+  if (m_space_filling_curve != SpaceFillingCurve::NONE and
+      m_reordering_interval > 0 and
+      ++m_resorts_since_reordering >= m_reordering_interval) {
+    reorder_particles();
+    m_resorts_since_reordering = 0;
+  }
+
   auto const &lebc = get_system().box_geo->lees_edwards_bc();
   m_rebuild_verlet_list = true;
+  m_particle_arrays.invalidate();
   m_le_pos_offset_at_last_resort = lebc.pos_offset;
 
 #ifdef ADDITIONAL_CHECKS
@@ -255,7 +321,8 @@ void CellStructure::set_regular_decomposition(
   auto &local_geo = *system.local_geo;
   auto const &box_geo = *system.box_geo;
   set_particle_decomposition(std::make_unique<RegularDecomposition>(
-      ::comm_cart, range, box_geo, local_geo, fully_connected_boundary));
+      ::comm_cart, range, box_geo, local_geo, fully_connected_boundary,
+      m_space_filling_curve, m_ghost_shell));
   m_type = CellStructureType::REGULAR;
   local_geo.set_cell_structure_type(m_type);
   system.on_cell_structure_change();
@@ -269,7 +336,7 @@ void CellStructure::set_hybrid_decomposition(double cutoff_regular,
   set_particle_decomposition(std::make_unique<HybridDecomposition>(
       ::comm_cart, cutoff_regular, m_verlet_skin,
       [&system]() { return system.get_global_ghost_flags(); }, box_geo,
-      local_geo, n_square_types));
+      local_geo, n_square_types, m_space_filling_curve));
   m_type = CellStructureType::HYBRID;
   local_geo.set_cell_structure_type(m_type);
   system.on_cell_structure_change();
@@ -296,11 +363,132 @@ void CellStructure::set_verlet_skin_heuristic() {
   set_verlet_skin(new_skin);
 }
 
-void CellStructure::update_ghosts_and_resort_particle(unsigned data_parts) {
+void CellStructure::set_n_threads(int value) {
+  if (value < 1) {
+    throw std::domain_error("Parameter 'n_threads' must be >= 1");
+  }
+#ifndef OPENMP
+  if (value != 1) {
+    throw std::runtime_error(
+        "Parameter 'n_threads' must be 1 without feature OPENMP");
+  }
+#endif
+  m_n_threads = value;
+}
+
+void CellStructure::set_space_filling_curve(SpaceFillingCurve curve) {
+  m_space_filling_curve = curve;
+  m_resorts_since_reordering = 0;
+  if (m_type != CellStructureType::NSQUARE) {
+    get_system().rebuild_cell_structure();
+  }
+}
+
+void CellStructure::set_ghost_shell(GhostShell ghost_shell) {
+  if (ghost_shell == GhostShell::HALF and
+      get_system().box_geo->type() == BoxType::LEES_EDWARDS) {
+    throw std::runtime_error(
+        "The half-shell ghost scheme doesn't support Lees-Edwards");
+  }
+  m_ghost_shell = ghost_shell;
+  if (m_type == CellStructureType::REGULAR) {
+    get_system().rebuild_cell_structure();
+  }
+}
+
+void CellStructure::set_reordering_interval(int value) {
+  if (value < 0) {
+    throw std::domain_error("Parameter 'reordering_interval' must be >= 0");
+  }
+  m_reordering_interval = value;
+  m_resorts_since_reordering = 0;
+}
+
+void CellStructure::reorder_particles() {
+  assert(m_space_filling_curve != SpaceFillingCurve::NONE);
+  /* the curve spans the local domain, or the whole box for the
+   * N-square decomposition */
+  auto const &system = get_system();
+  auto origin = system.local_geo->my_left();
+  auto length = system.local_geo->length();
+  if (m_type == CellStructureType::NSQUARE) {
+    origin = Utils::Vector3d{};
+    length = system.box_geo->length();
+  }
+  auto const key = [this, &origin, &length](Particle const &p) {
+    return curve_index(m_space_filling_curve, p.pos(), origin, length);
+  };
+
+  std::vector<std::pair<std::uint64_t, std::size_t>> keys;
+  std::vector<Particle> sorted;
+  for (auto cell : decomposition().local_cells()) {
+    auto &particles = cell->particles();
+    keys.clear();
+    for (std::size_t i = 0u; i < particles.size(); ++i) {
+      keys.emplace_back(key(particles.begin()[i]), i);
+    }
+    if (std::ranges::is_sorted(keys)) {
+      continue;
+    }
+    std::ranges::sort(keys);
+    sorted.clear();
+    sorted.reserve(particles.size());
+    for (auto const &entry : keys) {
+      sorted.emplace_back(std::move(particles.begin()[entry.second]));
+    }
+    std::ranges::move(sorted, particles.begin());
+    update_particle_index(particles);
+  }
+}
+
+std::vector<std::vector<std::size_t>> const &CellStructure::cell_colors() {
+  if (m_cell_colors.empty()) {
+    /* Greedy coloring: each cell gets the first color whose cells don't
+     * write to any of the cells this cell writes to, i.e. itself and its
+     * red neighbors. */
+    std::vector<std::unordered_set<Cell const *>> written_cells;
+    auto const cells = decomposition().local_cells();
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+      auto const cell = cells[i];
+      auto const red = cell->neighbors().red();
+      auto const is_independent = [cell, &red](auto const &written) {
+        return not written.contains(cell) and
+               std::none_of(red.begin(), red.end(), [&written](Cell *c) {
+                 return written.contains(c);
+               });
+      };
+      auto const it = std::ranges::find_if(written_cells, is_independent);
+      auto const color =
+          static_cast<std::size_t>(std::distance(written_cells.begin(), it));
+      if (it == written_cells.end()) {
+        written_cells.emplace_back();
+        m_cell_colors.emplace_back();
+      }
+      written_cells[color].insert(cell);
+      written_cells[color].insert(red.begin(), red.end());
+      m_cell_colors[color].emplace_back(i);
+    }
+  }
+  return m_cell_colors;
+}
+
+ParticleArrays const &CellStructure::particle_arrays() {
+  if (not m_particle_arrays.is_valid()) {
+    m_particle_arrays.rebuild(decomposition().local_cells(),
+                              decomposition().ghost_cells());
+  }
+  return m_particle_arrays;
+}
+
+void CellStructure::update_ghosts_and_resort_particle(unsigned data_parts,
+                                                      bool defer) {
   /* data parts that are only updated on resort */
   auto constexpr resort_only_parts =
       Cells::DATA_PART_PROPERTIES | Cells::DATA_PART_BONDS;
 
+  /* a postponed update is superseded by this one */
+  data_parts |= std::exchange(m_deferred_ghost_parts, 0u);
+
   auto const global_resort = boost::mpi::all_reduce(
       ::comm_cart, m_resort_particles, std::bit_or<unsigned>());
 
@@ -322,8 +510,19 @@ void CellStructure::update_ghosts_and_resort_particle(unsigned data_parts) {
 
     /* Particles are now sorted */
     clear_resort_particles();
+  } else if (defer and overlap_ghost_communication and
+             m_type == CellStructureType::REGULAR) {
+    m_deferred_ghost_parts = data_parts & ~resort_only_parts;
   } else {
     /* Communication step: ghost information */
     ghosts_update(data_parts & ~resort_only_parts);
   }
 }
+
+void CellStructure::complete_ghosts_update(
+    std::function<void()> const &overlap) {
+  auto const data_parts = std::exchange(m_deferred_ghost_parts, 0u);
+  ghost_communicator(decomposition().exchange_ghosts_comm(),
+                     *get_system().box_geo, map_data_parts(data_parts),
+                     overlap);
+}
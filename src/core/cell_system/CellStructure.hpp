@@ -32,6 +32,9 @@
 #include "bond_error.hpp"
 #include "cell_system/Cell.hpp"
 #include "cell_system/CellStructureType.hpp"
+#include "cell_system/GhostShell.hpp"
+#include "cell_system/ParticleArrays.hpp"
+#include "cell_system/SpaceFillingCurve.hpp"
 #include "config/config.hpp"
 #include "ghosts.hpp"
 #include "system/Leaf.hpp"
@@ -39,17 +42,20 @@
 #include <utils/math/sqr.hpp>
 
 #include <boost/container/static_vector.hpp>
-#include <boost/iterator/indirect_iterator.hpp>
 #include <boost/range/algorithm/transform.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <optional>
 #include <set>
 #include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -115,12 +121,22 @@ struct MinimalImageDistance {
   Distance operator()(Particle const &p1, Particle const &p2) const {
     return Distance(box.get_mi_vector(p1.pos(), p2.pos()));
   }
+
+  Distance operator()(Utils::Vector3d const &pos1,
+                      Utils::Vector3d const &pos2) const {
+    return Distance(box.get_mi_vector(pos1, pos2));
+  }
 };
 
 struct EuclidianDistance {
   Distance operator()(Particle const &p1, Particle const &p2) const {
     return Distance(p1.pos() - p2.pos());
   }
+
+  Distance operator()(Utils::Vector3d const &pos1,
+                      Utils::Vector3d const &pos2) const {
+    return Distance(pos1 - pos2);
+  }
 };
 } // namespace detail
 
@@ -143,17 +159,41 @@ private:
    */
   unsigned m_resort_particles = Cells::RESORT_NONE;
   bool m_rebuild_verlet_list = true;
-  std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
   double m_le_pos_offset_at_last_resort = 0.;
   /** @brief Verlet list skin. */
   double m_verlet_skin = 0.;
   bool m_verlet_skin_set = false;
   double m_verlet_reuse = 0.;
+  /** @brief Number of threads for the non-bonded pair loop. */
+  int m_n_threads = 1;
+  /** @brief Indices of the local cells, partitioned into sets of
+   *  independent cells. */
+  std::vector<std::vector<std::size_t>> m_cell_colors;
+  /** @brief Structure-of-arrays mirror of the particles. */
+  ParticleArrays m_particle_arrays;
+  /** @brief Data parts of a deferred ghost update. */
+  unsigned m_deferred_ghost_parts = 0u;
+  /** @brief Order of the local cells and of the particles in each cell. */
+  SpaceFillingCurve m_space_filling_curve = SpaceFillingCurve::NONE;
+  /** @brief Number of resorts between two particle reorderings. */
+  int m_reordering_interval = 1;
+  /** @brief Number of resorts since the last particle reordering. */
+  int m_resorts_since_reordering = 0;
+  /** @brief Neighbor domains of the regular decomposition that ghosts
+   *  are imported from. */
+  GhostShell m_ghost_shell = GhostShell::FULL;
 
 public:
   CellStructure(BoxGeometry const &box);
 
   bool use_verlet_list = true;
+  /** @brief Whether the non-bonded loop may run on @ref ParticleArrays. */
+  bool use_particle_arrays = false;
+  /**
+   * @brief Whether ghost updates may overlap with the non-bonded loop,
+   * see @ref update_ghosts_and_resort_particle.
+   */
+  bool overlap_ghost_communication = false;
 
   /**
    * @brief Update local particle index.
@@ -275,6 +315,36 @@ public:
     return Cells::particles(decomposition().ghost_cells());
   }
 
+  /**
+   * @brief Run a kernel on all local particles.
+   *
+   * The kernel is called once per particle and must only modify that
+   * particle. When more than one thread is available, the local cells
+   * are distributed over the threads.
+   *
+   * @tparam ParticleKernel Needs to be callable with a particle.
+   * @param particle_kernel Particle kernel functor.
+   */
+  template <class ParticleKernel>
+  void for_each_local_particle(ParticleKernel const &particle_kernel) {
+#ifdef OPENMP
+    if (m_n_threads > 1) {
+      auto const cells = decomposition().local_cells();
+      auto const n_cells = static_cast<int>(cells.size());
+#pragma omp parallel for schedule(static) num_threads(m_n_threads)
+      for (int i = 0; i < n_cells; ++i) {
+        for (auto &p : cells[static_cast<std::size_t>(i)]->particles()) {
+          particle_kernel(p);
+        }
+      }
+      return;
+    }
+#endif
+    for (auto &p : local_particles()) {
+      particle_kernel(p);
+    }
+  }
+
 private:
   /** Cell system dependent function to find the right cell for a
    *  particle.
@@ -308,7 +378,7 @@ public:
    *
    * Moves a particle into the cell system, if it
    * belongs to this node. Otherwise this does not
-   * have an effect and the particle is discarded.
+   * have an effect and the particle is left unchanged.
    * This can be used to add a particle without
    * knowledge where it should be placed by calling
    * the function on all nodes, it will then add
@@ -320,6 +390,14 @@ public:
    */
   Particle *add_local_particle(Particle &&p);
 
+  /**
+   * @brief Determine which rank a particle belongs to.
+   * See @ref ParticleDecomposition::particle_to_rank.
+   */
+  int particle_to_rank(Particle const &p) const {
+    return decomposition().particle_to_rank(p);
+  }
+
   /**
    * @brief Remove a particle.
    *
@@ -330,6 +408,16 @@ public:
    */
   void remove_particle(int id);
 
+  /**
+   * @brief Remove several particles.
+   *
+   * Removes the particles and all bonds pointing
+   * to them in a single pass over the local cells.
+   *
+   * @param ids Ids of the particles to remove.
+   */
+  void remove_particles(std::span<int const> ids);
+
   /**
    * @brief Get the maximal particle id on this node.
    *
@@ -370,6 +458,10 @@ public:
   void set_resort_particles(Cells::Resort level) {
     m_resort_particles |= level;
     assert(m_resort_particles >= level);
+    /* particles may have moved, the cells can't be skipped */
+    if (m_decomposition) {
+      m_decomposition->clear_displacements();
+    }
   }
 
   /**
@@ -400,6 +492,20 @@ public:
         });
   }
 
+  /**
+   * @brief Schedule a local resort if a particle has moved further than
+   * half the skin since the last Verlet list update.
+   *
+   * Unlike @ref check_resort_required, the cells left by one of their
+   * particles are recorded, such that the local resort only visits these
+   * cells. The record is discarded by any
+   * other call to @ref set_resort_particles.
+   *
+   * @param additional_offset   See @ref check_resort_required.
+   */
+  void resort_particles_if_displaced(
+      Utils::Vector3d const &additional_offset = {});
+
   auto get_le_pos_offset_at_last_resort() const {
     return m_le_pos_offset_at_last_resort;
   }
@@ -425,10 +531,27 @@ public:
    * Update ghost particles with data from the real particles.
    * Resort particles if a resort is due.
    *
+   * With @p defer and @ref overlap_ghost_communication set, an update
+   * without resort on a regular decomposition is postponed, such that
+   * @ref particle_arrays_loop can evaluate the inner cells while the
+   * ghost positions are in flight. The update has to be completed with
+   * @ref complete_ghosts_update before ghost data is accessed otherwise.
+   *
    * @param data_parts Particle parts to update, combination of @ref
    * Cells::DataPart
+   * @param defer Whether the update may be postponed.
+   */
+  void update_ghosts_and_resort_particle(unsigned data_parts,
+                                         bool defer = false);
+
+  /**
+   * @brief Complete a postponed ghost update, if any.
+   *
+   * @param overlap Work to run while the first group of messages is in
+   *        flight (see @ref ghost_communicator); it must not access
+   *        ghost particles.
    */
-  void update_ghosts_and_resort_particle(unsigned data_parts);
+  void complete_ghosts_update(std::function<void()> const &overlap = {});
 
   /**
    * @brief Add forces from ghost particles to real particles.
@@ -470,7 +593,62 @@ public:
   /** @brief Average number of integration steps the Verlet list was re-used */
   auto get_verlet_reuse() const { return m_verlet_reuse; }
 
+  /**
+   * @brief Get the number of threads used in the non-bonded pair loop
+   * and in the propagation.
+   */
+  auto get_n_threads() const { return m_n_threads; }
+
+  /**
+   * @brief Set the number of threads used in the non-bonded pair loop
+   * and in the propagation.
+   * Values larger than 1 require OpenMP support.
+   */
+  void set_n_threads(int value);
+
+  /** @brief Get the order of the local cells and particles. */
+  auto get_space_filling_curve() const { return m_space_filling_curve; }
+
+  /**
+   * @brief Set the order of the local cells and particles.
+   *
+   * The local cells of the regular decomposition are visited along the
+   * curve, and the particles of each cell are periodically sorted along
+   * it, such that particles close in space are also close in memory.
+   * Rebuilds the cell structure.
+   */
+  void set_space_filling_curve(SpaceFillingCurve curve);
+
+  /** @brief Get the neighbor domains that ghosts are imported from. */
+  auto get_ghost_shell() const { return m_ghost_shell; }
+
+  /**
+   * @brief Set the neighbor domains that ghosts are imported from.
+   *
+   * Only affects the regular decomposition, see @ref GhostShell.
+   * Rebuilds the cell structure.
+   */
+  void set_ghost_shell(GhostShell ghost_shell);
+
+  /** @brief Whether the ghosts only cover the upper half shell. */
+  bool has_half_ghost_shell() const {
+    return m_type == CellStructureType::REGULAR and
+           m_ghost_shell == GhostShell::HALF;
+  }
+
+  /** @brief Get the number of resorts between two particle reorderings. */
+  auto get_reordering_interval() const { return m_reordering_interval; }
+
+  /**
+   * @brief Set the number of resorts between two particle reorderings.
+   * A value of 0 keeps the particles in arrival order.
+   */
+  void set_reordering_interval(int value);
+
 private:
+  /** @brief Sort the particles of each local cell along the curve. */
+  void reorder_particles();
+
   /**
    * @brief Resolve ids to particles.
    *
@@ -537,6 +715,8 @@ private:
   void set_particle_decomposition(
       std::unique_ptr<ParticleDecomposition> &&decomposition) {
     clear_particle_index();
+    m_cell_colors.clear();
+    m_particle_arrays.invalidate();
 
     /* Swap in new cell system */
     std::swap(m_decomposition, decomposition);
@@ -573,74 +753,146 @@ public:
                                 std::set<int> n_square_types);
 
 private:
+  /**
+   * @brief Partition the local cells into sets of independent cells.
+   *
+   * Two cells are independent if the pair loops over their particles
+   * and their red neighbors don't write to a common cell. All cells
+   * of a set can therefore be processed concurrently.
+   */
+  std::vector<std::vector<std::size_t>> const &cell_colors();
+
+  /**
+   * @brief Run a kernel on all local cells.
+   *
+   * The kernel is called once per cell and must only modify particles
+   * of that cell and of its red neighbors. When @p parallel is true and
+   * more than one thread is available, cells of the same color are
+   * processed concurrently, otherwise cells are visited in order.
+   *
+   * @tparam CellKernel Needs to be callable with the index of the cell
+   *                    in the local cells.
+   * @param cell_kernel Cell kernel functor.
+   * @param parallel    Whether the kernel is thread-safe.
+   */
+  template <class CellKernel>
+  void for_each_local_cell(CellKernel const &cell_kernel, bool parallel) {
+#ifdef OPENMP
+    if (parallel and m_n_threads > 1) {
+      for (auto const &cells : cell_colors()) {
+        auto const n_cells = static_cast<int>(cells.size());
+#pragma omp parallel for schedule(dynamic) num_threads(m_n_threads)
+        for (int i = 0; i < n_cells; ++i) {
+          cell_kernel(cells[static_cast<std::size_t>(i)]);
+        }
+      }
+      return;
+    }
+#endif
+    auto const n_cells = decomposition().local_cells().size();
+    for (std::size_t i = 0; i < n_cells; ++i) {
+      cell_kernel(i);
+    }
+  }
+
   /**
    * @brief Run link_cell algorithm for local cells.
    *
-   * @tparam Kernel Needs to be callable with (Particle, Particle, Distance).
+   * @tparam Kernel Needs to be callable with (Cell, Particle, Particle,
+   *                Distance).
    * @param kernel Pair kernel functor.
+   * @param parallel Whether the kernel can be run on several threads.
    */
-  template <class Kernel> void link_cell(Kernel kernel) {
+  template <class Kernel> void link_cell(Kernel kernel, bool parallel) {
     auto const maybe_box = decomposition().minimum_image_distance();
-    auto const local_cells_span = decomposition().local_cells();
-    auto const first = boost::make_indirect_iterator(local_cells_span.begin());
-    auto const last = boost::make_indirect_iterator(local_cells_span.end());
+
+    auto const run = [this, &kernel, parallel](auto const &df) {
+      auto const cells = decomposition().local_cells();
+      for_each_local_cell(
+          [&kernel, &df, &cells](std::size_t i) {
+            auto &cell = *cells[i];
+            Algorithm::link_cell(cell, [&](Particle &p1, Particle &p2) {
+              kernel(cell, p1, p2, df(p1, p2));
+            });
+          },
+          parallel);
+    };
 
     if (maybe_box) {
-      Algorithm::link_cell(
-          first, last,
-          [&kernel, df = detail::MinimalImageDistance{decomposition().box()}](
-              Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
+      run(detail::MinimalImageDistance{decomposition().box()});
     } else {
       if (decomposition().box().type() != BoxType::CUBOID) {
         throw std::runtime_error("Non-cuboid box type is not compatible with a "
                                  "particle decomposition that relies on "
                                  "EuclideanDistance for distance calculation.");
       }
-      Algorithm::link_cell(
-          first, last,
-          [&kernel, df = detail::EuclidianDistance{}](
-              Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
+      run(detail::EuclidianDistance{});
     }
   }
 
+  /**
+   * @brief Run link_cell algorithm for local cells.
+   *
+   * @tparam Kernel Needs to be callable with (Particle, Particle, Distance).
+   * @param kernel Pair kernel functor.
+   */
+  template <class Kernel> void link_cell(Kernel kernel) {
+    link_cell([&kernel](Cell &, Particle &p1, Particle &p2,
+                        Distance const &d) { kernel(p1, p2, d); },
+              false);
+  }
+
   /** Non-bonded pair loop with verlet lists.
+   *
+   * The Verlet list of each cell holds the pairs found by the link_cell
+   * algorithm for this cell, such that the pair kernel can be run over
+   * the lists in the same order and with the same thread-safety
+   * guarantees as the link_cell algorithm.
    *
    * @param pair_kernel Kernel to apply
    * @param verlet_criterion Filter for verlet lists.
+   * @param parallel Whether the kernel can be run on several threads.
    */
   template <class PairKernel, class VerletCriterion>
   void verlet_list_loop(PairKernel pair_kernel,
-                        const VerletCriterion &verlet_criterion) {
+                        const VerletCriterion &verlet_criterion,
+                        bool parallel) {
     /* In this case the verlet list update is attached to
      * the pair kernel, and the verlet list is rebuilt as
      * we go. */
     if (m_rebuild_verlet_list) {
-      m_verlet_list.clear();
+      for (auto cell : decomposition().local_cells()) {
+        cell->m_verlet_list.clear();
+      }
 
-      link_cell([&](Particle &p1, Particle &p2, Distance const &d) {
-        if (verlet_criterion(p1, p2, d)) {
-          m_verlet_list.emplace_back(&p1, &p2);
-          pair_kernel(p1, p2, d);
-        }
-      });
+      link_cell(
+          [&](Cell &cell, Particle &p1, Particle &p2, Distance const &d) {
+            if (verlet_criterion(p1, p2, d)) {
+              cell.m_verlet_list.emplace_back(&p1, &p2);
+              pair_kernel(p1, p2, d);
+            }
+          },
+          parallel);
 
       m_rebuild_verlet_list = false;
     } else {
       auto const maybe_box = decomposition().minimum_image_distance();
       /* In this case the pair kernel is just run over the verlet list. */
+      auto const run = [this, &pair_kernel, parallel](auto const &df) {
+        auto const cells = decomposition().local_cells();
+        for_each_local_cell(
+            [&pair_kernel, &df, &cells](std::size_t i) {
+              for (auto &pair : cells[i]->m_verlet_list) {
+                pair_kernel(*pair.first, *pair.second,
+                            df(*pair.first, *pair.second));
+              }
+            },
+            parallel);
+      };
       if (maybe_box) {
-        auto const distance_function =
-            detail::MinimalImageDistance{decomposition().box()};
-        for (auto &pair : m_verlet_list) {
-          pair_kernel(*pair.first, *pair.second,
-                      distance_function(*pair.first, *pair.second));
-        }
+        run(detail::MinimalImageDistance{decomposition().box()});
       } else {
-        auto const distance_function = detail::EuclidianDistance{};
-        for (auto &pair : m_verlet_list) {
-          pair_kernel(*pair.first, *pair.second,
-                      distance_function(*pair.first, *pair.second));
-        }
+        run(detail::EuclidianDistance{});
       }
     }
   }
@@ -666,18 +918,202 @@ public:
    * of verlet lists.
    * @param pair_kernel Kernel to apply
    * @param verlet_criterion Filter for verlet lists.
+   * @param parallel Whether the kernel can be run on several threads.
+   *        The kernel must then only modify the two particles it is
+   *        called with.
    */
   template <class PairKernel, class VerletCriterion>
   void non_bonded_loop(PairKernel pair_kernel,
-                       const VerletCriterion &verlet_criterion) {
+                       const VerletCriterion &verlet_criterion,
+                       bool parallel = false) {
     if (use_verlet_list) {
-      verlet_list_loop(pair_kernel, verlet_criterion);
+      verlet_list_loop(pair_kernel, verlet_criterion, parallel);
     } else {
       /* No verlet lists, just run the kernel with pairs from the cells. */
-      link_cell(pair_kernel);
+      link_cell([&pair_kernel](Cell &, Particle &p1, Particle &p2,
+                               Distance const &d) { pair_kernel(p1, p2, d); },
+                parallel);
     }
   }
 
+  /**
+   * @brief Get the structure-of-arrays mirror of the particles.
+   *
+   * The layout is rebuilt if the particles were resorted since
+   * the last call.
+   */
+  ParticleArrays const &particle_arrays();
+
+  /** Non-bonded pair loop over the structure-of-arrays mirror
+   * of the particles.
+   *
+   * The particle data is gathered into @ref ParticleArrays, and the
+   * accumulated forces are added to the particles at the end.
+   * The kernel only has access to the data stored in the arrays.
+   * With Verlet lists, the lists store pairs of particle clusters,
+   * which interact if any of their particle pairs fulfill the
+   * Verlet criterion; all particle pairs of an interacting cluster
+   * pair are then handed to the kernel. Without Verlet lists, the
+   * pairs are visited in the same way as in @ref link_cell.
+   *
+   * @param pair_kernel Kernel to apply, needs to be callable with
+   *        (ParticleArrays, std::size_t, std::size_t, Distance).
+   *        If it is also callable with (ParticleArrays,
+   *        std::span<ParticleArrays::IndexPair const>, DistanceFunction),
+   *        the particle pairs of the cluster pairs are handed over in
+   *        chunks, such that the kernel can process them in batches.
+   * @param verlet_criterion Filter for verlet lists, needs to be callable
+   *        with (ParticleArrays, std::size_t, std::size_t, Distance).
+   * If a ghost update has been postponed, it is completed here: the
+   * pairs of the inner cells are evaluated while the first ghost
+   * messages are in flight, followed by the pairs of the other cells.
+   *
+   * @param parallel Whether the kernel can be run on several threads.
+   *        The kernel must then only modify the forces of the two
+   *        particles it is called with.
+   */
+  template <class PairKernel, class VerletCriterion>
+  void particle_arrays_loop(PairKernel pair_kernel,
+                            const VerletCriterion &verlet_criterion,
+                            bool parallel = false) {
+    using IndexPair = ParticleArrays::IndexPair;
+    particle_arrays();
+    auto &arrays = m_particle_arrays;
+
+    auto const maybe_box = decomposition().minimum_image_distance();
+    if (not maybe_box and decomposition().box().type() != BoxType::CUBOID) {
+      throw std::runtime_error("Non-cuboid box type is not compatible with a "
+                               "particle decomposition that relies on "
+                               "EuclideanDistance for distance calculation.");
+    }
+
+    auto const build_verlet_lists =
+        use_verlet_list and not arrays.verlet_lists_valid();
+    auto const run = [&](auto const &df, auto const &selected) {
+      auto const evaluate = [&](std::span<IndexPair const> pairs) {
+        if constexpr (std::is_invocable_v<PairKernel &, ParticleArrays &,
+                                          decltype(pairs), decltype(df)>) {
+          pair_kernel(arrays, pairs, df);
+        } else {
+          for (auto const &[i, j] : pairs) {
+            pair_kernel(arrays, i, j, df(arrays.pos[i], arrays.pos[j]));
+          }
+        }
+      };
+
+      if (use_verlet_list) {
+        for_each_local_cell(
+            [&](std::size_t c) {
+              if (not selected(c)) {
+                return;
+              }
+              /* Particle pairs of the cluster pairs, in chunks */
+              constexpr auto max_pairs_per_cluster_pair =
+                  ParticleArrays::cluster_size * ParticleArrays::cluster_size;
+              std::array<IndexPair, 16 * max_pairs_per_cluster_pair> buffer;
+              std::size_t n_pairs = 0;
+              auto const add_pair = [&](std::size_t i, std::size_t j) {
+                buffer[n_pairs++] = {static_cast<unsigned int>(i),
+                                     static_cast<unsigned int>(j)};
+              };
+              auto const add_cluster_pair = [&](std::size_t a, std::size_t b) {
+                if (n_pairs + max_pairs_per_cluster_pair > buffer.size()) {
+                  evaluate(std::span(buffer.data(), n_pairs));
+                  n_pairs = 0;
+                }
+                arrays.for_each_pair(a, b, add_pair);
+              };
+
+              auto &cluster_pairs = arrays.cluster_pairs(c);
+              if (build_verlet_lists) {
+                cluster_pairs.clear();
+                auto const interact = [&](std::size_t a, std::size_t b) {
+                  auto result = false;
+                  arrays.for_each_pair(a, b, [&](std::size_t i, std::size_t j) {
+                    if (not result) {
+                      auto const d = df(arrays.pos[i], arrays.pos[j]);
+                      result = verlet_criterion(arrays, i, j, d);
+                    }
+                  });
+                  return result;
+                };
+                auto const candidate = [&](std::size_t a, std::size_t b) {
+                  if (interact(a, b)) {
+                    cluster_pairs.emplace_back(static_cast<unsigned int>(a),
+                                               static_cast<unsigned int>(b));
+                  }
+                };
+                auto const &clusters = arrays.cell_clusters(c);
+                for (auto a = clusters.begin; a < clusters.end; ++a) {
+                  /* Cluster pairs in this cell */
+                  for (auto b = a; b < clusters.end; ++b) {
+                    candidate(a, b);
+                  }
+                  /* Cluster pairs with neighbors */
+                  for (auto const &neighbor : arrays.red_neighbor_clusters(c)) {
+                    for (auto b = neighbor.begin; b < neighbor.end; ++b) {
+                      candidate(a, b);
+                    }
+                  }
+                }
+              }
+              for (auto const &[a, b] : cluster_pairs) {
+                add_cluster_pair(a, b);
+              }
+              evaluate(std::span(buffer.data(), n_pairs));
+            },
+            parallel);
+        return;
+      }
+
+      for_each_local_cell(
+          [&](std::size_t c) {
+            if (not selected(c)) {
+              return;
+            }
+            auto const &cell = arrays.cell(c);
+            for (auto i = cell.begin; i < cell.end; ++i) {
+              /* Pairs in this cell */
+              for (auto j = i + 1; j < cell.end; ++j) {
+                pair_kernel(arrays, i, j, df(arrays.pos[i], arrays.pos[j]));
+              }
+              /* Pairs with neighbors */
+              for (auto const &neighbor : arrays.red_neighbors(c)) {
+                for (auto j = neighbor.begin; j < neighbor.end; ++j) {
+                  pair_kernel(arrays, i, j, df(arrays.pos[i], arrays.pos[j]));
+                }
+              }
+            }
+          },
+          parallel);
+    };
+    auto const run_cells = [&](auto const &selected) {
+      if (maybe_box) {
+        run(detail::MinimalImageDistance{decomposition().box()}, selected);
+      } else {
+        run(detail::EuclidianDistance{}, selected);
+      }
+    };
+
+    if (m_deferred_ghost_parts) {
+      auto const is_inner = [&arrays](std::size_t c) {
+        return arrays.is_inner_cell(c);
+      };
+      arrays.gather_local();
+      complete_ghosts_update([&]() { run_cells(is_inner); });
+      arrays.gather_ghosts();
+      run_cells([&is_inner](std::size_t c) { return not is_inner(c); });
+    } else {
+      arrays.gather();
+      run_cells([](std::size_t) { return true; });
+    }
+    if (build_verlet_lists) {
+      arrays.set_verlet_lists_valid();
+    }
+
+    arrays.scatter_forces();
+  }
+
   /**
    * @brief Check that particle index is commensurate with particles.
    *
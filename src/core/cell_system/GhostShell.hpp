@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <utils/Vector.hpp>
+
+/** @brief Neighbor domains whose particles are imported as ghosts. */
+enum class GhostShell : int {
+  /** @brief Ghosts from all 26 neighbor domains. */
+  FULL = 0,
+  /**
+   * @brief Ghosts from the 13 neighbor domains of the upper half shell.
+   *
+   * A pair of particles on two MPI ranks is evaluated by the rank that
+   * sees the other one in its upper half shell, and the force on the
+   * ghost is sent back. This halves the ghost volume.
+   */
+  HALF = 1
+};
+
+/**
+ * @brief Whether ghosts are imported from a neighbor domain.
+ *
+ * The upper half shell contains the domains above the local one
+ * (@f$ z @f$ offset of +1), the domains next to it above in @f$ y @f$,
+ * and the domain next to it above in @f$ x @f$.
+ *
+ * @param shell   Ghost shell.
+ * @param region  Offset of the neighbor domain, each component is -1, 0
+ *                or +1. The null offset is the local domain.
+ */
+inline bool imports_region(GhostShell shell, Utils::Vector3i const &region) {
+  if (shell == GhostShell::FULL) {
+    return true;
+  }
+  if (region[2] != 0) {
+    return region[2] > 0;
+  }
+  if (region[1] != 0) {
+    return region[1] > 0;
+  }
+  return region[0] >= 0;
+}
@@ -46,10 +46,12 @@ HybridDecomposition::HybridDecomposition(boost::mpi::communicator comm,
                                          std::function<bool()> get_ghost_flags,
                                          BoxGeometry const &box_geo,
                                          LocalBox const &local_box,
-                                         std::set<int> n_square_types)
+                                         std::set<int> n_square_types,
+                                         SpaceFillingCurve curve)
     : m_comm(std::move(comm)), m_box(box_geo), m_cutoff_regular(cutoff_regular),
-      m_regular_decomposition(RegularDecomposition(
-          m_comm, cutoff_regular + skin, m_box, local_box, std::nullopt)),
+      m_regular_decomposition(
+          RegularDecomposition(m_comm, cutoff_regular + skin, m_box, local_box,
+                               std::nullopt, curve, GhostShell::FULL)),
       m_n_square(AtomDecomposition(m_comm, m_box)),
       m_n_square_types(std::move(n_square_types)),
       m_get_global_ghost_flags(std::move(get_ghost_flags)) {
@@ -26,6 +26,7 @@
 #include "cell_system/RegularDecomposition.hpp"
 
 #include "cell_system/Cell.hpp"
+#include "cell_system/SpaceFillingCurve.hpp"
 
 #include "BoxGeometry.hpp"
 #include "LocalBox.hpp"
@@ -80,7 +81,7 @@ public:
   HybridDecomposition(boost::mpi::communicator comm, double cutoff_regular,
                       double skin, std::function<bool()> get_ghost_flags,
                       BoxGeometry const &box_geo, LocalBox const &local_box,
-                      std::set<int> n_square_types);
+                      std::set<int> n_square_types, SpaceFillingCurve curve);
 
   auto get_cell_grid() const { return m_regular_decomposition.cell_grid; }
 
@@ -117,6 +118,13 @@ public:
     return m_regular_decomposition.particle_to_cell(p);
   }
 
+  int particle_to_rank(Particle const &p) const override {
+    if (is_n_square_type(p.type())) {
+      return m_n_square.particle_to_rank(p);
+    }
+    return m_regular_decomposition.particle_to_rank(p);
+  }
+
   Utils::Vector3d max_cutoff() const override {
     return m_n_square.max_cutoff();
   }
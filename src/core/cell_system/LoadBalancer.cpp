@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cell_system/LoadBalancer.hpp"
+
+#include "BoxGeometry.hpp"
+#include "Particle.hpp"
+#include "ParticleRange.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/index.hpp>
+
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/operations.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+std::vector<double> balanced_domain_bounds(std::vector<double> const &weights,
+                                           int n_domains, double min_width) {
+  std::vector<double> bounds(static_cast<std::size_t>(n_domains) + 1u);
+  for (std::size_t k = 0u; k < bounds.size(); ++k) {
+    bounds[k] = static_cast<double>(k) / static_cast<double>(n_domains);
+  }
+  auto const total = std::accumulate(weights.begin(), weights.end(), 0.);
+  if (total <= 0. or n_domains * min_width >= 1.) {
+    return bounds;
+  }
+
+  /* invert the cumulative distribution at equally spaced values */
+  auto const n_bins = weights.size();
+  auto cumulative = 0.;
+  std::size_t bin = 0u;
+  for (std::size_t k = 1u; k + 1u < bounds.size(); ++k) {
+    auto const target = total * static_cast<double>(k) / n_domains;
+    while (bin < n_bins and cumulative + weights[bin] < target) {
+      cumulative += weights[bin];
+      ++bin;
+    }
+    auto fraction = 0.;
+    if (bin < n_bins and weights[bin] > 0.) {
+      fraction = (target - cumulative) / weights[bin];
+    }
+    bounds[k] = (static_cast<double>(bin) + fraction) /
+                static_cast<double>(n_bins);
+  }
+
+  /* enforce the minimal domain width */
+  for (std::size_t k = 1u; k + 1u < bounds.size(); ++k) {
+    bounds[k] = std::max(bounds[k], bounds[k - 1u] + min_width);
+  }
+  for (auto k = bounds.size() - 2u; k > 0u; --k) {
+    bounds[k] = std::min(bounds[k], bounds[k + 1u] - min_width);
+  }
+  return bounds;
+}
+
+bool LoadBalancer::fits(Utils::Vector3d const &box_l, double range) const {
+  for (auto dir = 0u; dir < 3u; ++dir) {
+    auto const &cuts = m_cuts[dir];
+    for (std::size_t k = 1u; k < cuts.size(); ++k) {
+      if ((cuts[k] - cuts[k - 1u]) * box_l[dir] < range) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void LoadBalancer::rebalance(boost::mpi::communicator const &comm,
+                             ParticleRange const &particles,
+                             BoxGeometry const &box_geo,
+                             Utils::Vector3i const &node_grid,
+                             double min_width) {
+  auto const n_local = static_cast<double>(particles.size());
+  auto const &box_l = box_geo.length();
+
+  /* cost of this rank; fall back to the particle count when no force
+   * calculation was timed since the last rebalancing */
+  auto cost = n_local;
+  if (m_metric == LoadBalancingMetric::FORCE_TIME) {
+    auto const total_time =
+        boost::mpi::all_reduce(comm, m_force_time, std::plus<>());
+    if (total_time > 0.) {
+      cost = m_force_time;
+    }
+  }
+  auto const weight = (n_local > 0.) ? cost / n_local : 0.;
+
+  auto const imbalance = [&comm](double max_cost, double total_cost) {
+    if (total_cost <= 0.) {
+      return 1.;
+    }
+    return max_cost * static_cast<double>(comm.size()) / total_cost;
+  };
+  auto const max_cost =
+      boost::mpi::all_reduce(comm, cost, boost::mpi::maximum<double>());
+  auto const total_cost = boost::mpi::all_reduce(comm, cost, std::plus<>());
+  m_imbalance_before = imbalance(max_cost, total_cost);
+  m_steps = 0;
+  m_force_time = 0.;
+  if (comm.size() == 1) {
+    m_imbalance_after = m_imbalance_before;
+    return;
+  }
+
+  /* fractional position of a particle along a direction */
+  auto const reduced_position = [&box_l](Particle const &p, unsigned dir) {
+    return std::clamp(p.pos()[dir] / box_l[dir], 0., 1.);
+  };
+
+  for (auto dir = 0u; dir < 3u; ++dir) {
+    auto const n_domains = node_grid[dir];
+    auto const n_bins = static_cast<std::size_t>(bins_per_domain * n_domains);
+    std::vector<double> local_weights(n_bins, 0.);
+    for (auto const &p : particles) {
+      auto const x = reduced_position(p, dir);
+      auto const bin = std::min(
+          static_cast<std::size_t>(x * static_cast<double>(n_bins)),
+          n_bins - 1u);
+      local_weights[bin] += weight;
+    }
+    std::vector<double> weights(n_bins);
+    boost::mpi::all_reduce(comm, local_weights.data(),
+                           static_cast<int>(n_bins), weights.data(),
+                           std::plus<>());
+    // domains are at least one histogram bin wide, the relative margin
+    // keeps the domain widths above the minimum despite round-off errors
+    auto const min_fraction =
+        std::max(min_width / box_l[dir] * (1. + 1e-10),
+                 1. / static_cast<double>(n_bins));
+    m_cuts[dir] = balanced_domain_bounds(weights, n_domains, min_fraction);
+  }
+
+  /* expected cost of each rank with the new domain boundaries */
+  std::vector<double> local_costs(
+      static_cast<std::size_t>(Utils::product(node_grid)), 0.);
+  for (auto const &p : particles) {
+    Utils::Vector3i node_index;
+    for (auto dir = 0u; dir < 3u; ++dir) {
+      auto const &cuts = m_cuts[dir];
+      auto const it = std::upper_bound(cuts.begin(), cuts.end(),
+                                       reduced_position(p, dir));
+      auto const index = static_cast<int>(std::distance(cuts.begin(), it));
+      node_index[dir] = std::clamp(index - 1, 0, node_grid[dir] - 1);
+    }
+    local_costs[Utils::get_linear_index(node_index, node_grid)] += weight;
+  }
+  std::vector<double> costs(local_costs.size());
+  boost::mpi::all_reduce(comm, local_costs.data(),
+                         static_cast<int>(local_costs.size()), costs.data(),
+                         std::plus<>());
+  m_imbalance_after =
+      imbalance(*std::ranges::max_element(costs),
+                std::accumulate(costs.begin(), costs.end(), 0.));
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/** \file
+ *
+ *  Dynamic load balancing of the regular decomposition.
+ *
+ *  The domain boundaries are shifted along each Cartesian direction,
+ *  such that the domains still form a tensor-product grid: all ranks
+ *  in a slab of the node grid share the same boundaries along the slab
+ *  normal. The boundaries are obtained from 1D histograms of the
+ *  computational cost along each direction, where the cost of a rank
+ *  is either its number of particles or its measured force calculation
+ *  time, and is evenly spread over its particles.
+ */
+
+#include "BoxGeometry.hpp"
+#include "ParticleRange.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/communicator.hpp>
+
+#include <array>
+#include <vector>
+
+enum class LoadBalancingMetric : int { N_PARTICLES, FORCE_TIME };
+
+/**
+ * @brief Domain boundaries that evenly split a cost histogram.
+ *
+ * @param weights     Cost histogram over the box length.
+ * @param n_domains   Number of domains.
+ * @param min_width   Minimal domain width, as a fraction of the box length.
+ * @return Domain boundaries, as fractions of the box length, from 0 to 1.
+ */
+std::vector<double> balanced_domain_bounds(std::vector<double> const &weights,
+                                           int n_domains, double min_width);
+
+class LoadBalancer {
+  /** Rebalance every @c m_interval integration steps, 0 disables it. */
+  int m_interval = 0;
+  LoadBalancingMetric m_metric = LoadBalancingMetric::N_PARTICLES;
+  /** Integration steps since the last rebalancing. */
+  int m_steps = 0;
+  /** Force calculation time since the last rebalancing. */
+  double m_force_time = 0.;
+  /** Domain boundaries as fractions of the box length, empty if uniform. */
+  std::array<std::vector<double>, 3> m_cuts = {};
+  double m_imbalance_before = 1.;
+  double m_imbalance_after = 1.;
+
+public:
+  /** Histogram resolution along each direction, per domain. */
+  static constexpr int bins_per_domain = 64;
+
+  auto get_interval() const { return m_interval; }
+  void set_interval(int interval) {
+    m_interval = interval;
+    m_steps = 0;
+    m_force_time = 0.;
+  }
+  auto get_metric() const { return m_metric; }
+  void set_metric(LoadBalancingMetric metric) {
+    m_metric = metric;
+    m_force_time = 0.;
+  }
+
+  /** Ratio of the largest to the mean cost before the last rebalancing. */
+  auto get_imbalance_before() const { return m_imbalance_before; }
+  /** Ratio of the largest to the mean cost expected after it. */
+  auto get_imbalance_after() const { return m_imbalance_after; }
+
+  auto const &get_cuts() const { return m_cuts; }
+  bool is_uniform() const { return m_cuts[0].empty(); }
+
+  /** Return to the uniform decomposition. */
+  void reset() {
+    m_cuts = {};
+    m_steps = 0;
+    m_force_time = 0.;
+  }
+
+  /** Whether the domains are wider than the interaction range. */
+  bool fits(Utils::Vector3d const &box_l, double range) const;
+
+  bool measures_force_time() const {
+    return m_interval > 0 and m_metric == LoadBalancingMetric::FORCE_TIME;
+  }
+  void add_force_time(double time) { m_force_time += time; }
+
+  /** @brief Start a new interval without rebalancing, for setups that
+   *  don't support load balancing.
+   */
+  void skip() {
+    m_steps = 0;
+    m_force_time = 0.;
+  }
+
+  /** @brief Count an integration step.
+   *  @return Whether the domains are due for rebalancing.
+   */
+  bool step() {
+    if (m_interval <= 0 or ++m_steps < m_interval) {
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Shift the domain boundaries to balance the cost.
+   *
+   * Only computes the new boundaries, which take effect when the
+   * local box is recreated.
+   *
+   * @param comm        Cartesian communicator.
+   * @param particles   Local particles.
+   * @param box_geo     Box geometry.
+   * @param node_grid   Node grid.
+   * @param min_width   Minimal domain width.
+   */
+  void rebalance(boost::mpi::communicator const &comm,
+                 ParticleRange const &particles, BoxGeometry const &box_geo,
+                 Utils::Vector3i const &node_grid, double min_width);
+};
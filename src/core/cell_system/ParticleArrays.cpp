@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cell_system/ParticleArrays.hpp"
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+/**
+ * @brief Sort particles into spatially compact clusters.
+ *
+ * Recursively bisects the particles along the axis of largest extent,
+ * with the split points at multiples of the cluster size, such that
+ * each consecutive group of @p cluster_size particles is compact.
+ */
+void sort_into_clusters(std::span<Particle *> particles,
+                        std::size_t cluster_size) {
+  if (particles.size() <= cluster_size) {
+    return;
+  }
+  auto lower = particles.front()->pos();
+  auto upper = lower;
+  for (auto const p : particles) {
+    for (unsigned int i = 0; i < 3; ++i) {
+      lower[i] = std::min(lower[i], p->pos()[i]);
+      upper[i] = std::max(upper[i], p->pos()[i]);
+    }
+  }
+  auto const extent = upper - lower;
+  auto const axis = static_cast<unsigned int>(std::distance(
+      extent.begin(), std::max_element(extent.begin(), extent.end())));
+  auto const n_clusters = (particles.size() + cluster_size - 1) / cluster_size;
+  auto const split = (n_clusters / 2) * cluster_size;
+  auto const compare = [axis](Particle const *a, Particle const *b) {
+    return a->pos()[axis] < b->pos()[axis];
+  };
+  std::nth_element(particles.begin(),
+                   particles.begin() + static_cast<std::ptrdiff_t>(split),
+                   particles.end(), compare);
+  sort_into_clusters(particles.first(split), cluster_size);
+  sort_into_clusters(particles.subspan(split), cluster_size);
+}
+} // namespace
+
+void ParticleArrays::rebuild(std::span<Cell *const> local_cells,
+                             std::span<Cell *const> ghost_cells) {
+  std::unordered_map<Cell const *, std::pair<Range, Range>> ranges;
+  std::unordered_set<Cell const *> const local_cell_set(local_cells.begin(),
+                                                        local_cells.end());
+  m_particles.clear();
+  m_clusters.clear();
+  m_has_exclusions = false;
+
+  auto const add_cell = [this, &ranges](Cell *cell) {
+    auto const begin = m_particles.size();
+    for (auto &p : cell->particles()) {
+      m_particles.emplace_back(&p);
+#ifdef EXCLUSIONS
+      if (not p.exclusions().empty()) {
+        m_has_exclusions = true;
+      }
+#endif
+    }
+    auto const end = m_particles.size();
+    sort_into_clusters(std::span(m_particles).subspan(begin, end - begin),
+                       cluster_size);
+    auto const first_cluster = m_clusters.size();
+    for (auto i = begin; i < end; i += cluster_size) {
+      m_clusters.emplace_back(Range{i, std::min(i + cluster_size, end)});
+    }
+    ranges[cell] = {Range{begin, end}, Range{first_cluster, m_clusters.size()}};
+  };
+
+  for (auto cell : local_cells) {
+    add_cell(cell);
+  }
+  m_n_local = m_particles.size();
+  for (auto cell : ghost_cells) {
+    add_cell(cell);
+  }
+
+  m_cells.clear();
+  m_red_neighbors.clear();
+  m_cell_clusters.clear();
+  m_red_neighbor_clusters.clear();
+  m_inner_cells.clear();
+  for (auto cell : local_cells) {
+    auto const &[particle_range, cluster_range] = ranges.at(cell);
+    m_cells.emplace_back(particle_range);
+    m_cell_clusters.emplace_back(cluster_range);
+    auto &neighbors = m_red_neighbors.emplace_back();
+    auto &neighbor_clusters = m_red_neighbor_clusters.emplace_back();
+    auto inner = true;
+    for (auto neighbor : cell->neighbors().red()) {
+      inner = inner and local_cell_set.contains(neighbor);
+      auto const &[neighbor_particles, neighbor_cluster_range] =
+          ranges.at(neighbor);
+      neighbors.emplace_back(neighbor_particles);
+      neighbor_clusters.emplace_back(neighbor_cluster_range);
+    }
+    m_inner_cells.push_back(inner);
+  }
+
+  m_cluster_pairs.resize(local_cells.size());
+  for (auto &list : m_cluster_pairs) {
+    list.clear();
+  }
+
+  auto const n_part = m_particles.size();
+  pos.resize(n_part);
+  type.resize(n_part);
+#ifdef ELECTROSTATICS
+  q.resize(n_part);
+#endif
+  force.resize(n_part);
+
+  m_valid = true;
+  m_verlet_lists_valid = false;
+}
+
+void ParticleArrays::gather_local() {
+  assert(m_valid);
+  gather_range(0, m_n_local);
+}
+
+void ParticleArrays::gather_ghosts() {
+  assert(m_valid);
+  gather_range(m_n_local, m_particles.size());
+}
+
+void ParticleArrays::gather_range(std::size_t begin, std::size_t end) {
+  for (auto i = begin; i < end; ++i) {
+    auto const &p = *m_particles[i];
+    pos[i] = p.pos();
+    type[i] = p.type();
+#ifdef ELECTROSTATICS
+    q[i] = p.q();
+#endif
+    force[i] = Utils::Vector3d{};
+  }
+}
+
+void ParticleArrays::scatter_forces() const {
+  assert(m_valid);
+  for (std::size_t i = 0; i < m_particles.size(); ++i) {
+    m_particles[i]->force() += force[i];
+  }
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Structure-of-arrays mirror of the particles in the cells.
+ *
+ * Holds the particle properties needed by central pair potentials
+ * in contiguous arrays, such that the non-bonded pair loop only
+ * streams the data it actually reads through the cache. Local and
+ * ghost particles are stored cell by cell, in the order of the cells.
+ * Within a cell, the particles are sorted into spatially compact
+ * clusters of up to @ref cluster_size particles, which are the units
+ * of the Verlet lists. The layout only depends on the cell contents
+ * and is rebuilt after each particle resort; the particle data is
+ * gathered into the arrays before each force calculation and the
+ * forces are scattered back afterwards.
+ */
+class ParticleArrays {
+public:
+  /** @brief Maximal number of particles in a cluster. */
+  static constexpr std::size_t cluster_size = 4;
+
+  /** @brief Range of array indices. */
+  struct Range {
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  /** @brief Index pair of particles or clusters. */
+  using IndexPair = std::pair<unsigned int, unsigned int>;
+
+  /** @brief Particle positions. */
+  std::vector<Utils::Vector3d> pos;
+  /** @brief Particle types. */
+  std::vector<int> type;
+#ifdef ELECTROSTATICS
+  /** @brief Particle charges. */
+  std::vector<double> q;
+#endif
+  /** @brief Force accumulators. */
+  std::vector<Utils::Vector3d> force;
+
+private:
+  /** Particle of each array entry. */
+  std::vector<Particle *> m_particles;
+  /** Particle range of each cluster. */
+  std::vector<Range> m_clusters;
+  /** Particle range of each local cell. */
+  std::vector<Range> m_cells;
+  /** Particle ranges of the red neighbors of each local cell. */
+  std::vector<std::vector<Range>> m_red_neighbors;
+  /** Cluster range of each local cell. */
+  std::vector<Range> m_cell_clusters;
+  /** Cluster ranges of the red neighbors of each local cell. */
+  std::vector<std::vector<Range>> m_red_neighbor_clusters;
+  /** Interacting cluster pairs of each local cell. */
+  std::vector<std::vector<IndexPair>> m_cluster_pairs;
+  /** Whether all red neighbors of each local cell are local cells. */
+  std::vector<bool> m_inner_cells;
+  /** Number of local particles, which precede the ghost particles. */
+  std::size_t m_n_local = 0;
+  bool m_valid = false;
+  bool m_verlet_lists_valid = false;
+  bool m_has_exclusions = false;
+
+  void gather_range(std::size_t begin, std::size_t end);
+
+public:
+  /** @brief Whether the layout matches the cell contents. */
+  bool is_valid() const { return m_valid; }
+
+  /** @brief Mark the layout as outdated, e.g. after a resort. */
+  void invalidate() {
+    m_valid = false;
+    m_verlet_lists_valid = false;
+  }
+
+  /**
+   * @brief Rebuild the layout from the cells.
+   *
+   * Has to be called after the ghost particles have been counted
+   * and updated, since the particle pointers are stored and the
+   * clusters are formed from the current positions.
+   *
+   * @param local_cells Local cells.
+   * @param ghost_cells Ghost cells.
+   */
+  void rebuild(std::span<Cell *const> local_cells,
+               std::span<Cell *const> ghost_cells);
+
+  /** @brief Copy particle data into the arrays and reset the forces. */
+  void gather() {
+    gather_local();
+    gather_ghosts();
+  }
+
+  /** @brief Like @ref gather, for the local particles only. */
+  void gather_local();
+
+  /** @brief Like @ref gather, for the ghost particles only. */
+  void gather_ghosts();
+
+  /** @brief Add the force accumulators to the particle forces. */
+  void scatter_forces() const;
+
+  /** @brief Number of particles in the arrays. */
+  auto size() const { return m_particles.size(); }
+
+  /** @brief Whether any particle has exclusions. */
+  auto has_exclusions() const { return m_has_exclusions; }
+
+  /** @brief Particle range of the i-th local cell. */
+  auto const &cell(std::size_t i) const { return m_cells[i]; }
+
+  /**
+   * @brief Whether the i-th local cell only interacts with local cells,
+   * such that its pairs can be evaluated before the ghosts are updated.
+   */
+  bool is_inner_cell(std::size_t i) const { return m_inner_cells[i]; }
+
+  /** @brief Particle ranges of the red neighbors of the i-th local cell. */
+  auto const &red_neighbors(std::size_t i) const { return m_red_neighbors[i]; }
+
+  /** @brief Cluster range of the i-th local cell. */
+  auto const &cell_clusters(std::size_t i) const { return m_cell_clusters[i]; }
+
+  /** @brief Cluster ranges of the red neighbors of the i-th local cell. */
+  auto const &red_neighbor_clusters(std::size_t i) const {
+    return m_red_neighbor_clusters[i];
+  }
+
+  /** @brief Interacting cluster pairs of the i-th local cell. */
+  auto &cluster_pairs(std::size_t i) { return m_cluster_pairs[i]; }
+
+  /**
+   * @brief Run a kernel on all particle pairs of a cluster pair.
+   * For a cluster paired with itself, each pair is visited once.
+   *
+   * @param a, b    Cluster indices.
+   * @param kernel  Callable with the two particle indices.
+   */
+  template <class Kernel>
+  void for_each_pair(std::size_t a, std::size_t b, Kernel &&kernel) const {
+    auto const &cluster_a = m_clusters[a];
+    auto const &cluster_b = m_clusters[b];
+    for (auto i = cluster_a.begin; i < cluster_a.end; ++i) {
+      for (auto j = (a == b) ? i + 1 : cluster_b.begin; j < cluster_b.end;
+           ++j) {
+        kernel(i, j);
+      }
+    }
+  }
+
+  /** @brief Whether the Verlet lists are up to date. */
+  auto verlet_lists_valid() const { return m_verlet_lists_valid; }
+
+  /** @brief Mark the Verlet lists as up to date. */
+  void set_verlet_lists_valid() { m_verlet_lists_valid = true; }
+};
@@ -74,6 +74,36 @@ public:
    */
   virtual void resort(bool global_flag, std::vector<ParticleChange> &diff) = 0;
 
+  /**
+   * @brief Record the displacement of the particles since the last
+   * Verlet list update.
+   *
+   * Implementations may record which local cells were left by one of
+   * their particles, and skip the other cells during the next local
+   * resort. The record is only valid as long as the particles are not
+   * moved by other means, otherwise it has to be discarded with
+   * @ref clear_displacements.
+   *
+   * @param max_displacement2 Squared displacement that requires a resort.
+   * @return Whether any particle moved further.
+   */
+  virtual bool record_displacements(double max_displacement2) {
+    for (auto const *cell : local_cells()) {
+      for (auto const &p : cell->particles()) {
+        if ((p.pos() - p.pos_at_last_verlet_update()).norm2() >
+            max_displacement2) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Discard the record of @ref record_displacements.
+   */
+  virtual void clear_displacements() {}
+
   /**
    * @brief Communicator for updating ghosts from the real particles.
    */
@@ -113,6 +143,18 @@ public:
   virtual Cell *particle_to_cell(Particle const &p) = 0;
   virtual Cell const *particle_to_cell(Particle const &p) const = 0;
 
+  /**
+   * @brief Determine which rank a particle belongs to.
+   *
+   * Unlike @ref particle_to_cell, this works for any particle, local or
+   * not. Positions on a domain boundary may be attributed to either side,
+   * hence the owner should still insert the particle with a fallback.
+   *
+   * @param p Particle to find the rank for, with a folded position.
+   * @return Rank of the MPI communicator of this decomposition.
+   */
+  virtual int particle_to_rank(Particle const &p) const = 0;
+
   /**
    * @brief Maximum supported cutoff.
    */
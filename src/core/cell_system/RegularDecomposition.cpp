@@ -22,6 +22,7 @@
 #include "cell_system/RegularDecomposition.hpp"
 
 #include "cell_system/Cell.hpp"
+#include "cell_system/SpaceFillingCurve.hpp"
 
 #include "communication.hpp"
 #include "error_handling/RuntimeErrorStream.hpp"
@@ -33,7 +34,7 @@
 #include <utils/mpi/cart_comm.hpp>
 #include <utils/mpi/sendrecv.hpp>
 
-#include <boost/container/flat_set.hpp>
+#include <boost/container/flat_map.hpp>
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
 #include <boost/range/algorithm/reverse.hpp>
@@ -43,6 +44,7 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <utility>
@@ -53,8 +55,9 @@ int RegularDecomposition::position_to_cell_index(
   Utils::Vector3i cpos;
 
   for (auto i = 0u; i < 3u; i++) {
-    cpos[i] = static_cast<int>(std::floor(pos[i] * inv_cell_size[i])) + 1 -
-              cell_offset[i];
+    cpos[i] = static_cast<int>(std::floor((pos[i] - m_lookup_origin[i]) *
+                                          inv_cell_size[i])) +
+              1 - m_lookup_offset[i];
 
     /* particles outside our box. Still take them if
        nonperiodic boundary. We also accept the particle if we are at
@@ -79,6 +82,21 @@ int RegularDecomposition::position_to_cell_index(
   return get_linear_index(cpos, ghost_cell_grid);
 }
 
+Utils::Vector3i
+RegularDecomposition::cell_region(Utils::Vector3i const &cell_index) const {
+  Utils::Vector3i region;
+  for (auto i = 0u; i < 3u; i++) {
+    if (cell_index[i] == 0) {
+      region[i] = -1;
+    } else if (cell_index[i] == ghost_cell_grid[i] - 1) {
+      region[i] = 1;
+    } else {
+      region[i] = 0;
+    }
+  }
+  return region;
+}
+
 void RegularDecomposition::move_if_local(
     ParticleList &src, ParticleList &rest,
     std::vector<ParticleChange> &modified_cells) {
@@ -171,12 +189,57 @@ static void fold_and_reset(Particle &p, BoxGeometry const &box_geo) {
   p.pos_at_last_verlet_update() = p.pos();
 }
 
+static bool is_inside(Utils::Vector3d const &pos,
+                      Utils::Vector3d const &lower,
+                      Utils::Vector3d const &upper) {
+  return lower[0] <= pos[0] and pos[0] < upper[0] and lower[1] <= pos[1] and
+         pos[1] < upper[1] and lower[2] <= pos[2] and pos[2] < upper[2];
+}
+
+bool RegularDecomposition::record_displacements(double max_displacement2) {
+  m_local_cells_left.resize(m_local_cells.size());
+  auto displaced = false;
+  for (std::size_t i = 0u; i < m_local_cells.size(); ++i) {
+    auto const &[lower, upper] = m_local_cell_bounds[i];
+    auto left = false;
+    for (auto const &p : m_local_cells[i]->particles()) {
+      displaced |= (p.pos() - p.pos_at_last_verlet_update()).norm2() >
+                   max_displacement2;
+      left |= not is_inside(p.pos(), lower, upper);
+    }
+    m_local_cells_left[i] = left;
+  }
+  return displaced;
+}
+
 void RegularDecomposition::resort(bool global,
                                   std::vector<ParticleChange> &diff) {
   ParticleList displaced_parts;
 
-  for (auto &c : local_cells()) {
+  /* On a local resort, the cells that no particle left since the skin
+   * check are skipped: their particles are still sorted, only their
+   * Verlet reference position has to be reset, since the Verlet lists
+   * are rebuilt from the current positions. */
+  auto const skip_cells = not global and not m_local_cells_left.empty();
+
+  for (std::size_t i = 0u; i < m_local_cells.size(); ++i) {
+    if (skip_cells and not m_local_cells_left[i]) {
+      for (auto &p : m_local_cells[i]->particles()) {
+        p.pos_at_last_verlet_update() = p.pos();
+      }
+      continue;
+    }
+    auto *const c = m_local_cells[i];
+    auto const &[lower, upper] = m_local_cell_bounds[i];
     for (auto it = c->particles().begin(); it != c->particles().end();) {
+      /* Particle is well inside its cell, hence also inside the box:
+       * neither folding nor a cell lookup is needed. */
+      if (is_inside(it->pos(), lower, upper)) {
+        it->pos_at_last_verlet_update() = it->pos();
+        std::advance(it, 1);
+        continue;
+      }
+
       fold_and_reset(*it, m_box);
 
       auto target_cell = particle_to_cell(*it);
@@ -235,11 +298,14 @@ void RegularDecomposition::resort(bool global,
       diff.emplace_back(ModifiedList{sort_cell->particles()});
     }
   }
+
+  clear_displacements();
 }
 
 void RegularDecomposition::mark_cells() {
   m_local_cells.clear();
   m_ghost_cells.clear();
+  clear_displacements();
 
   int cnt_c = 0;
   for (int o = 0; o < ghost_cell_grid[2]; o++)
@@ -248,9 +314,53 @@ void RegularDecomposition::mark_cells() {
         if ((m > 0 && m < ghost_cell_grid[0] - 1 && n > 0 &&
              n < ghost_cell_grid[1] - 1 && o > 0 && o < ghost_cell_grid[2] - 1))
           m_local_cells.push_back(&cells.at(cnt_c++));
-        else
+        else if (imports_region(m_ghost_shell, cell_region({m, n, o})))
           m_ghost_cells.push_back(&cells.at(cnt_c++));
+        else
+          cnt_c++;
       }
+
+  if (m_curve != SpaceFillingCurve::NONE) {
+    /* number of bits to represent the local cell indices */
+    auto bits = 0u;
+    while ((1 << bits) < *std::ranges::max_element(cell_grid)) {
+      ++bits;
+    }
+    auto const key = [this, bits](Cell const *cell) {
+      auto const index = static_cast<int>(cell - cells.data());
+      auto const grid_index = Utils::Vector3i{
+          index % ghost_cell_grid[0],
+          (index / ghost_cell_grid[0]) % ghost_cell_grid[1],
+          index / (ghost_cell_grid[0] * ghost_cell_grid[1])};
+      std::array<std::uint32_t, 3> x;
+      for (auto i = 0u; i < 3u; ++i) {
+        x[i] = static_cast<std::uint32_t>(grid_index[i] - 1);
+      }
+      return curve_index(m_curve, x, bits);
+    };
+    std::ranges::sort(m_local_cells, std::less<>{}, key);
+  }
+
+  /* Region of each local cell in which the position lookup is certain to
+   * return that cell, shrunk by a margin that absorbs rounding errors. */
+  m_local_cell_bounds.clear();
+  m_local_cell_bounds.reserve(m_local_cells.size());
+  for (auto const *cell : m_local_cells) {
+    auto const index = static_cast<int>(cell - cells.data());
+    auto const grid_index = Utils::Vector3i{
+        index % ghost_cell_grid[0],
+        (index / ghost_cell_grid[0]) % ghost_cell_grid[1],
+        index / (ghost_cell_grid[0] * ghost_cell_grid[1])};
+    Utils::Vector3d lower, upper;
+    for (auto i = 0u; i < 3u; ++i) {
+      auto const margin = 1e-10 * m_box.length()[i];
+      auto const left = m_lookup_origin[i] +
+                        (grid_index[i] - 1 + m_lookup_offset[i]) * cell_size[i];
+      lower[i] = left + margin;
+      upper[i] = left + cell_size[i] - margin;
+    }
+    m_local_cell_bounds.emplace_back(lower, upper);
+  }
 }
 
 void RegularDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
@@ -265,15 +375,73 @@ void RegularDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
       }
 }
 
+namespace {
+/** Smallest domain width along a direction of a non-uniform decomposition. */
+double min_domain_width(std::vector<double> const &bounds) {
+  auto width = bounds.back() - bounds.front();
+  for (std::size_t i = 1u; i < bounds.size(); ++i) {
+    width = std::min(width, bounds[i] - bounds[i - 1u]);
+  }
+  return width;
+}
+} // namespace
+
+int RegularDecomposition::particle_to_rank(Particle const &p) const {
+  auto const node_grid = Utils::Mpi::cart_get<3>(m_comm).dims;
+  Utils::Vector3i node_pos;
+  for (auto i = 0u; i < 3u; i++) {
+    auto const x = p.pos()[i];
+    if (m_local_box.is_uniform()) {
+      auto const domain_length = m_box.length()[i] / node_grid[i];
+      node_pos[i] = static_cast<int>(std::floor(x / domain_length));
+    } else {
+      auto const &bounds = m_local_box.domain_bounds()[i];
+      auto const upper = std::ranges::upper_bound(bounds, x);
+      node_pos[i] = static_cast<int>(std::distance(bounds.begin(), upper)) - 1;
+    }
+    /* positions outside a non-periodic box belong to the outer domains */
+    node_pos[i] = std::clamp(node_pos[i], 0, node_grid[i] - 1);
+  }
+  return Utils::Mpi::cart_rank<3>(m_comm, node_pos);
+}
+
 Utils::Vector3d RegularDecomposition::max_cutoff() const {
   auto dir_max_range = [this](unsigned int i) {
+    if (not m_local_box.is_uniform()) {
+      auto const &bounds = m_local_box.domain_bounds()[i];
+      return std::min(0.5 * m_box.length()[i], min_domain_width(bounds));
+    }
     return std::min(0.5 * m_box.length()[i], m_local_box.length()[i]);
   };
 
   return {dir_max_range(0u), dir_max_range(1u), dir_max_range(2u)};
 }
 
-Utils::Vector3d RegularDecomposition::max_range() const { return cell_size; }
+Utils::Vector3d RegularDecomposition::max_range() const {
+  if (m_local_box.is_uniform()) {
+    return cell_size;
+  }
+  /* the cell size differs between domains, report the smallest one */
+  Utils::Vector3d range;
+  for (auto i = 0u; i < 3u; i++) {
+    auto const &bounds = m_local_box.domain_bounds()[i];
+    range[i] = m_box.length()[i];
+    for (std::size_t k = 1u; k < bounds.size(); ++k) {
+      auto const width = bounds[k] - bounds[k - 1u];
+      range[i] = std::min(range[i], width / cells_per_domain(width));
+    }
+  }
+  return range;
+}
+
+int RegularDecomposition::cells_per_domain(double width) const {
+  if (m_range <= 0.) {
+    return static_cast<int>(
+        std::ceil(std::cbrt(calc_processor_min_num_cells())));
+  }
+  auto const n_cells = static_cast<int>(std::floor(width / m_range));
+  return std::clamp(n_cells, 1, max_cells_per_dir);
+}
 int RegularDecomposition::calc_processor_min_num_cells() const {
   /* the minimal number of cells can be lower if there are at least two nodes
      serving a direction,
@@ -292,8 +460,38 @@ void RegularDecomposition::create_cell_grid(double range) {
   int n_local_cells;
   auto cell_range = Utils::Vector3d::broadcast(range);
   auto const min_num_cells = calc_processor_min_num_cells();
+  auto const node_pos = cart_info.coords;
 
-  if (range <= 0.) {
+  if (not m_local_box.is_uniform()) {
+    /* The domain boundaries are shifted along each direction. The number
+     * of cells along a direction only depends on the domain width, such
+     * that neighboring domains agree on the cell grid of their common
+     * face. */
+    auto const &local_box_l = m_local_box.length();
+    for (auto i = 0u; i < 3u; i++) {
+      auto const &bounds = m_local_box.domain_bounds()[i];
+      cell_offset[i] = 0;
+      global_cell_grid[i] = 0;
+      for (std::size_t k = 1u; k < bounds.size(); ++k) {
+        auto const n_cells = cells_per_domain(bounds[k] - bounds[k - 1u]);
+        if (static_cast<int>(k) <= node_pos[i]) {
+          cell_offset[i] += n_cells;
+        }
+        global_cell_grid[i] += n_cells;
+      }
+      cell_grid[i] = cells_per_domain(local_box_l[i]);
+      if (range > 0. and local_box_l[i] < range) {
+        runtimeErrorMsg() << "interaction range " << range << " in direction "
+                          << i << " is larger than the local box size "
+                          << local_box_l[i];
+      }
+    }
+    n_local_cells = Utils::product(cell_grid);
+    if (n_local_cells < min_num_cells) {
+      runtimeErrorMsg() << "number of cells " << n_local_cells
+                        << " is smaller than minimum " << min_num_cells;
+    }
+  } else if (range <= 0.) {
     /* this is the non-interacting case */
     auto const cells_per_dir =
         static_cast<int>(std::ceil(std::cbrt(min_num_cells)));
@@ -365,8 +563,6 @@ void RegularDecomposition::create_cell_grid(double range) {
     runtimeErrorMsg() << "no suitable cell grid found";
   }
 
-  auto const node_pos = cart_info.coords;
-
   /* now set all dependent variables */
   int new_cells = 1;
   for (auto i = 0u; i < 3u; i++) {
@@ -374,7 +570,15 @@ void RegularDecomposition::create_cell_grid(double range) {
     new_cells *= ghost_cell_grid[i];
     cell_size[i] = m_local_box.length()[i] / static_cast<double>(cell_grid[i]);
     inv_cell_size[i] = 1.0 / cell_size[i];
-    cell_offset[i] = node_pos[i] * cell_grid[i];
+    if (m_local_box.is_uniform()) {
+      cell_offset[i] = node_pos[i] * cell_grid[i];
+      global_cell_grid[i] = cart_info.dims[i] * cell_grid[i];
+      m_lookup_origin[i] = 0.;
+      m_lookup_offset[i] = cell_offset[i];
+    } else {
+      m_lookup_origin[i] = m_local_box.my_left()[i];
+      m_lookup_offset[i] = 0;
+    }
   }
 
   /* allocate cell array and cell pointer arrays */
@@ -384,19 +588,24 @@ void RegularDecomposition::create_cell_grid(double range) {
   m_ghost_cells.resize(new_cells - n_local_cells);
 }
 
-template <class K, class Comparator> auto make_flat_set(Comparator &&comp) {
-  return boost::container::flat_set<K, std::remove_reference_t<Comparator>>(
-      std::forward<Comparator>(comp));
-}
+namespace {
+/** Image of a neighbor cell in the ghost cell grid. */
+struct NeighborImage {
+  /** Global index of the first image in an imported region. */
+  Utils::Vector3i index = {};
+  /** Whether any image is in an imported region. */
+  bool imported = false;
+  /** Whether the node of the neighbor imports the cell. */
+  bool imports_this = false;
+};
+} // namespace
 
 void RegularDecomposition::init_cell_interactions() {
 
   auto const halo = Utils::Vector3i{1, 1, 1};
-  auto const cart_info = Utils::Mpi::cart_get<3>(m_comm);
-  auto const &node_pos = cart_info.coords;
   auto const &node_grid = ::communicator.node_grid;
-  auto const global_halo_offset = hadamard_product(node_pos, cell_grid) - halo;
-  auto const global_size = hadamard_product(node_grid, cell_grid);
+  auto const global_halo_offset = cell_offset - halo;
+  auto const global_size = global_cell_grid;
   auto const at_boundary = [&global_size](int coord, Utils::Vector3i cell_idx) {
     return (cell_idx[coord] == 0 or cell_idx[coord] == global_size[coord]);
   };
@@ -450,6 +659,10 @@ void RegularDecomposition::init_cell_interactions() {
       throw std::runtime_error(
           "The MPI nodegrid must be 1 in the fully connected direction.");
     }
+    if (m_ghost_shell != GhostShell::FULL) {
+      throw std::runtime_error("The half-shell ghost scheme doesn't support "
+                               "a fully connected boundary.");
+    }
   }
 
   /* We only consider local cells (e.g. not halo cells), which
@@ -488,11 +701,9 @@ void RegularDecomposition::init_cell_interactions() {
         }
 
         /* Unique set of neighbors, cells are compared by their linear
-         * index in the global cell grid. */
-        auto neighbors = make_flat_set<Utils::Vector3i>(
-            [&](Utils::Vector3i const &a, Utils::Vector3i const &b) {
-              return folded_linear_index(a) < folded_linear_index(b);
-            });
+         * index in the global cell grid. In small cell grids, the same
+         * neighbor is reached through several images. */
+        boost::container::flat_map<int, NeighborImage> neighbors;
 
         /* Collect neighbors */
         for (int p = lower_index[2]; p <= upper_index[2]; p++)
@@ -504,23 +715,31 @@ void RegularDecomposition::init_cell_interactions() {
                 if (fcb_is_inner_connection({m, n, o}, {r, q, p}))
                   continue;
               }
-              neighbors.insert(Utils::Vector3i{r, q, p});
+              auto const neighbor = Utils::Vector3i{r, q, p};
+              auto const region = cell_region(local_index(neighbor));
+              auto &image = neighbors[folded_linear_index(neighbor)];
+              if (not image.imported and
+                  imports_region(m_ghost_shell, region)) {
+                image.index = neighbor;
+                image.imported = true;
+              }
+              image.imports_this |= imports_region(m_ghost_shell, -region);
             }
 
-        /* Red-black partition by global index. */
+        /* Red-black partition by global index. A pair that only one
+         * of the two cells can see is red for that cell. */
         auto const ind1 = folded_linear_index({m, n, o});
 
         std::vector<Cell *> red_neighbors;
         std::vector<Cell *> black_neighbors;
-        for (auto const &neighbor : neighbors) {
-          auto const ind2 = folded_linear_index(neighbor);
-          /* Exclude cell itself */
-          if (ind1 == ind2)
+        for (auto const &[ind2, image] : neighbors) {
+          /* Exclude cell itself and cells whose ghosts are missing */
+          if (ind1 == ind2 or not image.imported)
             continue;
 
           auto cell = &cells.at(
-              get_linear_index(local_index(neighbor), ghost_cell_grid));
-          if (ind2 > ind1) {
+              get_linear_index(local_index(image.index), ghost_cell_grid));
+          if (ind2 > ind1 or not image.imports_this) {
             red_neighbors.push_back(cell);
           } else {
             black_neighbors.push_back(cell);
@@ -557,8 +776,8 @@ void revert_comm_order(GhostCommunicator &comm) {
  *  poststore
  */
 void assign_prefetches(GhostCommunicator &comm) {
-  for (auto it = comm.communications.begin(); it != comm.communications.end();
-       it += 2) {
+  for (auto it = comm.communications.begin();
+       std::distance(it, comm.communications.end()) >= 2; it += 2) {
     auto next = std::next(it);
     if (it->type == GHOST_RECV && next->type == GHOST_SEND) {
       it->type |= GHOST_PREFETCH | GHOST_PSTSTORE;
@@ -570,6 +789,10 @@ void assign_prefetches(GhostCommunicator &comm) {
 } // namespace
 
 GhostCommunicator RegularDecomposition::prepare_comm() {
+  if (m_ghost_shell == GhostShell::HALF) {
+    return prepare_half_shell_comm();
+  }
+
   int dir, lr, i, cnt, n_comm_cells[3];
   Utils::Vector3i lc{}, hc{}, done{};
 
@@ -667,12 +890,103 @@ GhostCommunicator RegularDecomposition::prepare_comm() {
   return ghost_comm;
 }
 
+GhostCommunicator RegularDecomposition::prepare_half_shell_comm() {
+  auto const comm_info = Utils::Mpi::cart_get<3>(m_comm);
+  auto const &dims = comm_info.dims;
+  auto const &coords = comm_info.coords;
+
+  auto const neighbor_rank = [&](Utils::Vector3i const &offset) {
+    auto pos = coords + offset;
+    for (auto i = 0u; i < 3u; i++) {
+      pos[i] = (pos[i] + dims[i]) % dims[i];
+    }
+    return Utils::Mpi::cart_rank<3>(m_comm, pos);
+  };
+
+  /* Corners of a ghost region (ghost = true), or of the cells sent to
+   * the node that imports them as this region: along a direction of
+   * the offset, a ghost layer is filled with the opposite boundary
+   * layer of the neighbor. */
+  auto const region_corners = [this](Utils::Vector3i const &region,
+                                     bool ghost) {
+    Utils::Vector3i lc, hc;
+    for (auto i = 0u; i < 3u; i++) {
+      if (region[i] == 0) {
+        lc[i] = 1;
+        hc[i] = cell_grid[i];
+      } else if (ghost) {
+        lc[i] = hc[i] = (region[i] < 0) ? 0 : cell_grid[i] + 1;
+      } else {
+        lc[i] = hc[i] = (region[i] < 0) ? cell_grid[i] : 1;
+      }
+    }
+    return std::make_pair(lc, hc);
+  };
+
+  auto ghost_comm = GhostCommunicator{m_comm, 0u};
+  std::vector<GhostCommunication> local_comms;
+  for (int z = -1; z <= 1; z++)
+    for (int y = -1; y <= 1; y++)
+      for (int x = -1; x <= 1; x++) {
+        auto const region = Utils::Vector3i{x, y, z};
+        if (region == Utils::Vector3i{} or
+            not imports_region(m_ghost_shell, region)) {
+          continue;
+        }
+        auto const [send_lc, send_hc] = region_corners(region, false);
+        auto const [recv_lc, recv_hc] = region_corners(region, true);
+        auto const n_cells = static_cast<std::size_t>(
+            Utils::product(send_hc - send_lc + Utils::Vector3i{1, 1, 1}));
+        auto const source = neighbor_rank(region);
+
+        if (source == m_comm.rank()) {
+          /* just copy cells on a single node */
+          auto &local_comm = local_comms.emplace_back();
+          local_comm.type = GHOST_LOCL;
+          local_comm.node = source;
+          local_comm.part_lists.resize(2u * n_cells);
+          fill_comm_cell_lists(local_comm.part_lists.data(), send_lc, send_hc);
+          fill_comm_cell_lists(&local_comm.part_lists[n_cells], recv_lc,
+                               recv_hc);
+          continue;
+        }
+
+        /* Nodes with an even position along the first direction in which
+         * the neighbor is another node send first. */
+        auto dir = 0u;
+        while (region[dir] == 0 or dims[dir] == 1) {
+          dir++;
+        }
+        auto const send_first = coords[dir] % 2 == 0;
+        for (auto const is_send : {send_first, not send_first}) {
+          auto &c = ghost_comm.communications.emplace_back();
+          c.type = is_send ? GHOST_SEND : GHOST_RECV;
+          c.node = is_send ? neighbor_rank(-region) : source;
+          c.part_lists.resize(n_cells);
+          if (is_send) {
+            fill_comm_cell_lists(c.part_lists.data(), send_lc, send_hc);
+          } else {
+            fill_comm_cell_lists(c.part_lists.data(), recv_lc, recv_hc);
+          }
+        }
+      }
+
+  /* The ghost layers are not forwarded, hence the local copies can
+   * come last. */
+  std::ranges::move(local_comms,
+                    std::back_inserter(ghost_comm.communications));
+
+  return ghost_comm;
+}
+
 RegularDecomposition::RegularDecomposition(
     boost::mpi::communicator comm, double range, BoxGeometry const &box_geo,
     LocalBox const &local_geo,
-    std::optional<std::pair<int, int>> fully_connected)
+    std::optional<std::pair<int, int>> fully_connected,
+    SpaceFillingCurve curve, GhostShell ghost_shell)
     : m_comm(std::move(comm)), m_box(box_geo), m_local_box(local_geo),
-      m_fully_connected_boundary(std::move(fully_connected)) {
+      m_range(range), m_fully_connected_boundary(std::move(fully_connected)),
+      m_curve(curve), m_ghost_shell(ghost_shell) {
 
   /* set up new regular decomposition cell structure */
   create_cell_grid(range);
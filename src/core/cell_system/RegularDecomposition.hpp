@@ -24,6 +24,8 @@
 #include "cell_system/ParticleDecomposition.hpp"
 
 #include "cell_system/Cell.hpp"
+#include "cell_system/GhostShell.hpp"
+#include "cell_system/SpaceFillingCurve.hpp"
 
 #include "BoxGeometry.hpp"
 #include "LocalBox.hpp"
@@ -37,6 +39,7 @@
 
 #include <optional>
 #include <span>
+#include <utility>
 #include <vector>
 
 /**
@@ -63,6 +66,12 @@
  * blue). Caution: This implementation needs double sided ghost
  * communication! For single sided ghost communication one would need
  * some ghost-ghost cell interaction as well, which we do not need!
+ *
+ * With the half-shell scheme (@ref GhostShell::HALF), ghost cells are
+ * only filled from the neighbor domains of the upper half shell, and a
+ * pair of cells on different nodes is only visited by the node that
+ * imports the other cell. Pairs of local cells keep the red-black
+ * partition by linear index.
  */
 struct RegularDecomposition : public ParticleDecomposition {
   /** Grid dimensions per node. */
@@ -75,21 +84,41 @@ struct RegularDecomposition : public ParticleDecomposition {
   Utils::Vector3i ghost_cell_grid = {};
   /** inverse @ref RegularDecomposition::cell_size "cell_size". */
   Utils::Vector3d inv_cell_size = {};
+  /** Global grid dimensions. */
+  Utils::Vector3i global_cell_grid = {};
 
   boost::mpi::communicator m_comm;
   BoxGeometry const &m_box;
   LocalBox m_local_box;
+  double m_range;
   std::optional<std::pair<int, int>> m_fully_connected_boundary = {};
+  /** Order of the local cells. */
+  SpaceFillingCurve m_curve;
+  /** Neighbor domains that ghosts are imported from. */
+  GhostShell m_ghost_shell;
+  /** Origin and index shift of the local cells in the position lookup. */
+  Utils::Vector3d m_lookup_origin = {};
+  Utils::Vector3i m_lookup_offset = {};
   std::vector<Cell> cells;
   std::vector<Cell *> m_local_cells;
   std::vector<Cell *> m_ghost_cells;
+  /** Lower and upper corner of each local cell, in the order of
+   *  @c m_local_cells, shrunk by a small margin.
+   */
+  std::vector<std::pair<Utils::Vector3d, Utils::Vector3d>> m_local_cell_bounds;
+  /** Whether a particle left each local cell at the last call to
+   *  @ref record_displacements, in the order of @c m_local_cells.
+   *  Empty if there is no valid record.
+   */
+  std::vector<bool> m_local_cells_left;
   GhostCommunicator m_exchange_ghosts_comm;
   GhostCommunicator m_collect_ghost_force_comm;
 
 public:
   RegularDecomposition(boost::mpi::communicator comm, double range,
                        BoxGeometry const &box_geo, LocalBox const &local_geo,
-                       std::optional<std::pair<int, int>> fully_connected);
+                       std::optional<std::pair<int, int>> fully_connected,
+                       SpaceFillingCurve curve, GhostShell ghost_shell);
 
   GhostCommunicator const &exchange_ghosts_comm() const override {
     return m_exchange_ghosts_comm;
@@ -113,11 +142,17 @@ public:
     return position_to_cell(p.pos());
   }
 
+  int particle_to_rank(Particle const &p) const override;
+
   void resort(bool global, std::vector<ParticleChange> &diff) override;
+  bool record_displacements(double max_displacement2) override;
+  void clear_displacements() override { m_local_cells_left.clear(); }
   Utils::Vector3d max_cutoff() const override;
   Utils::Vector3d max_range() const override;
 
   auto fully_connected_boundary() const { return m_fully_connected_boundary; }
+  auto space_filling_curve() const { return m_curve; }
+  auto ghost_shell() const { return m_ghost_shell; }
 
   std::optional<BoxGeometry> minimum_image_distance() const override {
     return {m_box};
@@ -127,7 +162,7 @@ public:
 
 private:
   /** Fill @c m_local_cells list and @c m_ghost_cells list for use with regular
-   *  decomposition.
+   *  decomposition. The local cells are sorted along @c m_curve.
    */
   void mark_cells();
 
@@ -146,8 +181,18 @@ private:
 
   int calc_processor_min_num_cells() const;
 
+  /** Number of cells along a direction of a domain with shifted
+   *  boundaries, only depends on the domain width.
+   */
+  int cells_per_domain(double width) const;
+
   int position_to_cell_index(Utils::Vector3d const &pos) const;
 
+  /** Neighbor domain a cell of the ghost cell grid belongs to, each
+   *  component is -1, 0 or +1. Local cells have the null offset.
+   */
+  Utils::Vector3i cell_region(Utils::Vector3i const &cell_index) const;
+
   /**
    * @brief Get pointer to the cell which corresponds to the position if the
    * position is in the node's spatial domain, otherwise a nullptr.
@@ -229,6 +274,11 @@ private:
    */
   GhostCommunicator prepare_comm();
 
+  /** Create the communicator for the half-shell scheme. Each ghost
+   *  region is received directly from the node it belongs to.
+   */
+  GhostCommunicator prepare_half_shell_comm();
+
   /** Maximal number of cells per node. In order to avoid memory
    *  problems due to the cell grid, one has to specify the maximal
    *  number of cells. If the number of cells is larger
@@ -236,4 +286,5 @@ private:
    *  @c max_num_cells has to be larger than 27, e.g. one inner cell.
    */
   static constexpr int max_num_cells = 32768;
+  static constexpr int max_cells_per_dir = 32;
 };
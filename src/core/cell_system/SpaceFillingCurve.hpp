@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <utils/Vector.hpp>
+#include <utils/space_filling_curve.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+/** @brief Order of the local cells and of the particles in each cell. */
+enum class SpaceFillingCurve : int {
+  /** @brief Cells in lexicographic order, particles in arrival order. */
+  NONE = 0,
+  /** @brief Morton (Z-order) curve. */
+  MORTON = 1,
+  /** @brief Hilbert curve. */
+  HILBERT = 2
+};
+
+/**
+ * @brief Index of a grid point along a space-filling curve.
+ * @param curve  Space-filling curve, must not be @c NONE.
+ * @param x      Grid point.
+ * @param bits   Number of bits per coordinate.
+ */
+inline std::uint64_t curve_index(SpaceFillingCurve curve,
+                                 std::array<std::uint32_t, 3> const &x,
+                                 unsigned bits) {
+  if (curve == SpaceFillingCurve::HILBERT) {
+    return Utils::hilbert_index(x, bits);
+  }
+  return Utils::morton_index(x, bits);
+}
+
+/**
+ * @brief Index of a position along a space-filling curve.
+ *
+ * The box is split into a grid of @f$ 2^{10} @f$ points per direction,
+ * positions outside the box are attributed to the closest grid point.
+ *
+ * @param curve   Space-filling curve, must not be @c NONE.
+ * @param pos     Position.
+ * @param origin  Lower corner of the box.
+ * @param length  Box length.
+ */
+inline std::uint64_t curve_index(SpaceFillingCurve curve,
+                                 Utils::Vector3d const &pos,
+                                 Utils::Vector3d const &origin,
+                                 Utils::Vector3d const &length) {
+  auto constexpr bits = 10u;
+  auto constexpr n_points = static_cast<double>(1u << bits);
+  std::array<std::uint32_t, 3> x;
+  for (auto i = 0u; i < 3u; ++i) {
+    auto const point = (pos[i] - origin[i]) / length[i] * n_points;
+    x[i] = static_cast<std::uint32_t>(std::clamp(point, 0., n_points - 1.));
+  }
+  return curve_index(curve, x, bits);
+}
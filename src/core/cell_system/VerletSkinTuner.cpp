@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cell_system/VerletSkinTuner.hpp"
+
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/operations.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <optional>
+
+void VerletSkinTuner::reset() {
+  m_steps = 0;
+  m_time = 0.;
+  m_best = std::nullopt;
+  restart_search();
+  m_trace.clear();
+}
+
+void VerletSkinTuner::restart_search() {
+  m_settled = false;
+  m_factor = initial_factor;
+  m_direction = 1;
+  m_moved = false;
+  m_reference_time = std::nullopt;
+  m_drift_windows = 0;
+}
+
+void VerletSkinTuner::refine() {
+  m_factor = std::sqrt(m_factor);
+  m_direction = 1;
+  m_moved = false;
+  if (m_factor < min_factor) {
+    m_settled = true;
+  }
+}
+
+double VerletSkinTuner::probe(double min_skin, double max_skin) {
+  assert(m_best);
+  while (not m_settled) {
+    auto const candidate = std::clamp(
+        m_best->skin * std::pow(m_factor, m_direction), min_skin, max_skin);
+    if (candidate != m_best->skin) {
+      return candidate;
+    }
+    // the probe is blocked by the bounds
+    if (not m_moved and m_direction == 1) {
+      m_direction = -1;
+    } else {
+      refine();
+    }
+  }
+  return std::clamp(m_best->skin, min_skin, max_skin);
+}
+
+std::optional<double>
+VerletSkinTuner::update(boost::mpi::communicator const &comm, double skin,
+                        double min_skin, double max_skin) {
+  assert(m_steps > 0);
+  auto const max_time =
+      boost::mpi::all_reduce(comm, m_time, boost::mpi::maximum<double>());
+  auto const time = 1000. * max_time / static_cast<double>(m_steps);
+  m_steps = 0;
+  m_time = 0.;
+  if (max_skin <= min_skin) {
+    return std::nullopt;
+  }
+  return next_skin(skin, time, min_skin, max_skin);
+}
+
+std::optional<double> VerletSkinTuner::next_skin(double skin, double time,
+                                                 double min_skin,
+                                                 double max_skin) {
+  auto const sample = SkinTuningSample{skin, time};
+  if (m_settled) {
+    if (not m_reference_time) {
+      m_reference_time = time;
+      return std::nullopt;
+    }
+    auto const drift = std::abs(time - *m_reference_time);
+    if (drift <= drift_tolerance * *m_reference_time) {
+      m_drift_windows = 0;
+      return std::nullopt;
+    }
+    if (++m_drift_windows < drift_windows) {
+      return std::nullopt;
+    }
+    // the system changed: search again, starting from the current skin
+    restart_search();
+    m_best = sample;
+  } else if (not m_best) {
+    m_best = sample;
+  } else if (time < m_best->time) {
+    // keep going in the same direction
+    m_best = sample;
+    m_moved = true;
+  } else if (not m_moved and m_direction == 1) {
+    m_direction = -1;
+  } else {
+    refine();
+  }
+  m_trace.emplace_back(sample);
+
+  auto const new_skin = probe(min_skin, max_skin);
+  if (new_skin == skin) {
+    return std::nullopt;
+  }
+  return new_skin;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/** \file
+ *
+ *  Online tuning of the Verlet list skin.
+ *
+ *  The wall time per integration step is measured over windows of a
+ *  fixed number of steps, and a 1D pattern search in the logarithm of
+ *  the skin looks for the skin with the lowest step time: the skin is
+ *  scaled up or down by a factor as long as the step time decreases,
+ *  and the factor is reduced when neither direction improves. Once the
+ *  factor is small enough, the best skin is kept, and the step time is
+ *  monitored to restart the search when it drifts, e.g. because the
+ *  density or the temperature of the system changed.
+ */
+
+#include <boost/mpi/communicator.hpp>
+
+#include <optional>
+#include <vector>
+
+/** @brief Step time measured with a given skin. */
+struct SkinTuningSample {
+  double skin;
+  /** Wall time per integration step in ms. */
+  double time;
+};
+
+class VerletSkinTuner {
+  /** Measure the step time over @c m_interval steps, 0 disables tuning. */
+  int m_interval = 0;
+  /** Steps in the current measurement window. */
+  int m_steps = 0;
+  /** Wall time of the current measurement window, in seconds. */
+  double m_time = 0.;
+
+  bool m_settled = false;
+  std::optional<SkinTuningSample> m_best = std::nullopt;
+  /** Scaling factor of the skin between two probes. */
+  double m_factor = initial_factor;
+  /** Probe larger (+1) or smaller (-1) skins. */
+  int m_direction = 1;
+  /** Whether the best skin changed at the current scaling factor. */
+  bool m_moved = false;
+  /** Step time of the best skin measured after the search converged. */
+  std::optional<double> m_reference_time = std::nullopt;
+  /** Consecutive windows whose step time deviates from the reference. */
+  int m_drift_windows = 0;
+  std::vector<SkinTuningSample> m_trace;
+
+public:
+  static constexpr double initial_factor = 1.5;
+  /** The search converged when the scaling factor drops below this value. */
+  static constexpr double min_factor = 1.05;
+  /** Relative deviation of the step time that restarts the search. */
+  static constexpr double drift_tolerance = 0.2;
+  /** Number of deviating windows that restarts the search. */
+  static constexpr int drift_windows = 2;
+
+  auto get_interval() const { return m_interval; }
+  void set_interval(int interval) {
+    m_interval = interval;
+    reset();
+  }
+
+  bool is_active() const { return m_interval > 0; }
+  bool is_settled() const { return m_settled; }
+
+  /** @brief Skin chosen by the last converged search. */
+  std::optional<double> get_tuned_skin() const {
+    if (not m_settled) {
+      return std::nullopt;
+    }
+    return m_best->skin;
+  }
+
+  /** @brief Skins and step times measured by the search. */
+  auto const &get_trace() const { return m_trace; }
+
+  /** @brief Restart the search and clear the trace. */
+  void reset();
+
+  /** @brief Count an integration step.
+   *  @param time  Wall time of the step in seconds.
+   *  @return Whether the measurement window is complete.
+   */
+  bool step(double time) {
+    if (not is_active()) {
+      return false;
+    }
+    m_time += time;
+    return ++m_steps >= m_interval;
+  }
+
+  /**
+   * @brief Complete a measurement window.
+   *
+   * The step time is the one of the slowest rank. This is a collective
+   * call, all ranks get the same result.
+   *
+   * @param comm      Communicator.
+   * @param skin      Skin used during the measurement.
+   * @param min_skin  Smallest skin to probe.
+   * @param max_skin  Largest skin to probe.
+   * @return The skin to use for the next window, if it has to change.
+   */
+  std::optional<double> update(boost::mpi::communicator const &comm,
+                               double skin, double min_skin, double max_skin);
+
+  /**
+   * @brief Advance the search with a new measurement.
+   *
+   * @param skin      Skin used during the measurement.
+   * @param time      Step time measured with @p skin.
+   * @param min_skin  Smallest skin to probe.
+   * @param max_skin  Largest skin to probe.
+   * @return The skin to use for the next window, if it has to change.
+   */
+  std::optional<double> next_skin(double skin, double time, double min_skin,
+                                  double max_skin);
+
+private:
+  /** @brief Restart the search from the best skin. */
+  void restart_search();
+  /** @brief Reduce the scaling factor, until the search converges. */
+  void refine();
+  /** @brief Next skin to probe, or the best skin if the search converged. */
+  double probe(double min_skin, double max_skin);
+};
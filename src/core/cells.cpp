@@ -107,6 +107,10 @@ search_distance_sanity_check_cell_structure(System::System const &system,
     throw std::runtime_error("Cannot search for neighbors in the hybrid "
                              "decomposition cell system");
   }
+  if (cell_structure.has_half_ghost_shell()) {
+    throw std::runtime_error("Cannot search for neighbors with the "
+                             "half-shell ghost scheme");
+  }
 }
 static void search_neighbors_sanity_checks(System::System const &system,
                                            double const distance) {
@@ -41,6 +41,8 @@
 
 #include <cassert>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 #include <utility>
 
@@ -87,6 +89,28 @@ void init(std::shared_ptr<boost::mpi::environment> mpi_env) {
 }
 
 void deinit() { Communication::m_callbacks.reset(); }
+
+int split(int n_groups) {
+  auto const world = boost::mpi::communicator();
+  if (n_groups <= 0 or world.size() % n_groups != 0) {
+    throw std::invalid_argument("Cannot split " +
+                                std::to_string(world.size()) +
+                                " MPI ranks into " + std::to_string(n_groups) +
+                                " groups of equal size");
+  }
+  auto const group = world.rank() / (world.size() / n_groups);
+  communicator.comm = world.split(group);
+  communicator.size = communicator.comm.size();
+  communicator.node_grid = Utils::Mpi::dims_create<3>(communicator.size);
+  communicator.init_comm_cart();
+
+  auto mpi_env = Communication::m_callbacks->share_mpi_env();
+  Communication::m_callbacks =
+      std::make_shared<Communication::MpiCallbacks>(comm_cart, mpi_env);
+  ErrorHandling::init_error_handling(Communication::m_callbacks);
+
+  return group;
+}
 } // namespace Communication
 
 Communicator::Communicator()
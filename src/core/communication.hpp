@@ -64,7 +64,7 @@ struct Communicator {
   Utils::Vector3i node_grid;
   /** @brief The MPI rank. */
   int &this_node;
-  /** @brief The MPI world size. */
+  /** @brief The number of MPI ranks in @ref comm. */
   int size;
 
   Communicator();
@@ -129,6 +129,20 @@ namespace Communication {
  */
 void init(std::shared_ptr<boost::mpi::environment> mpi_env);
 void deinit();
+
+/**
+ * @brief Split the MPI ranks into groups of equal size.
+ *
+ * Each group gets its own Cartesian communicator, which replaces
+ * @ref comm_cart, and its own callback instance. Groups can then run
+ * independent simulations concurrently. This has to be called on all
+ * ranks before any system is created and before the script interface
+ * is initialized.
+ *
+ * @param n_groups Number of groups, must divide the number of ranks
+ * @return Index of the group of this rank
+ */
+int split(int n_groups);
 } // namespace Communication
 
 struct MpiContainerUnitTest {
@@ -40,6 +40,15 @@
 
 namespace Coulomb {
 
+/** @brief Real-space force kernel of a specific solver. */
+template <typename T> struct PairForceKernel {
+  T const &actor;
+  Utils::Vector3d operator()(double q1q2, Utils::Vector3d const &d,
+                             double dist) const {
+    return actor.pair_force(q1q2, d, dist);
+  }
+};
+
 struct ShortRangeForceKernel {
 
   using kernel_type = Solver::ShortRangeForceKernel;
@@ -48,11 +57,7 @@ struct ShortRangeForceKernel {
 #ifdef ELECTROSTATICS
   template <typename T>
   result_type operator()(std::shared_ptr<T> const &ptr) const {
-    auto const &actor = *ptr;
-    return kernel_type{
-        [&actor](double q1q2, Utils::Vector3d const &d, double dist) {
-          return actor.pair_force(q1q2, d, dist);
-        }};
+    return kernel_type{PairForceKernel<T>{*ptr}};
   }
 
 #ifdef P3M
@@ -64,6 +69,31 @@ struct ShortRangeForceKernel {
 #endif // ELECTROSTATICS
 };
 
+/**
+ * @brief Pass the real-space force kernel of the active solver to a
+ * callback without type erasure.
+ * The callback is instantiated once per solver type, such that the
+ * kernel can be inlined in the pair loop. Solvers wrapping another
+ * solver forward the kernel of the wrapped solver.
+ */
+template <class Callback> struct ShortRangeForceKernelDispatch {
+  Callback &callback;
+
+#ifdef ELECTROSTATICS
+  template <typename T> void operator()(std::shared_ptr<T> const &ptr) const {
+    auto const kernel = PairForceKernel<T>{*ptr};
+    callback(&kernel);
+  }
+
+#ifdef P3M
+  void
+  operator()(std::shared_ptr<ElectrostaticLayerCorrection> const &ptr) const {
+    std::visit(*this, ptr->base_solver);
+  }
+#endif // P3M
+#endif // ELECTROSTATICS
+};
+
 struct ShortRangeForceCorrectionsKernel {
 
   using kernel_type = Solver::ShortRangeForceCorrectionsKernel;
@@ -159,6 +189,18 @@ Solver::pair_force_kernel() const {
   return std::nullopt;
 }
 
+template <class Callback>
+void Solver::visit_pair_force_kernel(Callback &&callback) const {
+#ifdef ELECTROSTATICS
+  if (auto &solver = impl->solver; solver.has_value()) {
+    auto const visitor = ShortRangeForceKernelDispatch<Callback>{callback};
+    std::visit(visitor, *solver);
+    return;
+  }
+#endif // ELECTROSTATICS
+  callback(static_cast<ShortRangeForceKernel const *>(nullptr));
+}
+
 inline std::optional<Solver::ShortRangeForceCorrectionsKernel>
 Solver::pair_force_elc_kernel() const {
 #ifdef ELECTROSTATICS
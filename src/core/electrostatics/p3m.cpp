@@ -88,7 +88,9 @@
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #ifdef FFTW3_H
 #error "The FFTW3 library shouldn't be visible in this translation unit"
@@ -267,8 +269,10 @@ void CoulombP3MImpl<FloatType, Architecture>::init_cpu_kernels() {
   assert(p3m.fft);
   p3m.local_mesh.calc_local_ca_mesh(p3m.params, local_geo, skin, elc_layer);
   p3m.fft_buffers->init_halo();
+  p3m.fft->overlap_communication = overlap_fft_communication;
   p3m.fft->init(p3m.params);
   p3m.mesh.ks_pnum = p3m.fft->get_ks_pnum();
+  p3m.mesh.real_to_complex = p3m.fft->is_real_to_complex();
   p3m.fft_buffers->init_meshes(p3m.fft->get_ca_mesh_size());
   p3m.update_mesh_views();
   p3m.calc_differential_operator();
@@ -290,8 +294,9 @@ template <int cao> struct AssignCharge {
     });
   }
 
+  template <typename T>
   void operator()(auto &p3m, double q, Utils::Vector3d const &real_pos,
-                  p3m_interpolation_cache &inter_weights) {
+                  p3m_interpolation_cache<T> &inter_weights) {
     auto const w = p3m_calculate_interpolation_weights<cao>(
         real_pos, p3m.params.ai, p3m.local_mesh);
     inter_weights.store(w);
@@ -305,7 +310,14 @@ template <int cao> struct AssignCharge {
   }
 
   template <typename combined_ranges>
-  void operator()(auto &p3m, combined_ranges const &p_q_pos_range) {
+  void operator()(auto &p3m, combined_ranges const &p_q_pos_range,
+                  [[maybe_unused]] int n_threads) {
+#ifdef OPENMP
+    if (n_threads > 1) {
+      assign_parallel(p3m, p_q_pos_range, n_threads);
+      return;
+    }
+#endif
     for (auto zipped : p_q_pos_range) {
       auto const p_q = boost::get<0>(zipped);
       auto const &p_pos = boost::get<1>(zipped);
@@ -314,6 +326,68 @@ template <int cao> struct AssignCharge {
       }
     }
   }
+
+#ifdef OPENMP
+  /**
+   * @brief Assign the charges with several threads.
+   *
+   * The weights are calculated concurrently. To spread the charges
+   * without write conflicts, the x-slabs of the local mesh are grouped
+   * in chunks at least @c cao slabs thick, such that the charges whose
+   * interpolation cube starts in a chunk only reach the next chunk.
+   * Even and odd chunks are then processed in two sweeps.
+   */
+  template <typename combined_ranges>
+  void assign_parallel(auto &p3m, combined_ranges const &p_q_pos_range,
+                       int n_threads) {
+    using value_type =
+        typename std::remove_reference_t<decltype(p3m)>::value_type;
+    std::vector<double> charges;
+    std::vector<Utils::Vector3d> positions;
+    for (auto zipped : p_q_pos_range) {
+      auto const p_q = boost::get<0>(zipped);
+      if (p_q != 0.0) {
+        charges.emplace_back(p_q);
+        positions.emplace_back(boost::get<1>(zipped));
+      }
+    }
+    auto const n_charges = static_cast<int>(charges.size());
+    auto &inter_weights = p3m.inter_weights;
+    auto const offset = inter_weights.size();
+    inter_weights.resize(offset + charges.size());
+#pragma omp parallel for schedule(static) num_threads(n_threads)
+    for (int i = 0; i < n_charges; ++i) {
+      auto const w = p3m_calculate_interpolation_weights<cao>(
+          positions[static_cast<std::size_t>(i)], p3m.params.ai,
+          p3m.local_mesh);
+      inter_weights.store_at(offset + static_cast<std::size_t>(i), w);
+    }
+
+    auto const &dim = p3m.local_mesh.dim;
+    auto const slab_size = dim[1] * dim[2];
+    auto const chunk_size = std::max(cao, dim[0] / (2 * n_threads));
+    auto const n_chunks = (dim[0] + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<std::size_t>> chunks(
+        static_cast<std::size_t>(n_chunks));
+    for (std::size_t i = 0u; i < charges.size(); ++i) {
+      auto const w = inter_weights.template load<cao>(offset + i);
+      auto const chunk = (w.ind / slab_size) / chunk_size;
+      chunks[static_cast<std::size_t>(chunk)].emplace_back(i);
+    }
+    for (int parity = 0; parity < 2; ++parity) {
+#pragma omp parallel for schedule(dynamic) num_threads(n_threads)
+      for (int chunk = parity; chunk < n_chunks; chunk += 2) {
+        for (auto const i : chunks[static_cast<std::size_t>(chunk)]) {
+          auto const q = charges[i];
+          auto const w = inter_weights.template load<cao>(offset + i);
+          p3m_interpolate(p3m.local_mesh, w, [q, &p3m](int ind, double w) {
+            p3m.mesh.rs_scalar[ind] += value_type(w * q);
+          });
+        }
+      }
+    }
+  }
+#endif // OPENMP
 };
 } // namespace
 
@@ -326,7 +400,8 @@ void CoulombP3MImpl<FloatType, Architecture>::charge_assign(
   auto p_pos_range = ParticlePropertyRange::pos_range(particles);
 
   Utils::integral_parameter<int, AssignCharge, 1, 7>(
-      p3m.params.cao, p3m, boost::combine(p_q_range, p_pos_range));
+      p3m.params.cao, p3m, boost::combine(p_q_range, p_pos_range),
+      get_system().cell_structure->get_n_threads());
 }
 
 template <typename FloatType, Arch Architecture>
@@ -344,10 +419,46 @@ void CoulombP3MImpl<FloatType, Architecture>::assign_charge(
 template <int cao> struct AssignForces {
   template <typename combined_ranges>
   void operator()(auto &p3m, double force_prefac,
-                  combined_ranges const &p_q_force_range) const {
+                  combined_ranges const &p_q_force_range,
+                  [[maybe_unused]] int n_threads) const {
 
     assert(cao == p3m.inter_weights.cao());
 
+    auto const kernel = [&p3m, force_prefac](std::size_t p_index, double p_q,
+                                             Utils::Vector3d &p_force) {
+      auto const pref = p_q * force_prefac;
+      auto const w = p3m.inter_weights.template load<cao>(p_index);
+
+      Utils::Vector3d force{};
+      p3m_interpolate(p3m.local_mesh, w, [&force, &p3m](int ind, double w) {
+        force[0u] += w * double(p3m.mesh.rs_fields[0u][ind]);
+        force[1u] += w * double(p3m.mesh.rs_fields[1u][ind]);
+        force[2u] += w * double(p3m.mesh.rs_fields[2u][ind]);
+      });
+
+      p_force -= pref * force;
+    };
+
+#ifdef OPENMP
+    /* each charged particle only reads from the mesh */
+    if (n_threads > 1) {
+      std::vector<std::pair<double, Utils::Vector3d *>> charges;
+      for (auto zipped : p_q_force_range) {
+        auto const p_q = boost::get<0>(zipped);
+        if (p_q != 0.0) {
+          charges.emplace_back(p_q, &boost::get<1>(zipped));
+        }
+      }
+      auto const n_charges = static_cast<int>(charges.size());
+#pragma omp parallel for schedule(static) num_threads(n_threads)
+      for (int i = 0; i < n_charges; ++i) {
+        auto const p_index = static_cast<std::size_t>(i);
+        kernel(p_index, charges[p_index].first, *charges[p_index].second);
+      }
+      return;
+    }
+#endif
+
     /* charged particle counter */
     auto p_index = std::size_t{0ul};
 
@@ -355,17 +466,7 @@ template <int cao> struct AssignForces {
       auto p_q = boost::get<0>(zipped);
       auto &p_force = boost::get<1>(zipped);
       if (p_q != 0.0) {
-        auto const pref = p_q * force_prefac;
-        auto const w = p3m.inter_weights.template load<cao>(p_index);
-
-        Utils::Vector3d force{};
-        p3m_interpolate(p3m.local_mesh, w, [&force, &p3m](int ind, double w) {
-          force[0u] += w * double(p3m.mesh.rs_fields[0u][ind]);
-          force[1u] += w * double(p3m.mesh.rs_fields[1u][ind]);
-          force[2u] += w * double(p3m.mesh.rs_fields[2u][ind]);
-        });
-
-        p_force -= pref * force;
+        kernel(p_index, p_q, p_force);
         ++p_index;
       }
     }
@@ -421,6 +522,7 @@ Utils::Vector9d CoulombP3MImpl<FloatType, Architecture>::long_range_pressure(
 
       if (norm_sq != 0.) {
         auto const node_k_space_energy =
+            p3m.hermitian_weight(shift[KZ]) *
             double(p3m.g_energy[index] *
                    (Utils::sqr(p3m.mesh.rs_scalar[2u * index + 0u]) +
                     Utils::sqr(p3m.mesh.rs_scalar[2u * index + 1u])));
@@ -533,7 +635,8 @@ double CoulombP3MImpl<FloatType, Architecture>::long_range_kernel(
     auto const force_prefac = prefactor / volume;
     Utils::integral_parameter<int, AssignForces, 1, 7>(
         p3m.params.cao, p3m, force_prefac,
-        boost::combine(p_q_range, p_force_range));
+        boost::combine(p_q_range, p_force_range),
+        get_system().cell_structure->get_n_threads());
 
     // add dipole forces
     // Eq. (3.19) @cite deserno00b
@@ -549,15 +652,22 @@ double CoulombP3MImpl<FloatType, Architecture>::long_range_kernel(
 
   /* === k-space energy calculation  === */
   if (energy_flag or npt_flag) {
+    auto constexpr mesh_start = Utils::Vector3i::broadcast(0);
+    auto const &offset = p3m.mesh.start;
+    auto const KZ = std::get<2>(p3m.fft->get_permutations());
+    auto indices = Utils::Vector3i{};
+    auto index = std::size_t(0u);
     auto node_energy = 0.;
-    auto const mesh_length = Utils::product(p3m.mesh.size);
-    for (int i = 0; i < mesh_length; i++) {
+    for_each_3d(mesh_start, p3m.mesh.size, indices, [&]() {
       // Use the energy optimized influence function for energy!
       // Eq. (3.40) @cite deserno00b
       node_energy +=
-          double(p3m.g_energy[i] * (Utils::sqr(p3m.mesh.rs_scalar[2 * i + 0]) +
-                                    Utils::sqr(p3m.mesh.rs_scalar[2 * i + 1])));
-    }
+          p3m.hermitian_weight(indices[KZ] + offset[KZ]) *
+          double(p3m.g_energy[index] *
+                 (Utils::sqr(p3m.mesh.rs_scalar[2u * index + 0u]) +
+                  Utils::sqr(p3m.mesh.rs_scalar[2u * index + 1u])));
+      ++index;
+    });
     node_energy /= 2. * volume;
 
     auto energy = 0.;
@@ -623,6 +733,13 @@ public:
     m_logger->log_tuning_start();
   }
 
+  TuningDatabase::Key get_database_key() override {
+    auto const precision =
+        std::is_same_v<FloatType, float> ? "float" : "double";
+    return make_database_key(precision, p3m.fft->name(), p3m.sum_qpart,
+                             p3m.sum_q2);
+  }
+
   std::optional<std::string>
   layer_correction_veto_r_cut(double r_cut) const override {
     auto const &solver = m_system.coulomb.impl->solver;
@@ -779,7 +896,7 @@ void CoulombP3MImpl<FloatType, Architecture>::tune() {
       parameters.determine_r_cut_limits();
       parameters.determine_cao_limits(7);
       // run tuning algorithm
-      parameters.tune();
+      parameters.tune(tuning_database, tuning_verify);
       m_is_tuned = true;
       system.on_coulomb_change();
     } catch (...) {
@@ -846,10 +963,16 @@ void CoulombP3M::sanity_checks_cell_structure() const {
 
 void CoulombP3M::sanity_checks_node_grid() const {
   auto const &node_grid = ::communicator.node_grid;
-  if (node_grid[0] < node_grid[1] || node_grid[1] < node_grid[2]) {
+  if (requires_sorted_node_grid() and
+      (node_grid[0] < node_grid[1] or node_grid[1] < node_grid[2])) {
     throw std::runtime_error(
         "CoulombP3M: node grid must be sorted, largest first");
   }
+  auto const &local_geo = *get_system().local_geo;
+  if (requires_sorted_node_grid() and not local_geo.is_uniform()) {
+    throw std::runtime_error(
+        "CoulombP3M: the FFT backend requires domains of equal size");
+  }
 }
 
 template <typename FloatType, Arch Architecture>
@@ -50,10 +50,15 @@
 
 #include <cmath>
 #include <numbers>
+#include <string>
 
 /** @brief P3M solver. */
 struct CoulombP3M : public Coulomb::Actor<CoulombP3M> {
   P3MParameters const &p3m_params;
+  /** @brief Tuning database file, empty to always run the tuning. */
+  std::string tuning_database;
+  /** @brief Time the parameters found in the tuning database. */
+  bool tuning_verify = false;
 
 public:
   CoulombP3M(P3MParameters const &p3m_params) : p3m_params{p3m_params} {}
@@ -63,6 +68,8 @@ public:
   [[nodiscard]] virtual bool is_tuned() const noexcept = 0;
   [[nodiscard]] virtual bool is_gpu() const noexcept = 0;
   [[nodiscard]] virtual bool is_double_precision() const noexcept = 0;
+  /** @brief Whether the FFT backend requires a sorted node grid. */
+  [[nodiscard]] virtual bool requires_sorted_node_grid() const noexcept = 0;
 
   /** @brief Recalculate all derived parameters. */
   virtual void init() = 0;
@@ -51,7 +51,7 @@ struct p3m_data_struct_coulomb : public p3m_data_struct<FloatType> {
   /** square of sum of charges (only on head node). */
   double square_sum_q = 0.;
 
-  p3m_interpolation_cache inter_weights;
+  p3m_interpolation_cache<FloatType> inter_weights;
 };
 
 #ifdef CUDA
@@ -71,17 +71,19 @@ private:
   int tune_timings;
   bool tune_verbose;
   bool check_complex_residuals;
+  bool overlap_fft_communication;
   bool m_is_tuned;
 
 public:
   CoulombP3MImpl(
       std::unique_ptr<p3m_data_struct_coulomb<FloatType>> &&p3m_handle,
       double prefactor, int tune_timings, bool tune_verbose,
-      bool check_complex_residuals)
+      bool check_complex_residuals, bool overlap_fft_communication)
       : CoulombP3M(p3m_handle->params), p3m{*p3m_handle},
         p3m_impl{std::move(p3m_handle)}, tune_timings{tune_timings},
         tune_verbose{tune_verbose},
-        check_complex_residuals{check_complex_residuals} {
+        check_complex_residuals{check_complex_residuals},
+        overlap_fft_communication{overlap_fft_communication} {
 
     if (tune_timings <= 0) {
       throw std::domain_error("Parameter 'timings' must be > 0");
@@ -120,6 +122,9 @@ public:
   [[nodiscard]] bool is_double_precision() const noexcept override {
     return std::is_same_v<FloatType, double>;
   }
+  [[nodiscard]] bool requires_sorted_node_grid() const noexcept override {
+    return p3m.fft == nullptr or p3m.fft->requires_sorted_node_grid();
+  }
 
   void on_activation() override {
 #ifdef CUDA
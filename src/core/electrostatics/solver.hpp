@@ -76,6 +76,12 @@ struct Solver {
                            Utils::Vector3d const &, double)>;
 
   inline std::optional<ShortRangeForceKernel> pair_force_kernel() const;
+  /**
+   * @brief Call @p callback with a pointer to the real-space force kernel
+   * of the active solver, or with a null pointer if there is none.
+   */
+  template <class Callback>
+  void visit_pair_force_kernel(Callback &&callback) const;
   inline std::optional<ShortRangePressureKernel> pair_pressure_kernel() const;
   inline std::optional<ShortRangeEnergyKernel> pair_energy_kernel() const;
   inline std::optional<ShortRangeForceCorrectionsKernel>
@@ -33,6 +33,7 @@
 
 #include <memory>
 #include <span>
+#include <stdexcept>
 
 namespace System {
 
@@ -111,6 +112,10 @@ std::shared_ptr<Observable_stat> System::calculate_energy() {
 }
 
 double System::particle_short_range_energy_contribution(int pid) {
+  if (cell_structure->has_half_ghost_shell()) {
+    throw std::runtime_error("Cannot compute the energy of a particle with "
+                             "the half-shell ghost scheme");
+  }
   if (cell_structure->get_resort_particles()) {
     cell_structure->update_ghosts_and_resort_particle(get_global_ghost_flags());
   }
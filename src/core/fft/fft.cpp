@@ -26,6 +26,7 @@
  */
 
 #include "fft.hpp"
+#include "fftw.hpp"
 #include "vector.hpp"
 
 #include "p3m/packing.hpp"
@@ -38,8 +39,6 @@
 #include <boost/mpi/communicator.hpp>
 #include <boost/serialization/vector.hpp>
 
-#include <fftw3.h>
-
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
@@ -73,23 +72,6 @@ static void fft_sendrecv(T const *const sendbuf, int scount, int dest,
 
 namespace fft {
 
-template <typename FloatType = double> struct fftw {
-  using complex = fftw_complex;
-  static auto constexpr plan_many_dft = fftw_plan_many_dft;
-  static auto constexpr destroy_plan = fftw_destroy_plan;
-  static auto constexpr execute_dft = fftw_execute_dft;
-  static auto constexpr malloc = fftw_malloc;
-  static auto constexpr free = fftw_free;
-};
-template <> struct fftw<float> {
-  using complex = fftwf_complex;
-  static auto constexpr plan_many_dft = fftwf_plan_many_dft;
-  static auto constexpr destroy_plan = fftwf_destroy_plan;
-  static auto constexpr execute_dft = fftwf_execute_dft;
-  static auto constexpr malloc = fftwf_malloc;
-  static auto constexpr free = fftwf_free;
-};
-
 /** This ugly function does the bookkeeping: which nodes have to
  *  communicate to each other, when you change the node grid.
  *  Changing the regular decomposition requires communication. This
@@ -0,0 +1,525 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ *  Implementation of \ref pencil.hpp
+ */
+
+#include "pencil.hpp"
+#include "fft.hpp"
+#include "fftw.hpp"
+#include "vector.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/datatype.hpp>
+#include <boost/mpi/environment.hpp>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace fft {
+namespace {
+
+/** Maximal number of chunks of an overlapped transposition. */
+constexpr int max_chunks = 4;
+
+int box_volume(mesh_box const &box) {
+  auto volume = 1;
+  for (auto d = 0u; d < 3u; ++d) {
+    volume *= std::max(0, box.upper[d] - box.lower[d]);
+  }
+  return volume;
+}
+
+mesh_box box_intersection(mesh_box const &a, mesh_box const &b) {
+  mesh_box box;
+  for (auto d = 0u; d < 3u; ++d) {
+    box.lower[d] = std::max(a.lower[d], b.lower[d]);
+    box.upper[d] = std::max(box.lower[d], std::min(a.upper[d], b.upper[d]));
+  }
+  return box;
+}
+
+/**
+ * @brief Row-major layout of a box.
+ * @param box    Stored box.
+ * @param order  Cartesian directions, from the slowest to the fastest.
+ */
+mesh_layout make_layout(mesh_box const &box, std::array<int, 3> const &order) {
+  auto const extent = box.upper - box.lower;
+  mesh_layout layout{box, {}};
+  layout.stride[order[2]] = 1;
+  layout.stride[order[1]] = extent[order[2]];
+  layout.stride[order[0]] = extent[order[2]] * extent[order[1]];
+  return layout;
+}
+
+/**
+ * @brief Pencil of a process of the 2D process grid.
+ * The pencil spans the full mesh along @p axis; the two other
+ * directions are split on the process grid, in increasing order.
+ */
+mesh_box make_pencil(Utils::Vector3i const &mesh, int axis,
+                     std::array<int, 2> const &grid,
+                     std::array<int, 2> const &pos) {
+  mesh_box box{{0, 0, 0}, mesh};
+  auto i = 0u;
+  for (auto d = 0; d < 3; ++d) {
+    if (d != axis) {
+      box.lower[d] = mesh[d] * pos[i] / grid[i];
+      box.upper[d] = mesh[d] * (pos[i] + 1) / grid[i];
+      ++i;
+    }
+  }
+  return box;
+}
+
+/** @brief Call a kernel with the array index of each point of a box. */
+template <class Kernel>
+void for_each_index(mesh_box const &box, mesh_layout const &layout,
+                    Kernel &&kernel) {
+  auto const &origin = layout.box.lower;
+  auto const &stride = layout.stride;
+  for (auto x = box.lower[0]; x < box.upper[0]; ++x) {
+    for (auto y = box.lower[1]; y < box.upper[1]; ++y) {
+      auto index = (x - origin[0]) * stride[0] + (y - origin[1]) * stride[1] +
+                   (box.lower[2] - origin[2]) * stride[2];
+      for (auto z = box.lower[2]; z < box.upper[2]; ++z) {
+        kernel(index);
+        index += stride[2];
+      }
+    }
+  }
+}
+
+/** @brief Most square 2D process grid. */
+std::array<int, 2> calc_process_grid(int n_nodes) {
+  auto n_cols = static_cast<int>(std::sqrt(static_cast<double>(n_nodes)));
+  while (n_nodes % n_cols != 0) {
+    --n_cols;
+  }
+  return {n_nodes / n_cols, n_cols};
+}
+
+} // namespace
+
+template <typename FloatType>
+pencil_fft_data_struct<FloatType>::pencil_fft_data_struct(
+    decltype(m_mpi_env) mpi_env, bool real_to_complex)
+    : m_mpi_env{std::move(mpi_env)}, m_real_to_complex{real_to_complex} {}
+
+template <typename FloatType>
+pencil_fft_data_struct<FloatType>::~pencil_fft_data_struct() = default;
+
+template <typename FloatType>
+int pencil_fft_data_struct<FloatType>::initialize_fft(
+    boost::mpi::communicator const &comm, Utils::Vector3i const &ca_mesh_dim,
+    Utils::Vector3i const &ca_mesh_ld_ind, Utils::Vector3i const &inner_ld,
+    Utils::Vector3i const &inner_dim, Utils::Vector3i const &global_mesh_dim) {
+  auto const grid = calc_process_grid(comm.size());
+  auto const pos_of = [&grid](int rank) {
+    return std::array<int, 2>{rank / grid[1], rank % grid[1]};
+  };
+  auto const pos = pos_of(comm.rank());
+  auto ks_mesh_dim = global_mesh_dim;
+  if (m_real_to_complex) {
+    ks_mesh_dim[2] = global_mesh_dim[2] / 2 + 1;
+  }
+  auto const rs_pencil = [&global_mesh_dim, &grid](
+                             int axis, std::array<int, 2> const &p) {
+    return make_pencil(global_mesh_dim, axis, grid, p);
+  };
+  auto const pencil = [&ks_mesh_dim, &grid](int axis,
+                                            std::array<int, 2> const &p) {
+    return make_pencil(ks_mesh_dim, axis, grid, p);
+  };
+
+  m_global_box = {{0, 0, 0}, global_mesh_dim};
+  m_ks_box = {{0, 0, 0}, ks_mesh_dim};
+  m_rs_layout = make_layout({ca_mesh_ld_ind, ca_mesh_ld_ind + ca_mesh_dim},
+                            {0, 1, 2});
+  m_zc_layout = make_layout(pencil(2, pos), {0, 1, 2});
+  m_y_layout = make_layout(pencil(1, pos), {0, 2, 1});
+  m_x_layout = make_layout(pencil(0, pos), {1, 2, 0});
+  m_z_layout = m_zc_layout;
+  if (m_real_to_complex) {
+    /* real rows are padded to the length of the complex rows */
+    m_z_layout.box = rs_pencil(2, pos);
+    m_z_layout.stride = {2 * m_zc_layout.stride[0],
+                         2 * m_zc_layout.stride[1], 1};
+  }
+  auto const &z_box = m_z_layout.box;
+  auto const &zc_box = m_zc_layout.box;
+  auto const &y_box = m_y_layout.box;
+  auto const &x_box = m_x_layout.box;
+
+  /* === inner real-space meshes of all nodes === */
+  auto const inner_box = mesh_box{inner_ld, inner_ld + inner_dim};
+  std::vector<int> inner_boxes(6ul * static_cast<std::size_t>(comm.size()));
+  std::array<int, 6> local_inner_box;
+  std::copy(inner_box.lower.begin(), inner_box.lower.end(),
+            local_inner_box.begin());
+  std::copy(inner_box.upper.begin(), inner_box.upper.end(),
+            local_inner_box.begin() + 3);
+  MPI_Allgather(local_inner_box.data(), 6, MPI_INT, inner_boxes.data(), 6,
+                MPI_INT, comm);
+  auto const inner_box_of = [&inner_boxes](int rank) {
+    auto const *const box = inner_boxes.data() + 6 * rank;
+    return mesh_box{{box[0], box[1], box[2]}, {box[3], box[4], box[5]}};
+  };
+  auto covered = 0l;
+  for (int rank = 0; rank < comm.size(); ++rank) {
+    covered += box_volume(box_intersection(inner_box_of(rank), m_global_box));
+  }
+  if (covered != static_cast<long>(Utils::product(global_mesh_dim))) {
+    throw std::runtime_error(
+        "INTERNAL ERROR: the inner meshes do not tile the global mesh");
+  }
+
+  /* === communication patterns === */
+  m_rs_to_z = {comm, {}, {}};
+  for (int rank = 0; rank < comm.size(); ++rank) {
+    m_rs_to_z.send_boxes.emplace_back(
+        box_intersection(inner_box, rs_pencil(2, pos_of(rank))));
+    m_rs_to_z.recv_boxes.emplace_back(
+        box_intersection(inner_box_of(rank), z_box));
+  }
+  m_z_to_y = {comm.split(pos[0], pos[1]), {}, {}};
+  for (int q = 0; q < grid[1]; ++q) {
+    m_z_to_y.send_boxes.emplace_back(
+        box_intersection(zc_box, pencil(1, {pos[0], q})));
+    m_z_to_y.recv_boxes.emplace_back(
+        box_intersection(pencil(2, {pos[0], q}), y_box));
+  }
+  m_y_to_x = {comm.split(pos[1], pos[0]), {}, {}};
+  for (int q = 0; q < grid[0]; ++q) {
+    m_y_to_x.send_boxes.emplace_back(
+        box_intersection(y_box, pencil(0, {q, pos[1]})));
+    m_y_to_x.recv_boxes.emplace_back(
+        box_intersection(pencil(1, {q, pos[1]}), x_box));
+  }
+
+  /* === k-space mesh in order YZX === */
+  for (auto i = 0u; i < 3u; ++i) {
+    auto const d = (i + 1u) % 3u;
+    m_ks_start[i] = x_box.lower[d];
+    m_ks_size[i] = x_box.upper[d] - x_box.lower[d];
+  }
+
+  /* Factor 2 for complex fields */
+  auto const max_mesh_size =
+      std::max({Utils::product(ca_mesh_dim), 2 * box_volume(zc_box),
+                2 * box_volume(y_box), 2 * box_volume(x_box)});
+  send_buf.resize(static_cast<std::size_t>(max_mesh_size));
+  recv_buf.resize(static_cast<std::size_t>(max_mesh_size));
+  data_buf.resize(2ul * static_cast<std::size_t>(box_volume(y_box)));
+
+  /* plan all 1D-FFTs ahead of the first time step */
+  m_plans.clear();
+  fft::vector<FloatType> scratch(static_cast<std::size_t>(max_mesh_size));
+  std::fill(scratch.begin(), scratch.end(), FloatType(0));
+  forward_fft(scratch.data());
+  backward_fft(scratch.data(), false);
+
+  return max_mesh_size;
+}
+
+/**
+ * @brief Carry out the 1D-FFTs of the rows of a pencil in a chunk.
+ * @param layout  Pencil layout, @p axis has to be the fastest direction.
+ * @param chunk   Part of the global mesh.
+ * @param axis    Direction of the rows.
+ * @param dir     FFTW direction.
+ * @param data    Pencil data.
+ */
+template <typename FloatType>
+void pencil_fft_data_struct<FloatType>::transform(mesh_layout const &layout,
+                                                  mesh_box const &chunk,
+                                                  int axis, int dir,
+                                                  FloatType *data) {
+  if (m_real_to_complex and axis == 2) {
+    transform_real(chunk, dir, data);
+    return;
+  }
+  auto const box = box_intersection(layout.box, chunk);
+  if (box_volume(box) == 0) {
+    return;
+  }
+  /* the two other directions, from the slowest to the fastest */
+  auto slow = (axis + 1) % 3;
+  auto mid = (axis + 2) % 3;
+  if (layout.stride[slow] < layout.stride[mid]) {
+    std::swap(slow, mid);
+  }
+  auto const &origin = layout.box.lower;
+  auto const n = layout.box.upper[axis] - origin[axis];
+  auto const n_rows = box.upper[mid] - box.lower[mid];
+  auto const contiguous = box.lower[mid] == origin[mid] and
+                          box.upper[mid] == layout.box.upper[mid];
+  auto const n_ffts =
+      contiguous ? n_rows * (box.upper[slow] - box.lower[slow]) : n_rows;
+
+  auto &plan = m_plans[{n, n_ffts, dir, false}];
+  if (plan.plan_handle == nullptr) {
+    fft::vector<FloatType> buffer(2ul * static_cast<std::size_t>(n * n_ffts));
+    auto *c_buffer = reinterpret_cast<typename fftw<FloatType>::complex *>(
+        buffer.data());
+    plan.dir = dir;
+    plan.plan_handle = fftw<FloatType>::plan_many_dft(
+        1, &n, n_ffts, c_buffer, nullptr, 1, n, c_buffer, nullptr, 1, n, dir,
+        FFTW_MEASURE | FFTW_UNALIGNED);
+    assert(plan.plan_handle);
+  }
+
+  auto *c_data = reinterpret_cast<typename fftw<FloatType>::complex *>(data);
+  auto const row_offset = (box.lower[mid] - origin[mid]) * layout.stride[mid];
+  for (auto s = box.lower[slow]; s < box.upper[slow]; ++s) {
+    auto *rows = c_data + (s - origin[slow]) * layout.stride[slow] + row_offset;
+    fftw<FloatType>::execute_dft(plan.plan_handle, rows, rows);
+    if (contiguous) {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Carry out the real-to-complex 1D-FFTs along z in a chunk.
+ * The forward transform turns the real z-pencil into the complex
+ * z-pencil, the backward transform does the opposite.
+ * @param chunk   Part of the global mesh.
+ * @param dir     FFTW direction.
+ * @param data    Pencil data.
+ */
+template <typename FloatType>
+void pencil_fft_data_struct<FloatType>::transform_real(mesh_box const &chunk,
+                                                       int dir,
+                                                       FloatType *data) {
+  auto const &layout = m_zc_layout;
+  auto const box = box_intersection(layout.box, chunk);
+  if (box_volume(box) == 0) {
+    return;
+  }
+  auto const &origin = layout.box.lower;
+  auto const n = m_global_box.upper[2];
+  auto const n_complex = layout.stride[1];
+  auto const n_rows = box.upper[1] - box.lower[1];
+  auto const contiguous =
+      box.lower[1] == origin[1] and box.upper[1] == layout.box.upper[1];
+  auto const n_ffts =
+      contiguous ? n_rows * (box.upper[0] - box.lower[0]) : n_rows;
+
+  using complex = typename fftw<FloatType>::complex;
+  auto &plan = m_plans[{n, n_ffts, dir, true}];
+  if (plan.plan_handle == nullptr) {
+    fft::vector<FloatType> buffer(
+        2ul * static_cast<std::size_t>(n_complex * n_ffts));
+    auto *c_buffer = reinterpret_cast<complex *>(buffer.data());
+    plan.dir = dir;
+    if (dir == FFTW_FORWARD) {
+      plan.plan_handle = fftw<FloatType>::plan_many_dft_r2c(
+          1, &n, n_ffts, buffer.data(), nullptr, 1, 2 * n_complex, c_buffer,
+          nullptr, 1, n_complex, FFTW_MEASURE | FFTW_UNALIGNED);
+    } else {
+      plan.plan_handle = fftw<FloatType>::plan_many_dft_c2r(
+          1, &n, n_ffts, c_buffer, nullptr, 1, n_complex, buffer.data(),
+          nullptr, 1, 2 * n_complex, FFTW_MEASURE | FFTW_UNALIGNED);
+    }
+    assert(plan.plan_handle);
+  }
+
+  auto const row_offset = (box.lower[1] - origin[1]) * layout.stride[1];
+  for (auto x = box.lower[0]; x < box.upper[0]; ++x) {
+    auto const offset = (x - origin[0]) * layout.stride[0] + row_offset;
+    auto *r_rows = data + 2 * offset;
+    auto *c_rows = reinterpret_cast<complex *>(r_rows);
+    if (dir == FFTW_FORWARD) {
+      fftw<FloatType>::execute_dft_r2c(plan.plan_handle, r_rows, c_rows);
+    } else {
+      fftw<FloatType>::execute_dft_c2r(plan.plan_handle, c_rows, r_rows);
+    }
+    if (contiguous) {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Redistribute the part of a mesh within a chunk.
+ * The send buffer is packed and the communication is started before
+ * @p work is called, the receive buffer is unpacked afterwards.
+ * @param transpose    Communication pattern.
+ * @param reverse      Exchange the roles of the send and receive boxes.
+ * @param chunk        Part of the global mesh to communicate.
+ * @param in_layout    Layout of the input mesh.
+ * @param in           Input mesh.
+ * @param in_element   Number of values per mesh point of the input mesh.
+ * @param out_layout   Layout of the output mesh.
+ * @param out          Output mesh, may be the input mesh.
+ * @param out_element  Number of values per mesh point of the output mesh,
+ *                     values which are not communicated are set to zero.
+ * @param element      Number of communicated values per mesh point.
+ * @param work         Computation overlapping with the communication.
+ */
+template <typename FloatType>
+template <class Work>
+void pencil_fft_data_struct<FloatType>::exchange(
+    mesh_transpose const &transpose, bool reverse, mesh_box const &chunk,
+    mesh_layout const &in_layout, FloatType const *in, int in_element,
+    mesh_layout const &out_layout, FloatType *out, int out_element,
+    int element, Work &&work) {
+  auto const &send_boxes =
+      reverse ? transpose.recv_boxes : transpose.send_boxes;
+  auto const &recv_boxes =
+      reverse ? transpose.send_boxes : transpose.recv_boxes;
+  auto const n_nodes = send_boxes.size();
+  send_counts.resize(n_nodes);
+  send_displs.resize(n_nodes);
+  recv_counts.resize(n_nodes);
+  recv_displs.resize(n_nodes);
+
+  auto *send_ptr = send_buf.data();
+  for (std::size_t i = 0ul; i < n_nodes; ++i) {
+    auto const box = box_intersection(send_boxes[i], chunk);
+    send_displs[i] = static_cast<int>(send_ptr - send_buf.data());
+    send_counts[i] = element * box_volume(box);
+    for_each_index(box, in_layout, [&](int index) {
+      for (int e = 0; e < element; ++e) {
+        *send_ptr++ = in[in_element * index + e];
+      }
+    });
+  }
+  auto recv_size = 0;
+  for (std::size_t i = 0ul; i < n_nodes; ++i) {
+    recv_displs[i] = recv_size;
+    auto const box = box_intersection(recv_boxes[i], chunk);
+    recv_counts[i] = element * box_volume(box);
+    recv_size += recv_counts[i];
+  }
+
+  auto const type = boost::mpi::get_mpi_datatype<FloatType>(*in);
+  MPI_Request request;
+  MPI_Ialltoallv(send_buf.data(), send_counts.data(), send_displs.data(), type,
+                 recv_buf.data(), recv_counts.data(), recv_displs.data(), type,
+                 transpose.comm, &request);
+  work();
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+  auto const *recv_ptr = recv_buf.data();
+  for (std::size_t i = 0ul; i < n_nodes; ++i) {
+    auto const box = box_intersection(recv_boxes[i], chunk);
+    for_each_index(box, out_layout, [&](int index) {
+      for (int e = 0; e < element; ++e) {
+        out[out_element * index + e] = *recv_ptr++;
+      }
+      for (int e = element; e < out_element; ++e) {
+        out[out_element * index + e] = FloatType(0);
+      }
+    });
+  }
+}
+
+/**
+ * @brief Carry out the 1D-FFTs of a pencil and transpose it.
+ * The pencil is split into chunks along a direction whose block is
+ * shared by all ranks of the communicator. With @ref overlap, the
+ * 1D-FFTs of the next chunk are carried out while the current chunk
+ * is communicated.
+ */
+template <typename FloatType>
+void pencil_fft_data_struct<FloatType>::transpose_stage(
+    mesh_transpose const &transpose, bool reverse, int chunk_axis,
+    mesh_layout const &in_layout, int fft_axis, int dir, FloatType *in,
+    mesh_layout const &out_layout, FloatType *out) {
+  auto const lower = in_layout.box.lower[chunk_axis];
+  auto const length = in_layout.box.upper[chunk_axis] - lower;
+  auto const n_chunks = overlap ? std::clamp(length, 1, max_chunks) : 1;
+  auto const get_chunk = [&](int i) {
+    auto chunk = m_ks_box;
+    chunk.lower[chunk_axis] = lower + length * i / n_chunks;
+    chunk.upper[chunk_axis] = lower + length * (i + 1) / n_chunks;
+    return chunk;
+  };
+
+  transform(in_layout, get_chunk(0), fft_axis, dir, in);
+  for (int i = 0; i < n_chunks; ++i) {
+    exchange(transpose, reverse, get_chunk(i), in_layout, in, 2, out_layout,
+             out, 2, 2, [&]() {
+               if (i + 1 < n_chunks) {
+                 transform(in_layout, get_chunk(i + 1), fft_axis, dir, in);
+               }
+             });
+  }
+}
+
+template <typename FloatType>
+void pencil_fft_data_struct<FloatType>::forward_fft(FloatType *data) {
+  /* redistribute and complexify the real data (in/out is data) */
+  auto const z_element = m_real_to_complex ? 1 : 2;
+  exchange(m_rs_to_z, false, m_global_box, m_rs_layout, data, 1, m_z_layout,
+           data, z_element, 1, []() {});
+  /* FFT along z, transpose to y-pencils (out is data_buf) */
+  transpose_stage(m_z_to_y, false, 0, m_zc_layout, 2, FFTW_FORWARD, data,
+                  m_y_layout, data_buf.data());
+  /* FFT along y, transpose to x-pencils (out is data) */
+  transpose_stage(m_y_to_x, false, 2, m_y_layout, 1, FFTW_FORWARD,
+                  data_buf.data(), m_x_layout, data);
+  /* FFT along x (in/out is data) */
+  transform(m_x_layout, m_ks_box, 0, FFTW_FORWARD, data);
+}
+
+template <typename FloatType>
+void pencil_fft_data_struct<FloatType>::backward_fft(FloatType *data,
+                                                     bool check_complex) {
+  /* FFT along x, transpose to y-pencils (out is data_buf) */
+  transpose_stage(m_y_to_x, true, 2, m_x_layout, 0, FFTW_BACKWARD, data,
+                  m_y_layout, data_buf.data());
+  /* FFT along y, transpose to z-pencils (out is data) */
+  transpose_stage(m_z_to_y, true, 0, m_y_layout, 1, FFTW_BACKWARD,
+                  data_buf.data(), m_zc_layout, data);
+  /* FFT along z (in/out is data) */
+  transform(m_zc_layout, m_ks_box, 2, FFTW_BACKWARD, data);
+  auto const z_element = m_real_to_complex ? 1 : 2;
+  if (check_complex and not m_real_to_complex) {
+    auto const size = box_volume(m_z_layout.box);
+    for (int i = 0; i < size; i++) {
+      if (std::abs(data[2 * i + 1]) > 1e-5) {
+        throw std::runtime_error("Complex value is not zero");
+      }
+    }
+  }
+  /* throw away the complex component and redistribute (in/out is data) */
+  exchange(m_rs_to_z, true, m_global_box, m_z_layout, data, z_element,
+           m_rs_layout, data, 1, 1, []() {});
+}
+
+template struct pencil_fft_data_struct<float>;
+template struct pencil_fft_data_struct<double>;
+
+} // namespace fft
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/** \file
+ *
+ *  3D-FFT with a 2D pencil decomposition.
+ *
+ *  The MPI ranks are arranged on a 2D grid of @f$ P_1 \times P_2 @f$
+ *  processes, which is independent of the node grid. Each 1D-FFT
+ *  direction is carried out on pencils, i.e. on the full mesh length
+ *  along the transform direction and on a block of the other two
+ *  directions. The real-space mesh is redistributed once from the
+ *  domain decomposition to z-pencils, then the data is transposed
+ *  from z-pencils to y-pencils within the rows of the process grid,
+ *  and from y-pencils to x-pencils within its columns. Optionally,
+ *  the transpositions are split into chunks which are communicated
+ *  while the 1D-FFTs of the next chunk are carried out.
+ *
+ *  After the forward FFT, the k-space data is in order YZX, like in
+ *  @ref fft::fft_data_struct.
+ *
+ *  With a real-to-complex FFT, the 1D-FFTs along z take real input and
+ *  only store the @f$ n_z/2+1 @f$ non-negative frequencies, the other
+ *  half of the spectrum follows from the Hermitian symmetry. The real
+ *  z-pencils are stored in place of the complex ones, with each row
+ *  padded to @f$ 2(n_z/2+1) @f$ values. All subsequent transpositions
+ *  and 1D-FFTs only operate on the stored half of the k-space mesh.
+ */
+
+#include "fft.hpp"
+#include "vector.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/communicator.hpp>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace boost::mpi {
+class environment;
+} // namespace boost::mpi
+
+namespace fft {
+
+/** @brief Box of global mesh indices, the upper corner is excluded. */
+struct mesh_box {
+  Utils::Vector3i lower;
+  Utils::Vector3i upper;
+};
+
+/** @brief Memory layout of a mesh box stored in a contiguous array. */
+struct mesh_layout {
+  /** stored box. */
+  mesh_box box;
+  /** array stride of each Cartesian direction. */
+  Utils::Vector3i stride;
+};
+
+/** @brief Redistribution of mesh boxes between the ranks of a communicator. */
+struct mesh_transpose {
+  boost::mpi::communicator comm;
+  /** part of the local source box sent to each rank. */
+  std::vector<mesh_box> send_boxes;
+  /** part of the local target box received from each rank. */
+  std::vector<mesh_box> recv_boxes;
+};
+
+template <typename FloatType> struct pencil_fft_data_struct {
+private:
+  /**
+   * @brief Handle to the MPI environment.
+   * Has to be the first member in the class definition, so that FFT plans
+   * are destroyed before the MPI environment expires (non-static class
+   * members are destroyed in the reverse order of their initialization).
+   */
+  std::shared_ptr<boost::mpi::environment> m_mpi_env;
+
+  /** 1D-FFT plans, by row length, number of rows, direction and type. */
+  std::map<std::tuple<int, int, int, bool>, fft_plan<FloatType>> m_plans;
+
+  /** Only transform the non-negative frequencies along z. */
+  bool m_real_to_complex;
+
+  /** global mesh. */
+  mesh_box m_global_box;
+  /** stored part of the global k-space mesh. */
+  mesh_box m_ks_box;
+  /** layout of the real-space mesh, including the margins. */
+  mesh_layout m_rs_layout;
+  /** layout of the real z-pencil, in order XYZ. */
+  mesh_layout m_z_layout;
+  /** layout of the complex z-pencil, in order XYZ. */
+  mesh_layout m_zc_layout;
+  /** layout of the y-pencil, in order XZY. */
+  mesh_layout m_y_layout;
+  /** layout of the x-pencil, in order YZX. */
+  mesh_layout m_x_layout;
+
+  /** redistribution from the real-space mesh to z-pencils. */
+  mesh_transpose m_rs_to_z;
+  /** transposition from z-pencils to y-pencils. */
+  mesh_transpose m_z_to_y;
+  /** transposition from y-pencils to x-pencils. */
+  mesh_transpose m_y_to_x;
+
+  /** k-space mesh size in order YZX. */
+  std::array<int, 3u> m_ks_size;
+  /** k-space mesh start in order YZX. */
+  std::array<int, 3u> m_ks_start;
+
+  std::vector<FloatType> send_buf;
+  std::vector<FloatType> recv_buf;
+  std::vector<int> send_counts, send_displs, recv_counts, recv_displs;
+  /** Buffer for the intermediate pencils. */
+  fft::vector<FloatType> data_buf;
+
+public:
+  pencil_fft_data_struct(decltype(m_mpi_env) mpi_env, bool real_to_complex);
+  ~pencil_fft_data_struct();
+
+  // disable copy construction: unsafe because we store raw pointers
+  // to FFT plans (avoids double-free and use-after-free)
+  pencil_fft_data_struct &
+  operator=(pencil_fft_data_struct<FloatType> const &) = delete;
+  pencil_fft_data_struct(pencil_fft_data_struct<FloatType> const &) = delete;
+
+  /** Split the transpositions into chunks to overlap them with the FFTs. */
+  bool overlap = false;
+
+  /** Initialize everything connected to the 3D-FFT.
+   *
+   *  \param[in]  comm            MPI communicator.
+   *  \param[in]  ca_mesh_dim     Local CA mesh dimensions.
+   *  \param[in]  ca_mesh_ld_ind  Global index of the first CA mesh point.
+   *  \param[in]  inner_ld        Global index of the first inner mesh point.
+   *  \param[in]  inner_dim       Number of inner mesh points.
+   *  \param[in]  global_mesh_dim Global CA mesh dimensions.
+   *  \return Maximal size of local fft mesh (needed for allocation of ca_mesh).
+   */
+  int initialize_fft(boost::mpi::communicator const &comm,
+                     Utils::Vector3i const &ca_mesh_dim,
+                     Utils::Vector3i const &ca_mesh_ld_ind,
+                     Utils::Vector3i const &inner_ld,
+                     Utils::Vector3i const &inner_dim,
+                     Utils::Vector3i const &global_mesh_dim);
+
+  /** Perform an in-place forward 3D FFT.
+   *  \warning The content of \a data is overwritten.
+   *  \param[in,out] data  Mesh.
+   */
+  void forward_fft(FloatType *data);
+
+  /** Perform an in-place backward 3D FFT.
+   *  \warning The content of \a data is overwritten.
+   *  \param[in,out] data           Mesh.
+   *  \param[in]     check_complex  Throw an error if the complex component is
+   *                                non-zero. Ignored by the real-to-complex
+   *                                FFT, whose output is real by construction.
+   */
+  void backward_fft(FloatType *data, bool check_complex);
+
+  auto const &get_mesh_size() const { return m_ks_size; }
+
+  auto const &get_mesh_start() const { return m_ks_start; }
+
+  auto is_real_to_complex() const { return m_real_to_complex; }
+
+private:
+  void transform(mesh_layout const &layout, mesh_box const &chunk, int axis,
+                 int dir, FloatType *data);
+  void transform_real(mesh_box const &chunk, int dir, FloatType *data);
+  template <class Work>
+  void exchange(mesh_transpose const &transpose, bool reverse,
+                mesh_box const &chunk, mesh_layout const &in_layout,
+                FloatType const *in, int in_element,
+                mesh_layout const &out_layout, FloatType *out, int out_element,
+                int element, Work &&work);
+  void transpose_stage(mesh_transpose const &transpose, bool reverse,
+                       int chunk_axis, mesh_layout const &in_layout,
+                       int fft_axis, int dir, FloatType *in,
+                       mesh_layout const &out_layout, FloatType *out);
+};
+
+} // namespace fft
@@ -41,6 +41,7 @@
 #include "integrators/Propagation.hpp"
 #include "lb/particle_coupling.hpp"
 #include "magnetostatics/dipoles.hpp"
+#include "nonbonded_interactions/central_force_batch.hpp"
 #include "nonbonded_interactions/VerletCriterion.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
@@ -61,10 +62,43 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <memory>
 #include <span>
+#include <type_traits>
 #include <variant>
 
+namespace {
+/** Non-bonded kernel for particles stored in @ref ParticleArrays. */
+template <class CoulombKernel> struct ParticleArraysPairKernel {
+  InteractionsNonBonded const &nonbonded_ias;
+  CoulombKernel const *coulomb_kernel;
+
+  void operator()(ParticleArrays &arrays, std::size_t i, std::size_t j,
+                  Distance const &d) const {
+    auto const &ia_params =
+        nonbonded_ias.get_ia_param(arrays.type[i], arrays.type[j]);
+    add_non_bonded_pair_force(arrays, i, j, d.vec21, sqrt(d.dist2), ia_params,
+                              coulomb_kernel);
+  }
+
+  /** Verlet list of a cell, evaluated in batches when no pair
+   *  needs the Coulomb kernel. */
+  template <class DistanceFunction>
+  void operator()(ParticleArrays &arrays,
+                  std::span<ParticleArrays::IndexPair const> pairs,
+                  DistanceFunction const &df) const {
+    if (coulomb_kernel) {
+      for (auto const &[i, j] : pairs) {
+        (*this)(arrays, i, j, df(arrays.pos[i], arrays.pos[j]));
+      }
+    } else {
+      add_central_forces_batched(arrays, pairs, df, nonbonded_ias, *this);
+    }
+  }
+};
+} // namespace
+
 /** External particle forces */
 static ParticleForce external_force(Particle const &p) {
   ParticleForce f = {};
@@ -106,6 +140,41 @@ void init_forces_ghosts(ParticleRange const &particles) {
   }
 }
 
+/**
+ * @brief Initialize the forces for the RESPA integrator.
+ *
+ * The long-range forces are only calculated at the beginning of an outer
+ * step and applied as an impulse, i.e. scaled by the number of inner steps.
+ * Since the velocity Verlet half steps use the force of the last force
+ * calculation on both sides of the outer step boundary, this is equivalent
+ * to the reversible impulse RESPA scheme.
+ */
+static void init_forces_respa(ParticleRange const &particles,
+                              ParticleRange const &ghost_particles,
+                              Propagation &propagation) {
+  auto const n_inner_steps = propagation.respa_n_inner_steps;
+  if (propagation.respa_inner_step == 0) {
+    for (auto &p : particles) {
+      p.force_and_torque() = {};
+    }
+    calc_long_range_forces(particles);
+    for (auto &p : particles) {
+      p.force() *= static_cast<double>(n_inner_steps);
+#ifdef ROTATION
+      p.torque() *= static_cast<double>(n_inner_steps);
+#endif
+      p.force_and_torque() += external_force(p);
+    }
+  } else {
+    for (auto &p : particles) {
+      p.force_and_torque() = external_force(p);
+    }
+  }
+  init_forces_ghosts(ghost_particles);
+  propagation.respa_inner_step =
+      (propagation.respa_inner_step + 1) % n_inner_steps;
+}
+
 static void force_capping(ParticleRange const &particles, double force_cap) {
   if (force_cap > 0.) {
     auto const force_cap_sq = Utils::sqr(force_cap);
@@ -142,6 +211,7 @@ void System::System::calculate_forces() {
   if (coulomb.impl->extension) {
     if (auto icc = std::get_if<std::shared_ptr<ICCStar>>(
             get_ptr(coulomb.impl->extension))) {
+      cell_structure->complete_ghosts_update();
       (**icc).iteration(*cell_structure, particles, ghost_particles);
     }
   }
@@ -149,10 +219,15 @@ void System::System::calculate_forces() {
 #ifdef NPT
   npt_reset_instantaneous_virials();
 #endif
-  init_forces(particles, ghost_particles);
-  thermostat_force_init();
-
-  calc_long_range_forces(particles);
+  if (propagation->integ_switch == INTEG_METHOD_RESPA) {
+    init_forces_respa(particles, ghost_particles, *propagation);
+    thermostat_force_init();
+  } else {
+    init_forces(particles, ghost_particles);
+    thermostat_force_init();
+
+    calc_long_range_forces(particles);
+  }
 
   auto const elc_kernel = coulomb.pair_force_elc_kernel();
   auto const coulomb_kernel = coulomb.pair_force_kernel();
@@ -175,37 +250,86 @@ void System::System::calculate_forces() {
   auto const collision_detection_cutoff = INACTIVE_CUTOFF;
 #endif
 
-  short_range_loop(
-      [coulomb_kernel_ptr = get_ptr(coulomb_kernel), &bonded_ias = *bonded_ias,
-       &bond_breakage = *bond_breakage, &box_geo = *box_geo](
-          Particle &p1, int bond_id, std::span<Particle *> partners) {
-        return add_bonded_force(p1, bond_id, partners, bonded_ias,
-                                bond_breakage, box_geo, coulomb_kernel_ptr);
-      },
-      [coulomb_kernel_ptr = get_ptr(coulomb_kernel),
-       dipoles_kernel_ptr = get_ptr(dipoles_kernel),
-       elc_kernel_ptr = get_ptr(elc_kernel), &nonbonded_ias = *nonbonded_ias,
-       &thermostat = *thermostat, &bonded_ias = *bonded_ias,
+  /* the pair kernel only writes to the particle pair, except when
+   * accumulating the NpT virial or queuing collisions */
+  auto thread_safe_pair_kernel = true;
+#ifdef NPT
+  if (propagation->used_propagations & PropagationMode::TRANS_LANGEVIN_NPT) {
+    thread_safe_pair_kernel = false;
+  }
+#endif
+#ifdef COLLISION_DETECTION
+  if (not collision_detection->is_off()) {
+    thread_safe_pair_kernel = false;
+  }
+#endif
+
+  /* the structure-of-arrays mirror only holds the data needed by
+   * central pair potentials and short-range electrostatics */
+  auto use_particle_arrays = cell_structure->use_particle_arrays and
+                             thread_safe_pair_kernel and
+                             not get_ptr(dipoles_kernel) and
+                             not get_ptr(elc_kernel) and
+                             nonbonded_ias->only_central_forces();
+#ifdef DPD
+  if (thermostat->thermo_switch & THERMO_DPD) {
+    use_particle_arrays = false;
+  }
+#endif
+  if (use_particle_arrays) {
+    use_particle_arrays =
+        not cell_structure->particle_arrays().has_exclusions();
+  }
+
+  auto const verlet_criterion = VerletCriterion<>{
+      *this, cell_structure->get_verlet_skin(), get_interaction_range(),
+      coulomb_cutoff, dipole_cutoff, collision_detection_cutoff};
+  auto const pair_cutoff = maximal_cutoff();
+
+  /* the pair loops are instantiated for the active Coulomb solver,
+   * such that its real-space kernel can be inlined */
+  coulomb.visit_pair_force_kernel([&](auto const *coulomb_kernel_ptr) {
+    using CoulombKernel = std::remove_cvref_t<decltype(*coulomb_kernel_ptr)>;
+    /* runs first, since it completes a postponed ghost update
+     * while evaluating the inner cells */
+    if (use_particle_arrays and pair_cutoff > 0.) {
+      cell_structure->particle_arrays_loop(
+          ParticleArraysPairKernel<CoulombKernel>{*nonbonded_ias,
+                                                  coulomb_kernel_ptr},
+          verlet_criterion, thread_safe_pair_kernel);
+    }
+    cell_structure->complete_ghosts_update();
+
+    short_range_loop(
+        [coulomb_kernel_ptr = get_ptr(coulomb_kernel),
+         &bonded_ias = *bonded_ias, &bond_breakage = *bond_breakage,
+         &box_geo = *box_geo](Particle &p1, int bond_id,
+                              std::span<Particle *> partners) {
+          return add_bonded_force(p1, bond_id, partners, bonded_ias,
+                                  bond_breakage, box_geo, coulomb_kernel_ptr);
+        },
+        [coulomb_kernel_ptr, dipoles_kernel_ptr = get_ptr(dipoles_kernel),
+         elc_kernel_ptr = get_ptr(elc_kernel), &nonbonded_ias = *nonbonded_ias,
+         &thermostat = *thermostat, &bonded_ias = *bonded_ias,
 #ifdef COLLISION_DETECTION
-       &collision_detection = *collision_detection,
+         &collision_detection = *collision_detection,
 #endif
-       &box_geo = *box_geo](Particle &p1, Particle &p2, Distance const &d) {
-        auto const &ia_params =
-            nonbonded_ias.get_ia_param(p1.type(), p2.type());
-        add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
-                                  ia_params, thermostat, box_geo, bonded_ias,
-                                  coulomb_kernel_ptr, dipoles_kernel_ptr,
-                                  elc_kernel_ptr);
+         &box_geo = *box_geo](Particle &p1, Particle &p2, Distance const &d) {
+          add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
+                                    nonbonded_ias, thermostat, box_geo,
+                                    bonded_ias, coulomb_kernel_ptr,
+                                    dipoles_kernel_ptr, elc_kernel_ptr);
 #ifdef COLLISION_DETECTION
-        if (not collision_detection.is_off()) {
-          collision_detection.detect_collision(p1, p2, d.dist2);
-        }
+          if (not collision_detection.is_off()) {
+            collision_detection.detect_collision(p1, p2, d.dist2);
+          }
 #endif
-      },
-      *cell_structure, maximal_cutoff(), bonded_ias->maximal_cutoff(),
-      VerletCriterion<>{*this, cell_structure->get_verlet_skin(),
-                        get_interaction_range(), coulomb_cutoff, dipole_cutoff,
-                        collision_detection_cutoff});
+        },
+        *cell_structure,
+        use_particle_arrays ? INACTIVE_CUTOFF : pair_cutoff,
+        bonded_ias->maximal_cutoff(), verlet_criterion,
+        thread_safe_pair_kernel);
+  });
 
   constraints->add_forces(particles, get_sim_time());
   oif_global->calculate_forces();
@@ -34,12 +34,14 @@
 #include "bond_breakage/bond_breakage.hpp"
 #include "bonded_interactions/bonded_interaction_data.hpp"
 #include "bonded_interactions/thermalized_bond_kernel.hpp"
+#include "cell_system/ParticleArrays.hpp"
 #include "electrostatics/coulomb_inline.hpp"
 #include "immersed_boundary/ibm_tribend.hpp"
 #include "immersed_boundary/ibm_triel.hpp"
 #include "magnetostatics/dipoles_inline.hpp"
 #include "nonbonded_interactions/bmhtf-nacl.hpp"
 #include "nonbonded_interactions/buckingham.hpp"
+#include "nonbonded_interactions/central_force_batch.hpp"
 #include "nonbonded_interactions/gaussian.hpp"
 #include "nonbonded_interactions/gay_berne.hpp"
 #include "nonbonded_interactions/hat.hpp"
@@ -53,6 +55,7 @@
 #include "nonbonded_interactions/nonbonded_tab.hpp"
 #include "nonbonded_interactions/smooth_step.hpp"
 #include "nonbonded_interactions/soft_sphere.hpp"
+#include "nonbonded_interactions/spline_tabulation.hpp"
 #include "nonbonded_interactions/thole.hpp"
 #include "nonbonded_interactions/wca.hpp"
 #include "object-in-fluid/oif_global_forces.hpp"
@@ -72,6 +75,7 @@
 
 #include <boost/variant.hpp>
 
+#include <cstddef>
 #include <optional>
 #include <span>
 #include <tuple>
@@ -104,19 +108,27 @@ inline ParticleForce calc_central_radial_force(IA_parameters const &ia_params,
 #endif
 /* Gaussian force */
 #ifdef GAUSSIAN
-  force_factor += gaussian_pair_force_factor(ia_params, dist);
+  force_factor += splined_force_factor(
+      ia_params.spline_tabulation.gaussian, dist,
+      [&]() { return gaussian_pair_force_factor(ia_params, dist); });
 #endif
 /* BMHTF NaCl */
 #ifdef BMHTF_NACL
-  force_factor += BMHTF_pair_force_factor(ia_params, dist);
+  force_factor += splined_force_factor(
+      ia_params.spline_tabulation.bmhtf, dist,
+      [&]() { return BMHTF_pair_force_factor(ia_params, dist); });
 #endif
 /* Buckingham*/
 #ifdef BUCKINGHAM
-  force_factor += buck_pair_force_factor(ia_params, dist);
+  force_factor += splined_force_factor(
+      ia_params.spline_tabulation.buckingham, dist,
+      [&]() { return buck_pair_force_factor(ia_params, dist); });
 #endif
 /* Morse*/
 #ifdef MORSE
-  force_factor += morse_pair_force_factor(ia_params, dist);
+  force_factor += splined_force_factor(
+      ia_params.spline_tabulation.morse, dist,
+      [&]() { return morse_pair_force_factor(ia_params, dist); });
 #endif
 /*soft-sphere potential*/
 #ifdef SOFT_SPHERE
@@ -172,25 +184,29 @@ inline ParticleForce calc_opposing_force(ParticleForce const &pf,
 
 /** Calculate non-bonded forces between a pair of particles and update their
  *  forces and torques.
+ *  Pairs of types with only Lennard-Jones and WCA potentials are evaluated
+ *  from the compact parameter table, see @ref CompactIA_parameters.
  *  @param[in,out] p1      particle 1.
  *  @param[in,out] p2      particle 2.
  *  @param[in] d           vector between @p p1 and @p p2.
  *  @param[in] dist        distance between @p p1 and @p p2.
  *  @param[in] dist2       distance squared between @p p1 and @p p2.
- *  @param[in] ia_params       non-bonded interaction kernels.
+ *  @param[in] nonbonded_ias   non-bonded interaction kernels.
  *  @param[in] thermostat      thermostat.
  *  @param[in] box_geo         box geometry.
  *  @param[in] bonded_ias      bonded interaction kernels.
  *  @param[in] coulomb_kernel  Coulomb force kernel.
  *  @param[in] dipoles_kernel  Dipolar force kernel.
  *  @param[in] elc_kernel      ELC force correction kernel.
+ *  @tparam CoulombKernel      Type of the Coulomb force kernel.
  */
+template <class CoulombKernel>
 inline void add_non_bonded_pair_force(
     Particle &p1, Particle &p2, Utils::Vector3d const &d, double dist,
-    double dist2, IA_parameters const &ia_params,
+    double dist2, InteractionsNonBonded const &nonbonded_ias,
     Thermostat::Thermostat const &thermostat, BoxGeometry const &box_geo,
     [[maybe_unused]] BondedInteractionsMap const &bonded_ias,
-    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel,
+    CoulombKernel const *coulomb_kernel,
     Dipoles::ShortRangeForceKernel::kernel_type const *dipoles_kernel,
     Coulomb::ShortRangeForceCorrectionsKernel::kernel_type const *elc_kernel) {
 
@@ -200,16 +216,24 @@ inline void add_non_bonded_pair_force(
   /* non-bonded pair potentials                  */
   /***********************************************/
 
-  if (dist < ia_params.max_cut) {
+  auto const &compact_params =
+      nonbonded_ias.get_compact_ia_param(p1.type(), p2.type());
+  if (dist < compact_params.max_cut) {
 #ifdef EXCLUSIONS
     if (do_nonbonded(p1, p2)) {
 #endif
-      pf += calc_central_radial_force(ia_params, d, dist);
+      if (compact_params.batch_kernel != BatchKernel::NONE) {
+        pf.f += compact_central_force_factor(compact_params, dist, dist2) * d;
+      } else {
+        auto const &ia_params =
+            nonbonded_ias.get_ia_param(p1.type(), p2.type());
+        pf += calc_central_radial_force(ia_params, d, dist);
 #ifdef THOLE
-      pf.f += thole_pair_force(p1, p2, ia_params, d, dist, bonded_ias,
-                               coulomb_kernel);
+        pf.f += thole_pair_force(p1, p2, ia_params, d, dist, bonded_ias,
+                                 coulomb_kernel);
 #endif
-      pf += calc_non_central_force(p1, p2, ia_params, d, dist);
+        pf += calc_non_central_force(p1, p2, ia_params, d, dist);
+      }
 #ifdef EXCLUSIONS
     }
 #endif
@@ -246,6 +270,7 @@ inline void add_non_bonded_pair_force(
   /* The inter dpd force should not be part of the virial */
 #ifdef DPD
   if (thermostat.thermo_switch & THERMO_DPD) {
+    auto const &ia_params = nonbonded_ias.get_ia_param(p1.type(), p2.type());
     auto const force = dpd_pair_force(p1, p2, *thermostat.dpd, box_geo,
                                       ia_params, d, dist, dist2);
     p1.force() += force;
@@ -272,6 +297,42 @@ inline void add_non_bonded_pair_force(
   p2.force_and_torque() += calc_opposing_force(pf, d);
 }
 
+/** Calculate central non-bonded forces between a pair of particles
+ *  stored in @ref ParticleArrays and update their force accumulators.
+ *  Only the central pair potentials and the short-range electrostatics
+ *  are taken into account.
+ *  @param[in,out] arrays  particle data.
+ *  @param[in] i           index of particle 1.
+ *  @param[in] j           index of particle 2.
+ *  @param[in] d           vector between particle 1 and particle 2.
+ *  @param[in] dist        distance between particle 1 and particle 2.
+ *  @param[in] ia_params       non-bonded interaction kernels.
+ *  @param[in] coulomb_kernel  Coulomb force kernel.
+ *  @tparam CoulombKernel      Type of the Coulomb force kernel.
+ */
+template <class CoulombKernel>
+inline void add_non_bonded_pair_force(
+    ParticleArrays &arrays, std::size_t i, std::size_t j,
+    Utils::Vector3d const &d, double dist, IA_parameters const &ia_params,
+    [[maybe_unused]] CoulombKernel const *coulomb_kernel) {
+
+  Utils::Vector3d force{};
+
+  if (dist < ia_params.max_cut) {
+    force += calc_central_radial_force(ia_params, d, dist).f;
+  }
+
+#ifdef ELECTROSTATICS
+  auto const q1q2 = arrays.q[i] * arrays.q[j];
+  if (q1q2 != 0. and coulomb_kernel != nullptr) {
+    force += (*coulomb_kernel)(q1q2, d, dist);
+  }
+#endif // ELECTROSTATICS
+
+  arrays.force[i] += force;
+  arrays.force[j] -= force;
+}
+
 /** Compute the bonded interaction force between particle pairs.
  *
  *  @param[in] p1          First particle.
@@ -42,15 +42,22 @@
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/environment.hpp>
+#include <boost/mpi/exception.hpp>
 #include <boost/range/numeric.hpp>
 #include <boost/serialization/vector.hpp>
 
+#include <mpi.h>
+
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <span>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 /** Tag for ghosts communications. */
@@ -89,6 +96,75 @@ private:
   std::vector<char> bondbuf; ///< Buffer for bond lists
 };
 
+/**
+ * @brief Point-to-point message of a ghost communication.
+ * The persistent MPI request is set up once and reused as long as the
+ * message size doesn't change, i.e. between two particle resorts.
+ */
+class PersistentMessage {
+  CommBuf m_buffer;
+  MPI_Request m_request = MPI_REQUEST_NULL;
+
+  void free_request() {
+    if (m_request != MPI_REQUEST_NULL and
+        not boost::mpi::environment::finalized()) {
+      MPI_Request_free(&m_request);
+    }
+    m_request = MPI_REQUEST_NULL;
+  }
+
+public:
+  PersistentMessage() = default;
+  PersistentMessage(PersistentMessage const &) = delete;
+  PersistentMessage &operator=(PersistentMessage const &) = delete;
+  ~PersistentMessage() { free_request(); }
+
+  CommBuf &buffer() { return m_buffer; }
+
+  /** @brief Resize the buffer and set up the request if needed. */
+  void init(boost::mpi::communicator const &comm,
+            GhostCommunication const &ghost_comm, std::size_t size) {
+    if (m_request != MPI_REQUEST_NULL and m_buffer.size() == size) {
+      return;
+    }
+    free_request();
+    m_buffer.resize(size);
+    auto const count = static_cast<int>(size);
+    if ((ghost_comm.type & GHOST_JOBMASK) == GHOST_SEND) {
+      BOOST_MPI_CHECK_RESULT(MPI_Send_init,
+                             (m_buffer.data(), count, MPI_BYTE,
+                              ghost_comm.node, REQ_GHOST_SEND,
+                              static_cast<MPI_Comm>(comm), &m_request));
+    } else {
+      BOOST_MPI_CHECK_RESULT(MPI_Recv_init,
+                             (m_buffer.data(), count, MPI_BYTE,
+                              ghost_comm.node, REQ_GHOST_SEND,
+                              static_cast<MPI_Comm>(comm), &m_request));
+    }
+  }
+
+  void start() { BOOST_MPI_CHECK_RESULT(MPI_Start, (&m_request)); }
+
+  void wait() {
+    BOOST_MPI_CHECK_RESULT(MPI_Wait, (&m_request, MPI_STATUS_IGNORE));
+  }
+};
+
+struct GhostCommunicationCache {
+  explicit GhostCommunicationCache(std::size_t n_communications)
+      : messages(n_communications) {}
+
+  /** Message size per particle, for each combination of data parts. */
+  std::unordered_map<unsigned int, std::size_t> transmit_size;
+  /** Buffers of the collective operations and of the bond lists. */
+  CommBuf send_buffer, recv_buffer;
+  /** Point-to-point message of each communication. */
+  std::vector<PersistentMessage> messages;
+  /** For each communication, one past the last communication that is
+   *  posted together with it. */
+  std::vector<std::size_t> group_end;
+};
+
 /** @brief Pseudo-archive to calculate the size of the serialization buffer. */
 class SerializationSizeCalculator {
   std::size_t m_size = 0;
@@ -226,16 +302,36 @@ serialize_and_reduce(Archive &ar, Particle &p, unsigned int data_parts,
 #endif
 }
 
-static auto calc_transmit_size(BoxGeometry const &box_geo,
+static auto calc_transmit_size(GhostCommunicationCache &cache,
+                               BoxGeometry const &box_geo,
                                unsigned data_parts) {
+  /* the size only depends on the data parts, cache it to avoid
+   * constructing a particle in every communication step */
+  auto &transmit_size = cache.transmit_size;
+  if (auto const it = transmit_size.find(data_parts);
+      it != transmit_size.end()) {
+    return it->second;
+  }
   SerializationSizeCalculator sizeof_archive;
   Particle p{};
   serialize_and_reduce(sizeof_archive, p, data_parts, ReductionPolicy::MOVE,
                        SerializationDirection::SAVE, box_geo, nullptr);
+  transmit_size[data_parts] = sizeof_archive.size();
   return sizeof_archive.size();
 }
 
-static auto calc_transmit_size(GhostCommunication const &ghost_comm,
+/**
+ * @brief Whether the communication carries bond lists.
+ * Bond lists have a variable size and are sent as a separate message;
+ * all other data parts have a fixed size per particle and are sent as
+ * raw bytes in a single message whose size is known on both sides.
+ */
+static bool has_bonds(unsigned int data_parts) {
+  return data_parts & GHOSTTRANS_BONDS;
+}
+
+static auto calc_transmit_size(GhostCommunicationCache &cache,
+                               GhostCommunication const &ghost_comm,
                                BoxGeometry const &box_geo,
                                unsigned int data_parts) {
   if (data_parts & GHOSTTRANS_PARTNUM)
@@ -245,26 +341,22 @@ static auto calc_transmit_size(GhostCommunication const &ghost_comm,
       ghost_comm.part_lists, std::size_t{0},
       [](std::size_t sum, auto part_list) { return sum + part_list->size(); });
 
-  return n_part * calc_transmit_size(box_geo, data_parts);
+  return n_part * calc_transmit_size(cache, box_geo, data_parts);
 }
 
-static void prepare_send_buffer(CommBuf &send_buffer,
+static void prepare_send_buffer(GhostCommunicationCache &cache,
+                                CommBuf &send_buffer,
                                 GhostCommunication const &ghost_comm,
                                 BoxGeometry const &box_geo,
                                 unsigned int data_parts) {
 
   /* reallocate send buffer */
-  send_buffer.resize(calc_transmit_size(ghost_comm, box_geo, data_parts));
+  send_buffer.resize(
+      calc_transmit_size(cache, ghost_comm, box_geo, data_parts));
   send_buffer.bonds().clear();
 
   auto archiver = Utils::MemcpyOArchive{send_buffer.make_span()};
 
-  /* Construct archive that pushes back to the bond buffer */
-  namespace io = boost::iostreams;
-  io::stream<io::back_insert_device<std::vector<char>>> os{
-      io::back_inserter(send_buffer.bonds())};
-  boost::archive::binary_oarchive bond_archiver{os};
-
   /* put in data */
   for (auto part_list : ghost_comm.part_lists) {
     if (data_parts & GHOSTTRANS_PARTNUM) {
@@ -276,14 +368,25 @@ static void prepare_send_buffer(CommBuf &send_buffer,
         serialize_and_reduce(archiver, p, data_parts, ReductionPolicy::MOVE,
                              SerializationDirection::SAVE, box_geo,
                              &ghost_comm.shift);
-        if (data_parts & GHOSTTRANS_BONDS) {
-          bond_archiver << p.bonds();
-        }
       }
     }
   }
 
   assert(archiver.bytes_written() == send_buffer.size());
+
+  if (has_bonds(data_parts) and not(data_parts & GHOSTTRANS_PARTNUM)) {
+    /* Construct archive that pushes back to the bond buffer */
+    namespace io = boost::iostreams;
+    io::stream<io::back_insert_device<std::vector<char>>> os{
+        io::back_inserter(send_buffer.bonds())};
+    boost::archive::binary_oarchive bond_archiver{os};
+
+    for (auto part_list : ghost_comm.part_lists) {
+      for (auto &p : *part_list) {
+        bond_archiver << p.bonds();
+      }
+    }
+  }
 }
 
 static void prepare_ghost_cell(ParticleList *cell, std::size_t size) {
@@ -296,12 +399,14 @@ static void prepare_ghost_cell(ParticleList *cell, std::size_t size) {
   }
 }
 
-static void prepare_recv_buffer(CommBuf &recv_buffer,
+static void prepare_recv_buffer(GhostCommunicationCache &cache,
+                                CommBuf &recv_buffer,
                                 GhostCommunication const &ghost_comm,
                                 BoxGeometry const &box_geo,
                                 unsigned int data_parts) {
   /* reallocate recv buffer */
-  recv_buffer.resize(calc_transmit_size(ghost_comm, box_geo, data_parts));
+  recv_buffer.resize(
+      calc_transmit_size(cache, ghost_comm, box_geo, data_parts));
   /* clear bond buffer */
   recv_buffer.bonds().clear();
 }
@@ -374,12 +479,29 @@ static void add_forces_from_recv_buffer(CommBuf &recv_buffer,
   }
 }
 
-static void cell_cell_transfer(GhostCommunication const &ghost_comm,
+/** Write back received data; forces are added, the rest overwritten. */
+static void store_recv_buffer(CommBuf &recv_buffer,
+                              GhostCommunication const &ghost_comm,
+                              BoxGeometry const &box_geo,
+                              unsigned int data_parts, int comm_type) {
+  /* the addition is integrated into the communication for RDCE */
+  if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
+    add_forces_from_recv_buffer(recv_buffer, ghost_comm);
+#ifdef BOND_CONSTRAINT
+  else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
+    add_rattle_correction_from_recv_buffer(recv_buffer, ghost_comm);
+#endif
+  else
+    put_recv_buffer(recv_buffer, ghost_comm, box_geo, data_parts);
+}
+
+static void cell_cell_transfer(GhostCommunicationCache &cache,
+                               GhostCommunication const &ghost_comm,
                                BoxGeometry const &box_geo,
                                unsigned int data_parts) {
   CommBuf buffer;
   if (!(data_parts & GHOSTTRANS_PARTNUM)) {
-    buffer.resize(calc_transmit_size(box_geo, data_parts));
+    buffer.resize(calc_transmit_size(cache, box_geo, data_parts));
   }
   /* transfer data */
   auto const offset = ghost_comm.part_lists.size() / 2;
@@ -423,6 +545,122 @@ static bool is_recv_op(int comm_type, int node, int this_node) {
           (comm_type == GHOST_RDCE && node == this_node));
 }
 
+/** Whether a communication writes to a cell that another one reads. */
+using CellSet = std::unordered_set<ParticleList const *>;
+
+/** Whether a communication reads or writes any of the given cells. */
+static bool accesses_cells(GhostCommunication const &ghost_comm,
+                           CellSet const &cells) {
+  return std::ranges::any_of(ghost_comm.part_lists, [&cells](auto cell) {
+    return cells.contains(cell);
+  });
+}
+
+/**
+ * @brief Whether two communications are a point-to-point send and receive
+ * that can be posted together. A send that follows a receive must not
+ * read the received cells, unless it is flagged for prefetching.
+ */
+static bool is_exchange_pair(GhostCommunication const &first,
+                             GhostCommunication const &second) {
+  int const first_type = first.type & GHOST_JOBMASK;
+  int const second_type = second.type & GHOST_JOBMASK;
+  if (first_type == GHOST_SEND and second_type == GHOST_RECV) {
+    return true;
+  }
+  return first_type == GHOST_RECV and second_type == GHOST_SEND and
+         ((second.type & GHOST_PREFETCH) or
+          not accesses_cells(second, CellSet(first.part_lists.begin(),
+                                             first.part_lists.end())));
+}
+
+/**
+ * @brief Group the point-to-point communications posted together.
+ * A group is a run of consecutive exchange pairs in which no pair sends
+ * cells received by the pairs before it.
+ * @return For the first communication of each group, one past the last
+ * communication of the group.
+ */
+static auto group_exchanges(GhostCommunicator const &gcr) {
+  auto const &communications = gcr.communications;
+  auto const is_send = [](GhostCommunication const &ghost_comm) {
+    return (ghost_comm.type & GHOST_JOBMASK) == GHOST_SEND;
+  };
+  std::vector<std::size_t> group_end(communications.size());
+  for (std::size_t first = 0; first < communications.size();) {
+    auto last = first;
+    CellSet received;
+    while (last + 1 < communications.size() and
+           is_exchange_pair(communications[last], communications[last + 1])) {
+      auto const pair = std::span(communications).subspan(last, 2);
+      if (std::ranges::any_of(pair, [&](GhostCommunication const &c) {
+            return is_send(c) and accesses_cells(c, received);
+          })) {
+        break;
+      }
+      for (auto const &c : pair) {
+        if (not is_send(c)) {
+          received.insert(c.part_lists.begin(), c.part_lists.end());
+        }
+      }
+      last += 2;
+    }
+    group_end[first] = std::max(last, first + 1);
+    first = group_end[first];
+  }
+  return group_end;
+}
+
+GhostCommunicationCache &
+GhostCommunicationCacheHandle::get(GhostCommunicator const &gcr) const {
+  if (not m_cache or m_cache->messages.size() != gcr.communications.size()) {
+    m_cache =
+        std::make_shared<GhostCommunicationCache>(gcr.communications.size());
+    m_cache->group_end = group_exchanges(gcr);
+  }
+  return *m_cache;
+}
+
+/**
+ * @brief Exchange point-to-point messages with persistent requests.
+ * All send buffers are packed before the messages are posted, and the
+ * received data is stored once all messages have arrived.
+ * @param overlap Work to run while the messages are in flight.
+ */
+static void exchange_messages(GhostCommunicator const &gcr,
+                              GhostCommunicationCache &cache,
+                              BoxGeometry const &box_geo,
+                              unsigned int data_parts, std::size_t first,
+                              std::size_t last,
+                              std::function<void()> const &overlap) {
+  for (auto i = first; i < last; ++i) {
+    auto const &ghost_comm = gcr.communications[i];
+    auto &message = cache.messages[i];
+    message.init(gcr.mpi_comm, ghost_comm,
+                 calc_transmit_size(cache, ghost_comm, box_geo, data_parts));
+    if ((ghost_comm.type & GHOST_JOBMASK) == GHOST_SEND) {
+      prepare_send_buffer(cache, message.buffer(), ghost_comm, box_geo,
+                          data_parts);
+    }
+  }
+  for (auto i = first; i < last; ++i) {
+    cache.messages[i].start();
+  }
+  if (overlap) {
+    overlap();
+  }
+  for (auto i = first; i < last; ++i) {
+    cache.messages[i].wait();
+  }
+  for (auto i = first; i < last; ++i) {
+    auto const &ghost_comm = gcr.communications[i];
+    if ((ghost_comm.type & GHOST_JOBMASK) == GHOST_RECV) {
+      store_recv_buffer(cache.messages[i].buffer(), ghost_comm, box_geo,
+                        data_parts, GHOST_RECV);
+    }
+  }
+}
+
 static bool is_prefetchable(GhostCommunication const &ghost_comm,
                             int this_node) {
   int const comm_type = ghost_comm.type & GHOST_JOBMASK;
@@ -440,13 +678,20 @@ static bool is_poststorable(GhostCommunication const &ghost_comm,
 }
 
 void ghost_communicator(GhostCommunicator const &gcr,
-                        BoxGeometry const &box_geo, unsigned int data_parts) {
-  if (GHOSTTRANS_NONE == data_parts)
+                        BoxGeometry const &box_geo, unsigned int data_parts,
+                        std::function<void()> const &overlap) {
+  if (GHOSTTRANS_NONE == data_parts) {
+    if (overlap)
+      overlap();
     return;
+  }
 
-  static CommBuf send_buffer, recv_buffer;
+  auto &cache = gcr.cache.get(gcr);
+  auto &send_buffer = cache.send_buffer;
+  auto &recv_buffer = cache.recv_buffer;
 
   auto const &comm = gcr.mpi_comm;
+  auto overlapped = not overlap;
 
   for (auto it = gcr.communications.begin(); it != gcr.communications.end();
        ++it) {
@@ -454,7 +699,26 @@ void ghost_communicator(GhostCommunicator const &gcr,
     int const comm_type = ghost_comm.type & GHOST_JOBMASK;
 
     if (comm_type == GHOST_LOCL) {
-      cell_cell_transfer(ghost_comm, box_geo, data_parts);
+      cell_cell_transfer(cache, ghost_comm, box_geo, data_parts);
+      continue;
+    }
+
+    /* messages without bond lists have a fixed size between resorts
+     * and are sent with persistent requests */
+    if (not has_bonds(data_parts) and
+        (comm_type == GHOST_SEND or comm_type == GHOST_RECV)) {
+      auto const first = static_cast<std::size_t>(
+          std::distance(gcr.communications.begin(), it));
+      auto const last = cache.group_end[first];
+      if (not overlapped and last - first > 1) {
+        /* run the overlapping work while the first group is in flight */
+        exchange_messages(gcr, cache, box_geo, data_parts, first, last,
+                          overlap);
+        overlapped = true;
+      } else {
+        exchange_messages(gcr, cache, box_geo, data_parts, first, last, {});
+      }
+      it += static_cast<std::ptrdiff_t>(last - first - 1);
       continue;
     }
 
@@ -466,12 +730,13 @@ void ghost_communicator(GhostCommunicator const &gcr,
     if (is_send_op(comm_type, node, comm.rank())) {
       /* ok, we send this step, prepare send buffer if not yet done */
       if (!prefetch) {
-        prepare_send_buffer(send_buffer, ghost_comm, box_geo, data_parts);
+        prepare_send_buffer(cache, send_buffer, ghost_comm, box_geo,
+                            data_parts);
       }
       // Check prefetched send buffers (must also hold for buffers allocated
       // in the previous lines.)
       assert(send_buffer.size() ==
-             calc_transmit_size(ghost_comm, box_geo, data_parts));
+             calc_transmit_size(cache, ghost_comm, box_geo, data_parts));
     } else if (prefetch) {
       /* we do not send this time, let's look for a prefetch */
       auto prefetch_ghost_comm = std::find_if(
@@ -481,37 +746,48 @@ void ghost_communicator(GhostCommunicator const &gcr,
           });
 
       if (prefetch_ghost_comm != gcr.communications.end())
-        prepare_send_buffer(send_buffer, *prefetch_ghost_comm, box_geo,
-                            data_parts);
+        prepare_send_buffer(cache, send_buffer, *prefetch_ghost_comm,
+                            box_geo, data_parts);
     }
 
     /* recv buffer for recv and multinode operations to this node */
     if (is_recv_op(comm_type, node, comm.rank()))
-      prepare_recv_buffer(recv_buffer, ghost_comm, box_geo, data_parts);
+      prepare_recv_buffer(cache, recv_buffer, ghost_comm, box_geo,
+                          data_parts);
 
     /* transfer data */
     // Use two send/recvs in order to avoid having to serialize CommBuf
     // (which consists of already serialized data).
     switch (comm_type) {
+    // The bond buffer is only exchanged when bonds are transferred, such
+    // that position and force updates only need a single message.
     case GHOST_RECV:
       comm.recv(node, REQ_GHOST_SEND, recv_buffer.data(),
                 static_cast<int>(recv_buffer.size()));
-      comm.recv(node, REQ_GHOST_SEND, recv_buffer.bonds());
+      if (has_bonds(data_parts)) {
+        comm.recv(node, REQ_GHOST_SEND, recv_buffer.bonds());
+      }
       break;
     case GHOST_SEND:
       comm.send(node, REQ_GHOST_SEND, send_buffer.data(),
                 static_cast<int>(send_buffer.size()));
-      comm.send(node, REQ_GHOST_SEND, send_buffer.bonds());
+      if (has_bonds(data_parts)) {
+        comm.send(node, REQ_GHOST_SEND, send_buffer.bonds());
+      }
       break;
     case GHOST_BCST:
       if (node == comm.rank()) {
         boost::mpi::broadcast(comm, send_buffer.data(),
                               static_cast<int>(send_buffer.size()), node);
-        boost::mpi::broadcast(comm, send_buffer.bonds(), node);
+        if (has_bonds(data_parts)) {
+          boost::mpi::broadcast(comm, send_buffer.bonds(), node);
+        }
       } else {
         boost::mpi::broadcast(comm, recv_buffer.data(),
                               static_cast<int>(recv_buffer.size()), node);
-        boost::mpi::broadcast(comm, recv_buffer.bonds(), node);
+        if (has_bonds(data_parts)) {
+          boost::mpi::broadcast(comm, recv_buffer.bonds(), node);
+        }
       }
       break;
     case GHOST_RDCE:
@@ -532,16 +808,8 @@ void ghost_communicator(GhostCommunicator const &gcr,
     // recv op; write back data directly, if no PSTSTORE delay is requested.
     if (is_recv_op(comm_type, node, comm.rank())) {
       if (!poststore) {
-        /* forces have to be added, the rest overwritten. Exception is RDCE,
-         * where the addition is integrated into the communication. */
-        if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-          add_forces_from_recv_buffer(recv_buffer, ghost_comm);
-#ifdef BOND_CONSTRAINT
-        else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
-          add_rattle_correction_from_recv_buffer(recv_buffer, ghost_comm);
-#endif
-        else
-          put_recv_buffer(recv_buffer, ghost_comm, box_geo, data_parts);
+        store_recv_buffer(recv_buffer, ghost_comm, box_geo, data_parts,
+                          comm_type);
       }
     } else if (poststore) {
       /* send op; write back delayed data from last recv, when this was a
@@ -554,20 +822,17 @@ void ghost_communicator(GhostCommunicator const &gcr,
           });
 
       if (poststore_ghost_comm != gcr.communications.rend()) {
-        assert(recv_buffer.size() ==
-               calc_transmit_size(*poststore_ghost_comm, box_geo, data_parts));
-        /* as above */
-        if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-          add_forces_from_recv_buffer(recv_buffer, *poststore_ghost_comm);
-#ifdef BOND_CONSTRAINT
-        else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
-          add_rattle_correction_from_recv_buffer(recv_buffer,
-                                                 *poststore_ghost_comm);
-#endif
-        else
-          put_recv_buffer(recv_buffer, *poststore_ghost_comm, box_geo,
-                          data_parts);
+        assert(recv_buffer.size() == calc_transmit_size(cache,
+                                                        *poststore_ghost_comm,
+                                                        box_geo, data_parts));
+        store_recv_buffer(recv_buffer, *poststore_ghost_comm, box_geo,
+                          data_parts, comm_type);
       }
     }
   }
+
+  /* no exchange to overlap with */
+  if (not overlapped) {
+    overlap();
+  }
 }
@@ -93,6 +93,8 @@
 #include <boost/mpi/communicator.hpp>
 
 #include <cstddef>
+#include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -153,6 +155,35 @@ struct GhostCommunication {
   Utils::Vector3d shift = {};
 };
 
+struct GhostCommunicator;
+
+/** Buffers and persistent MPI requests of a ghost communicator. */
+struct GhostCommunicationCache;
+
+/**
+ * @brief Handle to the lazily created @ref GhostCommunicationCache.
+ * The cache refers to the communications of its owner, hence a copy
+ * of the handle starts with an empty cache.
+ */
+class GhostCommunicationCacheHandle {
+  mutable std::shared_ptr<GhostCommunicationCache> m_cache;
+
+public:
+  GhostCommunicationCacheHandle() = default;
+  GhostCommunicationCacheHandle(GhostCommunicationCacheHandle const &) {}
+  GhostCommunicationCacheHandle(GhostCommunicationCacheHandle &&) = default;
+  GhostCommunicationCacheHandle &
+  operator=(GhostCommunicationCacheHandle const &) {
+    m_cache.reset();
+    return *this;
+  }
+  GhostCommunicationCacheHandle &
+  operator=(GhostCommunicationCacheHandle &&) = default;
+
+  /** @brief Get the cache, created on first use by @p gcr. */
+  GhostCommunicationCache &get(GhostCommunicator const &gcr) const;
+};
+
 /** Properties for a ghost communication. */
 struct GhostCommunicator {
   GhostCommunicator() = default;
@@ -164,10 +195,27 @@ struct GhostCommunicator {
 
   /** List of ghost communications. */
   std::vector<GhostCommunication> communications;
+
+  /** Buffers reused by every call to @ref ghost_communicator. */
+  GhostCommunicationCacheHandle cache;
 };
 
 /**
  * @brief Do a ghost communication with the specified data parts.
+ *
+ * Point-to-point messages without bond lists are sent with persistent
+ * MPI requests, which are set up again when the message sizes change.
+ * Consecutive pairs of a send and a receive operation are posted
+ * together, as long as no send reads cells received by the pairs before
+ * it. With the half-shell scheme, this covers all exchanges; with the
+ * full-shell scheme, the exchanges of a direction forward the ghost
+ * layers received in the previous directions, hence each direction is
+ * posted separately.
+ *
+ * If @p overlap is set, it is run while the first group of messages is
+ * in flight. @p overlap must not access the particles that are
+ * communicated.
  */
 void ghost_communicator(GhostCommunicator const &gcr,
-                        BoxGeometry const &box_geo, unsigned int data_parts);
+                        BoxGeometry const &box_geo, unsigned int data_parts,
+                        std::function<void()> const &overlap = {});
@@ -41,6 +41,8 @@
 #include "bond_breakage/bond_breakage.hpp"
 #include "bonded_interactions/bonded_interaction_data.hpp"
 #include "cell_system/CellStructure.hpp"
+#include "cell_system/LoadBalancer.hpp"
+#include "cell_system/VerletSkinTuner.hpp"
 #include "cells.hpp"
 #include "collision_detection/CollisionDetection.hpp"
 #include "communication.hpp"
@@ -72,6 +74,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <csignal>
 #include <functional>
@@ -132,7 +135,8 @@ void Propagation::update_default_propagation(int thermo_switch) {
   case INTEG_METHOD_STEEPEST_DESCENT:
     default_propagation = PropagationMode::NONE;
     break;
-  case INTEG_METHOD_NVT: {
+  case INTEG_METHOD_NVT:
+  case INTEG_METHOD_RESPA: {
     // NOLINTNEXTLINE(bugprone-branch-clone)
     if ((thermo_switch & THERMO_LB) and (thermo_switch & THERMO_LANGEVIN)) {
       default_propagation = PropagationMode::TRANS_LB_MOMENTUM_EXCHANGE;
@@ -208,6 +212,12 @@ void System::System::integrator_sanity_checks() const {
                            "currently active combination of thermostats";
     }
   }
+  if (propagation->integ_switch == INTEG_METHOD_RESPA) {
+    if (thermo_switch & (THERMO_NPT_ISO | THERMO_BROWNIAN | THERMO_SD)) {
+      runtimeErrorMsg() << "The RESPA integrator is incompatible with the "
+                           "currently active combination of thermostats";
+    }
+  }
 #ifdef NPT
   if (propagation->used_propagations & PropagationMode::TRANS_LANGEVIN_NPT) {
     if (thermo_switch != THERMO_NPT_ISO) {
@@ -237,6 +247,32 @@ void System::System::integrator_sanity_checks() const {
       runtimeErrorMsg() << "The LB integrator requires the LB thermostat";
     }
   }
+  if (cell_structure->has_half_ghost_shell()) {
+    /* bond partners and LB coupling need ghosts on all sides */
+    for (auto const &p : cell_structure->local_particles()) {
+      if (not p.bonds().empty()) {
+        runtimeErrorMsg() << "The half-shell ghost scheme doesn't support "
+                             "bonded interactions";
+        break;
+      }
+    }
+    if (lb.is_solver_set()) {
+      runtimeErrorMsg() << "The half-shell ghost scheme doesn't support LB";
+    }
+    /* the box type can change after the ghost shell was set */
+    if (box_geo->type() == BoxType::LEES_EDWARDS) {
+      runtimeErrorMsg()
+          << "The half-shell ghost scheme doesn't support Lees-Edwards";
+    }
+#ifdef VIRTUAL_SITES_RELATIVE
+    /* reference particles can be on any side of a virtual site */
+    if (propagation->used_propagations & (PropagationMode::TRANS_VS_RELATIVE |
+                                          PropagationMode::ROT_VS_RELATIVE)) {
+      runtimeErrorMsg() << "The half-shell ghost scheme doesn't support "
+                           "virtual sites relative";
+    }
+#endif
+  }
   if (bonded_ias->get_n_thermalized_bonds() >= 1 and
       (thermostat->thermalized_bond == nullptr or
        (thermo_switch & THERMO_BOND) == 0)) {
@@ -306,9 +342,7 @@ static void resort_particles_if_needed(System::System &system) {
   auto &cell_structure = *system.cell_structure;
   auto const offset = LeesEdwards::verlet_list_offset(
       *system.box_geo, cell_structure.get_le_pos_offset_at_last_resort());
-  if (cell_structure.check_resort_required(offset)) {
-    cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
-  }
+  cell_structure.resort_particles_if_displaced(offset);
 }
 
 void System::System::thermostat_force_init() {
@@ -320,7 +354,7 @@ void System::System::thermostat_force_init() {
   }
   auto const &langevin = *thermostat->langevin;
   auto const kT = thermostat->kT;
-  for (auto &p : cell_structure->local_particles()) {
+  cell_structure->for_each_local_particle([&](Particle &p) {
     if (propagation.should_propagate_with(p, PropagationMode::TRANS_LANGEVIN))
       p.force() += friction_thermo_langevin(langevin, p, time_step, kT);
 #ifdef ROTATION
@@ -328,7 +362,7 @@ void System::System::thermostat_force_init() {
       p.torque() += convert_vector_body_to_space(
           p, friction_thermo_langevin_rotation(langevin, p, time_step, kT));
 #endif
-  }
+  });
 }
 
 /** @brief Calls the hook for propagation kernels before the force calculation
@@ -343,11 +377,11 @@ static bool integrator_step_1(ParticleRange const &particles,
 
   auto const &thermostat = *system.thermostat;
   auto const kT = thermostat.kT;
-  for (auto &p : particles) {
+  system.cell_structure->for_each_local_particle([&](Particle &p) {
 #ifdef VIRTUAL_SITES
     // virtual sites are updated later in the integration loop
     if (p.is_virtual())
-      continue;
+      return;
 #endif
     if (propagation.should_propagate_with(
             p, PropagationMode::TRANS_LB_MOMENTUM_EXCHANGE))
@@ -370,7 +404,7 @@ static bool integrator_step_1(ParticleRange const &particles,
     if (propagation.should_propagate_with(p, PropagationMode::ROT_BROWNIAN))
       brownian_dynamics_rotator(*thermostat.brownian, p, time_step, kT);
 #endif
-  }
+  });
 
 #ifdef NPT
   if ((propagation.used_propagations & PropagationMode::TRANS_LANGEVIN_NPT) and
@@ -395,16 +429,15 @@ static bool integrator_step_1(ParticleRange const &particles,
 
 static void integrator_step_2(ParticleRange const &particles,
                               Propagation const &propagation,
-                              Thermostat::Thermostat const &thermostat,
-                              double time_step) {
+                              System::System &system, double time_step) {
   if (propagation.integ_switch == INTEG_METHOD_STEEPEST_DESCENT)
     return;
 
-  for (auto &p : particles) {
+  system.cell_structure->for_each_local_particle([&](Particle &p) {
 #ifdef VIRTUAL_SITES
     // virtual sites are updated later in the integration loop
     if (p.is_virtual())
-      continue;
+      return;
 #endif
     if (propagation.should_propagate_with(
             p, PropagationMode::TRANS_LB_MOMENTUM_EXCHANGE))
@@ -421,14 +454,14 @@ static void integrator_step_2(ParticleRange const &particles,
     if (propagation.should_propagate_with(p, PropagationMode::ROT_LANGEVIN))
       velocity_verlet_rotator_2(p, time_step);
 #endif
-  }
+  });
 
 #ifdef NPT
   if ((propagation.used_propagations & PropagationMode::TRANS_LANGEVIN_NPT) and
       (propagation.default_propagation & PropagationMode::TRANS_LANGEVIN_NPT)) {
     auto pred = PropagationPredicateNPT(propagation.default_propagation);
-    velocity_verlet_npt_step_2(particles.filter(pred), *thermostat.npt_iso,
-                               time_step);
+    velocity_verlet_npt_step_2(particles.filter(pred),
+                               *system.thermostat->npt_iso, time_step);
   }
 #endif
 }
@@ -472,9 +505,13 @@ int System::System::integrate(int n_steps, int reuse_forces) {
     }
 #endif
 
-    // Communication step: distribute ghost positions
-    cell_structure->update_ghosts_and_resort_particle(get_global_ghost_flags());
+    // Communication step: distribute ghost positions, may be completed
+    // during the force calculation
+    cell_structure->update_ghosts_and_resort_particle(get_global_ghost_flags(),
+                                                      true);
 
+    // the first force calculation starts a RESPA outer step
+    propagation.respa_inner_step = 0;
     calculate_forces();
 
     if (propagation.integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
@@ -524,6 +561,7 @@ int System::System::integrate(int n_steps, int reuse_forces) {
 #ifdef CALIPER
     CALI_CXX_MARK_LOOP_ITERATION(integration_loop, step);
 #endif
+    auto const step_start = std::chrono::steady_clock::now();
 
     auto particles = cell_structure->local_particles();
 
@@ -578,12 +616,22 @@ int System::System::integrate(int n_steps, int reuse_forces) {
     if (cell_structure->get_resort_particles() >= Cells::RESORT_LOCAL)
       n_verlet_updates++;
 
-    // Communication step: distribute ghost positions
-    cell_structure->update_ghosts_and_resort_particle(get_global_ghost_flags());
+    // Communication step: distribute ghost positions, may be completed
+    // during the force calculation
+    cell_structure->update_ghosts_and_resort_particle(get_global_ghost_flags(),
+                                                      true);
 
     particles = cell_structure->local_particles();
 
-    calculate_forces();
+    if (load_balancer->measures_force_time()) {
+      auto const start = std::chrono::steady_clock::now();
+      calculate_forces();
+      auto const stop = std::chrono::steady_clock::now();
+      load_balancer->add_force_time(
+          std::chrono::duration<double>(stop - start).count());
+    } else {
+      calculate_forces();
+    }
 
 #ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
     if (thermostat->lb and
@@ -592,7 +640,7 @@ int System::System::integrate(int n_steps, int reuse_forces) {
                                              *local_geo, lb);
     }
 #endif
-    integrator_step_2(particles, propagation, *thermostat, time_step);
+    integrator_step_2(particles, propagation, *this, time_step);
     if (propagation.integ_switch == INTEG_METHOD_BD) {
       resort_particles_if_needed(*this);
     }
@@ -670,6 +718,16 @@ int System::System::integrate(int n_steps, int reuse_forces) {
 
     integrated_steps++;
 
+    if (load_balancer->step()) {
+      rebalance_domains();
+    }
+
+    auto const step_stop = std::chrono::steady_clock::now();
+    if (skin_tuner->step(
+            std::chrono::duration<double>(step_stop - step_start).count())) {
+      autotune_verlet_skin();
+    }
+
     if (check_runtime_errors(comm_cart)) {
       caught_error = true;
       break;
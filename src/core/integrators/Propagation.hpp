@@ -30,6 +30,10 @@ public:
   int default_propagation = PropagationMode::NONE;
   int lb_skipped_md_steps = 0;
   int ek_skipped_md_steps = 0;
+  /** Number of time steps between two long-range force calculations. */
+  int respa_n_inner_steps = 1;
+  /** Number of force calculations since the last long-range one. */
+  int respa_inner_step = 0;
   /** If true, forces will be recalculated before the next integration. */
   bool recalc_forces = true;
 
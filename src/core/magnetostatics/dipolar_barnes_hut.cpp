@@ -0,0 +1,582 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config/config.hpp"
+
+#ifdef DIPOLES
+
+#include "magnetostatics/dipolar_barnes_hut.hpp"
+#include "magnetostatics/dipolar_common.hpp"
+
+#include "BoxGeometry.hpp"
+#include "Particle.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/int_pow.hpp>
+
+#include <boost/mpi/collectives.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/** @brief Maximal number of particles in a leaf of the tree. */
+auto constexpr max_leaf_size = 8;
+
+/** @brief Maximal depth of the tree, guards against coincident particles. */
+auto constexpr max_depth = 32;
+
+/** @brief Magnetic particle sorted into the tree. */
+struct Source {
+  Utils::Vector3d pos;
+  Utils::Vector3d m;
+  /** @brief Index in the gathered particle array. */
+  int id;
+};
+
+/**
+ * @brief Multi-indices of a Cartesian Taylor expansion, sorted by degree.
+ * Multi-indices of degree up to @c n occupy the first
+ * <tt>(n + 1)(n + 2)(n + 3)/6</tt> positions.
+ */
+class MultiIndices {
+  int m_max_degree;
+  std::vector<Utils::Vector3i> m_indices;
+  std::vector<int> m_lookup;
+
+  auto linear_index(Utils::Vector3i const &k) const {
+    return static_cast<std::size_t>((k[0] * (m_max_degree + 1) + k[1]) *
+                                        (m_max_degree + 1) +
+                                    k[2]);
+  }
+
+public:
+  explicit MultiIndices(int max_degree)
+      : m_max_degree{max_degree},
+        m_lookup(Utils::int_pow<3>(static_cast<std::size_t>(max_degree + 1)),
+                 -1) {
+    for (int n = 0; n <= max_degree; ++n) {
+      for (int i = n; i >= 0; --i) {
+        for (int j = n - i; j >= 0; --j) {
+          auto const k = Utils::Vector3i{{i, j, n - i - j}};
+          m_lookup[linear_index(k)] = size();
+          m_indices.emplace_back(k);
+        }
+      }
+    }
+  }
+
+  static int count(int degree) {
+    return (degree + 1) * (degree + 2) * (degree + 3) / 6;
+  }
+  int size() const { return static_cast<int>(m_indices.size()); }
+  auto const &operator[](int index) const {
+    return m_indices[static_cast<std::size_t>(index)];
+  }
+  /** @brief Position of a multi-index, -1 if it is out of range. */
+  int find(Utils::Vector3i const &k) const {
+    if (std::ranges::min(k) < 0 or k[0] + k[1] + k[2] > m_max_degree) {
+      return -1;
+    }
+    return m_lookup[linear_index(k)];
+  }
+};
+
+/**
+ * @brief Cartesian multipole expansion of a dipole distribution.
+ *
+ * The magnetic scalar potential of dipoles @f$ \vec{m}_j @f$ at positions
+ * @f$ \vec{c} + \vec{\delta}_j @f$ is expanded around @f$ \vec{c} @f$:
+ * @f[
+ *   \phi(\vec{c} + \vec{R}) = \sum_j \vec{m}_j \cdot \nabla_{\vec{s}}
+ *   \frac{1}{|\vec{c} + \vec{R} - \vec{s}|}\bigg|_{\vec{s} = \vec{c} +
+ *   \vec{\delta}_j} \approx \sum_{1 \leq |k| \leq p} a_k(\vec{R}) Q_k
+ * @f]
+ * with moments @f$ Q_k = \sum_j \sum_i k_i m_{j,i} \vec{\delta}_j^{k - e_i}
+ * @f$, and Taylor coefficients @f$ a_k = \partial^k_{\vec{s}} |\vec{R} -
+ * \vec{s}|^{-1}/k! @f$ obtained from the recurrence relation of
+ * @cite lindsay01a. The field and its gradient follow from
+ * @f$ \partial_{R_i} a_k = -(k_i + 1) a_{k + e_i} @f$.
+ */
+class DipolarExpansion {
+  int m_order;
+  MultiIndices m_indices;
+  int m_n_moments;
+  int m_n_coefficients;
+  /** @brief Positions of @f$ k - e_i @f$ and @f$ k - 2e_i @f$. */
+  std::vector<std::array<int, 3>> m_minus1, m_minus2;
+  /** @brief Positions of @f$ k + e_i @f$. */
+  std::vector<std::array<int, 3>> m_plus1;
+  /** @brief Positions of @f$ k + e_i + e_l @f$. */
+  std::vector<std::array<int, 9>> m_plus2;
+
+public:
+  explicit DipolarExpansion(int order)
+      : m_order{order}, m_indices{order + 2},
+        m_n_moments{MultiIndices::count(order)},
+        m_n_coefficients{MultiIndices::count(order + 2)} {
+    for (int q = 0; q < m_n_coefficients; ++q) {
+      auto const &k = m_indices[q];
+      std::array<int, 3> minus1{}, minus2{}, plus1{};
+      std::array<int, 9> plus2{};
+      for (int i = 0; i < 3; ++i) {
+        auto const e_i = Utils::Vector3i{{i == 0, i == 1, i == 2}};
+        minus1[i] = m_indices.find(k - e_i);
+        minus2[i] = m_indices.find(k - 2 * e_i);
+        plus1[i] = m_indices.find(k + e_i);
+        for (int l = 0; l < 3; ++l) {
+          auto const e_l = Utils::Vector3i{{l == 0, l == 1, l == 2}};
+          plus2[3 * i + l] = m_indices.find(k + e_i + e_l);
+        }
+      }
+      m_minus1.emplace_back(minus1);
+      m_minus2.emplace_back(minus2);
+      m_plus1.emplace_back(plus1);
+      m_plus2.emplace_back(plus2);
+    }
+  }
+
+  auto n_moments() const { return m_n_moments; }
+  auto n_coefficients() const { return m_n_coefficients; }
+
+  /**
+   * @brief Add the moments of a dipole to a moment vector.
+   * @param[in]     delta     Dipole position relative to the center
+   * @param[in]     m         Dipole moment
+   * @param[in,out] monomials Buffer for the monomials of @p delta
+   * @param[in,out] moments   Moments
+   */
+  void add_moments(Utils::Vector3d const &delta, Utils::Vector3d const &m,
+                   std::vector<double> &monomials,
+                   std::span<double> moments) const {
+    auto const n_monomials = MultiIndices::count(m_order - 1);
+    monomials.resize(static_cast<std::size_t>(n_monomials));
+    monomials[0] = 1.;
+    for (int q = 1; q < n_monomials; ++q) {
+      auto const i = (m_indices[q][0] > 0) ? 0 : (m_indices[q][1] > 0) ? 1 : 2;
+      monomials[q] = monomials[m_minus1[q][i]] * delta[i];
+    }
+    for (int k = 1; k < m_n_moments; ++k) {
+      auto const &index = m_indices[k];
+      for (int i = 0; i < 3; ++i) {
+        if (index[i] > 0) {
+          moments[k] += index[i] * m[i] * monomials[m_minus1[k][i]];
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Calculate the Taylor coefficients of @f$ 1/|\vec{R}| @f$.
+   * @param[in]  R            Target position relative to the center
+   * @param[out] coefficients Taylor coefficients
+   */
+  void taylor_coefficients(Utils::Vector3d const &R,
+                           std::vector<double> &coefficients) const {
+    coefficients.resize(static_cast<std::size_t>(m_n_coefficients));
+    auto const r2_inv = 1. / R.norm2();
+    coefficients[0] = std::sqrt(r2_inv);
+    for (int q = 1; q < m_n_coefficients; ++q) {
+      auto const &k = m_indices[q];
+      auto const n = static_cast<double>(k[0] + k[1] + k[2]);
+      auto s1 = 0.;
+      auto s2 = 0.;
+      for (int i = 0; i < 3; ++i) {
+        if (m_minus1[q][i] != -1) {
+          s1 += R[i] * coefficients[m_minus1[q][i]];
+        }
+        if (m_minus2[q][i] != -1) {
+          s2 += coefficients[m_minus2[q][i]];
+        }
+      }
+      coefficients[q] = ((2. * n - 1.) * s1 - (n - 1.) * s2) * r2_inv / n;
+    }
+  }
+
+  /**
+   * @brief Add the dipole field of a moment vector and its action on a
+   * target dipole.
+   * @tparam with_force   Whether to calculate the force on the target
+   * @param[in]     coefficients Taylor coefficients
+   * @param[in]     moments      Moments
+   * @param[in]     m            Target dipole moment
+   * @param[in,out] field        Dipole field at the target
+   * @param[in,out] force        Force on the target dipole
+   */
+  template <bool with_force>
+  void add_field(std::vector<double> const &coefficients,
+                 std::span<double const> moments, Utils::Vector3d const &m,
+                 Utils::Vector3d &field, Utils::Vector3d &force) const {
+    for (int k = 1; k < m_n_moments; ++k) {
+      auto const Q_k = moments[k];
+      auto const &index = m_indices[k];
+      for (int i = 0; i < 3; ++i) {
+        field[i] += Q_k * (index[i] + 1) * coefficients[m_plus1[k][i]];
+        if constexpr (with_force) {
+          for (int l = 0; l < 3; ++l) {
+            auto const c = (index[i] + 1) * (index[l] + (i == l) + 1);
+            force[l] -= m[i] * Q_k * c * coefficients[m_plus2[k][3 * i + l]];
+          }
+        }
+      }
+    }
+  }
+};
+
+/**
+ * @brief Octree of magnetic particles with multipole moments.
+ */
+class Tree {
+public:
+  struct Node {
+    Utils::Vector3d center;
+    double half_size;
+    /** @brief Largest distance between a particle and the center. */
+    double radius;
+    int begin;
+    int end;
+    std::array<int, 8> children;
+    int n_children;
+  };
+
+  std::vector<Source> sources;
+  std::vector<Node> nodes;
+  std::vector<double> moments;
+
+  Tree(std::vector<PosMom> const &particles,
+       DipolarExpansion const &expansion) {
+    sources.reserve(particles.size());
+    for (int i = 0; auto const &p : particles) {
+      sources.emplace_back(Source{p.pos, p.m, i++});
+    }
+    if (sources.empty()) {
+      return;
+    }
+    auto lower = sources.front().pos;
+    auto upper = sources.front().pos;
+    for (auto const &s : sources) {
+      for (auto i = 0u; i < 3u; ++i) {
+        lower[i] = std::min(lower[i], s.pos[i]);
+        upper[i] = std::max(upper[i], s.pos[i]);
+      }
+    }
+    auto const half_size = 0.5 * std::ranges::max(upper - lower);
+    build(0, static_cast<int>(sources.size()), 0.5 * (lower + upper),
+          half_size, 0);
+    compute_moments(expansion);
+  }
+
+  auto get_moments(int node, int n_moments) const {
+    return std::span<double const>(moments).subspan(
+        static_cast<std::size_t>(node * n_moments),
+        static_cast<std::size_t>(n_moments));
+  }
+
+private:
+  int build(int begin, int end, Utils::Vector3d const &center,
+            double half_size, int depth) {
+    auto const index = static_cast<int>(nodes.size());
+    nodes.emplace_back(Node{center, half_size, 0., begin, end, {}, 0});
+    if (end - begin <= max_leaf_size or depth >= max_depth) {
+      return index;
+    }
+    // sort the particles into octants
+    std::array<int, 9> bounds{};
+    bounds[0] = begin;
+    bounds[8] = end;
+    auto const split = [this, &center](int first, int last, unsigned dim) {
+      auto const it = std::partition(
+          sources.begin() + first, sources.begin() + last,
+          [&center, dim](Source const &s) { return s.pos[dim] < center[dim]; });
+      return static_cast<int>(std::distance(sources.begin(), it));
+    };
+    bounds[4] = split(bounds[0], bounds[8], 0u);
+    for (auto const i : {0, 4}) {
+      bounds[i + 2] = split(bounds[i], bounds[i + 4], 1u);
+    }
+    for (auto const i : {0, 2, 4, 6}) {
+      bounds[i + 1] = split(bounds[i], bounds[i + 2], 2u);
+    }
+    std::array<int, 8> children{};
+    auto n_children = 0;
+    for (int octant = 0; octant < 8; ++octant) {
+      if (bounds[octant] == bounds[octant + 1]) {
+        continue;
+      }
+      auto const shift = Utils::Vector3d{{(octant & 4) ? 0.5 : -0.5,
+                                          (octant & 2) ? 0.5 : -0.5,
+                                          (octant & 1) ? 0.5 : -0.5}};
+      children[n_children++] =
+          build(bounds[octant], bounds[octant + 1],
+                center + half_size * shift, 0.5 * half_size, depth + 1);
+    }
+    nodes[index].children = children;
+    nodes[index].n_children = n_children;
+    return index;
+  }
+
+  void compute_moments(DipolarExpansion const &expansion) {
+    auto const n_moments = expansion.n_moments();
+    moments.assign(nodes.size() * static_cast<std::size_t>(n_moments), 0.);
+    std::vector<double> monomials;
+    for (int i = 0; auto &node : nodes) {
+      auto const node_moments = std::span<double>(moments).subspan(
+          static_cast<std::size_t>(i++ * n_moments),
+          static_cast<std::size_t>(n_moments));
+      for (int j = node.begin; j < node.end; ++j) {
+        auto const &s = sources[static_cast<std::size_t>(j)];
+        auto const delta = s.pos - node.center;
+        node.radius = std::max(node.radius, delta.norm());
+        expansion.add_moments(delta, s.m, monomials, node_moments);
+      }
+    }
+  }
+};
+
+/** @brief Dipole field and force on one target dipole. */
+struct TargetResult {
+  Utils::Vector3d field{};
+  Utils::Vector3d force{};
+};
+
+/**
+ * @brief Evaluate the dipole field and force acting on a target dipole.
+ */
+class TreeEvaluator {
+  Tree const &m_tree;
+  DipolarExpansion const &m_expansion;
+  BoxGeometry const &m_box_geo;
+  double m_theta;
+  std::vector<Utils::Vector3d> m_shifts;
+  bool m_minimum_image;
+  std::vector<int> m_stack;
+  std::vector<double> m_coefficients;
+
+  /**
+   * @brief Whether all particles of a node have the same minimum image
+   * as the node center.
+   */
+  bool minimum_image_consistent(Utils::Vector3d const &R,
+                                double radius) const {
+    for (auto i = 0u; i < 3u; ++i) {
+      if (m_box_geo.periodic(i) and
+          std::abs(R[i]) + radius >= 0.5 * m_box_geo.length()[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+public:
+  TreeEvaluator(Tree const &tree, DipolarExpansion const &expansion,
+                BoxGeometry const &box_geo, double theta,
+                Utils::Vector3i const &ncut)
+      : m_tree{tree}, m_expansion{expansion}, m_box_geo{box_geo},
+        m_theta{theta}, m_minimum_image{ncut.norm2() == 0} {
+    auto const &box_l = box_geo.length();
+    for_each_image(ncut, [&](int nx, int ny, int nz) {
+      m_shifts.emplace_back(
+          Utils::Vector3d{nx * box_l[0], ny * box_l[1], nz * box_l[2]});
+    });
+  }
+
+  template <bool with_force>
+  TargetResult operator()(Utils::Vector3d const &pos, Utils::Vector3d const &m,
+                          int id) {
+    TargetResult result{};
+    if (m_tree.nodes.empty()) {
+      return result;
+    }
+    auto const n_moments = m_expansion.n_moments();
+    auto const theta2 = m_theta * m_theta;
+    for (auto const &shift : m_shifts) {
+      auto const is_primary = (shift.norm2() == 0.);
+      auto const x = pos - shift;
+      auto const distance_to = [&](Utils::Vector3d const &point) {
+        return (m_minimum_image) ? m_box_geo.get_mi_vector(x, point)
+                                 : x - point;
+      };
+      m_stack.clear();
+      m_stack.emplace_back(0);
+      while (not m_stack.empty()) {
+        auto const &node =
+            m_tree.nodes[static_cast<std::size_t>(m_stack.back())];
+        auto const node_index = m_stack.back();
+        m_stack.pop_back();
+        auto const R = distance_to(node.center);
+        auto const r2 = R.norm2();
+        if (node.radius * node.radius < theta2 * r2 and
+            (not m_minimum_image or
+             minimum_image_consistent(R, node.radius))) {
+          m_expansion.taylor_coefficients(R, m_coefficients);
+          m_expansion.add_field<with_force>(
+              m_coefficients, m_tree.get_moments(node_index, n_moments), m,
+              result.field, result.force);
+        } else if (node.n_children == 0) {
+          for (int j = node.begin; j < node.end; ++j) {
+            auto const &s = m_tree.sources[static_cast<std::size_t>(j)];
+            if (is_primary and s.id == id) {
+              continue;
+            }
+            add_pair<with_force>(distance_to(s.pos), s.m, m, result);
+          }
+        } else {
+          for (int c = 0; c < node.n_children; ++c) {
+            m_stack.emplace_back(node.children[static_cast<std::size_t>(c)]);
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+private:
+  /**
+   * @brief Exact dipole field of a source dipole @p m_j at distance @p d
+   * and force on a target dipole @p m_i.
+   */
+  template <bool with_force>
+  static void add_pair(Utils::Vector3d const &d, Utils::Vector3d const &m_j,
+                       Utils::Vector3d const &m_i, TargetResult &result) {
+    auto const r2 = d.norm2();
+    auto const r = std::sqrt(r2);
+    auto const r3_inv = 1. / (r2 * r);
+    auto const r5_inv = r3_inv / r2;
+    auto const pe_j = m_j * d;
+    result.field += 3. * pe_j * r5_inv * d - r3_inv * m_j;
+    if constexpr (with_force) {
+      auto const pe_i = m_i * d;
+      auto const a = 3. * (m_i * m_j) * r5_inv;
+      auto const b = -15. * pe_i * pe_j * r5_inv / r2;
+      result.force += (a + b) * d + 3. * r5_inv * (pe_j * m_i + pe_i * m_j);
+    }
+  }
+};
+
+/**
+ * @brief Evaluate the tree for all local magnetic particles.
+ *
+ * Every rank builds the tree of all magnetic particles and evaluates
+ * it for its local particles, optionally with several threads.
+ *
+ * @return Sum of the values returned by @p kernel.
+ */
+template <bool with_force, typename Kernel>
+double for_each_target(System::System const &system, double theta, int order,
+                       int n_replicas, ParticleRange const &particles,
+                       Kernel &&kernel) {
+  auto const &box_geo = *system.box_geo;
+  auto [local_particles, all_posmom, reqs, offset] =
+      gather_particle_data(box_geo, particles);
+  boost::mpi::wait_all(reqs.begin(), reqs.end());
+  DipolarExpansion const expansion(order);
+  Tree const tree(all_posmom, expansion);
+  auto const ncut = get_n_cut(box_geo, n_replicas);
+  auto const n_targets = static_cast<int>(local_particles.size());
+  auto sum = 0.;
+  auto const evaluate_target = [&](TreeEvaluator &evaluate, int i) {
+    auto const id = offset + i;
+    auto const &target = all_posmom[static_cast<std::size_t>(id)];
+    auto const result =
+        evaluate.template operator()<with_force>(target.pos, target.m, id);
+    return kernel(*local_particles[static_cast<std::size_t>(i)], result);
+  };
+#ifdef OPENMP
+  auto const n_threads = system.cell_structure->get_n_threads();
+  if (n_threads > 1) {
+#pragma omp parallel num_threads(n_threads) reduction(+ : sum)
+    {
+      TreeEvaluator evaluate(tree, expansion, box_geo, theta, ncut);
+#pragma omp for schedule(dynamic)
+      for (int i = 0; i < n_targets; ++i) {
+        sum += evaluate_target(evaluate, i);
+      }
+    }
+    return sum;
+  }
+#endif
+  TreeEvaluator evaluate(tree, expansion, box_geo, theta, ncut);
+  for (int i = 0; i < n_targets; ++i) {
+    sum += evaluate_target(evaluate, i);
+  }
+  return sum;
+}
+
+} // namespace
+
+void DipolarBarnesHut::add_long_range_forces(
+    ParticleRange const &particles) const {
+  for_each_target<true>(
+      get_system(), theta, order, n_replicas, particles,
+      [this](Particle &p, TargetResult const &result) {
+        p.force() += prefactor * result.force;
+        p.torque() += prefactor * vector_product(p.calc_dip(), result.field);
+        return 0.;
+      });
+}
+
+double
+DipolarBarnesHut::long_range_energy(ParticleRange const &particles) const {
+  auto const energy =
+      for_each_target<false>(get_system(), theta, order, n_replicas, particles,
+                             [](Particle &p, TargetResult const &result) {
+                               return -0.5 * p.calc_dip() * result.field;
+                             });
+  return prefactor * energy;
+}
+
+#ifdef DIPOLE_FIELD_TRACKING
+void DipolarBarnesHut::dipole_field_at_part(
+    ParticleRange const &particles) const {
+  for_each_target<false>(get_system(), theta, order, n_replicas, particles,
+                         [this](Particle &p, TargetResult const &result) {
+                           p.dip_fld() = prefactor * result.field;
+                           return 0.;
+                         });
+}
+#endif
+
+DipolarBarnesHut::DipolarBarnesHut(double prefactor, double theta, int order,
+                                   int n_replicas)
+    : theta{theta}, order{order}, n_replicas{n_replicas} {
+  set_prefactor(prefactor);
+  if (theta <= 0. or theta >= 1.) {
+    throw std::domain_error("Parameter 'theta' must be in the range (0, 1)");
+  }
+  if (order < 1 or order > 8) {
+    throw std::domain_error("Parameter 'order' must be in the range [1, 8]");
+  }
+  if (n_replicas < 0) {
+    throw std::domain_error("Parameter 'n_replicas' must be >= 0");
+  }
+}
+
+#endif // DIPOLES
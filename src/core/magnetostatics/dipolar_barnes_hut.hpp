@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "config/config.hpp"
+
+#ifdef DIPOLES
+
+#include "magnetostatics/actor.hpp"
+
+#include "ParticleRange.hpp"
+
+/**
+ * @brief Dipolar Barnes-Hut tree code.
+ *
+ * The magnetic particles are sorted into an octree. The dipole field
+ * of a tree node is approximated by a Cartesian multipole expansion
+ * around the node center when the node is seen under an angle smaller
+ * than the opening angle @ref theta, otherwise the node is opened.
+ * Particles in leaves that cannot be approximated interact directly.
+ * The computational cost scales as O(N log N).
+ *
+ * Periodic boundaries are handled like in @ref DipolarDirectSum:
+ * without replicas, the minimum image convention is applied in the
+ * periodic directions, otherwise @ref n_replicas periodic copies are
+ * taken into account within a spherical cutoff.
+ */
+struct DipolarBarnesHut : public Dipoles::Actor<DipolarBarnesHut> {
+  /** @brief Opening angle of the multipole acceptance criterion. */
+  double theta;
+  /** @brief Highest order of the multipole expansion (1 = dipole). */
+  int order;
+  int n_replicas;
+  DipolarBarnesHut(double prefactor, double theta, int order, int n_replicas);
+
+  void on_activation() const {}
+  void on_boxl_change() const {}
+  void on_node_grid_change() const {}
+  void on_periodicity_change() const {}
+  void on_cell_structure_change() const {}
+  void init() const {}
+  void sanity_checks() const {}
+
+  double long_range_energy(ParticleRange const &particles) const;
+  void add_long_range_forces(ParticleRange const &particles) const;
+#ifdef DIPOLE_FIELD_TRACKING
+  void dipole_field_at_part(ParticleRange const &particles) const;
+#endif
+};
+
+#endif // DIPOLES
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2010-2024 The ESPResSo project
+ * Copyright (C) 2002,2003,2004,2005,2006,2007,2008,2009,2010
+ *   Max-Planck-Institute for Polymer Research, Theory Group
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/** @file
+ *  Particle data exchange and periodic images shared by the dipolar
+ *  solvers that sum over all pairs of magnetic particles.
+ */
+
+#include "config/config.hpp"
+
+#ifdef DIPOLES
+
+#include "BoxGeometry.hpp"
+#include "Particle.hpp"
+#include "ParticleRange.hpp"
+#include "communication.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/cartesian_product.hpp>
+#include <utils/mpi/iall_gatherv.hpp>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/request.hpp>
+
+#include <numeric>
+#include <ranges>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Position and dipole moment of one particle.
+ */
+struct PosMom {
+  Utils::Vector3d pos;
+  Utils::Vector3d m;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar & pos & m;
+  }
+};
+
+/**
+ * @brief Call kernel for every 3d index in a sphere around the origin.
+ *
+ * This calls a callable for all index-triples
+ * that are within ball around the origin with
+ * radius |ncut|.
+ *
+ * @tparam F Callable
+ * @param ncut Limits in the three directions,
+ *             all non-zero elements have to be
+ *             the same number.
+ * @param f will be called for each index triple
+ *        within the limits of @p ncut.
+ */
+template <typename F> void for_each_image(Utils::Vector3i const &ncut, F f) {
+  auto const ncut2 = ncut.norm2();
+
+  /* This runs over the index "cube"
+   * [-ncut[0], ncut[0]] x ... x [-ncut[2], ncut[2]]
+   * (inclusive on both sides), and calls f with
+   * all the elements as argument. Counting range
+   * is a range that just enumerates a range.
+   */
+  Utils::cartesian_product(
+      [&](int nx, int ny, int nz) {
+        if (nx * nx + ny * ny + nz * nz <= ncut2) {
+          f(nx, ny, nz);
+        }
+      },
+      std::views::iota(-ncut[0], ncut[0] + 1),
+      std::views::iota(-ncut[1], ncut[1] + 1),
+      std::views::iota(-ncut[2], ncut[2] + 1));
+}
+
+/**
+ * @brief Start the exchange of the magnetic particles between all ranks.
+ *
+ * The folded positions and dipole moments of the local particles with
+ * a non-zero dipole moment are gathered on all ranks. The local
+ * particles are stored in the global array in their order, starting
+ * at the returned offset.
+ *
+ * @param box_geo Box geometry.
+ * @param particles Local particles.
+ *
+ * @return The local magnetic particles, the global array of positions
+ *         and dipole moments, the pending requests that fill the
+ *         global array and the offset of the local particles in it.
+ */
+inline auto gather_particle_data(BoxGeometry const &box_geo,
+                                 ParticleRange const &particles) {
+  auto const &comm = ::comm_cart;
+  std::vector<Particle *> local_particles;
+  std::vector<PosMom> local_posmom;
+  std::vector<PosMom> all_posmom;
+  std::vector<boost::mpi::request> reqs;
+
+  local_particles.reserve(particles.size());
+  local_posmom.reserve(particles.size());
+
+  for (auto &p : particles) {
+    if (p.dipm() != 0.0) {
+      local_particles.emplace_back(&p);
+      local_posmom.emplace_back(
+          PosMom{box_geo.folded_position(p.pos()), p.calc_dip()});
+    }
+  }
+
+  auto const local_size = static_cast<int>(local_posmom.size());
+  std::vector<int> all_sizes;
+  boost::mpi::all_gather(comm, local_size, all_sizes);
+
+  auto const offset =
+      std::accumulate(all_sizes.begin(), all_sizes.begin() + comm.rank(), 0);
+  auto const total_size =
+      std::accumulate(all_sizes.begin() + comm.rank(), all_sizes.end(), offset);
+
+  if (comm.size() > 1) {
+    all_posmom.resize(static_cast<std::size_t>(total_size));
+    reqs = Utils::Mpi::iall_gatherv(comm, local_posmom.data(), local_size,
+                                    all_posmom.data(), all_sizes.data());
+  } else {
+    std::swap(all_posmom, local_posmom);
+  }
+
+  return std::make_tuple(std::move(local_particles), std::move(all_posmom),
+                         std::move(reqs), offset);
+}
+
+/**
+ * @brief Number of periodic replicas in each direction.
+ *
+ * @param box_geo Box geometry.
+ * @param n_replicas Number of replicas along the periodic directions.
+ */
+inline auto get_n_cut(BoxGeometry const &box_geo, int n_replicas) {
+  return n_replicas * Utils::Vector3i{static_cast<int>(box_geo.periodic(0)),
+                                      static_cast<int>(box_geo.periodic(1)),
+                                      static_cast<int>(box_geo.periodic(2))};
+}
+
+#endif // DIPOLES
@@ -24,16 +24,14 @@
 #ifdef DIPOLES
 
 #include "magnetostatics/dipolar_direct_sum.hpp"
+#include "magnetostatics/dipolar_common.hpp"
 
 #include "BoxGeometry.hpp"
 #include "cells.hpp"
-#include "communication.hpp"
 #include "errorhandling.hpp"
 #include "system/System.hpp"
 
-#include <utils/cartesian_product.hpp>
 #include <utils/math/sqr.hpp>
-#include <utils/mpi/iall_gatherv.hpp>
 
 #include <boost/mpi/collectives.hpp>
 #include <boost/mpi/communicator.hpp>
@@ -44,10 +42,7 @@
 #include <cassert>
 #include <cmath>
 #include <iterator>
-#include <ranges>
 #include <stdexcept>
-#include <tuple>
-#include <utility>
 #include <vector>
 
 /**
@@ -122,52 +117,6 @@ static auto dipole_field(Utils::Vector3d const &d, Utils::Vector3d const &m1) {
   return 3.0 * pe2 * d / r5 - m1 / r3;
 }
 
-/**
- * @brief Call kernel for every 3d index in a sphere around the origin.
- *
- * This calls a callable for all index-triples
- * that are within ball around the origin with
- * radius |ncut|.
- *
- * @tparam F Callable
- * @param ncut Limits in the three directions,
- *             all non-zero elements have to be
- *             the same number.
- * @param f will be called for each index triple
- *        within the limits of @p ncut.
- */
-template <typename F> void for_each_image(Utils::Vector3i const &ncut, F f) {
-  auto const ncut2 = ncut.norm2();
-
-  /* This runs over the index "cube"
-   * [-ncut[0], ncut[0]] x ... x [-ncut[2], ncut[2]]
-   * (inclusive on both sides), and calls f with
-   * all the elements as argument. Counting range
-   * is a range that just enumerates a range.
-   */
-  Utils::cartesian_product(
-      [&](int nx, int ny, int nz) {
-        if (nx * nx + ny * ny + nz * nz <= ncut2) {
-          f(nx, ny, nz);
-        }
-      },
-      std::views::iota(-ncut[0], ncut[0] + 1),
-      std::views::iota(-ncut[1], ncut[1] + 1),
-      std::views::iota(-ncut[2], ncut[2] + 1));
-}
-
-/**
- * @brief Position and dipole moment of one particle.
- */
-struct PosMom {
-  Utils::Vector3d pos;
-  Utils::Vector3d m;
-
-  template <class Archive> void serialize(Archive &ar, long int) {
-    ar & pos & m;
-  }
-};
-
 /**
  * @brief Sum over all pairs with periodic images.
  *
@@ -218,52 +167,6 @@ T image_sum(InputIterator begin, InputIterator end, InputIterator it,
   return init;
 }
 
-static auto gather_particle_data(BoxGeometry const &box_geo,
-                                 ParticleRange const &particles) {
-  auto const &comm = ::comm_cart;
-  std::vector<Particle *> local_particles;
-  std::vector<PosMom> local_posmom;
-  std::vector<PosMom> all_posmom;
-  std::vector<boost::mpi::request> reqs;
-
-  local_particles.reserve(particles.size());
-  local_posmom.reserve(particles.size());
-
-  for (auto &p : particles) {
-    if (p.dipm() != 0.0) {
-      local_particles.emplace_back(&p);
-      local_posmom.emplace_back(
-          PosMom{box_geo.folded_position(p.pos()), p.calc_dip()});
-    }
-  }
-
-  auto const local_size = static_cast<int>(local_posmom.size());
-  std::vector<int> all_sizes;
-  boost::mpi::all_gather(comm, local_size, all_sizes);
-
-  auto const offset =
-      std::accumulate(all_sizes.begin(), all_sizes.begin() + comm.rank(), 0);
-  auto const total_size =
-      std::accumulate(all_sizes.begin() + comm.rank(), all_sizes.end(), offset);
-
-  if (comm.size() > 1) {
-    all_posmom.resize(total_size);
-    reqs = Utils::Mpi::iall_gatherv(comm, local_posmom.data(), local_size,
-                                    all_posmom.data(), all_sizes.data());
-  } else {
-    std::swap(all_posmom, local_posmom);
-  }
-
-  return std::make_tuple(std::move(local_particles), std::move(all_posmom),
-                         std::move(reqs), offset);
-}
-
-static auto get_n_cut(BoxGeometry const &box_geo, int n_replicas) {
-  return n_replicas * Utils::Vector3i{static_cast<int>(box_geo.periodic(0)),
-                                      static_cast<int>(box_geo.periodic(1)),
-                                      static_cast<int>(box_geo.periodic(2))};
-}
-
 /**
  * @brief Calculate and add the interaction forces/torques to the particles.
  *
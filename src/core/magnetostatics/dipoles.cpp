@@ -128,6 +128,9 @@ struct LongRangeForce {
   void operator()(std::shared_ptr<DipolarDirectSum> const &actor) const {
     actor->add_long_range_forces(m_particles);
   }
+  void operator()(std::shared_ptr<DipolarBarnesHut> const &actor) const {
+    actor->add_long_range_forces(m_particles);
+  }
 #ifdef DIPOLAR_DIRECT_SUM
   void operator()(std::shared_ptr<DipolarDirectSumGpu> const &actor) const {
     actor->add_long_range_forces();
@@ -158,6 +161,9 @@ struct LongRangeEnergy {
   double operator()(std::shared_ptr<DipolarDirectSum> const &actor) const {
     return actor->long_range_energy(m_particles);
   }
+  double operator()(std::shared_ptr<DipolarBarnesHut> const &actor) const {
+    return actor->long_range_energy(m_particles);
+  }
 #ifdef DIPOLAR_DIRECT_SUM
   double operator()(std::shared_ptr<DipolarDirectSumGpu> const &actor) const {
     actor->long_range_energy();
@@ -180,6 +186,9 @@ struct LongRangeField {
   void operator()(std::shared_ptr<DipolarDirectSum> const &actor) const {
     actor->dipole_field_at_part(m_particles);
   }
+  void operator()(std::shared_ptr<DipolarBarnesHut> const &actor) const {
+    actor->dipole_field_at_part(m_particles);
+  }
 
   template <typename T,
             std::enable_if_t<!traits::has_dipole_fields<T>::value> * = nullptr>
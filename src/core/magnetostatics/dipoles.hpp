@@ -27,6 +27,7 @@
 
 #include "magnetostatics/solver.hpp"
 
+#include "magnetostatics/dipolar_barnes_hut.hpp"
 #include "magnetostatics/dipolar_direct_sum.hpp"
 #include "magnetostatics/dipolar_direct_sum_gpu.hpp"
 #include "magnetostatics/dlc.hpp"
@@ -45,6 +46,7 @@ namespace Dipoles {
 
 using MagnetostaticsActor =
     std::variant<std::shared_ptr<DipolarDirectSum>,
+                 std::shared_ptr<DipolarBarnesHut>,
 #ifdef DIPOLAR_DIRECT_SUM
                  std::shared_ptr<DipolarDirectSumGpu>,
 #endif
@@ -72,6 +74,7 @@ using is_solver = std::is_convertible<std::shared_ptr<T>, MagnetostaticsActor>;
 template <class T> struct has_dipole_fields : std::false_type {};
 #ifdef DIPOLE_FIELD_TRACKING
 template <> struct has_dipole_fields<DipolarDirectSum> : std::true_type {};
+template <> struct has_dipole_fields<DipolarBarnesHut> : std::true_type {};
 #endif // DIPOLE_FIELD_TRACKING
 
 } // namespace traits
@@ -73,7 +73,9 @@
 #include <span>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #ifdef FFTW3_H
@@ -115,8 +117,12 @@ double
 DipolarP3MImpl<FloatType, Architecture>::calc_average_self_energy_k_space()
     const {
   auto const &box_geo = *get_system().box_geo;
+  auto const KZ = std::get<2>(dp3m.fft->get_permutations());
   auto const node_phi = grid_influence_function_self_energy(
-      dp3m.params, dp3m.mesh.start, dp3m.mesh.stop, dp3m.g_energy);
+      dp3m.params, dp3m.mesh.start, dp3m.mesh.stop, dp3m.g_energy,
+      [this, KZ](Utils::Vector3i const &indices) {
+        return dp3m.hermitian_weight(indices[KZ]);
+      });
 
   double phi = 0.;
   boost::mpi::reduce(comm_cart, node_phi, phi, std::plus<>(), 0);
@@ -141,8 +147,10 @@ void DipolarP3MImpl<FloatType, Architecture>::init_cpu_kernels() {
   assert(dp3m.fft);
   dp3m.local_mesh.calc_local_ca_mesh(dp3m.params, local_geo, verlet_skin, 0.);
   dp3m.fft_buffers->init_halo();
+  dp3m.fft->overlap_communication = overlap_fft_communication;
   dp3m.fft->init(dp3m.params);
   dp3m.mesh.ks_pnum = dp3m.fft->get_ks_pnum();
+  dp3m.mesh.real_to_complex = dp3m.fft->is_real_to_complex();
   dp3m.fft_buffers->init_meshes(dp3m.fft->get_ca_mesh_size());
   dp3m.update_mesh_views();
   dp3m.calc_differential_operator();
@@ -297,7 +305,8 @@ double DipolarP3MImpl<FloatType, Architecture>::long_range_kernel(
                         mesh_dip[1u][index] * FloatType(d_op[shift[KY]]) +
                         mesh_dip[2u][index] * FloatType(d_op[shift[KZ]]);
         ++index;
-        node_energy += *it_energy * (Utils::sqr(re) + Utils::sqr(im));
+        node_energy += dp3m.hermitian_weight(shift[KZ]) * *it_energy *
+                       (Utils::sqr(re) + Utils::sqr(im));
         std::advance(it_energy, 1);
       });
 
@@ -559,6 +568,13 @@ public:
     m_logger->log_tuning_start();
   }
 
+  TuningDatabase::Key get_database_key() override {
+    auto const precision =
+        std::is_same_v<FloatType, float> ? "float" : "double";
+    return make_database_key(precision, dp3m.fft->name(), dp3m.sum_dip_part,
+                             dp3m.sum_mu2);
+  }
+
   std::tuple<double, double, double, double>
   calculate_accuracy(Utils::Vector3i const &mesh, int cao,
                      double r_cut_iL) const override {
@@ -669,7 +685,7 @@ void DipolarP3MImpl<FloatType, Architecture>::tune() {
       parameters.determine_r_cut_limits();
       parameters.determine_cao_limits(3);
       // run tuning algorithm
-      parameters.tune();
+      parameters.tune(tuning_database, tuning_verify);
       m_is_tuned = true;
       system.on_dipoles_change();
     } catch (...) {
@@ -870,10 +886,16 @@ void DipolarP3M::sanity_checks_cell_structure() const {
 
 void DipolarP3M::sanity_checks_node_grid() const {
   auto const &node_grid = ::communicator.node_grid;
-  if (node_grid[0] < node_grid[1] or node_grid[1] < node_grid[2]) {
+  if (requires_sorted_node_grid() and
+      (node_grid[0] < node_grid[1] or node_grid[1] < node_grid[2])) {
     throw std::runtime_error(
         "DipolarP3M: node grid must be sorted, largest first");
   }
+  auto const &local_geo = *get_system().local_geo;
+  if (requires_sorted_node_grid() and not local_geo.is_uniform()) {
+    throw std::runtime_error(
+        "DipolarP3M: the FFT backend requires domains of equal size");
+  }
 }
 
 template <typename FloatType, Arch Architecture>
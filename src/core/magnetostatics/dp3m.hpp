@@ -49,6 +49,7 @@
 
 #include <cmath>
 #include <numbers>
+#include <string>
 
 #ifdef NPT
 /** Update the NpT virial */
@@ -58,6 +59,10 @@ void npt_add_virial_magnetic_contribution(double energy);
 /** @brief Dipolar P3M solver. */
 struct DipolarP3M : public Dipoles::Actor<DipolarP3M> {
   P3MParameters const &dp3m_params;
+  /** @brief Tuning database file, empty to always run the tuning. */
+  std::string tuning_database;
+  /** @brief Time the parameters found in the tuning database. */
+  bool tuning_verify = false;
 
 public:
   DipolarP3M(P3MParameters const &dp3m_params) : dp3m_params{dp3m_params} {}
@@ -67,6 +72,8 @@ public:
   [[nodiscard]] virtual bool is_tuned() const noexcept = 0;
   [[nodiscard]] virtual bool is_gpu() const noexcept = 0;
   [[nodiscard]] virtual bool is_double_precision() const noexcept = 0;
+  /** @brief Whether the FFT backend requires a sorted node grid. */
+  [[nodiscard]] virtual bool requires_sorted_node_grid() const noexcept = 0;
 
   virtual void on_activation() = 0;
   /** @brief Recalculate all box-length-dependent parameters. */
@@ -58,7 +58,7 @@ struct p3m_data_struct_dipoles : public p3m_data_struct<FloatType> {
   /** k-space scalar mesh for k-space calculations. */
   std::vector<FloatType> ks_scalar;
 
-  p3m_interpolation_cache inter_weights;
+  p3m_interpolation_cache<FloatType> inter_weights;
 };
 
 template <typename FloatType, Arch Architecture>
@@ -73,15 +73,18 @@ private:
   std::unique_ptr<p3m_data_struct_dipoles<FloatType>> dp3m_impl;
   int tune_timings;
   bool tune_verbose;
+  bool overlap_fft_communication;
   bool m_is_tuned;
 
 public:
   DipolarP3MImpl(
       std::unique_ptr<p3m_data_struct_dipoles<FloatType>> &&dp3m_handle,
-      double prefactor, int tune_timings, bool tune_verbose)
+      double prefactor, int tune_timings, bool tune_verbose,
+      bool overlap_fft_communication)
       : DipolarP3M(dp3m_handle->params), dp3m{*dp3m_handle},
         dp3m_impl{std::move(dp3m_handle)}, tune_timings{tune_timings},
-        tune_verbose{tune_verbose} {
+        tune_verbose{tune_verbose},
+        overlap_fft_communication{overlap_fft_communication} {
 
     if (tune_timings <= 0) {
       throw std::domain_error("Parameter 'timings' must be > 0");
@@ -109,6 +112,9 @@ public:
   [[nodiscard]] bool is_double_precision() const noexcept override {
     return std::is_same_v<FloatType, double>;
   }
+  [[nodiscard]] bool requires_sorted_node_grid() const noexcept override {
+    return dp3m.fft == nullptr or dp3m.fft->requires_sorted_node_grid();
+  }
 
   void on_activation() override {
     sanity_checks();
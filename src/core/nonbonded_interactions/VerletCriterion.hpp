@@ -22,6 +22,7 @@
 #pragma once
 
 #include "Particle.hpp"
+#include "cell_system/ParticleArrays.hpp"
 #include "config/config.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "system/System.hpp"
@@ -29,6 +30,8 @@
 #include <utils/index.hpp>
 #include <utils/math/sqr.hpp>
 
+#include <cstddef>
+
 struct GetNonbondedCutoff {
   GetNonbondedCutoff(System::System const &system) : m_system{system} {}
   auto operator()(int type_i, int type_j) const {
@@ -95,4 +98,34 @@ public:
     return (ia_cut != INACTIVE_CUTOFF) &&
            (dist2 <= Utils::sqr(ia_cut + m_skin));
   }
+
+  /** @brief Criterion for particles stored in @ref ParticleArrays.
+   *  The arrays don't hold dipole moments, so the dipolar cutoff
+   *  is not considered.
+   */
+  template <typename Distance>
+  bool operator()(ParticleArrays const &arrays, std::size_t i, std::size_t j,
+                  Distance const &dist) const {
+    auto const &dist2 = dist.dist2;
+    if (dist2 > m_eff_max_cut2)
+      return false;
+
+#ifdef ELECTROSTATICS
+    // Within real space cutoff of electrostatics and both are charged
+    if (dist2 <= m_eff_coulomb_cut2 and arrays.q[i] != 0. and
+        arrays.q[j] != 0.)
+      return true;
+#endif
+
+#ifdef COLLISION_DETECTION
+    // Collision detection
+    if (dist2 <= m_collision_cut2)
+      return true;
+#endif
+
+    // Within short-range distance (including dpd and the like)
+    auto const ia_cut = get_nonbonded_cutoff(arrays.type[i], arrays.type[j]);
+    return (ia_cut != INACTIVE_CUTOFF) &&
+           (dist2 <= Utils::sqr(ia_cut + m_skin));
+  }
 };
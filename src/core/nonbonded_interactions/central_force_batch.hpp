@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/** \file
+ *  Batched evaluation of central pair forces.
+ *
+ *  Pairs of particles stored in @ref ParticleArrays are collected in
+ *  batches per @ref BatchKernel, such that the force factors of a batch
+ *  are computed in a branch-free loop the compiler can map to the
+ *  vector units of the target architecture.
+ */
+
+#include "config/config.hpp"
+
+#include "cell_system/ParticleArrays.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/int_pow.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+/** @brief Lennard-Jones force factor from the compact coefficients. */
+inline double compact_lj_force_factor(double c12, double c6, double offset,
+                                      double min_cut, double max_cut,
+                                      double dist) {
+  auto const r_off = dist - offset;
+  auto const ir6 = 1. / Utils::int_pow<6>(r_off);
+  auto const value = ir6 * (c12 * ir6 - c6) / (r_off * dist);
+  return (dist < max_cut and dist > min_cut) ? value : 0.;
+}
+
+/** @brief WCA force factor from the compact coefficients. */
+inline double compact_wca_force_factor(double c12, double c6, double cut,
+                                       double dist, double dist2) {
+  auto const ir6 = 1. / Utils::int_pow<3>(dist2);
+  auto const value = ir6 * (c12 * ir6 - c6) / dist2;
+  return (dist < cut) ? value : 0.;
+}
+
+/**
+ * @brief Force factor of the potentials of a @ref BatchKernel, for
+ * a single pair.
+ * @param ia_params  Compact parameters, with a batch kernel.
+ * @param dist       Distance between the particles.
+ * @param dist2      Squared distance between the particles.
+ */
+inline double compact_central_force_factor(CompactIA_parameters const &ia_params,
+                                           double dist, double dist2) {
+  auto const kernel = ia_params.batch_kernel;
+  auto factor = 0.;
+  if (kernel == BatchKernel::LJ_ONLY or kernel == BatchKernel::LJ_AND_WCA) {
+    factor += compact_lj_force_factor(ia_params.lj_c12, ia_params.lj_c6,
+                                      ia_params.lj_offset, ia_params.lj_min_cut,
+                                      ia_params.lj_max_cut, dist);
+  }
+  if (kernel == BatchKernel::WCA_ONLY or kernel == BatchKernel::LJ_AND_WCA) {
+    factor += compact_wca_force_factor(ia_params.wca_c12, ia_params.wca_c6,
+                                       ia_params.wca_cut, dist, dist2);
+  }
+  return factor;
+}
+
+/**
+ * @brief Batch of particle pairs sharing the same set of potentials.
+ *
+ * The precomputed coefficients of each pair are copied into the batch,
+ * such that pairs of different particle types can be evaluated together.
+ *
+ * @tparam kernel Active potentials.
+ * @tparam N      Batch size.
+ */
+template <BatchKernel kernel, std::size_t N = 8> class CentralForceBatch {
+  static constexpr bool with_lj =
+      kernel == BatchKernel::LJ_ONLY or kernel == BatchKernel::LJ_AND_WCA;
+  static constexpr bool with_wca =
+      kernel == BatchKernel::WCA_ONLY or kernel == BatchKernel::LJ_AND_WCA;
+
+  std::size_t m_size = 0;
+  std::array<unsigned int, N> m_i;
+  std::array<unsigned int, N> m_j;
+  std::array<Utils::Vector3d, N> m_d;
+  std::array<double, N> m_dist;
+  std::array<double, N> m_dist2;
+  std::array<double, N> m_lj_c12;
+  std::array<double, N> m_lj_c6;
+  std::array<double, N> m_lj_offset;
+  std::array<double, N> m_lj_min_cut;
+  std::array<double, N> m_lj_max_cut;
+  std::array<double, N> m_wca_c12;
+  std::array<double, N> m_wca_c6;
+  std::array<double, N> m_wca_cut;
+
+public:
+  static constexpr std::size_t size() { return N; }
+
+  /**
+   * @brief Add a pair to the batch.
+   * @return Whether the batch is full.
+   */
+  bool push(unsigned int i, unsigned int j, Utils::Vector3d const &d,
+            double dist2, CompactIA_parameters const &ia_params) {
+    m_i[m_size] = i;
+    m_j[m_size] = j;
+    m_d[m_size] = d;
+    m_dist[m_size] = std::sqrt(dist2);
+    m_dist2[m_size] = dist2;
+    if constexpr (with_lj) {
+      m_lj_c12[m_size] = ia_params.lj_c12;
+      m_lj_c6[m_size] = ia_params.lj_c6;
+      m_lj_offset[m_size] = ia_params.lj_offset;
+      m_lj_min_cut[m_size] = ia_params.lj_min_cut;
+      m_lj_max_cut[m_size] = ia_params.lj_max_cut;
+    }
+    if constexpr (with_wca) {
+      m_wca_c12[m_size] = ia_params.wca_c12;
+      m_wca_c6[m_size] = ia_params.wca_c6;
+      m_wca_cut[m_size] = ia_params.wca_cut;
+    }
+    return ++m_size == N;
+  }
+
+  /**
+   * @brief Add the forces of all pairs in the batch to the force
+   * accumulators and empty the batch.
+   */
+  void add_forces(ParticleArrays &arrays) {
+    std::array<double, N> force_factor;
+    auto const n = m_size;
+#if defined(OPENMP) or defined(ESPRESSO_OPENMP_SIMD)
+#pragma omp simd
+#elif defined(__GNUC__) and not defined(__clang__)
+#pragma GCC ivdep
+#endif
+    for (std::size_t k = 0; k < n; ++k) {
+      auto const dist = m_dist[k];
+      auto factor = 0.;
+      if constexpr (with_lj) {
+        factor += compact_lj_force_factor(m_lj_c12[k], m_lj_c6[k],
+                                          m_lj_offset[k], m_lj_min_cut[k],
+                                          m_lj_max_cut[k], dist);
+      }
+      if constexpr (with_wca) {
+        factor += compact_wca_force_factor(m_wca_c12[k], m_wca_c6[k],
+                                           m_wca_cut[k], dist, m_dist2[k]);
+      }
+      force_factor[k] = factor;
+    }
+    for (std::size_t k = 0; k < n; ++k) {
+      auto const force = force_factor[k] * m_d[k];
+      arrays.force[m_i[k]] += force;
+      arrays.force[m_j[k]] -= force;
+    }
+    m_size = 0;
+  }
+};
+
+/**
+ * @brief Add the central forces of a list of pairs using batched kernels.
+ *
+ * Pairs whose particle types have a @ref BatchKernel are evaluated in
+ * batches, pairs of particle types without any active potential are
+ * skipped, all other pairs are handed to the scalar kernel. The
+ * coefficients are read from the compact parameter table
+ * @ref InteractionsNonBonded::get_compact_ia_param.
+ *
+ * @param arrays       Particle data.
+ * @param pairs        Index pairs into @p arrays.
+ * @param df           Distance function.
+ * @param ias          Non-bonded interactions.
+ * @param pair_kernel  Scalar kernel, needs to be callable with
+ *                     (ParticleArrays, std::size_t, std::size_t, Distance).
+ */
+template <class DistanceFunction, class PairKernel>
+void add_central_forces_batched(
+    ParticleArrays &arrays,
+    std::span<ParticleArrays::IndexPair const> pairs,
+    DistanceFunction const &df, InteractionsNonBonded const &ias,
+    PairKernel const &pair_kernel) {
+  CentralForceBatch<BatchKernel::LJ_ONLY> lj;
+  CentralForceBatch<BatchKernel::WCA_ONLY> wca;
+  CentralForceBatch<BatchKernel::LJ_AND_WCA> lj_wca;
+
+  for (auto const &[i, j] : pairs) {
+    auto const &ia_params =
+        ias.get_compact_ia_param(arrays.type[i], arrays.type[j]);
+    if (not ia_params.active) {
+      continue;
+    }
+    auto const d = df(arrays.pos[i], arrays.pos[j]);
+    switch (ia_params.batch_kernel) {
+    case BatchKernel::LJ_ONLY:
+      if (lj.push(i, j, d.vec21, d.dist2, ia_params)) {
+        lj.add_forces(arrays);
+      }
+      break;
+    case BatchKernel::WCA_ONLY:
+      if (wca.push(i, j, d.vec21, d.dist2, ia_params)) {
+        wca.add_forces(arrays);
+      }
+      break;
+    case BatchKernel::LJ_AND_WCA:
+      if (lj_wca.push(i, j, d.vec21, d.dist2, ia_params)) {
+        lj_wca.add_forces(arrays);
+      }
+      break;
+    default:
+      pair_kernel(arrays, i, j, d);
+    }
+  }
+
+  lj.add_forces(arrays);
+  wca.add_forces(arrays);
+  lj_wca.add_forces(arrays);
+}
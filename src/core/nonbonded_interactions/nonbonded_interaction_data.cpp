@@ -24,8 +24,11 @@
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 
 #include "electrostatics/coulomb.hpp"
+#include "nonbonded_interactions/spline_tabulation.hpp"
 #include "system/System.hpp"
 
+#include <utils/math/int_pow.hpp>
+
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
@@ -110,9 +113,70 @@ static double recalc_maximal_cutoff(IA_parameters const &data) {
   return max_cut_current;
 }
 
+static BatchKernel find_batch_kernel(IA_parameters const &data) {
+  /* the batched kernels apply if no other potential is active;
+   * DPD only contributes to the thermostat force */
+  auto others = data;
+  auto has_lj = false;
+  auto has_wca = false;
+#ifdef LENNARD_JONES
+  has_lj = data.lj.cut != INACTIVE_CUTOFF;
+  others.lj = {};
+#endif
+#ifdef WCA
+  has_wca = data.wca.cut != INACTIVE_CUTOFF;
+  others.wca = {};
+#endif
+#ifdef DPD
+  others.dpd = {};
+#endif
+  if (recalc_maximal_cutoff(others) != INACTIVE_CUTOFF) {
+    return BatchKernel::NONE;
+  }
+  if (has_lj and has_wca) {
+    return BatchKernel::LJ_AND_WCA;
+  }
+  if (has_lj) {
+    return BatchKernel::LJ_ONLY;
+  }
+  if (has_wca) {
+    return BatchKernel::WCA_ONLY;
+  }
+  return BatchKernel::NONE;
+}
+
+static CompactIA_parameters make_compact_ia_param(IA_parameters const &data) {
+  CompactIA_parameters compact;
+  compact.batch_kernel = find_batch_kernel(data);
+  compact.active = data.max_cut != INACTIVE_CUTOFF;
+  compact.max_cut = data.max_cut;
+#ifdef LENNARD_JONES
+  if (data.lj.cut != INACTIVE_CUTOFF) {
+    auto const sig6 = Utils::int_pow<6>(data.lj.sig);
+    compact.lj_c12 = 48. * data.lj.eps * sig6 * sig6;
+    compact.lj_c6 = 24. * data.lj.eps * sig6;
+    compact.lj_offset = data.lj.offset;
+    compact.lj_min_cut = data.lj.min_cutoff();
+    compact.lj_max_cut = data.lj.max_cutoff();
+  }
+#endif
+#ifdef WCA
+  if (data.wca.cut != INACTIVE_CUTOFF) {
+    auto const sig6 = Utils::int_pow<6>(data.wca.sig);
+    compact.wca_c12 = 48. * data.wca.eps * sig6 * sig6;
+    compact.wca_c6 = 24. * data.wca.eps * sig6;
+    compact.wca_cut = data.wca.cut;
+  }
+#endif
+  return compact;
+}
+
 void InteractionsNonBonded::recalc_maximal_cutoffs() {
-  for (auto &data : m_nonbonded_ia_params) {
-    data->max_cut = recalc_maximal_cutoff(*data);
+  for (std::size_t key = 0; key < m_nonbonded_ia_params.size(); ++key) {
+    auto &data = *m_nonbonded_ia_params[key];
+    data.max_cut = recalc_maximal_cutoff(data);
+    update_spline_tabulation(data);
+    m_compact_ia_params[key] = make_compact_ia_param(data);
   }
 }
 
@@ -124,6 +188,24 @@ double InteractionsNonBonded::maximal_cutoff() const {
   return max_cut_nonbonded;
 }
 
+bool InteractionsNonBonded::only_central_forces() const {
+  return std::ranges::none_of(m_nonbonded_ia_params, [](auto const &data) {
+    auto is_non_central = false;
+#ifdef GAY_BERNE
+    is_non_central |= data->gay_berne.max_cutoff() != INACTIVE_CUTOFF;
+#endif
+#ifdef THOLE
+    is_non_central |= data->thole.scaling_coeff != 0.;
+#endif
+    return is_non_central;
+  });
+}
+
 void InteractionsNonBonded::on_non_bonded_ia_change() const {
   get_system().on_non_bonded_ia_change();
+  for (auto const &weak_ptr : m_sharing_systems) {
+    if (auto const system = weak_ptr.lock()) {
+      system->on_non_bonded_ia_change();
+    }
+  }
 }
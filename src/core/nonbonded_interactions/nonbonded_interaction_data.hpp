@@ -27,6 +27,7 @@
 
 #include "TabulatedPotential.hpp"
 #include "config/config.hpp"
+#include "nonbonded_interactions/spline_tabulation.hpp"
 #include "system/Leaf.hpp"
 
 #include <utils/index.hpp>
@@ -276,6 +277,73 @@ struct DPD_Parameters {
   double max_cutoff() const { return std::max(radial.cutoff, trans.cutoff); }
 };
 
+/** Automatic spline tabulation of expensive potentials */
+struct SplineTabulation_Parameters {
+  /** Smallest tabulated distance */
+  double min = 0.;
+  /** Maximal absolute force error, tabulation is off if negative */
+  double accuracy = INACTIVE_CUTOFF;
+#ifdef GAUSSIAN
+  CubicSpline gaussian;
+#endif
+#ifdef BMHTF_NACL
+  CubicSpline bmhtf;
+#endif
+#ifdef MORSE
+  CubicSpline morse;
+#endif
+#ifdef BUCKINGHAM
+  CubicSpline buckingham;
+#endif
+  SplineTabulation_Parameters() = default;
+  SplineTabulation_Parameters(double min, double accuracy);
+  bool is_active() const { return accuracy > 0.; }
+};
+
+/** @brief Batched force kernels, see @ref CentralForceBatch. */
+enum class BatchKernel : int {
+  NONE,       /**< Not supported, use the scalar kernel */
+  LJ_ONLY,    /**< Lennard-Jones */
+  WCA_ONLY,   /**< WCA */
+  LJ_AND_WCA, /**< Lennard-Jones and WCA */
+};
+
+/**
+ * @brief Compact parameters for non-bonded interactions.
+ *
+ * Flat copy of the coefficients used by the force kernels, with the
+ * prefactors of the force expressions precomputed. It is derived from
+ * @ref IA_parameters by @ref InteractionsNonBonded::recalc_maximal_cutoffs.
+ *
+ * Only the Lennard-Jones and WCA coefficients are stored here, since
+ * these are the only potentials with a batched kernel. Both the batched
+ * and the scalar force kernels evaluate these pairs from the compact
+ * table alone; pairs with any other active potential still read the full
+ * parameter struct.
+ */
+struct CompactIA_parameters {
+  /** Batched force kernel that covers all active potentials. */
+  BatchKernel batch_kernel = BatchKernel::NONE;
+  /** Whether any short-range potential is active. */
+  bool active = false;
+  /** Maximal cutoff, see @ref IA_parameters::max_cut */
+  double max_cut = INACTIVE_CUTOFF;
+  /** Lennard-Jones: @f$ 48\epsilon\sigma^{12} @f$ */
+  double lj_c12 = 0.;
+  /** Lennard-Jones: @f$ 24\epsilon\sigma^{6} @f$ */
+  double lj_c6 = 0.;
+  /** Lennard-Jones: offset and interaction range */
+  double lj_offset = 0.;
+  double lj_min_cut = 0.;
+  double lj_max_cut = 0.;
+  /** WCA: @f$ 48\epsilon\sigma^{12} @f$ */
+  double wca_c12 = 0.;
+  /** WCA: @f$ 24\epsilon\sigma^{6} @f$ */
+  double wca_c6 = 0.;
+  /** WCA: cutoff */
+  double wca_cut = 0.;
+};
+
 /** @brief Parameters for non-bonded interactions. */
 struct IA_parameters {
   /** maximal cutoff for this pair of particle types. This contains
@@ -351,18 +419,25 @@ struct IA_parameters {
 #ifdef THOLE
   Thole_Parameters thole;
 #endif
+
+  SplineTabulation_Parameters spline_tabulation;
 };
 
 class InteractionsNonBonded : public System::Leaf<InteractionsNonBonded> {
   /** @brief List of pairwise interactions. */
   std::vector<std::shared_ptr<IA_parameters>> m_nonbonded_ia_params{};
+  /** @brief Compact copy of the pairwise interactions. */
+  std::vector<CompactIA_parameters> m_compact_ia_params{};
   /** @brief Maximal particle type seen so far. */
   int max_seen_particle_type = -1;
+  /** @brief Other systems that share these interactions. */
+  std::vector<std::weak_ptr<System::System>> m_sharing_systems{};
 
   void realloc_ia_params(int type) {
     assert(type >= 0);
     auto const old_size = m_nonbonded_ia_params.size();
     m_nonbonded_ia_params.resize(Utils::lower_triangular(type, type) + 1);
+    m_compact_ia_params.resize(m_nonbonded_ia_params.size());
     auto const new_size = m_nonbonded_ia_params.size();
     if (new_size > old_size) {
       for (auto &data : m_nonbonded_ia_params) {
@@ -421,6 +496,22 @@ public:
     return *m_nonbonded_ia_params[get_ia_param_key(i, j)];
   }
 
+  /**
+   * @brief Get compact interaction parameters between particle types i and j
+   *
+   * Unlike @ref get_ia_param, this is a lookup in a contiguous table
+   * without indirection, meant for the inner loop of the force
+   * calculation. The table is updated by @ref recalc_maximal_cutoffs.
+   * It only covers the potentials of the batched kernels, see
+   * @ref CompactIA_parameters.
+   *
+   * @param i First type, must exist
+   * @param j Second type, must exist
+   */
+  auto const &get_compact_ia_param(int i, int j) const {
+    return m_compact_ia_params[get_ia_param_key(i, j)];
+  }
+
   auto get_ia_param_ref_counted(int i, int j) const {
     return m_nonbonded_ia_params[get_ia_param_key(i, j)];
   }
@@ -437,6 +528,20 @@ public:
   /** @brief Get maximal cutoff. */
   double maximal_cutoff() const;
 
-  /** @brief Notify system that non-bonded interactions changed. */
+  /**
+   * @brief Whether all active interactions are central pair potentials
+   * that only depend on the particle types and distance.
+   */
+  bool only_central_forces() const;
+
+  /**
+   * @brief Share the interactions with another system, which is notified
+   * by @ref on_non_bonded_ia_change along with the bound system.
+   */
+  void share_with(std::shared_ptr<System::System> const &system) {
+    m_sharing_systems.emplace_back(system);
+  }
+
+  /** @brief Notify systems that non-bonded interactions changed. */
   void on_non_bonded_ia_change() const;
 };
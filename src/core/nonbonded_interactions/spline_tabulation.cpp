@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ *  Implementation of \ref spline_tabulation.hpp
+ */
+
+#include "nonbonded_interactions/spline_tabulation.hpp"
+
+#include "config/config.hpp"
+
+#include "errorhandling.hpp"
+#include "nonbonded_interactions/bmhtf-nacl.hpp"
+#include "nonbonded_interactions/buckingham.hpp"
+#include "nonbonded_interactions/gaussian.hpp"
+#include "nonbonded_interactions/morse.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+SplineTabulation_Parameters::SplineTabulation_Parameters(double min,
+                                                         double accuracy)
+    : min{min}, accuracy{accuracy} {
+  if (min < 0.) {
+    throw std::domain_error(
+        "SplineTabulation parameter 'min' has to be >= 0");
+  }
+  if (accuracy <= 0.) {
+    throw std::domain_error(
+        "SplineTabulation parameter 'accuracy' has to be > 0");
+  }
+}
+
+CubicSpline::CubicSpline(std::function<double(double)> const &f, double min,
+                         double max, std::size_t n_intervals)
+    : m_min{min}, m_max{max} {
+  assert(max > min);
+  assert(n_intervals > 0);
+  auto const step = (max - min) / static_cast<double>(n_intervals);
+  m_inv_step = 1. / step;
+
+  /* 4th-order finite differences on a fraction of the grid step,
+   * one-sided at the interval ends */
+  auto const delta = step / 16.;
+  auto const last = std::nextafter(max, min);
+  auto const derivative = [&f, delta, min, last](double x) {
+    if (x <= min or x >= last) {
+      auto const h = (x <= min) ? delta : -delta;
+      x = std::clamp(x, min, last);
+      return (-25. * f(x) + 48. * f(x + h) - 36. * f(x + 2. * h) +
+              16. * f(x + 3. * h) - 3. * f(x + 4. * h)) /
+             (12. * h);
+    }
+    return (f(x - 2. * delta) - 8. * f(x - delta) + 8. * f(x + delta) -
+            f(x + 2. * delta)) /
+           (12. * delta);
+  };
+
+  std::vector<double> values(n_intervals + 1);
+  std::vector<double> slopes(n_intervals + 1);
+  for (std::size_t k = 0; k <= n_intervals; ++k) {
+    auto const x =
+        (k == n_intervals) ? last : min + static_cast<double>(k) * step;
+    values[k] = f(x);
+    slopes[k] = derivative(x) * step;
+  }
+
+  m_coefficients.resize(n_intervals);
+  for (std::size_t k = 0; k < n_intervals; ++k) {
+    auto const y0 = values[k];
+    auto const y1 = values[k + 1];
+    auto const m0 = slopes[k];
+    auto const m1 = slopes[k + 1];
+    m_coefficients[k] = {y0, m0, 3. * (y1 - y0) - 2. * m0 - m1,
+                         2. * (y0 - y1) + m0 + m1};
+  }
+}
+
+CubicSpline make_force_spline(std::function<double(double)> const &force_factor,
+                              double min, double max, double accuracy) {
+  constexpr std::size_t max_intervals = 1u << 14;
+  for (std::size_t n = 64; n <= max_intervals; n *= 2) {
+    auto spline = CubicSpline(force_factor, min, max, n);
+    auto const step = (max - min) / static_cast<double>(n);
+    auto converged = true;
+    for (std::size_t k = 0; k < n and converged; ++k) {
+      for (auto const t : {0.25, 0.5, 0.75}) {
+        auto const x = min + (static_cast<double>(k) + t) * step;
+        auto const error = x * std::abs(spline(x) - force_factor(x));
+        if (not(error <= accuracy)) {
+          converged = false;
+          break;
+        }
+      }
+    }
+    if (converged) {
+      return spline;
+    }
+  }
+  return {};
+}
+
+CubicSpline make_force_spline_above(
+    std::function<double(double)> const &force_factor, double min, double max,
+    double accuracy) {
+  auto spline = make_force_spline(force_factor, min, max, accuracy);
+  if (not spline.empty()) {
+    return spline;
+  }
+  /* bisect between the largest failed and the smallest successful
+   * lower end, an empty table at the cutoff always succeeds */
+  constexpr int n_bisections = 10;
+  auto lower = min;
+  auto upper = max;
+  for (int i = 0; i < n_bisections; ++i) {
+    auto const mid = 0.5 * (lower + upper);
+    auto candidate = make_force_spline(force_factor, mid, max, accuracy);
+    if (candidate.empty()) {
+      lower = mid;
+    } else {
+      spline = std::move(candidate);
+      upper = mid;
+    }
+  }
+  return spline;
+}
+
+void update_spline_tabulation(IA_parameters &ia_params) {
+  auto &params = ia_params.spline_tabulation;
+  [[maybe_unused]] auto const tabulate =
+      [&params](CubicSpline &spline, char const *name, double min, double max,
+                std::function<double(double)> const &f) {
+        spline = {};
+        if (not params.is_active() or max == INACTIVE_CUTOFF or min >= max) {
+          return;
+        }
+        spline = make_force_spline_above(f, min, max, params.accuracy);
+        if (spline.empty()) {
+          runtimeErrorMsg() << "Cannot tabulate the " << name
+                            << " potential with accuracy " << params.accuracy
+                            << " below the cutoff " << max;
+        }
+      };
+
+#ifdef GAUSSIAN
+  tabulate(params.gaussian, "Gaussian", params.min, ia_params.gaussian.cut,
+           [&ia_params](double r) {
+             return gaussian_pair_force_factor(ia_params, r);
+           });
+#endif
+#ifdef BMHTF_NACL
+  tabulate(params.bmhtf, "BMHTF", params.min, ia_params.bmhtf.cut,
+           [&ia_params](double r) {
+             return BMHTF_pair_force_factor(ia_params, r);
+           });
+#endif
+#ifdef MORSE
+  tabulate(params.morse, "Morse", params.min, ia_params.morse.cut,
+           [&ia_params](double r) {
+             return morse_pair_force_factor(ia_params, r);
+           });
+#endif
+#ifdef BUCKINGHAM
+  /* the linear region below the discontinuity is cheap and not smooth
+   * at the discontinuity, only the Buckingham region is tabulated */
+  auto const discont = std::nextafter(ia_params.buckingham.discont,
+                                      ia_params.buckingham.cut);
+  tabulate(params.buckingham, "Buckingham", std::max(params.min, discont),
+           ia_params.buckingham.cut, [&ia_params](double r) {
+             return buck_pair_force_factor(ia_params, r);
+           });
+#endif
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/** \file
+ *  Automatic spline tabulation of expensive pair potentials.
+ *
+ *  The force factors of potentials that involve exponentials or
+ *  non-integer powers are tabulated on a uniform grid and evaluated
+ *  by cubic Hermite interpolation. The grid is refined until the
+ *  force error is below a user-defined accuracy.
+ *
+ *  Implementation in \ref spline_tabulation.cpp.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+struct IA_parameters;
+
+/**
+ * @brief Piecewise cubic Hermite interpolation of a function.
+ *
+ * The function is sampled uniformly on the interval [min, max).
+ * The coefficients of each interval are stored contiguously, such
+ * that an evaluation reads a single cache line.
+ */
+class CubicSpline {
+  double m_min = 0.;
+  double m_max = 0.;
+  double m_inv_step = 0.;
+  std::vector<std::array<double, 4>> m_coefficients;
+
+public:
+  CubicSpline() = default;
+
+  /**
+   * @brief Tabulate a function.
+   *
+   * The derivatives at the grid points are estimated by finite
+   * differences inside the interval, such that @p f is only evaluated
+   * in [min, max).
+   *
+   * @param f            Function to tabulate.
+   * @param min          Lower end of the interval.
+   * @param max          Upper end of the interval, excluded.
+   * @param n_intervals  Number of grid intervals.
+   */
+  CubicSpline(std::function<double(double)> const &f, double min, double max,
+              std::size_t n_intervals);
+
+  /** @brief Whether no function is tabulated. */
+  bool empty() const { return m_coefficients.empty(); }
+
+  /** @brief Number of grid intervals. */
+  auto size() const { return m_coefficients.size(); }
+
+  /** @brief Whether @p x is in the tabulated interval. */
+  bool contains(double x) const {
+    return not empty() and x >= m_min and x < m_max;
+  }
+
+  /** @brief Interpolate the function at @p x, which must be in range. */
+  double operator()(double x) const {
+    assert(contains(x));
+    auto const u = (x - m_min) * m_inv_step;
+    auto const k =
+        std::min(static_cast<std::size_t>(u), m_coefficients.size() - 1);
+    auto const t = u - static_cast<double>(k);
+    auto const &c = m_coefficients[k];
+    return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+  }
+};
+
+/**
+ * @brief Tabulate a force factor at a given accuracy.
+ *
+ * The number of grid intervals is doubled until the error of the force
+ * @f$ |F(r) - F_{\mathrm{spline}}(r)| = r |f(r) - f_{\mathrm{spline}}(r)| @f$
+ * sampled inside each interval is below @p accuracy.
+ *
+ * @param force_factor  Force divided by distance, as a function of distance.
+ * @param min           Lower end of the interval.
+ * @param max           Upper end of the interval, excluded.
+ * @param accuracy      Maximal absolute force error.
+ * @return The spline, or an empty spline if the accuracy cannot be
+ *         reached within a maximal table size of 2<sup>14</sup> intervals.
+ */
+CubicSpline make_force_spline(std::function<double(double)> const &force_factor,
+                              double min, double max, double accuracy);
+
+/**
+ * @brief Tabulate a force factor down to the smallest feasible distance.
+ *
+ * Potentials that diverge at short distances cannot be tabulated down
+ * to r = 0 at a finite accuracy. If the table cannot be built from
+ * @p min, its lower end is raised towards @p max by bisection until
+ * the accuracy is reached. Distances below the lower end of the
+ * returned spline have to be evaluated analytically.
+ *
+ * @param force_factor  Force divided by distance, as a function of distance.
+ * @param min           Smallest requested lower end of the interval.
+ * @param max           Upper end of the interval, excluded.
+ * @param accuracy      Maximal absolute force error.
+ * @return The spline, or an empty spline if no lower end above @p min
+ *         reaches the accuracy.
+ */
+CubicSpline
+make_force_spline_above(std::function<double(double)> const &force_factor,
+                        double min, double max, double accuracy);
+
+/**
+ * @brief Rebuild the splines of a pair of particle types.
+ *
+ * Called by @ref InteractionsNonBonded::recalc_maximal_cutoffs, such
+ * that the splines follow any change of the potential parameters.
+ * Each table starts at the smallest distance above the user-defined
+ * minimum where the accuracy can be reached, see
+ * @ref make_force_spline_above. A runtime error is queued if a potential
+ * cannot be tabulated at the requested accuracy; it is then evaluated
+ * analytically.
+ */
+void update_spline_tabulation(IA_parameters &ia_params);
+
+/**
+ * @brief Evaluate a force factor from its spline where available.
+ *
+ * @param spline    Tabulated force factor, may be empty.
+ * @param dist      Distance.
+ * @param analytic  Callable returning the exact force factor.
+ */
+template <class Kernel>
+double splined_force_factor(CubicSpline const &spline, double dist,
+                            Kernel const &analytic) {
+  if (spline.contains(dist)) {
+    return spline(dist);
+  }
+  return analytic();
+}
@@ -40,11 +40,12 @@
 #include <cmath>
 
 /** Calculate Thole force */
+template <class CoulombKernel>
 inline Utils::Vector3d
 thole_pair_force(Particle const &p1, Particle const &p2,
                  IA_parameters const &ia_params, Utils::Vector3d const &d,
                  double dist, BondedInteractionsMap const &bonded_ias,
-                 Coulomb::ShortRangeForceKernel::kernel_type const *kernel) {
+                 CoulombKernel const *kernel) {
   auto const thole_q1q2 = ia_params.thole.q1q2;
   auto const thole_s = ia_params.thole.scaling_coeff;
 
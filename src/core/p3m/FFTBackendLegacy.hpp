@@ -60,6 +60,9 @@ public:
   void backward_fft(FloatType *rs_mesh) override;
   int get_ca_mesh_size() const noexcept override { return ca_mesh_size; }
   int get_ks_pnum() const noexcept override { return ks_pnum; }
+  bool requires_sorted_node_grid() const noexcept override { return true; }
+  bool is_real_to_complex() const noexcept override { return false; }
+  char const *name() const noexcept override { return "legacy"; }
   std::array<int, 3u> const &get_mesh_size() const override {
     return fft->get_mesh_size();
   }
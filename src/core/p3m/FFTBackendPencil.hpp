@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "config/config.hpp"
+
+#if defined(P3M) or defined(DP3M)
+
+#include "common.hpp"
+#include "data_struct.hpp"
+
+#include <array>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+namespace fft {
+template <typename FloatType> struct pencil_fft_data_struct;
+} // namespace fft
+
+/**
+ * @brief FFT backend based on FFTW3 with a 2D pencil decomposition.
+ * Works with any node grid and can overlap the transpositions
+ * with the 1D FFTs. Optionally, a real-to-complex FFT only stores
+ * half of the k-space mesh.
+ */
+template <typename FloatType>
+class FFTBackendPencil : public FFTBackend<FloatType> {
+  static_assert(std::is_same_v<FloatType, float> or
+                    std::is_same_v<FloatType, double>,
+                "FFTW only implements float and double");
+  std::unique_ptr<fft::pencil_fft_data_struct<FloatType>> fft;
+  using FFTBackend<FloatType>::local_mesh;
+  using FFTBackend<FloatType>::check_complex_residuals;
+  using FFTBackend<FloatType>::overlap_communication;
+  int ca_mesh_size = -1;
+  bool real_to_complex;
+
+public:
+  FFTBackendPencil(P3MLocalMesh const &local_mesh,
+                   bool real_to_complex = false);
+  ~FFTBackendPencil() override;
+  void init(P3MParameters const &params) override;
+  void forward_fft(FloatType *rs_mesh) override;
+  void backward_fft(FloatType *rs_mesh) override;
+  int get_ca_mesh_size() const noexcept override { return ca_mesh_size; }
+  int get_ks_pnum() const noexcept override { return 4; }
+  bool requires_sorted_node_grid() const noexcept override { return false; }
+  bool is_real_to_complex() const noexcept override { return real_to_complex; }
+  char const *name() const noexcept override {
+    return (real_to_complex) ? "pencil_r2c" : "pencil";
+  }
+  std::array<int, 3u> const &get_mesh_size() const override;
+  std::array<int, 3u> const &get_mesh_start() const override;
+
+  /**
+   * @brief Index helpers for reciprocal space.
+   * After the FFT the data is in order YZX, which
+   * means that Y is the slowest changing index.
+   */
+  std::tuple<int, int, int> get_permutations() const override {
+    constexpr static int KX = 2;
+    constexpr static int KY = 0;
+    constexpr static int KZ = 1;
+    return {KX, KY, KZ};
+  }
+};
+
+/**
+ * @brief Pencil FFT backend with a real-to-complex FFT.
+ */
+template <typename FloatType>
+class FFTBackendPencilR2C : public FFTBackendPencil<FloatType> {
+public:
+  FFTBackendPencilR2C(P3MLocalMesh const &local_mesh)
+      : FFTBackendPencil<FloatType>(local_mesh, true) {}
+};
+
+#endif // defined(P3M) or defined(DP3M)
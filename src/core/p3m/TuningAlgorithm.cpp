@@ -24,6 +24,7 @@
 #if defined(P3M) || defined(DP3M)
 
 #include "p3m/TuningAlgorithm.hpp"
+#include "p3m/TuningDatabase.hpp"
 #include "p3m/common.hpp"
 
 #include "tuning.hpp"
@@ -34,9 +35,16 @@
 #include "communication.hpp"
 #include "system/System.hpp"
 
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/collectives/broadcast.hpp>
+
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <exception>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -97,6 +105,181 @@ void TuningAlgorithm::commit(Utils::Vector3i const &mesh, int cao,
   p3m_params.mesh = mesh;
 }
 
+TuningDatabase::Key
+TuningAlgorithm::make_database_key(std::string precision,
+                                   std::string fft_backend, int n_particles,
+                                   double sum_prop) {
+  TuningDatabase::Key key{};
+  key.solver = m_logger->get_name();
+  key.precision = std::move(precision);
+  key.fft_backend = std::move(fft_backend);
+  key.node_grid = ::communicator.node_grid;
+  key.box_l = m_system.box_geo->length();
+  key.n_particles = n_particles;
+  key.sum_prop = sum_prop;
+  key.accuracy = get_params().accuracy;
+  key.skin = m_system.cell_structure->get_verlet_skin();
+  return key;
+}
+
+/**
+ * @brief Run a file operation on the head node.
+ * Errors are propagated to all ranks to avoid a deadlock.
+ */
+template <typename F> static void run_on_head_node(F &&f) {
+  std::string error;
+  if (this_node == 0) {
+    try {
+      f();
+    } catch (std::exception const &err) {
+      error = err.what();
+    }
+  }
+  boost::mpi::broadcast(comm_cart, error, 0);
+  if (not error.empty()) {
+    throw std::runtime_error(error);
+  }
+}
+
+void TuningAlgorithm::tune(std::string const &database, bool verify) {
+  // the database only holds the outcome of unconstrained tunings
+  auto const use_database = not database.empty() and
+                            get_params().mesh[0] == -1 and
+                            get_params().cao == -1 and
+                            get_params().r_cut_iL == 0.;
+  auto const key = get_database_key();
+
+  // activate tuning mode
+  get_params().tuning = true;
+
+  std::optional<Parameters> tuned_params;
+  if (use_database) {
+    tuned_params = get_database_params(key, database, verify);
+  }
+  auto const from_database = tuned_params.has_value();
+  if (not from_database) {
+    tuned_params = get_time();
+  }
+
+  // deactivate tuning mode
+  get_params().tuning = false;
+
+  if (tuned_params->time == time_sentinel) {
+    throw std::runtime_error(m_logger->get_name() +
+                             ": failed to reach requested accuracy");
+  }
+  // set tuned parameters
+  get_params().accuracy = tuned_params->accuracy;
+  commit(tuned_params->mesh, tuned_params->cao, tuned_params->r_cut_iL,
+         tuned_params->alpha_L);
+
+  m_logger->tuning_results(tuned_params->mesh, tuned_params->cao,
+                           tuned_params->r_cut_iL, tuned_params->alpha_L,
+                           tuned_params->accuracy, tuned_params->time);
+
+  if (use_database and (verify or not from_database)) {
+    auto entry = TuningDatabase::Entry{};
+    entry.key = key;
+    entry.mesh = tuned_params->mesh;
+    entry.cao = tuned_params->cao;
+    entry.r_cut = get_params().r_cut;
+    entry.time = tuned_params->time;
+    run_on_head_node([&]() {
+      TuningDatabase db{database};
+      db.insert(entry);
+      db.save();
+    });
+  }
+}
+
+/**
+ * @brief Get parameters from the tuning database.
+ *
+ * The parameters are only accepted if they are compatible with the
+ * current system and reach the target accuracy. In verification mode,
+ * they are also timed.
+ *
+ * @param[in]     key       Key of the current system
+ * @param[in]     database  Path to the tuning database
+ * @param[in]     verify    Whether to time the parameters
+ *
+ * @returns The parameters, or nothing if the full tuning is required.
+ */
+std::optional<TuningAlgorithm::Parameters>
+TuningAlgorithm::get_database_params(TuningDatabase::Key const &key,
+                                     std::string const &database,
+                                     bool verify) {
+  auto const &box_geo = *m_system.box_geo;
+  std::optional<TuningDatabase::Entry> entry;
+  run_on_head_node([&]() { entry = TuningDatabase{database}.find(key); });
+  auto found = entry.has_value();
+  boost::mpi::broadcast(comm_cart, found, 0);
+  if (not found) {
+    return std::nullopt;
+  }
+  if (this_node != 0) {
+    entry = TuningDatabase::Entry{};
+  }
+  boost::mpi::broadcast(comm_cart, entry->mesh, 0);
+  boost::mpi::broadcast(comm_cart, entry->cao, 0);
+  boost::mpi::broadcast(comm_cart, entry->r_cut, 0);
+  boost::mpi::broadcast(comm_cart, entry->time, 0);
+  m_logger->report_database_entry(database);
+
+  Parameters params{};
+  double rs_err, ks_err;
+  params.mesh = entry->mesh;
+  params.cao = entry->cao;
+  params.r_cut_iL = entry->r_cut * box_geo.length_inv()[0];
+  if (not cao_fits_mesh(params.mesh, params.cao)) {
+    m_logger->log_cao_too_large(params.mesh[0], params.cao);
+    return std::nullopt;
+  }
+  std::tie(params.accuracy, rs_err, ks_err, params.alpha_L) =
+      calculate_accuracy(params.mesh, params.cao, params.r_cut_iL);
+  if (params.r_cut_iL > m_r_cut_iL_max) {
+    m_logger->log_skip("r_cut too large", params.mesh[0], params.cao,
+                       params.r_cut_iL, params.alpha_L, params.accuracy,
+                       rs_err, ks_err);
+    return std::nullopt;
+  }
+  if (params.accuracy > get_params().accuracy) {
+    m_logger->log_skip("accuracy not achieved", params.mesh[0], params.cao,
+                       params.r_cut_iL, params.alpha_L, params.accuracy,
+                       rs_err, ks_err);
+    return std::nullopt;
+  }
+  if (auto const veto = layer_correction_veto_r_cut(entry->r_cut)) {
+    m_logger->log_skip(*veto, params.mesh[0], params.cao, params.r_cut_iL,
+                       params.alpha_L, params.accuracy, rs_err, ks_err);
+    return std::nullopt;
+  }
+  params.time = entry->time;
+  if (verify) {
+    commit(params.mesh, params.cao, params.r_cut_iL, params.alpha_L);
+    on_solver_change();
+    params.time = benchmark_integration_step(m_system, m_timings);
+    m_logger->log_success(params.time, params.mesh[0], params.cao,
+                          params.r_cut_iL, params.alpha_L, params.accuracy,
+                          rs_err, ks_err);
+  }
+  return params;
+}
+
+bool TuningAlgorithm::cao_fits_mesh(Utils::Vector3i const &mesh,
+                                    int cao) const {
+  auto const &box_geo = *m_system.box_geo;
+  auto const &local_geo = *m_system.local_geo;
+  auto const verlet_skin = m_system.cell_structure->get_verlet_skin();
+  auto const k_cut_per_dir = (static_cast<double>(cao) / 2.) *
+                             Utils::hadamard_division(box_geo.length(), mesh);
+  auto const k_cut = std::ranges::min(k_cut_per_dir);
+  auto const min_box_l = std::ranges::min(box_geo.length());
+  auto const min_local_box_l = std::ranges::min(local_geo.length());
+  auto const k_cut_max = std::min(min_box_l, min_local_box_l) - verlet_skin;
+  return cao < std::ranges::min(mesh) and k_cut < k_cut_max;
+}
+
 /**
  * @brief Get the optimal alpha and the corresponding computation time
  * for a fixed @p mesh and @p cao.
@@ -118,22 +301,13 @@ double TuningAlgorithm::get_mc_time(Utils::Vector3i const &mesh, int cao,
                                     double &tuned_alpha_L,
                                     double &tuned_accuracy) {
   auto const &box_geo = *m_system.box_geo;
-  auto const &local_geo = *m_system.local_geo;
-  auto const verlet_skin = m_system.cell_structure->get_verlet_skin();
   auto const target_accuracy = get_params().accuracy;
   double rs_err, ks_err;
   double r_cut_iL_min = m_r_cut_iL_min;
   double r_cut_iL_max = m_r_cut_iL_max;
 
   /* initial checks. */
-  auto const k_cut_per_dir = (static_cast<double>(cao) / 2.) *
-                             Utils::hadamard_division(box_geo.length(), mesh);
-  auto const k_cut = std::ranges::min(k_cut_per_dir);
-  auto const min_box_l = std::ranges::min(box_geo.length());
-  auto const min_local_box_l = std::ranges::min(local_geo.length());
-  auto const k_cut_max = std::min(min_box_l, min_local_box_l) - verlet_skin;
-
-  if (cao >= std::ranges::min(mesh) or k_cut >= k_cut_max) {
+  if (not cao_fits_mesh(mesh, cao)) {
     m_logger->log_cao_too_large(mesh[0], cao);
     return -P3M_TUNE_CAO_TOO_LARGE;
   }
@@ -25,6 +25,7 @@
 
 #if defined(P3M) || defined(DP3M)
 
+#include "p3m/TuningDatabase.hpp"
 #include "p3m/TuningLogger.hpp"
 #include "p3m/common.hpp"
 
@@ -151,30 +152,28 @@ public:
   void commit(Utils::Vector3i const &mesh, int cao, double r_cut_iL,
               double alpha_L);
 
-  void tune() {
-    // activate tuning mode
-    get_params().tuning = true;
+  /** @brief Key of the current system in the tuning database. */
+  virtual TuningDatabase::Key get_database_key() = 0;
 
-    auto const tuned_params = get_time();
-
-    // deactivate tuning mode
-    get_params().tuning = false;
-
-    if (tuned_params.time == time_sentinel) {
-      throw std::runtime_error(m_logger->get_name() +
-                               ": failed to reach requested accuracy");
-    }
-    // set tuned parameters
-    get_params().accuracy = tuned_params.accuracy;
-    commit(tuned_params.mesh, tuned_params.cao, tuned_params.r_cut_iL,
-           tuned_params.alpha_L);
-
-    m_logger->tuning_results(tuned_params.mesh, tuned_params.cao,
-                             tuned_params.r_cut_iL, tuned_params.alpha_L,
-                             tuned_params.accuracy, tuned_params.time);
-  }
+  /**
+   * @brief Tune the parameters and write them to the P3M parameter struct.
+   *
+   * When a @p database file is provided and none of the parameters were
+   * fixed by the user, the database is consulted first: parameters of an
+   * identical or sufficiently similar system are re-used if they achieve
+   * the target accuracy, otherwise the full tuning algorithm runs and its
+   * result is stored in the database.
+   * @param database  Path to the tuning database, empty to disable it
+   * @param verify    Time the parameters found in the database and store
+   *                  the measured time in the database
+   */
+  void tune(std::string const &database = {}, bool verify = false);
 
 protected:
+  /** @brief Fill in the solver-independent components of a database key. */
+  TuningDatabase::Key make_database_key(std::string precision,
+                                        std::string fft_backend,
+                                        int n_particles, double sum_prop);
   auto get_n_trials() { return m_n_trials; }
   void increment_n_trials() { ++m_n_trials; }
   void reset_n_trials() { m_n_trials = 0ul; }
@@ -184,6 +183,12 @@ protected:
   double get_mc_time(Utils::Vector3i const &mesh, int cao,
                      double &tuned_r_cut_iL, double &tuned_alpha_L,
                      double &tuned_accuracy);
+
+private:
+  bool cao_fits_mesh(Utils::Vector3i const &mesh, int cao) const;
+  std::optional<Parameters> get_database_params(TuningDatabase::Key const &key,
+                                                std::string const &database,
+                                                bool verify);
 };
 
 #endif // P3M or DP3M
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "p3m/TuningDatabase.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+/** @brief Relative deviation of two positive quantities. */
+double log_deviation(double a, double b) {
+  if (a == b) {
+    return 0.;
+  }
+  if (a <= 0. or b <= 0.) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return std::abs(std::log(a / b));
+}
+
+std::string version_line() {
+  return "# tuning database format " +
+         std::to_string(TuningDatabase::format_version);
+}
+
+void write_entry(std::ostream &stream, TuningDatabase::Entry const &entry) {
+  auto const &key = entry.key;
+  stream << key.solver << " " << key.precision << " " << key.fft_backend;
+  for (auto const value : key.node_grid) {
+    stream << " " << value;
+  }
+  for (auto const value : key.box_l) {
+    stream << " " << value;
+  }
+  stream << " " << key.n_particles << " " << key.sum_prop << " "
+         << key.accuracy << " " << key.skin;
+  for (auto const value : entry.mesh) {
+    stream << " " << value;
+  }
+  stream << " " << entry.cao << " " << entry.r_cut << " " << entry.time
+         << "\n";
+}
+
+/** @brief Exclusive advisory lock on a file, held until destruction. */
+class FileLock {
+  int m_fd;
+
+public:
+  explicit FileLock(std::string const &filename)
+      : m_fd{::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)} {
+    if (m_fd == -1) {
+      throw std::runtime_error("Cannot open lock file '" + filename + "'");
+    }
+    while (::flock(m_fd, LOCK_EX) == -1) {
+      if (errno != EINTR) {
+        ::close(m_fd);
+        throw std::runtime_error("Cannot lock file '" + filename + "'");
+      }
+    }
+  }
+  FileLock(FileLock const &) = delete;
+  FileLock &operator=(FileLock const &) = delete;
+  ~FileLock() {
+    ::flock(m_fd, LOCK_UN);
+    ::close(m_fd);
+  }
+};
+
+std::optional<TuningDatabase::Entry> read_entry(std::string const &line) {
+  std::istringstream stream(line);
+  TuningDatabase::Entry entry{};
+  auto &key = entry.key;
+  stream >> key.solver;
+  if (stream.fail() or key.solver.starts_with("#")) {
+    return std::nullopt;
+  }
+  stream >> key.precision >> key.fft_backend;
+  for (auto &value : key.node_grid) {
+    stream >> value;
+  }
+  for (auto &value : key.box_l) {
+    stream >> value;
+  }
+  stream >> key.n_particles >> key.sum_prop >> key.accuracy >> key.skin;
+  for (auto &value : entry.mesh) {
+    stream >> value;
+  }
+  stream >> entry.cao >> entry.r_cut >> entry.time;
+  if (stream.fail() or not(stream >> std::ws).eof()) {
+    throw std::runtime_error("cannot parse line '" + line + "'");
+  }
+  return entry;
+}
+} // namespace
+
+double TuningDatabase::distance(Key const &lhs, Key const &rhs) {
+  if (lhs.solver != rhs.solver or lhs.precision != rhs.precision or
+      lhs.fft_backend != rhs.fft_backend or lhs.node_grid != rhs.node_grid) {
+    return std::numeric_limits<double>::infinity();
+  }
+  auto const min_box_l = std::ranges::min(lhs.box_l);
+  auto result = std::abs(lhs.skin - rhs.skin) / min_box_l;
+  for (auto i = 0u; i < 3u; ++i) {
+    result = std::max(result, log_deviation(lhs.box_l[i], rhs.box_l[i]));
+  }
+  result = std::max(result, log_deviation(lhs.n_particles, rhs.n_particles));
+  result = std::max(result, log_deviation(lhs.sum_prop, rhs.sum_prop));
+  result = std::max(result, log_deviation(lhs.accuracy, rhs.accuracy));
+  return result;
+}
+
+void TuningDatabase::insert(Entry const &entry) {
+  auto const it = std::ranges::find_if(m_entries, [&entry](auto const &e) {
+    return distance(e.key, entry.key) == 0.;
+  });
+  if (it != m_entries.end()) {
+    *it = entry;
+  } else {
+    m_entries.emplace_back(entry);
+  }
+}
+
+std::optional<TuningDatabase::Entry>
+TuningDatabase::find(Key const &key) const {
+  std::vector<std::pair<double, Entry const *>> neighbors;
+  for (auto const &entry : m_entries) {
+    auto const d = distance(key, entry.key);
+    if (d == 0.) {
+      return entry;
+    }
+    if (d < tolerance) {
+      neighbors.emplace_back(d, &entry);
+    }
+  }
+  if (neighbors.empty()) {
+    return std::nullopt;
+  }
+  auto const n_neighbors = std::min(neighbors.size(), std::size_t{2u});
+  std::ranges::partial_sort(neighbors, neighbors.begin() + n_neighbors,
+                            {}, &std::pair<double, Entry const *>::first);
+
+  auto const &nearest = *neighbors.front().second;
+  auto weights = 0.;
+  auto r_cut = 0.;
+  auto mesh_density = Utils::Vector3d{};
+  for (auto const &[d, entry] : std::span(neighbors).first(n_neighbors)) {
+    auto const weight = 1. / d;
+    weights += weight;
+    r_cut += weight * entry->r_cut;
+    for (auto i = 0u; i < 3u; ++i) {
+      mesh_density[i] += weight * entry->mesh[i] / entry->key.box_l[i];
+    }
+  }
+  Entry result = nearest;
+  result.key = key;
+  result.r_cut = r_cut / weights;
+  for (auto i = 0u; i < 3u; ++i) {
+    auto const mesh = mesh_density[i] / weights * key.box_l[i];
+    result.mesh[i] = static_cast<int>(std::round(mesh));
+    // make the mesh even in all directions
+    result.mesh[i] += result.mesh[i] % 2;
+  }
+  return result;
+}
+
+void TuningDatabase::load() {
+  m_entries.clear();
+  std::ifstream stream(m_filename);
+  if (not stream.is_open()) {
+    return;
+  }
+  std::string line;
+  // entries of older formats lack key components, they are ignored
+  if (not std::getline(stream, line) or line != version_line()) {
+    return;
+  }
+  for (int line_number = 2; std::getline(stream, line); ++line_number) {
+    try {
+      if (auto const entry = read_entry(line)) {
+        insert(*entry);
+      }
+    } catch (std::runtime_error const &err) {
+      throw std::runtime_error("Tuning database '" + m_filename + "', line " +
+                               std::to_string(line_number) + ": " +
+                               err.what());
+    }
+  }
+}
+
+void TuningDatabase::save() const {
+  // the database file is replaced on every save, so the lock is taken on
+  // a separate file, such that concurrent jobs don't lose their entries
+  FileLock const lock{m_filename + ".lock"};
+  TuningDatabase merged{m_filename};
+  for (auto const &entry : m_entries) {
+    merged.insert(entry);
+  }
+  // write to a uniquely named file first, so that readers
+  // never observe a partially written database
+  auto const tmp_filename =
+      m_filename + ".tmp" + std::to_string(std::random_device{}());
+  {
+    std::ofstream stream(tmp_filename);
+    stream.precision(std::numeric_limits<double>::max_digits10);
+    stream << version_line() << "\n";
+    stream << "# solver precision fft_backend node_grid[3] box_l[3] "
+              "n_particles sum_prop accuracy skin mesh[3] cao r_cut time\n";
+    for (auto const &entry : merged.entries()) {
+      write_entry(stream, entry);
+    }
+    if (not stream) {
+      throw std::runtime_error("Cannot write tuning database '" + m_filename +
+                               "'");
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_filename, m_filename, ec);
+  if (ec) {
+    std::filesystem::remove(tmp_filename, ec);
+    throw std::runtime_error("Cannot write tuning database '" + m_filename +
+                             "'");
+  }
+}
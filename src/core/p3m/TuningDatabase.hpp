@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <utils/Vector.hpp>
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Persistent store of tuned P3M parameters.
+ *
+ * Each entry maps the quantities that determine the outcome of the
+ * P3M tuning algorithm (solver, floating-point precision, FFT backend,
+ * node grid, box, number of charged particles, sum of squared charges
+ * or dipole moments, target accuracy and Verlet skin) to the optimal
+ * mesh, charge assignment order and real-space cutoff, as well as the
+ * measured time.
+ *
+ * Entries are stored in a text file, one entry per line, such that
+ * databases from different machines can be concatenated. When a key
+ * appears more than once, the last entry wins. The first line holds
+ * the @ref format_version; files written in another format are treated
+ * as empty and their entries are dropped on the next @ref save.
+ */
+class TuningDatabase {
+public:
+  struct Key {
+    std::string solver;
+    std::string precision;
+    std::string fft_backend;
+    Utils::Vector3i node_grid = {};
+    Utils::Vector3d box_l = {};
+    int n_particles = 0;
+    double sum_prop = 0.;
+    double accuracy = 0.;
+    double skin = 0.;
+  };
+
+  struct Entry {
+    Key key;
+    Utils::Vector3i mesh = {};
+    int cao = -1;
+    /** @brief Real-space cutoff in simulation units. */
+    double r_cut = 0.;
+    /** @brief Integration time in milliseconds. */
+    double time = 0.;
+  };
+
+  /**
+   * @brief Maximal relative deviation between two keys for an entry
+   * to be considered a neighbor of the queried system.
+   */
+  static auto constexpr tolerance = 0.1;
+
+  /** @brief Version of the file format, bumped when the key changes. */
+  static auto constexpr format_version = 2;
+
+  TuningDatabase() = default;
+  explicit TuningDatabase(std::string filename)
+      : m_filename{std::move(filename)} {
+    load();
+  }
+
+  auto const &entries() const { return m_entries; }
+
+  /** @brief Add an entry, replacing any entry with the same key. */
+  void insert(Entry const &entry);
+
+  /**
+   * @brief Find parameters for a system.
+   *
+   * On an exact match, the stored parameters are returned. Otherwise
+   * the parameters are interpolated from the two nearest compatible
+   * entries, weighted by the inverse of their distance to @p key:
+   * the mesh density and the real-space cutoff are interpolated, and
+   * the mesh is rescaled to the queried box.
+   * Entries are compatible when they share the solver, precision,
+   * FFT backend and node grid, and their other key components deviate
+   * by less than @ref tolerance.
+   * The returned time is only meaningful for exact matches.
+   */
+  std::optional<Entry> find(Key const &key) const;
+
+  /** @brief Re-read the database file. */
+  void load();
+
+  /**
+   * @brief Merge the entries into the database file.
+   *
+   * Entries written by other processes since the last @ref load are
+   * preserved. The file is replaced atomically, and an advisory lock
+   * on the file with the suffix <tt>.lock</tt> serializes concurrent
+   * saves.
+   */
+  void save() const;
+
+  /** @brief Distance between two keys, infinite if incompatible. */
+  static double distance(Key const &lhs, Key const &rhs);
+
+private:
+  std::string m_filename;
+  std::vector<Entry> m_entries;
+};
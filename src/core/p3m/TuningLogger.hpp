@@ -117,6 +117,12 @@ public:
     }
   }
 
+  void report_database_entry(std::string const &filename) const {
+    if (m_verbose) {
+      std::printf("parameters from tuning database '%s'\n", filename.c_str());
+    }
+  }
+
   auto get_name() const { return m_name; }
 
 private:
@@ -233,6 +233,8 @@ template <typename FloatType> struct P3MFFTMesh {
 
   /** @brief number of permutations in k_space */
   int ks_pnum = 0;
+  /** @brief only half of the spectrum is stored along the z-axis */
+  bool real_to_complex = false;
 };
 
 #endif // defined(P3M) or defined(DP3M)
@@ -78,6 +78,20 @@ template <typename FloatType> struct p3m_data_struct {
   /** @brief FFT buffers. */
   std::unique_ptr<FFTBuffers<FloatType>> fft_buffers;
 
+  /**
+   * @brief Number of k-space points represented by a stored point.
+   * With a real-to-complex FFT, the points with a negative z-frequency
+   * are not stored and have the same contribution to k-space sums as
+   * their complex conjugate.
+   * @param kz  Global k-space index along the real-space z-axis.
+   */
+  int hermitian_weight(int kz) const {
+    if (not mesh.real_to_complex or kz == 0 or 2 * kz == params.mesh[2]) {
+      return 1;
+    }
+    return 2;
+  }
+
   void init();
 
   void update_mesh_views() {
@@ -111,12 +125,26 @@ protected:
 
 public:
   bool check_complex_residuals = false;
+  /** @brief Overlap communication and computation, if supported. */
+  bool overlap_communication = false;
   explicit FFTBackend(P3MLocalMesh const &local_mesh)
       : local_mesh{local_mesh} {}
   virtual ~FFTBackend() = default;
   virtual void init(P3MParameters const &params) = 0;
   virtual int get_ca_mesh_size() const noexcept = 0;
   virtual int get_ks_pnum() const noexcept = 0;
+  /**
+   * @brief Whether the node grid must be sorted, largest first,
+   * and the domains must have equal size.
+   */
+  virtual bool requires_sorted_node_grid() const noexcept = 0;
+  /**
+   * @brief Whether the k-space mesh only stores the non-negative half
+   * of the Hermitian-symmetric spectrum along the real-space z-axis.
+   */
+  virtual bool is_real_to_complex() const noexcept = 0;
+  /** @brief Name of the backend, as used in the tuning database. */
+  virtual char const *name() const noexcept = 0;
   /** @brief Carry out the forward FFT of the scalar mesh. */
   virtual void forward_fft(FloatType *rs_mesh) = 0;
   /** @brief Carry out the backward FFT of the scalar mesh. */
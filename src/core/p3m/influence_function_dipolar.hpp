@@ -181,12 +181,14 @@ inline double G_opt_dipolar_self_energy(P3MParameters const &params,
  * @param n_start Lower left corner of the grid
  * @param n_stop Upper right corner of the grid.
  * @param g Energies on the grid.
+ * @param weight Number of k-space points represented by a grid point.
  * @return Total self-energy.
  */
-template <typename FloatType>
+template <typename FloatType, class Weight>
 inline double grid_influence_function_self_energy(
     P3MParameters const &params, Utils::Vector3i const &n_start,
-    Utils::Vector3i const &n_stop, std::vector<FloatType> const &g) {
+    Utils::Vector3i const &n_stop, std::vector<FloatType> const &g,
+    Weight &&weight) {
 
   auto const offset = detail::calc_meshift(params.mesh, false)[0];
   auto const d_op = detail::calc_meshift(params.mesh, true)[0];
@@ -203,7 +205,7 @@ inline double grid_influence_function_self_energy(
         if (((indices[0] % half_mesh != 0) or (indices[1] % half_mesh != 0) or
              (indices[2] % half_mesh != 0))) {
           auto const U2 = G_opt_dipolar_self_energy(params, shift_off);
-          energy += double(g[index]) * U2 * d_op_off.norm2();
+          energy += weight(indices) * double(g[index]) * U2 * d_op_off.norm2();
         }
         ++index;
       },
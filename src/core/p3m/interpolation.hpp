@@ -22,14 +22,18 @@
 #pragma once
 
 #include <utils/index.hpp>
+#include <utils/integral_parameter.hpp>
 #include <utils/math/bspline.hpp>
 
+#include <boost/align/aligned_allocator.hpp>
+
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
-#include <span>
-#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
 /**
@@ -46,25 +50,77 @@ template <int cao> struct InterpolationWeights {
   Utils::Array<double, cao> w_x, w_y, w_z;
 };
 
+/**
+ * @brief Interpolation weights for one point, as stored in the cache.
+ *
+ * @tparam T   Floating-point type of the weights.
+ * @tparam cao Interpolation order.
+ */
+template <typename T, int cao> struct InterpolationRecord {
+  /** Linear index of the corner of the interpolation cube. */
+  int ind;
+  /** Weights for the directions */
+  std::array<T, cao> w_x, w_y, w_z;
+};
+
 /**
  * @brief Cache for interpolation weights.
  *
  * This is a storage container for interpolation weights of
- * type InterpolationWeights.
+ * type InterpolationWeights. The mesh index and the weights of a point
+ * are stored next to each other in one record of an aligned buffer,
+ * such that the mesh assignment streams through memory. The buffer is
+ * only released on destruction or when the interpolation order changes,
+ * and is reused when the cache is reset.
+ *
+ * @tparam T Floating-point type of the stored weights.
  */
-class p3m_interpolation_cache {
+template <typename T = double> class p3m_interpolation_cache {
+  static_assert(std::is_floating_point_v<T>);
+
+  template <int cao>
+  using records_type = std::vector<
+      InterpolationRecord<T, cao>,
+      boost::alignment::aligned_allocator<InterpolationRecord<T, cao>, 64u>>;
+
+  template <int... i>
+  static auto make_storage(std::integer_sequence<int, i...>)
+      -> std::variant<std::monostate, records_type<i + 1>...>;
+
+  /** One buffer type per interpolation order from 1 to 7. */
+  using storage_type =
+      decltype(make_storage(std::make_integer_sequence<int, 7>{}));
+
+  template <int cao> struct make_records {
+    void operator()(storage_type &storage) const {
+      if (not std::holds_alternative<records_type<cao>>(storage)) {
+        storage.template emplace<records_type<cao>>();
+      }
+    }
+  };
+
   int m_cao = 0;
-  /** Charge fractions for mesh assignment. */
-  std::vector<double> ca_frac;
-  /** index of first mesh point for charge assignment. */
-  std::vector<int> ca_fmp;
+  /** Number of points in the cache. */
+  std::size_t m_size = 0u;
+  /** Mesh indices and charge fractions for mesh assignment. */
+  storage_type m_records;
+
+  template <int cao> auto &records() {
+    assert(cao == m_cao);
+    return std::get<records_type<cao>>(m_records);
+  }
+
+  template <int cao> auto const &records() const {
+    assert(cao == m_cao);
+    return std::get<records_type<cao>>(m_records);
+  }
 
 public:
   /**
    * @brief Number of points in the cache.
    * @return Number of points currently in the cache.
    */
-  auto size() const { return ca_fmp.size(); }
+  auto size() const { return m_size; }
 
   /**
    * @brief Charge assignment order the weights are for.
@@ -80,13 +136,52 @@ public:
    * @param w Interpolation weights to store.
    */
   template <int cao> void store(const InterpolationWeights<cao> &w) {
-    assert(cao == m_cao);
+    auto &buffer = records<cao>();
+    if (m_size + 1u > buffer.size()) {
+      buffer.resize(std::max(2u * buffer.size(), m_size + 1u));
+    }
+    store_at(m_size++, w);
+  }
+
+  /**
+   * @brief Store weights for one point at a given position.
+   *
+   * The cache must have been resized beforehand. Different points can
+   * be stored concurrently.
+   *
+   * @tparam cao Interpolation order has to match the order
+   *         set at last call to @ref p3m_interpolation_cache::reset.
+   * @param i Index of the entry to store.
+   * @param w Interpolation weights to store.
+   */
+  template <int cao>
+  void store_at(std::size_t i, const InterpolationWeights<cao> &w) {
+    assert(i < size());
 
-    ca_fmp.push_back(w.ind);
-    auto it = std::back_inserter(ca_frac);
-    std::ranges::copy(w.w_x, it);
-    std::ranges::copy(w.w_y, it);
-    std::ranges::copy(w.w_z, it);
+    auto &record = records<cao>()[i];
+    record.ind = w.ind;
+    std::ranges::transform(w.w_x, record.w_x.begin(), to_value);
+    std::ranges::transform(w.w_y, record.w_y.begin(), to_value);
+    std::ranges::transform(w.w_z, record.w_z.begin(), to_value);
+  }
+
+  /**
+   * @brief Resize the cache to a given number of points.
+   *
+   * @param n Number of points.
+   */
+  void resize(std::size_t n) {
+    std::visit(
+        [n](auto &buffer) {
+          if constexpr (not std::is_same_v<decltype(buffer),
+                                           std::monostate &>) {
+            if (n > buffer.size()) {
+              buffer.resize(n);
+            }
+          }
+        },
+        m_records);
+    m_size = n;
   }
 
   /**
@@ -101,18 +196,14 @@ public:
    * @return i-it interpolation weights.
    */
   template <int cao> InterpolationWeights<cao> load(std::size_t i) const {
-    assert(cao == m_cao);
     assert(i < size());
 
     InterpolationWeights<cao> ret;
-    ret.ind = ca_fmp[i];
-
-    auto const view = std::span(std::as_const(ca_frac));
-    auto const offset = 3ul * i * static_cast<std::size_t>(cao);
-
-    std::ranges::copy(view.subspan(offset + 0ul * cao, cao), ret.w_x.begin());
-    std::ranges::copy(view.subspan(offset + 1ul * cao, cao), ret.w_y.begin());
-    std::ranges::copy(view.subspan(offset + 2ul * cao, cao), ret.w_z.begin());
+    auto const &record = records<cao>()[i];
+    ret.ind = record.ind;
+    std::ranges::copy(record.w_x, ret.w_x.begin());
+    std::ranges::copy(record.w_y, ret.w_y.begin());
+    std::ranges::copy(record.w_z, ret.w_z.begin());
 
     return ret;
   }
@@ -123,10 +214,17 @@ public:
    * @param cao Interpolation order.
    */
   void reset(int cao) {
+    if (cao >= 1 and cao <= 7) {
+      Utils::integral_parameter<int, make_records, 1, 7>(cao, m_records);
+    } else {
+      m_records = std::monostate{};
+    }
     m_cao = cao;
-    ca_frac.clear();
-    ca_fmp.clear();
+    m_size = 0u;
   }
+
+private:
+  static T to_value(double x) { return static_cast<T>(x); }
 };
 
 /**
@@ -166,13 +264,16 @@ p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
                                     Utils::MemoryOrder::ROW_MAJOR);
 
   assert((nmp + Utils::Vector3i::broadcast(cao)) <= local_mesh.dim);
-  for (int i = 0; i < cao; i++) {
+  /* unroll the loop over the spline polynomials, such that each one
+   * is selected at compile time and evaluated for the three directions
+   * side by side */
+  [&]<std::size_t... i>(std::index_sequence<i...>) {
     using Utils::bspline;
-
-    ret.w_x[i] = bspline<cao>(i, dist[0]);
-    ret.w_y[i] = bspline<cao>(i, dist[1]);
-    ret.w_z[i] = bspline<cao>(i, dist[2]);
-  }
+    ((ret.w_x[i] = bspline<cao>(static_cast<int>(i), dist[0]),
+      ret.w_y[i] = bspline<cao>(static_cast<int>(i), dist[1]),
+      ret.w_z[i] = bspline<cao>(static_cast<int>(i), dist[2])),
+     ...);
+  }(std::make_index_sequence<cao>{});
 
   return ret;
 }
@@ -36,6 +36,7 @@
 
 #include <boost/mpi/collectives/all_gather.hpp>
 #include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/broadcast.hpp>
 #include <boost/mpi/collectives/gather.hpp>
 #include <boost/mpi/collectives/reduce.hpp>
 #include <boost/mpi/collectives/scatter.hpp>
@@ -410,6 +411,18 @@ static void clear_particle_type_map() {
   }
 }
 
+void reset_particle_index() {
+  clear_particle_node();
+  invalidate_fetch_cache();
+  if (::type_list_enable) {
+    auto types = Utils::keys(::particle_type_map);
+    std::ranges::sort(types);
+    for (auto const type : types) {
+      init_type_map(type);
+    }
+  }
+}
+
 /**
  * @brief Calculate the largest particle id.
  * Traversing the @ref particle_node to find the largest particle id
@@ -512,6 +525,44 @@ void remove_particle(int p_id) {
   mpi_synchronize_max_seen_pid_local();
 }
 
+void remove_particles(std::span<int const> p_ids) {
+  if (rebuild_needed()) {
+    build_particle_node_parallel();
+  }
+  auto &cell_structure = get_cell_structure();
+  if (::type_list_enable) {
+    std::vector<int> local_types;
+    for (auto const p_id : p_ids) {
+      auto p = cell_structure.get_local_particle(p_id);
+      if (p != nullptr and not p->is_ghost()) {
+        local_types.emplace_back(p_id);
+        local_types.emplace_back(p->type());
+      }
+    }
+    std::vector<std::vector<int>> global_types;
+    boost::mpi::all_gather(::comm_cart, local_types, global_types);
+    for (auto const &vec : global_types) {
+      for (auto it = vec.begin(); it != vec.end(); it += 2) {
+        remove_id_from_map(it[0], it[1]);
+      }
+    }
+  }
+
+  cell_structure.remove_particles(p_ids);
+  System::get_system().on_particle_change();
+  if (this_node == 0) {
+    auto removed_max_seen_pid = false;
+    for (auto const p_id : p_ids) {
+      particle_node.erase(p_id);
+      removed_max_seen_pid |= (p_id == ::max_seen_pid);
+    }
+    if (removed_max_seen_pid) {
+      ::max_seen_pid = calculate_max_seen_id();
+    }
+  }
+  mpi_synchronize_max_seen_pid_local();
+}
+
 void make_new_particle(int p_id, Utils::Vector3d const &pos) {
   if (rebuild_needed()) {
     build_particle_node_parallel();
@@ -530,6 +581,91 @@ void make_new_particle(int p_id, Utils::Vector3d const &pos) {
   mpi_synchronize_max_seen_pid_local();
 }
 
+void make_new_particles(std::vector<Particle> particles) {
+  if (rebuild_needed()) {
+    build_particle_node_parallel();
+  }
+  auto existing_pid = -1;
+  if (::this_node == 0) {
+    auto const it = std::ranges::find_if(particles, [](Particle const &p) {
+      return particle_node.contains(p.id());
+    });
+    if (it != particles.end()) {
+      existing_pid = it->id();
+    }
+  }
+  boost::mpi::broadcast(::comm_cart, existing_pid, 0);
+  if (existing_pid != -1) {
+    throw std::invalid_argument("Particle " + std::to_string(existing_pid) +
+                                " already exists");
+  }
+
+  /* send each particle to the rank that owns its position */
+  auto &cell_structure = get_cell_structure();
+  std::vector<std::vector<Particle>> particles_per_node;
+  if (::this_node == 0) {
+    auto const &box_geo = *System::get_system().box_geo;
+    particles_per_node.resize(static_cast<std::size_t>(::comm_cart.size()));
+    for (auto &p : particles) {
+      box_geo.fold_position(p.pos(), p.image_box());
+      auto const node = cell_structure.particle_to_rank(p);
+      particles_per_node[static_cast<std::size_t>(node)].emplace_back(
+          std::move(p));
+    }
+  }
+  std::vector<Particle> local_particles;
+  boost::mpi::scatter(::comm_cart, particles_per_node, local_particles, 0);
+
+  /* a position on a domain boundary may belong to the neighbor rank,
+   * in which case the next global resort moves the particle there */
+  std::vector<int> created;
+  std::vector<int> created_types;
+  auto misplaced = false;
+  for (auto &p : local_particles) {
+    auto const p_id = p.id();
+    created_types.emplace_back(p_id);
+    created_types.emplace_back(p.type());
+    if (cell_structure.add_local_particle(std::move(p)) != nullptr) {
+      created.emplace_back(p_id);
+    } else {
+      /* the particle was left unchanged */
+      cell_structure.add_particle(std::move(p));
+      misplaced = true;
+    }
+  }
+  System::get_system().on_particle_change();
+
+  if (::type_list_enable) {
+    std::vector<std::vector<int>> global_types;
+    boost::mpi::all_gather(::comm_cart, created_types, global_types);
+    for (auto const &vec : global_types) {
+      for (auto it = vec.begin(); it != vec.end(); it += 2) {
+        on_particle_type_change(it[0], type_tracking::new_part, it[1]);
+      }
+    }
+  }
+
+  auto const any_misplaced =
+      boost::mpi::all_reduce(::comm_cart, misplaced, std::logical_or<>());
+  if (::this_node == 0) {
+    std::vector<std::vector<int>> created_per_node;
+    boost::mpi::gather(::comm_cart, created, created_per_node, 0);
+    if (any_misplaced) {
+      clear_particle_node();
+    } else {
+      for (int node = 0; node < ::comm_cart.size(); ++node) {
+        for (auto const p_id : created_per_node[node]) {
+          particle_node[p_id] = node;
+          max_seen_pid = std::max(max_seen_pid, p_id);
+        }
+      }
+    }
+  } else {
+    boost::mpi::gather(::comm_cart, created, 0);
+  }
+  mpi_synchronize_max_seen_pid_local();
+}
+
 void set_particle_pos(int p_id, Utils::Vector3d const &pos) {
   auto const has_moved = maybe_move_particle(p_id, pos);
   get_cell_structure().set_resort_particles(Cells::RESORT_GLOBAL);
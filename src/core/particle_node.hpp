@@ -75,6 +75,14 @@ std::size_t fetch_cache_max_size();
  */
 void clear_particle_node();
 
+/**
+ * @brief Rebuild all particle book-keeping from the active system.
+ * Invalidates \ref particle_node and the fetch cache, and rebuilds the
+ * tracked types. This has to be done on all ranks when a different
+ * system instance becomes active.
+ */
+void reset_particle_index();
+
 /**
  * @brief Create a new particle and attach it to a cell.
  * @param p_id  The identity of the particle to create.
@@ -82,6 +90,16 @@ void clear_particle_node();
  */
 void make_new_particle(int p_id, Utils::Vector3d const &pos);
 
+/**
+ * @brief Create several new particles and attach them to cells.
+ * The particles are only significant on the head node, which sends each
+ * of them to the rank that owns its position, and the particle index is
+ * updated with a single collective operation. This is a collective call.
+ * @param particles  The particles to create, with unfolded positions.
+ * @throw std::invalid_argument if one of the particle ids already exists.
+ */
+void make_new_particles(std::vector<Particle> particles);
+
 /**
  * @brief Move particle to a new position.
  * @param p_id  The identity of the particle to move.
@@ -95,6 +113,12 @@ void set_particle_pos(int p_id, Utils::Vector3d const &pos);
  */
 void remove_particle(int p_id);
 
+/** Remove several particles with a single collective operation. Also
+ *  removes all bonds to the particles.
+ *  @param p_ids    identities of the particles to remove
+ */
+void remove_particles(std::span<int const> p_ids);
+
 /** Remove all particles. */
 void remove_all_particles();
 
@@ -39,12 +39,25 @@ struct True {
 };
 } // namespace detail
 
+/**
+ * @brief Run the bonded and non-bonded kernels.
+ *
+ * @param bond_kernel      Kernel for bonded interactions.
+ * @param pair_kernel      Kernel for non-bonded interactions.
+ * @param cell_structure   Cell structure.
+ * @param pair_cutoff      Non-bonded interactions cutoff.
+ * @param bond_cutoff      Bonded interactions cutoff.
+ * @param verlet_criterion Filter for Verlet lists.
+ * @param parallel         Whether the pair kernel is thread-safe,
+ *                         see @ref CellStructure::non_bonded_loop.
+ */
 template <class BondKernel, class PairKernel,
           class VerletCriterion = detail::True>
 void short_range_loop(BondKernel bond_kernel, PairKernel pair_kernel,
                       CellStructure &cell_structure, double pair_cutoff,
                       double bond_cutoff,
-                      VerletCriterion const &verlet_criterion = {}) {
+                      VerletCriterion const &verlet_criterion = {},
+                      bool parallel = false) {
 #ifdef CALIPER
   CALI_CXX_MARK_FUNCTION;
 #endif
@@ -56,6 +69,6 @@ void short_range_loop(BondKernel bond_kernel, PairKernel pair_kernel,
   }
 
   if (pair_cutoff > 0.) {
-    cell_structure.non_bonded_loop(pair_kernel, verlet_criterion);
+    cell_structure.non_bonded_loop(pair_kernel, verlet_criterion, parallel);
   }
 }
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ReplicaBatch.hpp"
+#include "System.hpp"
+
+#include "integrate.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+namespace System {
+
+std::shared_ptr<System> ReplicaBatch::add_replica() {
+  auto replica = System::create();
+  if (not m_replicas.empty()) {
+    replica->nonbonded_ias = m_replicas.front()->nonbonded_ias;
+    replica->nonbonded_ias->share_with(replica);
+  }
+  m_replicas.emplace_back(replica);
+  return replica;
+}
+
+void ReplicaBatch::activate(std::size_t index) const {
+  set_system(m_replicas.at(index));
+}
+
+int ReplicaBatch::integrate(int n_steps, int sweep_length,
+                            int reuse_forces) const {
+  assert(n_steps >= 0);
+  assert(sweep_length > 0);
+  auto const previous = get_system().shared_from_this();
+  auto const run_sweep = [this, &reuse_forces](int steps) {
+    for (auto const &replica : m_replicas) {
+      set_system(replica);
+      auto const retval =
+          replica->integrate_with_signal_handler(steps, reuse_forces, true);
+      if (retval < 0) {
+        return retval;
+      }
+    }
+    // replicas are not modified between two sweeps
+    reuse_forces = INTEG_REUSE_FORCES_ALWAYS;
+    return 0;
+  };
+  auto retval = (n_steps == 0) ? run_sweep(0) : 0;
+  for (int i = 0; i < n_steps and retval == 0; i += sweep_length) {
+    retval = run_sweep(std::min(n_steps - i, sweep_length));
+  }
+  set_system(previous);
+  return retval;
+}
+
+} // namespace System
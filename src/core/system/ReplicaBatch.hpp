@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace System {
+
+class System;
+
+/**
+ * @brief Independent system instances hosted by the same process.
+ *
+ * The replicas are advanced in lockstep: each sweep integrates every
+ * replica in turn for the same number of time steps, making it the
+ * active system for the duration of its integration. All replicas
+ * use the same MPI communicator.
+ *
+ * Replicas share the non-bonded interaction parameters of the first
+ * replica. After a modification, all replicas are notified by
+ * @ref InteractionsNonBonded::on_non_bonded_ia_change.
+ */
+class ReplicaBatch {
+  std::vector<std::shared_ptr<System>> m_replicas;
+
+public:
+  /** @brief Create a new replica and append it to the batch. */
+  std::shared_ptr<System> add_replica();
+
+  auto size() const { return m_replicas.size(); }
+  auto empty() const { return m_replicas.empty(); }
+  auto &operator[](std::size_t index) const { return m_replicas[index]; }
+  auto begin() const { return m_replicas.begin(); }
+  auto end() const { return m_replicas.end(); }
+
+  /** @brief Make a replica the active system. */
+  void activate(std::size_t index) const;
+
+  /**
+   * @brief Integrate all replicas in lockstep.
+   * The previously active system is restored afterwards.
+   * @param n_steps       Number of time steps to integrate.
+   * @param sweep_length  Number of time steps a replica is integrated
+   *                      before the next replica becomes active.
+   * @param reuse_forces  Force reuse policy of the first sweep.
+   * @return 0 on success, or the first negative error code returned
+   * by a replica.
+   */
+  int integrate(int n_steps, int sweep_length, int reuse_forces) const;
+};
+
+} // namespace System
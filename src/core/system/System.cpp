@@ -31,6 +31,8 @@
 #include "cell_system/CellStructure.hpp"
 #include "cell_system/CellStructureType.hpp"
 #include "cell_system/HybridDecomposition.hpp"
+#include "cell_system/LoadBalancer.hpp"
+#include "cell_system/VerletSkinTuner.hpp"
 #include "collision_detection/CollisionDetection.hpp"
 #include "communication.hpp"
 #include "electrostatics/icc.hpp"
@@ -66,6 +68,8 @@ System::System(Private) {
   box_geo = std::make_shared<BoxGeometry>();
   local_geo = std::make_shared<LocalBox>();
   cell_structure = std::make_shared<CellStructure>(*box_geo);
+  load_balancer = std::make_shared<LoadBalancer>();
+  skin_tuner = std::make_shared<VerletSkinTuner>();
   propagation = std::make_shared<Propagation>();
   bonded_ias = std::make_shared<BondedInteractionsMap>();
   thermostat = std::make_shared<Thermostat::Thermostat>();
@@ -116,7 +120,10 @@ void System::initialize() {
 void reset_system() { instance.reset(); }
 
 void set_system(std::shared_ptr<System> new_instance) {
-  instance = new_instance;
+  if (new_instance != instance) {
+    instance = new_instance;
+    reset_particle_index();
+  }
 }
 
 System &get_system() { return *instance; }
@@ -180,9 +187,35 @@ void System::set_cell_structure_topology(CellStructureType topology) {
 }
 
 void System::rebuild_cell_structure() {
+  if (not load_balancer->is_uniform() and
+      not load_balancer->fits(box_geo->length(), get_interaction_range())) {
+    // domains became too narrow for the interaction range
+    load_balancer->reset();
+    update_local_geo();
+  }
   set_cell_structure_topology(cell_structure->decomposition_type());
 }
 
+void System::rebalance_domains() {
+  /* Setups that don't support non-uniform domains keep the uniform
+   * decomposition. This is not an error, since load balancing is an
+   * optimization that may be enabled before the setup is complete. */
+  if (cell_structure->decomposition_type() != CellStructureType::REGULAR or
+      lb.is_solver_set() or ek.is_solver_set()) {
+    load_balancer->skip();
+    return;
+  }
+  load_balancer->rebalance(::comm_cart, cell_structure->local_particles(),
+                           *box_geo, ::communicator.node_grid,
+                           get_interaction_range());
+  update_local_geo();
+  if (not long_range_interactions_support_domains()) {
+    load_balancer->reset();
+    update_local_geo();
+  }
+  rebuild_cell_structure();
+}
+
 void System::on_boxl_change(bool skip_method_adaption) {
   update_local_geo();
   rebuild_cell_structure();
@@ -216,6 +249,7 @@ void System::veto_boxl_change(bool skip_particle_checks) const {
 }
 
 void System::on_node_grid_change() {
+  load_balancer->reset();
   update_local_geo();
   lb.on_node_grid_change();
   ek.on_node_grid_change();
@@ -381,9 +415,15 @@ void System::on_observable_calc() {
 void System::on_lees_edwards_change() { lb.on_lees_edwards_change(); }
 
 void System::update_local_geo() {
-  *local_geo = LocalBox::make_regular_decomposition(
-      box_geo->length(), ::communicator.calc_node_index(),
-      ::communicator.node_grid);
+  if (load_balancer->is_uniform()) {
+    *local_geo = LocalBox::make_regular_decomposition(
+        box_geo->length(), ::communicator.calc_node_index(),
+        ::communicator.node_grid);
+  } else {
+    *local_geo = LocalBox::make_regular_decomposition(
+        box_geo->length(), ::communicator.calc_node_index(),
+        ::communicator.node_grid, load_balancer->get_cuts());
+  }
 }
 
 double System::maximal_cutoff() const {
@@ -423,6 +463,20 @@ bool System::long_range_interactions_sanity_checks() const {
   return false;
 }
 
+bool System::long_range_interactions_support_domains() const {
+  try {
+#ifdef ELECTROSTATICS
+    coulomb.sanity_checks();
+#endif
+#ifdef DIPOLES
+    dipoles.sanity_checks();
+#endif
+  } catch (std::runtime_error const &) {
+    return false;
+  }
+  return true;
+}
+
 double System::get_interaction_range() const {
   auto const max_cut = maximal_cutoff();
   auto const verlet_skin = cell_structure->get_verlet_skin();
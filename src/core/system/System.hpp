@@ -39,6 +39,8 @@
 class BoxGeometry;
 class LocalBox;
 struct CellStructure;
+class LoadBalancer;
+class VerletSkinTuner;
 class Propagation;
 class InteractionsNonBonded;
 class BondedInteractionsMap;
@@ -124,12 +126,23 @@ public:
   void tune_verlet_skin(double min_skin, double max_skin, double tol,
                         int int_steps, bool adjust_max_skin);
 
+  /**
+   * @brief Let the online tuner adjust the Verlet skin.
+   * Called at the end of each measurement window of the tuner.
+   */
+  void autotune_verlet_skin();
+
   /** @brief Change cell structure topology. */
   void set_cell_structure_topology(CellStructureType topology);
 
   /** @brief Rebuild cell lists. Use e.g. after a skin change. */
   void rebuild_cell_structure();
 
+  /** @brief Shift the domain boundaries to balance the load.
+   *  Setups that require uniform domains are left unchanged.
+   */
+  void rebalance_domains();
+
   /** @brief Calculate the maximal cutoff of all interactions. */
   double maximal_cutoff() const;
 
@@ -143,6 +156,11 @@ public:
    */
   bool long_range_interactions_sanity_checks() const;
 
+  /** Check whether the electrostatic and magnetostatic methods accept
+   *  the current domain decomposition, without queuing a runtime error.
+   */
+  bool long_range_interactions_support_domains() const;
+
   /** @brief Calculate the total energy. */
   std::shared_ptr<Observable_stat> calculate_energy();
 
@@ -278,6 +296,8 @@ public:
   std::shared_ptr<BoxGeometry> box_geo;
   std::shared_ptr<LocalBox> local_geo;
   std::shared_ptr<CellStructure> cell_structure;
+  std::shared_ptr<LoadBalancer> load_balancer;
+  std::shared_ptr<VerletSkinTuner> skin_tuner;
   std::shared_ptr<Propagation> propagation;
   std::shared_ptr<BondedInteractionsMap> bonded_ias;
   std::shared_ptr<InteractionsNonBonded> nonbonded_ias;
@@ -326,6 +346,11 @@ private:
 };
 
 System &get_system();
+/**
+ * @brief Make @p new_instance the active system.
+ * Global particle book-keeping is rebuilt when the active system changes,
+ * which requires all ranks to call this function.
+ */
 void set_system(std::shared_ptr<System> new_instance);
 void reset_system();
 
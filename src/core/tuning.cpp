@@ -21,7 +21,10 @@
 
 #include "tuning.hpp"
 
+#include "BoxGeometry.hpp"
+#include "LocalBox.hpp"
 #include "cell_system/CellStructure.hpp"
+#include "cell_system/VerletSkinTuner.hpp"
 #include "communication.hpp"
 #include "errorhandling.hpp"
 #include "integrate.hpp"
@@ -32,6 +35,7 @@
 
 #include <boost/mpi/collectives/all_reduce.hpp>
 #include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/operations.hpp>
 
 #include <mpi.h>
 
@@ -154,4 +158,26 @@ void System::tune_verlet_skin(double min_skin, double max_skin, double tol,
   }
   cell_structure->set_verlet_skin(0.5 * (a + b));
 }
+
+void System::autotune_verlet_skin() {
+  auto const max_cut = maximal_cutoff();
+  auto min_skin = 0.;
+  auto max_skin = 0.;
+  if (max_cut > 0.) {
+    /* The interaction range can't exceed half the box size nor the
+     * width of the narrowest domain. */
+    auto const min_domain_width = boost::mpi::all_reduce(
+        ::comm_cart, std::ranges::min(local_geo->length()),
+        boost::mpi::minimum<double>());
+    min_skin = 0.05 * max_cut;
+    max_skin = std::min(0.5 * std::ranges::min(box_geo->length()),
+                        min_domain_width) -
+               max_cut;
+  }
+  auto const new_skin = skin_tuner->update(
+      ::comm_cart, cell_structure->get_verlet_skin(), min_skin, max_skin);
+  if (new_skin) {
+    cell_structure->set_verlet_skin(*new_skin);
+  }
+}
 } // namespace System
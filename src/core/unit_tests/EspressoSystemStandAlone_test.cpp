@@ -54,6 +54,7 @@ namespace utf = boost::unit_test;
 #include "observables/ParticleVelocities.hpp"
 #include "observables/PidObservable.hpp"
 #include "p3m/FFTBackendLegacy.hpp"
+#include "p3m/FFTBackendPencil.hpp"
 #include "p3m/FFTBuffersLegacy.hpp"
 #include "particle_node.hpp"
 #include "system/System.hpp"
@@ -76,6 +77,7 @@ namespace utf = boost::unit_test;
 #include <limits>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -221,7 +223,8 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory) {
 
   // check electrostatics
 #ifdef P3M
-  {
+  for (std::string const fft_backend :
+       {"legacy", "pencil", "pencil_overlap", "pencil_r2c"}) {
     // add charges
     set_particle_property(pid1, &Particle::q, +0.5);
     set_particle_property(pid2, &Particle::q, -0.5);
@@ -236,9 +239,21 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory) {
                              5,
                              0.615,
                              1e-3};
-    auto solver =
-        new_p3m_handle<double, Arch::CPU, FFTBackendLegacy, FFTBuffersLegacy>(
-            std::move(p3m), prefactor, 1, false, true);
+    auto const overlap = fft_backend == "pencil_overlap";
+    std::shared_ptr<CoulombP3M> solver;
+    if (fft_backend == "legacy") {
+      solver = new_p3m_handle<double, Arch::CPU, FFTBackendLegacy,
+                              FFTBuffersLegacy>(std::move(p3m), prefactor, 1,
+                                                false, true, overlap);
+    } else if (fft_backend == "pencil_r2c") {
+      solver = new_p3m_handle<double, Arch::CPU, FFTBackendPencilR2C,
+                              FFTBuffersLegacy>(std::move(p3m), prefactor, 1,
+                                                false, true, overlap);
+    } else {
+      solver = new_p3m_handle<double, Arch::CPU, FFTBackendPencil,
+                              FFTBuffersLegacy>(std::move(p3m), prefactor, 1,
+                                                false, true, overlap);
+    }
     add_actor(comm, espresso::system, system.coulomb.impl->solver, solver,
               [&system]() { system.on_coulomb_change(); });
     BOOST_CHECK(not solver->is_gpu());
@@ -307,7 +322,7 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory) {
                              1e-3};
     auto solver =
         new_dp3m_handle<double, Arch::CPU, FFTBackendLegacy, FFTBuffersLegacy>(
-            std::move(p3m), prefactor, 1, false);
+            std::move(p3m), prefactor, 1, false, false);
     add_actor(comm, espresso::system, system.dipoles.impl->solver, solver,
               [&system]() { system.on_dipoles_change(); });
     BOOST_CHECK(not solver->is_gpu());
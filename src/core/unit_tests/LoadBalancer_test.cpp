@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Load balancing test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/data/monomorphic.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/unit_test.hpp>
+namespace bdata = boost::unit_test::data;
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#include "LocalBox.hpp"
+#include "Particle.hpp"
+#include "actor/registration.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/LoadBalancer.hpp"
+#include "communication.hpp"
+#include "electrostatics/coulomb.hpp"
+#include "electrostatics/p3m.hpp"
+#include "electrostatics/p3m.impl.hpp"
+#include "errorhandling.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "p3m/FFTBackendLegacy.hpp"
+#include "p3m/FFTBuffersLegacy.hpp"
+#include "p3m/common.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(balanced_domain_bounds_test) {
+  auto constexpr tol = 100. * std::numeric_limits<double>::epsilon();
+
+  /* uniform cost: uniform domains */
+  {
+    auto const bounds = balanced_domain_bounds(std::vector<double>(8, 1.), 4,
+                                               /* min_width */ 0.);
+    auto const expected = std::vector<double>{0., 0.25, 0.5, 0.75, 1.};
+    BOOST_TEST(bounds == expected, boost::test_tools::tolerance(tol)
+                                       << boost::test_tools::per_element());
+  }
+
+  /* no cost: uniform domains */
+  {
+    auto const bounds = balanced_domain_bounds(std::vector<double>(8, 0.), 2,
+                                               /* min_width */ 0.);
+    auto const expected = std::vector<double>{0., 0.5, 1.};
+    BOOST_TEST(bounds == expected, boost::test_tools::per_element());
+  }
+
+  /* cost in the first half: boundaries interpolated within bins */
+  {
+    auto const weights = std::vector<double>{2., 2., 0., 0.};
+    auto const bounds = balanced_domain_bounds(weights, 4, 0.);
+    auto const expected = std::vector<double>{0., 0.125, 0.25, 0.375, 1.};
+    BOOST_TEST(bounds == expected, boost::test_tools::tolerance(tol)
+                                       << boost::test_tools::per_element());
+  }
+
+  /* minimal width */
+  {
+    auto const weights = std::vector<double>{1., 0., 0., 0., 0., 0., 0., 0.};
+    auto const bounds = balanced_domain_bounds(weights, 4, 0.2);
+    BOOST_REQUIRE_EQUAL(bounds.size(), 5u);
+    BOOST_CHECK_EQUAL(bounds.front(), 0.);
+    BOOST_CHECK_EQUAL(bounds.back(), 1.);
+    for (std::size_t i = 1u; i < bounds.size(); ++i) {
+      BOOST_CHECK_GE(bounds[i] - bounds[i - 1u], 0.2 - tol);
+    }
+    BOOST_CHECK_CLOSE(bounds[1], 0.2, 1e-10);
+  }
+
+  /* domains cannot be wide enough: uniform domains */
+  {
+    auto const bounds = balanced_domain_bounds({1., 0.}, 4, 0.3);
+    auto const expected = std::vector<double>{0., 0.25, 0.5, 0.75, 1.};
+    BOOST_TEST(bounds == expected, boost::test_tools::tolerance(tol)
+                                       << boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(interval_test) {
+  LoadBalancer load_balancer;
+  BOOST_CHECK(not load_balancer.step());
+  load_balancer.set_interval(3);
+  BOOST_CHECK(not load_balancer.step());
+  BOOST_CHECK(not load_balancer.step());
+  BOOST_CHECK(load_balancer.step());
+  /* a skipped rebalancing starts a new interval */
+  load_balancer.skip();
+  BOOST_CHECK(not load_balancer.step());
+  BOOST_CHECK(not load_balancer.step());
+  BOOST_CHECK(load_balancer.step());
+}
+
+BOOST_AUTO_TEST_CASE(shifted_local_box_test) {
+  auto const box_l = Utils::Vector3d{10., 20., 30.};
+  auto const node_grid = Utils::Vector3i{1, 2, 3};
+  auto const cuts = std::array<std::vector<double>, 3>{
+      {{0., 1.}, {0., 0.25, 1.}, {0., 0.1, 0.5, 1.}}};
+  auto const local_box = LocalBox::make_regular_decomposition(
+      box_l, {0, 1, 1}, node_grid, cuts);
+  BOOST_CHECK(not local_box.is_uniform());
+  BOOST_CHECK_EQUAL(local_box.my_left()[0], 0.);
+  BOOST_CHECK_EQUAL(local_box.my_right()[0], 10.);
+  BOOST_CHECK_EQUAL(local_box.my_left()[1], 5.);
+  BOOST_CHECK_EQUAL(local_box.my_right()[1], 20.);
+  BOOST_CHECK_EQUAL(local_box.my_left()[2], 3.);
+  BOOST_CHECK_EQUAL(local_box.my_right()[2], 15.);
+  BOOST_CHECK_CLOSE(local_box.length()[2], 12., 1e-10);
+  BOOST_CHECK_EQUAL(local_box.boundary()[2], 0);
+  BOOST_CHECK_EQUAL(local_box.boundary()[3], -1);
+  BOOST_CHECK_EQUAL(local_box.boundary()[4], 0);
+  BOOST_CHECK_EQUAL(local_box.boundary()[5], 0);
+  BOOST_CHECK_EQUAL(local_box.domain_bounds()[2].size(), 4u);
+  BOOST_CHECK_EQUAL(local_box.domain_bounds()[2].back(), 30.);
+  BOOST_CHECK(LocalBox::make_regular_decomposition(box_l, {0, 1, 1}, node_grid)
+                  .is_uniform());
+}
+
+#ifdef LENNARD_JONES
+auto const node_grids =
+    std::vector<Utils::Vector3i>{{4, 1, 1}, {2, 2, 1}, {1, 2, 2}};
+
+/** @brief The node grids of the rebalancing test need 4 MPI ranks. */
+static boost::test_tools::assertion_result
+four_ranks(boost::unit_test::test_unit_id) {
+  return boost::mpi::communicator().size() == 4;
+}
+
+BOOST_TEST_DECORATOR(*boost::unit_test::precondition(four_ranks))
+BOOST_DATA_TEST_CASE_F(SystemFixture, rebalance_test,
+                       bdata::make(node_grids), node_grid) {
+  auto const comm = boost::mpi::communicator();
+  auto &system = *espresso::system;
+  auto &load_balancer = *system.load_balancer;
+
+  set_lj_system(Utils::Vector3d::broadcast(10.), 0.2,
+                LJ_Parameters{1., 0.4, 1., 0., 0., 0.});
+  ::communicator.set_node_grid(node_grid);
+  system.on_node_grid_change();
+
+  // dense cluster in a corner of the box
+  std::vector<int> pids;
+  for (int i = 0; i < 7; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      for (int k = 0; k < 8; ++k) {
+        auto const pid = static_cast<int>(pids.size());
+        auto const jitter = 0.01 * static_cast<double>((7 * pid) % 11);
+        create_particle({0.1 + 0.45 * i + jitter, 0.1 + 0.45 * j,
+                         0.2 + 0.9 * k + jitter},
+                        pid, 0);
+        pids.emplace_back(pid);
+      }
+    }
+  }
+
+  auto const ref_forces = get_forces(pids);
+  BOOST_REQUIRE(system.local_geo->is_uniform());
+
+  system.rebalance_domains();
+  BOOST_REQUIRE(not load_balancer.is_uniform());
+  BOOST_REQUIRE(not system.local_geo->is_uniform());
+  BOOST_CHECK_GT(load_balancer.get_imbalance_before(), 1.5);
+  BOOST_CHECK_LT(load_balancer.get_imbalance_after(),
+                 load_balancer.get_imbalance_before());
+
+  // domains are wider than the interaction range
+  auto const range = system.get_interaction_range();
+  for (auto const &bounds : system.local_geo->domain_bounds()) {
+    for (std::size_t i = 1u; i < bounds.size(); ++i) {
+      BOOST_CHECK_GE(bounds[i] - bounds[i - 1u], range);
+    }
+  }
+
+  // particles are sorted into the shifted domains
+  system.cell_structure->resort_particles(true);
+  auto const &local_geo = *system.local_geo;
+  for (auto const &p : system.cell_structure->local_particles()) {
+    for (auto i = 0u; i < 3u; ++i) {
+      BOOST_CHECK_GE(p.pos()[i], local_geo.my_left()[i]);
+      BOOST_CHECK_LT(p.pos()[i], local_geo.my_right()[i]);
+    }
+  }
+  auto const n_part = boost::mpi::all_reduce(
+      comm, static_cast<int>(system.cell_structure->local_particles().size()),
+      std::plus<>());
+  BOOST_CHECK_EQUAL(n_part, static_cast<int>(pids.size()));
+
+  // forces don't depend on the domain boundaries
+  check_forces(ref_forces, get_forces(pids));
+
+  // rebalancing during integration
+  load_balancer.set_interval(1);
+  system.integrate(2, INTEG_REUSE_FORCES_CONDITIONALLY);
+  BOOST_CHECK(not system.local_geo->is_uniform());
+  load_balancer.set_interval(0);
+
+  // a node grid change restores domains of equal size
+  system.on_node_grid_change();
+  BOOST_CHECK(load_balancer.is_uniform());
+  BOOST_CHECK(system.local_geo->is_uniform());
+}
+
+#ifdef P3M
+BOOST_TEST_DECORATOR(*boost::unit_test::precondition(four_ranks))
+BOOST_FIXTURE_TEST_CASE(uniform_long_range_test, SystemFixture) {
+  auto const comm = boost::mpi::communicator();
+  auto &system = *espresso::system;
+  auto &load_balancer = *system.load_balancer;
+
+  set_lj_system(Utils::Vector3d::broadcast(10.), 0.2,
+                LJ_Parameters{1., 0.4, 1., 0., 0., 0.});
+  ::communicator.set_node_grid({4, 1, 1});
+  system.on_node_grid_change();
+
+  // dense cluster of charges in a corner of the box
+  for (int pid = 0; pid < 100; ++pid) {
+    auto const jitter = 0.01 * static_cast<double>((7 * pid) % 11);
+    create_particle({0.1 + 0.45 * (pid % 5) + jitter,
+                     0.1 + 0.45 * ((pid / 5) % 5), 0.2 + 0.9 * (pid / 25)},
+                    pid, 0);
+    set_particle_property(pid, &Particle::q, (pid % 2 == 0) ? 1. : -1.);
+  }
+
+  // the legacy FFT backend requires domains of equal size
+  auto p3m = P3MParameters{false,
+                           0.0,
+                           1.5,
+                           Utils::Vector3i::broadcast(10),
+                           Utils::Vector3d::broadcast(0.5),
+                           5,
+                           2.,
+                           1e-3};
+  auto const solver =
+      new_p3m_handle<double, Arch::CPU, FFTBackendLegacy, FFTBuffersLegacy>(
+          std::move(p3m), 1., 1, false, true, false);
+  add_actor(comm, espresso::system, system.coulomb.impl->solver, solver,
+            [&system]() { system.on_coulomb_change(); });
+
+  // the domains are left unchanged without raising an error
+  system.rebalance_domains();
+  BOOST_CHECK(load_balancer.is_uniform());
+  BOOST_CHECK(system.local_geo->is_uniform());
+  BOOST_CHECK_EQUAL(check_runtime_errors(comm), 0);
+
+  load_balancer.set_interval(1);
+  BOOST_CHECK_EQUAL(system.integrate(2, INTEG_REUSE_FORCES_CONDITIONALLY), 0);
+  BOOST_CHECK(system.local_geo->is_uniform());
+  BOOST_CHECK_EQUAL(check_runtime_errors(comm), 0);
+  load_balancer.set_interval(0);
+
+  solver->detach_system(espresso::system);
+  system.coulomb.impl->solver = std::nullopt;
+  system.on_coulomb_change();
+}
+#endif // P3M
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Replica batch test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "particle_management.hpp"
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_node.hpp"
+#include "system/ReplicaBatch.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+static std::shared_ptr<System::System> system;
+} // namespace espresso
+
+#ifdef LENNARD_JONES
+BOOST_AUTO_TEST_CASE(replica_batch_test) {
+  auto const comm = boost::mpi::communicator();
+  auto const rank = comm.rank();
+  auto const n_replicas = std::size_t{3u};
+
+  // each replica is a jittered lattice with a different number of vacancies
+  auto const n_sites = 4 * ::communicator.node_grid;
+  std::vector<std::unordered_map<int, Utils::Vector3d>> positions(n_replicas);
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> jitter(-0.2, 0.2);
+  for (auto &replica_positions : positions) {
+    auto pid = 0;
+    for (int i = 0; i < n_sites[0]; ++i) {
+      for (int j = 0; j < n_sites[1]; ++j) {
+        for (int k = 0; k < n_sites[2]; ++k, ++pid) {
+          if (jitter(engine) < -0.15) {
+            continue;
+          }
+          replica_positions[pid] =
+              1.5 * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5} +
+              Utils::Vector3d{jitter(engine), jitter(engine), jitter(engine)};
+        }
+      }
+    }
+  }
+
+  auto const make_batch = [&]() {
+    auto batch = std::make_shared<System::ReplicaBatch>();
+    for (std::size_t i = 0u; i < n_replicas; ++i) {
+      auto const replica = batch->add_replica();
+      batch->activate(i);
+      replica->set_box_l({6. * ::communicator.node_grid[0],
+                          6. * ::communicator.node_grid[1],
+                          6. * ::communicator.node_grid[2]});
+      replica->set_cell_structure_topology(CellStructureType::REGULAR);
+      replica->set_time_step(0.01);
+      replica->cell_structure->set_verlet_skin(0.4);
+      if (i == 0u) {
+        replica->nonbonded_ias->make_particle_type_exist(0);
+        replica->nonbonded_ias->get_ia_param(0, 0).lj =
+            LJ_Parameters{1., 1., 1.12246, 0.25, 0., 0.};
+      }
+      replica->on_non_bonded_ia_change();
+      for (auto const &[pid, pos] : positions[i]) {
+        ::make_new_particle(pid, pos);
+        if (auto p = replica->cell_structure->get_local_particle(pid)) {
+          p->v() = Utils::Vector3d{0.5, -0.3, 0.1} * (i + 1.);
+        }
+      }
+      replica->on_particle_change();
+    }
+    ::System::set_system(espresso::system);
+    return batch;
+  };
+
+  auto const gather = [&](System::ReplicaBatch const &batch) {
+    std::vector<std::unordered_map<int, Utils::Vector3d>> trajectories;
+    for (std::size_t i = 0u; i < batch.size(); ++i) {
+      batch.activate(i);
+      BOOST_REQUIRE_EQUAL(::get_particle_ids_parallel().size(),
+                          positions[i].size());
+      auto &trajectory = trajectories.emplace_back();
+      for (auto const &kv : positions[i]) {
+        auto const pid = kv.first;
+        auto const p_opt = copy_particle_to_head_node(comm, *batch[i], pid);
+        if (rank == 0) {
+          trajectory[pid] = p_opt->pos();
+        }
+      }
+    }
+    ::System::set_system(espresso::system);
+    return trajectories;
+  };
+
+  auto const batch = make_batch();
+  auto const reference = make_batch();
+
+  // replicas share the non-bonded interactions
+  for (auto const &replica : *batch) {
+    BOOST_CHECK_EQUAL(replica->nonbonded_ias, (*batch)[0]->nonbonded_ias);
+    BOOST_CHECK_NE(replica->nonbonded_ias, (*reference)[0]->nonbonded_ias);
+  }
+
+  // interleaving the replicas doesn't change their trajectories
+  BOOST_REQUIRE_EQUAL(batch->integrate(20, 3, INTEG_REUSE_FORCES_NEVER), 0);
+  BOOST_REQUIRE_EQUAL(reference->integrate(20, 20, INTEG_REUSE_FORCES_NEVER),
+                      0);
+  BOOST_CHECK_EQUAL(&::System::get_system(), espresso::system.get());
+  auto const trajectories = gather(*batch);
+  auto const trajectories_ref = gather(*reference);
+  if (rank == 0) {
+    for (std::size_t i = 0u; i < n_replicas; ++i) {
+      for (auto const &[pid, pos] : trajectories_ref[i]) {
+        BOOST_CHECK_EQUAL(trajectories[i].at(pid), pos);
+        BOOST_CHECK_GT((pos - positions[i].at(pid)).norm(), 0.);
+      }
+    }
+  }
+
+  // a change of the shared interactions reaches all replicas
+  auto &nonbonded_ias = *(*batch)[0]->nonbonded_ias;
+  nonbonded_ias.get_ia_param(0, 0).lj.cut = 1.5;
+  nonbonded_ias.on_non_bonded_ia_change();
+  for (auto const &replica : *batch) {
+    // the cutoff includes the offset of the potential
+    BOOST_CHECK_CLOSE(replica->maximal_cutoff(), 1.75, 1e-10);
+    for (auto const range : replica->cell_structure->max_range()) {
+      BOOST_CHECK_GE(range, 1.75 + 0.4);
+    }
+  }
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  auto const mpi_handle = MpiContainerUnitTest(argc, argv);
+  espresso::system = System::System::create();
+  espresso::system->set_cell_structure_topology(CellStructureType::REGULAR);
+  ::System::set_system(espresso::system);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Replica exchange test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#include "ReplicaExchange.hpp"
+#include "communication.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "system/System.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace espresso {
+// index of the replica simulated by this rank
+static int replica = 0;
+// number of replicas
+static int n_replicas = 1;
+} // namespace espresso
+
+BOOST_AUTO_TEST_CASE(communicator_split) {
+  auto const world = boost::mpi::communicator();
+  BOOST_CHECK_EQUAL(::comm_cart.size() * espresso::n_replicas, world.size());
+  std::vector<int> replicas;
+  boost::mpi::all_gather(world, espresso::replica, replicas);
+  for (int i = 0; i < espresso::n_replicas; ++i) {
+    BOOST_CHECK_EQUAL(std::ranges::count(replicas, i), ::comm_cart.size());
+  }
+  BOOST_CHECK_THROW(Communication::split(world.size() + 1),
+                    std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(swap_acceptance) {
+  auto const world = boost::mpi::communicator();
+  auto const replica = espresso::replica;
+  BOOST_CHECK_THROW(ReplicaExchange(world, replica, {}, 42),
+                    std::domain_error);
+  BOOST_CHECK_THROW(ReplicaExchange(world, replica, {1., 0., 3.}, 42),
+                    std::domain_error);
+  if (espresso::n_replicas != 2) {
+    return;
+  }
+
+  ReplicaExchange driver(world, replica, {1., 2.}, 42);
+  BOOST_CHECK_EQUAL(driver.get_kT(), 1. + replica);
+
+  // a high energy at the low temperature always swaps
+  BOOST_CHECK_EQUAL(driver.exchange((replica == 0) ? 10. : 0.), 1);
+  BOOST_CHECK_EQUAL(driver.get_kT(), 2. - replica);
+  BOOST_CHECK_EQUAL(driver.get_replica_kT()[0], 1);
+  BOOST_CHECK_EQUAL(driver.get_replica_kT()[1], 0);
+
+  // odd attempts have no pair of temperatures when there are two replicas
+  BOOST_CHECK_EQUAL(driver.exchange(0.), 0);
+
+  // a much lower energy at the high temperature never swaps
+  BOOST_CHECK_EQUAL(driver.exchange((replica == 0) ? 1e3 : 0.), 0);
+  BOOST_CHECK_EQUAL(driver.get_kT(), 2. - replica);
+  BOOST_CHECK_EQUAL(driver.get_n_swaps_attempted()[0], 2);
+  BOOST_CHECK_EQUAL(driver.get_n_swaps_accepted()[0], 1);
+}
+
+#ifdef LENNARD_JONES
+BOOST_FIXTURE_TEST_CASE(parallel_tempering, SystemFixture) {
+  auto const world = boost::mpi::communicator();
+  auto &system = *espresso::system;
+  auto &thermostat = *system.thermostat;
+
+  set_lj_system(box_per_node(8.), 0.4, LJ_Parameters{1., 1., 2.5, 0., 0., 0.});
+#ifdef PARTICLE_ANISOTROPY
+  auto const gamma = Utils::Vector3d::broadcast(1.);
+#else
+  auto const gamma = 1.;
+#endif
+  thermostat.kT = 1.;
+  thermostat.langevin = std::make_shared<LangevinThermostat>();
+  thermostat.langevin->gamma = gamma;
+  thermostat.langevin->rng_initialize(42u);
+  thermostat.thermo_switch = THERMO_LANGEVIN;
+  system.on_thermostat_param_change();
+
+  auto const n_sites = 4 * ::communicator.node_grid;
+  auto pid = 0;
+  for (int i = 0; i < n_sites[0]; ++i) {
+    for (int j = 0; j < n_sites[1]; ++j) {
+      for (int k = 0; k < n_sites[2]; ++k) {
+        create_particle(2. * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5},
+                        pid++, 0);
+      }
+    }
+  }
+
+  // closely spaced temperatures swap frequently
+  std::vector<double> kT_ladder;
+  for (int i = 0; i < espresso::n_replicas; ++i) {
+    kT_ladder.emplace_back(1. + 0.01 * i);
+  }
+  ReplicaExchange driver(world, espresso::replica, kT_ladder, 42);
+  BOOST_REQUIRE_EQUAL(driver.run(system, 10, 20), 0);
+
+  // all ranks agree on the temperature of each replica
+  auto const &replica_kT = driver.get_replica_kT();
+  std::vector<int> replica_kT_ref(replica_kT);
+  boost::mpi::broadcast(world, replica_kT_ref, 0);
+  BOOST_CHECK(replica_kT == replica_kT_ref);
+  auto sorted = replica_kT;
+  std::ranges::sort(sorted);
+  for (int i = 0; i < espresso::n_replicas; ++i) {
+    BOOST_CHECK_EQUAL(sorted[i], i);
+  }
+  BOOST_CHECK_EQUAL(thermostat.kT, driver.get_kT());
+  if (espresso::n_replicas > 1) {
+    BOOST_CHECK_GT(driver.get_n_swaps_accepted()[0], 0);
+  }
+
+  thermostat.thermo_switch = THERMO_OFF;
+  thermostat.langevin.reset();
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv, []() {
+    auto const world_size = boost::mpi::communicator().size();
+    espresso::n_replicas = (world_size % 2 == 0) ? 2 : 1;
+    espresso::replica = Communication::split(espresso::n_replicas);
+  });
+}
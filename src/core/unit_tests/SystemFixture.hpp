@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2025 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/** @file
+ *  Fixture and entry point of the unit tests that run a full system
+ *  with a regular decomposition on several MPI ranks.
+ *  Include it after @c boost/test/unit_test.hpp in a test module
+ *  that defines @c BOOST_TEST_NO_MAIN and
+ *  @c BOOST_TEST_ALTERNATIVE_INIT_API.
+ */
+
+#include "ParticleFactory.hpp"
+#include "particle_management.hpp"
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/communicator.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+inline std::shared_ptr<System::System> system;
+} // namespace espresso
+
+/** Fixture to set up a system of particles and compare their forces. */
+struct SystemFixture : public ParticleFactory {
+  /** @brief Box with domains of the given length on each MPI rank. */
+  static Utils::Vector3d box_per_node(double domain_length) {
+    auto const &node_grid = ::communicator.node_grid;
+    return domain_length * static_cast<Utils::Vector3d>(node_grid);
+  }
+
+#ifdef LENNARD_JONES
+  /** @brief Set the box, the skin and the LJ interaction of type 0. */
+  void set_lj_system(Utils::Vector3d const &box_l, double skin,
+                     LJ_Parameters const &lj,
+                     double time_step = 0.01) const {
+    auto &system = *espresso::system;
+    system.set_box_l(box_l);
+    system.set_time_step(time_step);
+    system.cell_structure->set_verlet_skin(skin);
+    system.nonbonded_ias->make_particle_type_exist(0);
+    system.nonbonded_ias->get_ia_param(0, 0).lj = lj;
+    system.on_non_bonded_ia_change();
+  }
+#endif
+
+  /** @brief Recalculate the forces and gather them on the head node. */
+  static std::unordered_map<int, Utils::Vector3d>
+  get_forces(std::vector<int> const &pids) {
+    auto const comm = boost::mpi::communicator();
+    auto &system = *espresso::system;
+    system.integrate(0, INTEG_REUSE_FORCES_NEVER);
+    std::unordered_map<int, Utils::Vector3d> forces;
+    for (auto const pid : pids) {
+      auto const p_opt = copy_particle_to_head_node(comm, system, pid);
+      if (comm.rank() == 0) {
+        forces[pid] = p_opt->force();
+      }
+    }
+    return forces;
+  }
+
+  /** @brief Check the forces on the head node against reference values. */
+  static void
+  check_forces(std::unordered_map<int, Utils::Vector3d> const &ref,
+               std::unordered_map<int, Utils::Vector3d> const &res) {
+    if (boost::mpi::communicator().rank() == 0) {
+      for (auto const &[pid, f_ref] : ref) {
+        BOOST_CHECK_SMALL((res.at(pid) - f_ref).norm(),
+                          1e-10 * (1. + f_ref.norm()));
+      }
+    }
+  }
+};
+
+/**
+ * @brief Create the system and run the test module.
+ * @param argc, argv  Command line arguments
+ * @param setup       Called once MPI is initialized, before the system
+ *                    is created
+ */
+template <typename F>
+int run_system_unit_tests(int argc, char **argv, F &&setup) {
+  auto const mpi_handle = MpiContainerUnitTest(argc, argv);
+  std::forward<F>(setup)();
+  espresso::system = System::System::create();
+  espresso::system->set_cell_structure_topology(CellStructureType::REGULAR);
+  ::System::set_system(espresso::system);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
+
+inline int run_system_unit_tests(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv, []() {});
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Verlet skin online tuning test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/VerletSkinTuner.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <functional>
+
+/** Run the search on a step time model until it converges. */
+static double converge(VerletSkinTuner &tuner,
+                       std::function<double(double)> const &step_time,
+                       double skin, double min_skin, double max_skin) {
+  for (int i = 0; i < 100 and not tuner.is_settled(); ++i) {
+    auto const new_skin =
+        tuner.next_skin(skin, step_time(skin), min_skin, max_skin);
+    if (new_skin) {
+      BOOST_REQUIRE_GE(*new_skin, min_skin);
+      BOOST_REQUIRE_LE(*new_skin, max_skin);
+      skin = *new_skin;
+    }
+  }
+  BOOST_REQUIRE(tuner.is_settled());
+  return skin;
+}
+
+BOOST_AUTO_TEST_CASE(search_test) {
+  auto const tol = std::log(1.1);
+  VerletSkinTuner tuner;
+  BOOST_CHECK(not tuner.is_active());
+  BOOST_CHECK(not tuner.step(1.));
+  BOOST_CHECK(not tuner.get_tuned_skin());
+  tuner.set_interval(10);
+  BOOST_CHECK(tuner.is_active());
+  BOOST_CHECK_EQUAL(tuner.get_interval(), 10);
+
+  // Verlet list rebuilds scale with 1/skin, pair evaluations with skin
+  auto const step_time = [](double skin) { return 1. / skin + 4. * skin; };
+  auto const skin = converge(tuner, step_time, 0.1, 0.01, 2.);
+  BOOST_REQUIRE(tuner.get_tuned_skin());
+  BOOST_CHECK_EQUAL(*tuner.get_tuned_skin(), skin);
+  BOOST_CHECK_SMALL(std::log(skin / 0.5), tol);
+  BOOST_CHECK_GT(tuner.get_trace().size(), 2u);
+  BOOST_CHECK_EQUAL(tuner.get_trace().front().skin, 0.1);
+
+  // stable step times don't restart the search
+  for (int i = 0; i < 10; ++i) {
+    BOOST_CHECK(not tuner.next_skin(skin, step_time(skin), 0.01, 2.));
+  }
+  BOOST_CHECK(tuner.is_settled());
+
+  // a single slow window doesn't restart the search
+  BOOST_CHECK(not tuner.next_skin(skin, 10. * step_time(skin), 0.01, 2.));
+  BOOST_CHECK(not tuner.next_skin(skin, step_time(skin), 0.01, 2.));
+  BOOST_CHECK(tuner.is_settled());
+
+  // a drift of the step time restarts the search
+  auto const denser = [](double skin) { return 1. / skin + 16. * skin; };
+  BOOST_CHECK(not tuner.next_skin(skin, denser(skin), 0.01, 2.));
+  auto const probe = tuner.next_skin(skin, denser(skin), 0.01, 2.);
+  BOOST_REQUIRE(probe);
+  BOOST_CHECK(not tuner.is_settled());
+  BOOST_CHECK(not tuner.get_tuned_skin());
+  auto const new_skin = converge(tuner, denser, *probe, 0.01, 2.);
+  BOOST_CHECK_SMALL(std::log(new_skin / 0.25), tol);
+
+  // the search stays within the bounds
+  tuner.reset();
+  BOOST_CHECK(tuner.get_trace().empty());
+  BOOST_CHECK_EQUAL(converge(tuner, step_time, 0.1, 0.01, 0.3), 0.3);
+  tuner.reset();
+  BOOST_CHECK_EQUAL(converge(tuner, step_time, 1., 0.8, 2.), 0.8);
+
+  // the measurement window
+  tuner.set_interval(3);
+  BOOST_CHECK(not tuner.step(1e-3));
+  BOOST_CHECK(not tuner.step(1e-3));
+  BOOST_CHECK(tuner.step(1e-3));
+  auto const comm = boost::mpi::communicator();
+  BOOST_CHECK(tuner.update(comm, 0.2, 0.01, 1.));
+  BOOST_REQUIRE_EQUAL(tuner.get_trace().size(), 1u);
+  BOOST_CHECK_CLOSE(tuner.get_trace().front().time, 1., 1e-6);
+  // without room for the skin, nothing is probed
+  BOOST_CHECK(not tuner.step(1e-3));
+  BOOST_CHECK(not tuner.step(1e-3));
+  BOOST_CHECK(tuner.step(1e-3));
+  BOOST_CHECK(not tuner.update(comm, 0.2, 0.3, 0.2));
+  BOOST_CHECK_EQUAL(tuner.get_trace().size(), 1u);
+}
+
+#ifdef LENNARD_JONES
+BOOST_FIXTURE_TEST_CASE(integration_test, SystemFixture) {
+  auto const comm = boost::mpi::communicator();
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+  auto &skin_tuner = *system.skin_tuner;
+
+  set_lj_system({6., 6., 6.}, 0.1, LJ_Parameters{1., 0.5, 1., 0., 0., 0.});
+
+  auto pid = 0;
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 6; ++j) {
+      for (int k = 0; k < 6; ++k) {
+        create_particle(Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5}, pid++, 0);
+      }
+    }
+  }
+  for (int i = 0; i < pid; ++i) {
+    set_particle_v(i, {0.1 * (i % 3), 0.1 * (i % 5), -0.1});
+  }
+
+  skin_tuner.set_interval(2);
+  system.integrate(40, INTEG_REUSE_FORCES_CONDITIONALLY);
+
+  // the skin changed between windows and stays within the bounds
+  BOOST_CHECK_GE(skin_tuner.get_trace().size(), 2u);
+  auto const skin = cell_structure.get_verlet_skin();
+  BOOST_CHECK_GE(skin, 0.05 * 1.);
+  BOOST_CHECK_LE(skin, 0.5 * 6. - 1.);
+  // all ranks agree on the skin
+  auto const min_skin =
+      boost::mpi::all_reduce(comm, skin, boost::mpi::minimum<double>());
+  BOOST_CHECK_EQUAL(min_skin, skin);
+  BOOST_CHECK_EQUAL(system.get_interaction_range(), 1. + skin);
+
+  // disabling the tuner keeps the skin
+  skin_tuner.set_interval(0);
+  system.integrate(4, INTEG_REUSE_FORCES_CONDITIONALLY);
+  BOOST_CHECK_EQUAL(cell_structure.get_verlet_skin(), skin);
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
@@ -57,6 +57,8 @@ namespace bdata = boost::unit_test::data;
 #include <limits>
 #include <memory>
 #include <ostream>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace espresso {
@@ -152,9 +154,44 @@ auto const propagators =
 #endif // EXTERNAL_FORCES
     };
 
+#ifdef OPENMP
+auto const thread_counts = std::vector<int>{1, 2};
+#else
+auto const thread_counts = std::vector<int>{1};
+#endif
+
+static auto make_test_cases() {
+  std::vector<std::tuple<Utils::Vector3i,
+                         std::reference_wrapper<Testing::IntegratorHelper>,
+                         int, bool, bool>>
+      test_cases;
+  for (auto const &[use_particle_arrays, overlap] :
+       {std::pair{false, false}, std::pair{true, false},
+        std::pair{true, true}}) {
+    for (auto const n_threads : thread_counts) {
+      for (auto const &node_grid : node_grids) {
+        for (auto const &propagator : propagators) {
+#ifdef NPT
+          // the NpT integrator always runs the non-bonded loop on one thread
+          // with the particle-based kernel
+          if ((n_threads != 1 or use_particle_arrays) and
+              &propagator.get() == &Testing::velocity_verlet_npt) {
+            continue;
+          }
+#endif // NPT
+          test_cases.emplace_back(node_grid, propagator, n_threads,
+                                  use_particle_arrays, overlap);
+        }
+      }
+    }
+  }
+  return test_cases;
+}
+
 BOOST_DATA_TEST_CASE_F(ParticleFactory, verlet_list_update,
-                       bdata::make(node_grids) * bdata::make(propagators),
-                       node_grid, integration_helper) {
+                       bdata::make(make_test_cases()), node_grid,
+                       integration_helper, n_threads, use_particle_arrays,
+                       overlap_ghost_communication) {
   auto constexpr tol = 8. * 100. * std::numeric_limits<double>::epsilon();
   auto const comm = boost::mpi::communicator();
   auto const rank = comm.rank();
@@ -190,6 +227,10 @@ BOOST_DATA_TEST_CASE_F(ParticleFactory, verlet_list_update,
   auto const skin = 0.1;
   system.set_time_step(time_step);
   system.cell_structure->set_verlet_skin(skin);
+  system.cell_structure->set_n_threads(n_threads);
+  system.cell_structure->use_particle_arrays = use_particle_arrays;
+  system.cell_structure->overlap_ghost_communication =
+      overlap_ghost_communication;
   integration_helper.get().set_integrator();
 
   // If the Verlet list is not updated, two particles initially placed in
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Bulk particle insertion and removal test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "SystemFixture.hpp"
+#include "particle_management.hpp"
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "particle_node.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+BOOST_FIXTURE_TEST_CASE(bulk_insertion_and_removal, SystemFixture) {
+  auto const comm = boost::mpi::communicator();
+  auto const rank = comm.rank();
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+
+  system.set_box_l(box_per_node(4.));
+
+  // random positions, some of them outside the box
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> uniform(-0.5, 1.5);
+  auto const box_l = system.box_geo->length();
+  auto const n_part = 200;
+  std::vector<int> p_ids;
+  std::vector<Utils::Vector3d> positions;
+  for (int i = 0; i < n_part; ++i) {
+    p_ids.emplace_back(2 * i + 1);
+    positions.emplace_back(Utils::Vector3d{uniform(engine) * box_l[0],
+                                           uniform(engine) * box_l[1],
+                                           uniform(engine) * box_l[2]});
+  }
+
+  auto const count_local = [&]() {
+    auto n_local = 0;
+    for (auto const &p : cell_structure.local_particles()) {
+      BOOST_CHECK_EQUAL(cell_structure.get_local_particle(p.id()), &p);
+      ++n_local;
+    }
+    return boost::mpi::all_reduce(comm, n_local, std::plus<int>());
+  };
+
+  auto const gather = [&]() {
+    std::vector<std::pair<Utils::Vector3d, int>> result;
+    for (auto const p_id : p_ids) {
+      auto const p = cell_structure.get_local_particle(p_id);
+      auto const owner = (p != nullptr and not p->is_ghost()) ? rank : 0;
+      auto const node = boost::mpi::all_reduce(comm, owner, std::plus<int>());
+      auto const p_opt = copy_particle_to_head_node(comm, system, p_id);
+      if (rank == 0) {
+        result.emplace_back(p_opt->pos(), node);
+      }
+    }
+    return result;
+  };
+
+  // particles are stored on the same ranks as with single insertions
+  for (int i = 0; i < n_part; ++i) {
+    ::make_new_particle(p_ids[i], positions[i]);
+  }
+  auto const ref = gather();
+  ::remove_all_particles();
+  // only the head node holds the new particles
+  auto const make_particles = [&]() {
+    std::vector<Particle> particles;
+    if (rank == 0) {
+      for (int i = 0; i < n_part; ++i) {
+        auto &p = particles.emplace_back();
+        p.id() = p_ids[i];
+        p.pos() = positions[i];
+      }
+    }
+    return particles;
+  };
+  ::make_new_particles(make_particles());
+  BOOST_CHECK_EQUAL(count_local(), n_part);
+  BOOST_CHECK_EQUAL(::get_maximal_particle_id(), 2 * n_part - 1);
+  auto ids = ::get_particle_ids_parallel();
+  std::ranges::sort(ids);
+  BOOST_CHECK(ids == p_ids);
+  auto const values = gather();
+  if (rank == 0) {
+    for (int i = 0; i < n_part; ++i) {
+      BOOST_CHECK_EQUAL(values[i].first, ref[i].first);
+      BOOST_CHECK_EQUAL(values[i].second, ref[i].second);
+    }
+  }
+
+  // existing particles cannot be created again
+  BOOST_CHECK_THROW(::make_new_particles(make_particles()),
+                    std::invalid_argument);
+  BOOST_CHECK_EQUAL(count_local(), n_part);
+
+  // bonds to removed particles are removed too
+  insert_particle_bond(3, 0, {1});
+  insert_particle_bond(5, 0, {7});
+  ::remove_particles(std::vector<int>{1, 2 * n_part - 1});
+  BOOST_CHECK_EQUAL(count_local(), n_part - 2);
+  BOOST_CHECK_EQUAL(::get_maximal_particle_id(), 2 * n_part - 3);
+  auto const p3 = copy_particle_to_head_node(comm, system, 3);
+  auto const p5 = copy_particle_to_head_node(comm, system, 5);
+  if (rank == 0) {
+    BOOST_CHECK(p3->bonds().empty());
+    BOOST_CHECK_EQUAL(p5->bonds().size(), 1u);
+  }
+
+  ::remove_particles(::get_particle_ids_parallel());
+  BOOST_CHECK_EQUAL(count_local(), 0);
+  BOOST_CHECK_EQUAL(::get_maximal_particle_id(), -1);
+  BOOST_CHECK(::get_particle_ids_parallel().empty());
+}
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Batched central force kernels
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#if defined(LENNARD_JONES) and defined(WCA)
+
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/ParticleArrays.hpp"
+#include "forces_inline.hpp"
+#include "nonbonded_interactions/central_force_batch.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(batch_kernel_tags) {
+  InteractionsNonBonded ias;
+  ias.make_particle_type_exist(2);
+  ias.get_ia_param(0, 0).lj = LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+  ias.get_ia_param(0, 1).wca = WCA_Parameters{1., 1.};
+  ias.get_ia_param(1, 1).lj = LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+  ias.get_ia_param(1, 1).wca = WCA_Parameters{1., 1.};
+#ifdef DPD
+  ias.get_ia_param(0, 2).dpd = DPD_Parameters{1., 1., 1., 0, 1., 1., 0};
+#endif
+#ifdef MORSE
+  ias.get_ia_param(1, 2).lj = LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+  ias.get_ia_param(1, 2).morse = Morse_Parameters{1., 1., 1., 2.};
+#endif
+  ias.recalc_maximal_cutoffs();
+
+  auto const batch_kernel = [&ias](int i, int j) {
+    return ias.get_compact_ia_param(i, j).batch_kernel;
+  };
+  BOOST_CHECK(batch_kernel(0, 0) == BatchKernel::LJ_ONLY);
+  BOOST_CHECK(batch_kernel(0, 1) == BatchKernel::WCA_ONLY);
+  BOOST_CHECK(batch_kernel(1, 0) == BatchKernel::WCA_ONLY);
+  BOOST_CHECK(batch_kernel(1, 1) == BatchKernel::LJ_AND_WCA);
+  BOOST_CHECK(batch_kernel(0, 2) == BatchKernel::NONE);
+  BOOST_CHECK(batch_kernel(1, 2) == BatchKernel::NONE);
+  BOOST_CHECK(batch_kernel(2, 2) == BatchKernel::NONE);
+  BOOST_CHECK(not ias.get_compact_ia_param(2, 2).active);
+  BOOST_CHECK(ias.get_compact_ia_param(1, 1).active);
+}
+
+BOOST_AUTO_TEST_CASE(compact_parameters) {
+  auto constexpr tol = 1e-12; // in percent
+  InteractionsNonBonded ias;
+  ias.get_ia_param(0, 0).lj = LJ_Parameters{1.5, 0.8, 2.5, 0.2, 0.1, 0.3};
+  ias.recalc_maximal_cutoffs();
+  /* new types do not interact until the parameters are set */
+  ias.make_particle_type_exist(3);
+  BOOST_CHECK(ias.get_compact_ia_param(0, 0).active);
+  BOOST_CHECK(not ias.get_compact_ia_param(3, 0).active);
+  BOOST_CHECK(ias.get_compact_ia_param(3, 3).batch_kernel == BatchKernel::NONE);
+  ias.get_ia_param(3, 1).wca = WCA_Parameters{2., 0.9};
+  ias.recalc_maximal_cutoffs();
+
+  auto const &lj = ias.get_compact_ia_param(0, 0);
+  BOOST_CHECK_CLOSE(lj.lj_c12, 48. * 1.5 * std::pow(0.8, 12), tol);
+  BOOST_CHECK_CLOSE(lj.lj_c6, 24. * 1.5 * std::pow(0.8, 6), tol);
+  BOOST_CHECK_CLOSE(lj.lj_offset, 0.2, tol);
+  BOOST_CHECK_CLOSE(lj.lj_min_cut, 0.3, tol);
+  BOOST_CHECK_CLOSE(lj.lj_max_cut, 2.7, tol);
+  auto const &wca = ias.get_compact_ia_param(1, 3);
+  BOOST_CHECK(&wca == &ias.get_compact_ia_param(3, 1));
+  BOOST_CHECK(wca.batch_kernel == BatchKernel::WCA_ONLY);
+  BOOST_CHECK_CLOSE(wca.wca_c12, 48. * 2. * std::pow(0.9, 12), tol);
+  BOOST_CHECK_CLOSE(wca.wca_c6, 24. * 2. * std::pow(0.9, 6), tol);
+  BOOST_CHECK_CLOSE(wca.wca_cut, ias.get_ia_param(1, 3).wca.cut, tol);
+}
+
+BOOST_AUTO_TEST_CASE(compact_vs_full_parameters) {
+  auto constexpr tol = 100. * std::numeric_limits<double>::epsilon();
+  InteractionsNonBonded ias;
+  ias.make_particle_type_exist(1);
+  ias.get_ia_param(0, 0).lj = LJ_Parameters{1., 0.8, 2.5, 0.2, 0.1, 0.3};
+  ias.get_ia_param(0, 1).wca = WCA_Parameters{1.2, 0.9};
+  ias.get_ia_param(1, 1).lj = LJ_Parameters{0.7, 0.8, 1.5, 0.1, 0.2, 0.};
+  ias.get_ia_param(1, 1).wca = WCA_Parameters{1., 0.7};
+  ias.recalc_maximal_cutoffs();
+
+  // the default pair kernel evaluates these pairs from the compact table
+  auto const d = Utils::Vector3d{0.6, -0.8, 0.}; // unit vector
+  for (auto const &[i, j] : {std::pair{0, 0}, {0, 1}, {1, 1}}) {
+    auto const &compact = ias.get_compact_ia_param(i, j);
+    auto const &ia_params = ias.get_ia_param(i, j);
+    BOOST_REQUIRE(compact.batch_kernel != BatchKernel::NONE);
+    BOOST_CHECK_EQUAL(compact.max_cut, ia_params.max_cut);
+    for (auto dist = 0.35; dist < 3.; dist += 0.05) {
+      auto const ref = calc_central_radial_force(ia_params, dist * d, dist).f;
+      auto const value =
+          compact_central_force_factor(compact, dist, dist * dist) * dist * d;
+      BOOST_CHECK_SMALL((value - ref).norm(), tol * (1. + ref.norm()));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batched_vs_scalar) {
+  auto constexpr n_part = 200;
+  auto constexpr box_l = 4.;
+  auto constexpr tol = 100. * std::numeric_limits<double>::epsilon();
+
+  InteractionsNonBonded ias;
+  ias.make_particle_type_exist(3);
+  ias.get_ia_param(0, 0).lj = LJ_Parameters{1., 0.8, 2.5, 0., 0., 0.};
+  ias.get_ia_param(0, 1).wca = WCA_Parameters{1.2, 0.9};
+  ias.get_ia_param(1, 1).lj = LJ_Parameters{0.7, 0.8, 1.5, 0.1, 0.2, 0.};
+  ias.get_ia_param(1, 1).wca = WCA_Parameters{1., 0.7};
+  ias.get_ia_param(0, 2).lj = LJ_Parameters{1., 0.6, 1.2, 0.2, 0., 0.};
+#ifdef MORSE
+  ias.get_ia_param(2, 2).lj = LJ_Parameters{1., 0.8, 2.5, 0., 0., 0.};
+  ias.get_ia_param(2, 2).morse = Morse_Parameters{1., 1., 1., 2.};
+#endif
+  ias.recalc_maximal_cutoffs();
+
+  Cell cell;
+  cell.m_neighbors = Neighbors<Cell *>({}, {});
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist_pos(0., box_l);
+  std::uniform_int_distribution<int> dist_type(0, 3);
+  for (int pid = 0; pid < n_part; ++pid) {
+    Particle p;
+    p.id() = pid;
+    p.type() = dist_type(rng);
+    p.pos() = {dist_pos(rng), dist_pos(rng), dist_pos(rng)};
+    cell.particles().insert(std::move(p));
+  }
+  auto const cells = std::vector<Cell *>{&cell};
+
+  ParticleArrays arrays;
+  arrays.rebuild(cells, {});
+  std::vector<ParticleArrays::IndexPair> pairs;
+  for (unsigned int i = 0; i < n_part; ++i) {
+    for (unsigned int j = i + 1; j < n_part; ++j) {
+      pairs.emplace_back(i, j);
+    }
+  }
+  auto const df = detail::EuclidianDistance{};
+  auto const scalar_kernel = [&ias](ParticleArrays &arrays, std::size_t i,
+                                    std::size_t j, Distance const &d) {
+    auto const &ia_params = ias.get_ia_param(arrays.type[i], arrays.type[j]);
+    add_non_bonded_pair_force(
+        arrays, i, j, d.vec21, std::sqrt(d.dist2), ia_params,
+        static_cast<Coulomb::ShortRangeForceKernel::kernel_type const *>(
+            nullptr));
+  };
+
+  arrays.gather();
+  for (auto const &[i, j] : pairs) {
+    scalar_kernel(arrays, i, j, df(arrays.pos[i], arrays.pos[j]));
+  }
+  auto const ref = arrays.force;
+
+  arrays.gather();
+  add_central_forces_batched(arrays, pairs, df, ias, scalar_kernel);
+
+  for (std::size_t i = 0; i < arrays.size(); ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      BOOST_CHECK_SMALL(arrays.force[i][k] - ref[i][k],
+                        tol * (1. + std::abs(ref[i][k])));
+    }
+  }
+}
+
+/* The force calculation evaluates the Verlet lists of the particle
+ * arrays with the batched kernels; it must agree with the scalar kernel
+ * of the particle-based force loop. */
+BOOST_FIXTURE_TEST_CASE(batched_vs_particle_loop, SystemFixture) {
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+  auto &ias = *system.nonbonded_ias;
+
+  auto const box_l = box_per_node(5.);
+  set_lj_system(box_l, 0.3, LJ_Parameters{1., 0.8, 2.5, 0., 0., 0.});
+  ias.make_particle_type_exist(1);
+  ias.get_ia_param(0, 1).wca = WCA_Parameters{1.2, 0.9};
+  ias.get_ia_param(1, 1).lj = LJ_Parameters{0.7, 0.8, 1.5, 0.1, 0.2, 0.};
+  ias.get_ia_param(1, 1).wca = WCA_Parameters{1., 0.7};
+  system.on_non_bonded_ia_change();
+  BOOST_REQUIRE(ias.get_compact_ia_param(0, 0).batch_kernel ==
+                BatchKernel::LJ_ONLY);
+  BOOST_REQUIRE(ias.get_compact_ia_param(0, 1).batch_kernel ==
+                BatchKernel::WCA_ONLY);
+  BOOST_REQUIRE(ias.get_compact_ia_param(1, 1).batch_kernel ==
+                BatchKernel::LJ_AND_WCA);
+
+  // jittered lattice with a lattice constant of 0.9
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> jitter(-0.1, 0.1);
+  auto const n_sites = static_cast<Utils::Vector3i>(box_l / 0.9);
+  std::vector<int> pids;
+  for (int i = 0; i < n_sites[0]; ++i) {
+    for (int j = 0; j < n_sites[1]; ++j) {
+      for (int k = 0; k < n_sites[2]; ++k) {
+        auto const pid = static_cast<int>(pids.size());
+        auto const pos = 0.9 * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5} +
+                         Utils::Vector3d{jitter(engine), jitter(engine),
+                                         jitter(engine)};
+        create_particle(pos, pid, pid % 2);
+        pids.emplace_back(pid);
+      }
+    }
+  }
+
+  cell_structure.use_particle_arrays = false;
+  auto const ref_forces = get_forces(pids);
+
+  // the first force calculation builds the Verlet lists of the particle
+  // arrays, the second one evaluates them in batches
+  cell_structure.use_particle_arrays = true;
+  check_forces(ref_forces, get_forces(pids));
+  check_forces(ref_forces, get_forces(pids));
+
+  cell_structure.use_particle_arrays = false;
+}
+
+#else // defined(LENNARD_JONES) and defined(WCA)
+BOOST_AUTO_TEST_CASE(batched_vs_scalar) {}
+#endif // defined(LENNARD_JONES) and defined(WCA)
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
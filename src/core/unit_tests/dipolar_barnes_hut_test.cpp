@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Dipolar Barnes-Hut tree code test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#include "BoxGeometry.hpp"
+#include "Particle.hpp"
+#include "actor/registration.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "magnetostatics/dipolar_barnes_hut.hpp"
+#include "magnetostatics/dipolar_direct_sum.hpp"
+#include "magnetostatics/dipoles.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/quaternion.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef DIPOLES
+namespace {
+struct Result {
+  std::unordered_map<int, Utils::Vector3d> forces;
+  std::unordered_map<int, Utils::Vector3d> torques;
+  double energy;
+};
+
+template <typename Solver> Result evaluate(std::shared_ptr<Solver> solver) {
+  auto const comm = boost::mpi::communicator();
+  auto &system = *espresso::system;
+  add_actor(comm, espresso::system, system.dipoles.impl->solver, solver,
+            [&system]() { system.on_dipoles_change(); });
+  auto const particles = system.cell_structure->local_particles();
+  for (auto &p : particles) {
+    p.force() = {};
+    p.torque() = {};
+  }
+  solver->add_long_range_forces(particles);
+  Result result{};
+  for (auto const &p : particles) {
+    result.forces[p.id()] = p.force();
+    result.torques[p.id()] = p.torque();
+  }
+  result.energy = boost::mpi::all_reduce(
+      comm, solver->long_range_energy(particles), std::plus<>());
+  solver->detach_system(espresso::system);
+  system.dipoles.impl->solver = std::nullopt;
+  system.on_dipoles_change();
+  return result;
+}
+
+/** @brief Relative root-mean-square deviation over all MPI ranks. */
+double rms_error(std::unordered_map<int, Utils::Vector3d> const &values,
+                 std::unordered_map<int, Utils::Vector3d> const &ref) {
+  auto const comm = boost::mpi::communicator();
+  auto local = Utils::Vector2d{};
+  for (auto const &[pid, value_ref] : ref) {
+    local[0] += (values.at(pid) - value_ref).norm2();
+    local[1] += value_ref.norm2();
+  }
+  auto const total = boost::mpi::all_reduce(comm, local, std::plus<>());
+  return std::sqrt(total[0] / total[1]);
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(barnes_hut_vs_direct_sum, SystemFixture) {
+  auto &system = *espresso::system;
+  auto &box_geo = *system.box_geo;
+  auto const box_l = 10.;
+  system.set_box_l(Utils::Vector3d::broadcast(box_l));
+  system.cell_structure->set_verlet_skin(0.4);
+
+  // jittered lattice of randomly oriented dipoles
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+  std::normal_distribution<double> normal(0., 1.);
+  auto const n_sites = 6;
+  auto const spacing = box_l / static_cast<double>(n_sites);
+  int pid = 0;
+  for (int i = 0; i < n_sites; ++i) {
+    for (int j = 0; j < n_sites; ++j) {
+      for (int k = 0; k < n_sites; ++k) {
+        auto const pos =
+            spacing * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5} +
+            Utils::Vector3d{jitter(engine), jitter(engine), jitter(engine)};
+        auto const director =
+            Utils::Vector3d{normal(engine), normal(engine), normal(engine)}
+                .normalized();
+        create_particle(pos, pid, 0);
+        set_particle_property(pid, &Particle::dipm, 1.);
+        set_particle_property(
+            pid, &Particle::quat,
+            Utils::convert_director_to_quaternion(director));
+        ++pid;
+      }
+    }
+  }
+
+  auto const set_periodicity = [&](Utils::Vector3i const &periodic) {
+    for (auto i = 0u; i < 3u; ++i) {
+      box_geo.set_periodic(i, static_cast<bool>(periodic[i]));
+    }
+    system.on_periodicity_change();
+  };
+
+  struct Geometry {
+    Utils::Vector3i periodic;
+    int n_replicas;
+  };
+  for (auto const &[periodic, n_replicas] :
+       {Geometry{{0, 0, 0}, 0}, Geometry{{1, 1, 0}, 1},
+        Geometry{{0, 0, 1}, 2}, Geometry{{1, 1, 1}, 0}}) {
+    set_periodicity(periodic);
+    auto const ref =
+        evaluate(std::make_shared<DipolarDirectSum>(1.2, n_replicas));
+
+    std::vector<double> errors;
+    for (auto const order : {2, 3, 4, 6}) {
+      auto const result = evaluate(
+          std::make_shared<DipolarBarnesHut>(1.2, 0.3, order, n_replicas));
+      errors.emplace_back(rms_error(result.forces, ref.forces));
+      if (order == 6 and n_replicas == 0) {
+        // with replicas, the energy of the periodic self-images differs
+        BOOST_CHECK_LT(std::abs(result.energy / ref.energy - 1.), 1e-3);
+      }
+    }
+    // the error decreases with the order of the multipole expansion
+    for (auto i = 1u; i < errors.size(); ++i) {
+      BOOST_CHECK_LT(errors[i], errors[i - 1u]);
+    }
+    BOOST_CHECK_LT(errors.back(), 2e-3);
+
+    // with a small opening angle, the result converges to the direct sum
+    auto const result = evaluate(
+        std::make_shared<DipolarBarnesHut>(1.2, 0.1, 4, n_replicas));
+    BOOST_CHECK_LT(rms_error(result.forces, ref.forces), 2e-5);
+    BOOST_CHECK_LT(rms_error(result.torques, ref.torques), 2e-5);
+  }
+  set_periodicity({1, 1, 1});
+
+#ifdef OPENMP
+  // the threads evaluate the same tree for disjoint targets
+  auto const serial =
+      evaluate(std::make_shared<DipolarBarnesHut>(1.2, 0.3, 4, 0));
+  system.cell_structure->set_n_threads(3);
+  auto const threaded =
+      evaluate(std::make_shared<DipolarBarnesHut>(1.2, 0.3, 4, 0));
+  system.cell_structure->set_n_threads(1);
+  BOOST_CHECK_SMALL(rms_error(threaded.forces, serial.forces), 1e-14);
+  BOOST_CHECK_SMALL(rms_error(threaded.torques, serial.torques), 1e-14);
+  BOOST_CHECK_CLOSE(threaded.energy, serial.energy, 1e-10);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(invalid_parameters) {
+  BOOST_CHECK_THROW(DipolarBarnesHut(-1., 0.5, 3, 0), std::domain_error);
+  BOOST_CHECK_THROW(DipolarBarnesHut(1., 0., 3, 0), std::domain_error);
+  BOOST_CHECK_THROW(DipolarBarnesHut(1., 1., 3, 0), std::domain_error);
+  BOOST_CHECK_THROW(DipolarBarnesHut(1., 0.5, 0, 0), std::domain_error);
+  BOOST_CHECK_THROW(DipolarBarnesHut(1., 0.5, 9, 0), std::domain_error);
+  BOOST_CHECK_THROW(DipolarBarnesHut(1., 0.5, 3, -1), std::domain_error);
+}
+#endif // DIPOLES
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Half-shell ghost scheme test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/data/monomorphic.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/unit_test.hpp>
+namespace bdata = boost::unit_test::data;
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/GhostShell.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(upper_half_shell) {
+  // exactly one of two opposite neighbor domains is imported
+  auto n_regions = 0;
+  for (int z = -1; z <= 1; ++z) {
+    for (int y = -1; y <= 1; ++y) {
+      for (int x = -1; x <= 1; ++x) {
+        auto const region = Utils::Vector3i{x, y, z};
+        BOOST_CHECK(imports_region(GhostShell::FULL, region));
+        if (region != Utils::Vector3i{}) {
+          BOOST_CHECK_NE(imports_region(GhostShell::HALF, region),
+                         imports_region(GhostShell::HALF, -region));
+          n_regions += imports_region(GhostShell::HALF, region);
+        }
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(n_regions, 13);
+  BOOST_CHECK(imports_region(GhostShell::HALF, {0, 0, 0}));
+  BOOST_CHECK(imports_region(GhostShell::HALF, {-1, -1, 1}));
+  BOOST_CHECK(not imports_region(GhostShell::HALF, {1, 1, -1}));
+}
+
+#ifdef LENNARD_JONES
+/* Box length per node along each direction; the small box has a global
+ * grid of two cells, where neighbors are reached through several images. */
+auto const domain_lengths = std::vector<double>{5., 1.5};
+
+BOOST_DATA_TEST_CASE_F(SystemFixture, ghost_shell_test,
+                       bdata::make(domain_lengths), domain_length) {
+  auto const comm = boost::mpi::communicator();
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+
+  auto box_l = box_per_node(domain_length);
+  for (auto i = 0u; i < 3u; ++i) {
+    box_l[i] = std::max(box_l[i], 3.);
+  }
+  set_lj_system(box_l, 0.2, LJ_Parameters{1., 0.3, 1., 0., 0., 0.});
+
+  // jittered lattice with a lattice constant of 0.5
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> jitter(-0.1, 0.1);
+  auto const n_sites = Utils::Vector3i{static_cast<int>(2. * box_l[0]),
+                                       static_cast<int>(2. * box_l[1]),
+                                       static_cast<int>(2. * box_l[2])};
+  std::vector<int> pids;
+  for (int i = 0; i < n_sites[0]; ++i) {
+    for (int j = 0; j < n_sites[1]; ++j) {
+      for (int k = 0; k < n_sites[2]; ++k) {
+        auto const pid = static_cast<int>(pids.size());
+        auto const pos = 0.5 * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5} +
+                         Utils::Vector3d{jitter(engine), jitter(engine),
+                                         jitter(engine)};
+        create_particle(pos, pid, 0);
+        set_particle_v(pid, {jitter(engine), jitter(engine), jitter(engine)});
+        pids.emplace_back(pid);
+      }
+    }
+  }
+
+  auto const count_ghosts = [&]() {
+    auto const n_ghosts = cell_structure.ghost_particles().size();
+    return boost::mpi::all_reduce(comm, n_ghosts, std::plus<std::size_t>());
+  };
+
+  BOOST_REQUIRE(cell_structure.get_ghost_shell() == GhostShell::FULL);
+  BOOST_REQUIRE(not cell_structure.has_half_ghost_shell());
+  auto const ref_forces = get_forces(pids);
+  auto const n_ghosts_full = count_ghosts();
+
+  // the half shell finds the same pairs with half of the ghosts
+  cell_structure.set_ghost_shell(GhostShell::HALF);
+  BOOST_REQUIRE(cell_structure.has_half_ghost_shell());
+  check_forces(ref_forces, get_forces(pids));
+  auto const n_ghosts_half = count_ghosts();
+  BOOST_CHECK_GT(n_ghosts_half, 0u);
+  BOOST_CHECK_LT(n_ghosts_half, 0.6 * static_cast<double>(n_ghosts_full));
+
+  // the particle index is up-to-date after resorts
+  system.integrate(20, INTEG_REUSE_FORCES_CONDITIONALLY);
+  for (auto &p : cell_structure.local_particles()) {
+    BOOST_CHECK_EQUAL(cell_structure.get_local_particle(p.id()), &p);
+  }
+  auto const half_forces = get_forces(pids);
+  cell_structure.set_ghost_shell(GhostShell::FULL);
+  check_forces(half_forces, get_forces(pids));
+
+  // neighbor searches need ghosts on all sides
+  cell_structure.set_ghost_shell(GhostShell::HALF);
+  BOOST_CHECK_THROW(get_short_range_neighbors(system, 0, 0.5),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(system.particle_short_range_energy_contribution(0),
+                    std::runtime_error);
+  cell_structure.set_ghost_shell(GhostShell::FULL);
+  BOOST_CHECK(get_short_range_neighbors(system, 0, 0.5).has_value() ==
+              (cell_structure.get_local_particle(0) != nullptr));
+}
+
+/* The ghost update of the integrator overlaps with the evaluation of the
+ * inner cells; the forces must not depend on it. On four ranks, the node
+ * grid has two domains along x and y. */
+BOOST_DATA_TEST_CASE_F(SystemFixture, overlap_ghost_communication_test,
+                       bdata::make(std::vector<bool>{false, true}),
+                       half_shell) {
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+  auto const &node_grid = ::communicator.node_grid;
+  BOOST_REQUIRE_GE(std::ranges::count_if(node_grid, [](int n) {
+                     return n > 1;
+                   }),
+                   2);
+
+  auto const box_l = box_per_node(4.);
+  set_lj_system(box_l, 0.2, LJ_Parameters{1., 0.3, 1., 0., 0., 0.});
+  cell_structure.set_ghost_shell(half_shell ? GhostShell::HALF
+                                            : GhostShell::FULL);
+  cell_structure.use_particle_arrays = true;
+
+  // jittered lattice with a lattice constant of 0.8
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> jitter(-0.1, 0.1);
+  auto const n_sites = static_cast<Utils::Vector3i>(box_l / 0.8);
+  std::vector<int> pids;
+  for (int i = 0; i < n_sites[0]; ++i) {
+    for (int j = 0; j < n_sites[1]; ++j) {
+      for (int k = 0; k < n_sites[2]; ++k) {
+        auto const pid = static_cast<int>(pids.size());
+        auto const pos = 0.8 * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5} +
+                         Utils::Vector3d{jitter(engine), jitter(engine),
+                                         jitter(engine)};
+        create_particle(pos, pid, 0);
+        set_particle_v(pid, {jitter(engine), jitter(engine), jitter(engine)});
+        pids.emplace_back(pid);
+      }
+    }
+  }
+
+  auto const forces = [&](bool overlap) {
+    cell_structure.overlap_ghost_communication = overlap;
+    return get_forces(pids);
+  };
+
+  // the first force calculation resorts, the following ones overlap
+  auto const ref_forces = forces(false);
+  check_forces(ref_forces, forces(true));
+
+  // overlapped ghost updates during the integration
+  cell_structure.overlap_ghost_communication = true;
+  system.integrate(20, INTEG_REUSE_FORCES_CONDITIONALLY);
+  auto const overlap_forces = forces(true);
+  check_forces(overlap_forces, forces(false));
+
+  cell_structure.overlap_ghost_communication = false;
+  cell_structure.use_particle_arrays = false;
+  cell_structure.set_ghost_shell(GhostShell::FULL);
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
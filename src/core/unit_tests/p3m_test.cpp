@@ -21,12 +21,21 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include "p3m/TuningDatabase.hpp"
 #include "p3m/common.hpp"
+#include "p3m/interpolation.hpp"
 
 #include <utils/Vector.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
 BOOST_AUTO_TEST_CASE(calc_meshift_false) {
@@ -58,3 +67,179 @@ BOOST_AUTO_TEST_CASE(calc_meshift_true) {
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE(interpolation_weights) {
+  P3MLocalMesh local_mesh{};
+  local_mesh.dim = Utils::Vector3i{{12, 12, 12}};
+  local_mesh.ld_pos[0] = local_mesh.ld_pos[1] = local_mesh.ld_pos[2] = -1.5;
+  auto const ai = Utils::Vector3d::broadcast(2.);
+  auto const positions = std::vector<Utils::Vector3d>{
+      {0., 0., 0.}, {0.1, 0.7, 1.3}, {1.9, 0.25, 0.6}};
+
+  p3m_interpolation_cache<> cache;
+  cache.reset(7);
+  cache.resize(positions.size());
+  for (std::size_t i = positions.size(); i-- > 0u;) {
+    auto const w =
+        p3m_calculate_interpolation_weights<7>(positions[i], ai, local_mesh);
+    // the weights are a partition of unity
+    for (auto const &w_d : {w.w_x, w.w_y, w.w_z}) {
+      BOOST_CHECK_CLOSE(std::accumulate(w_d.begin(), w_d.end(), 0.), 1., 1e-9);
+    }
+    cache.store_at(i, w);
+  }
+  cache.store(
+      p3m_calculate_interpolation_weights<7>(positions[0], ai, local_mesh));
+  BOOST_REQUIRE_EQUAL(cache.size(), positions.size() + 1u);
+  for (std::size_t i = 0u; i < positions.size(); ++i) {
+    auto const ref =
+        p3m_calculate_interpolation_weights<7>(positions[i], ai, local_mesh);
+    auto const w = cache.load<7>(i);
+    BOOST_CHECK_EQUAL(w.ind, ref.ind);
+    BOOST_CHECK(std::ranges::equal(w.w_x, ref.w_x));
+    BOOST_CHECK(std::ranges::equal(w.w_y, ref.w_y));
+    BOOST_CHECK(std::ranges::equal(w.w_z, ref.w_z));
+  }
+  BOOST_CHECK_EQUAL(cache.load<7>(positions.size()).ind, cache.load<7>(0).ind);
+}
+
+BOOST_AUTO_TEST_CASE(interpolation_cache_single_precision) {
+  InterpolationWeights<2> w{};
+  w.ind = (1 << 24) + 1;
+  w.w_x = {0.25, 0.75};
+  w.w_y = {0.5, 0.5};
+  w.w_z = {1. / 3., 2. / 3.};
+
+  p3m_interpolation_cache<float> cache;
+  cache.reset(2);
+  cache.store(w);
+  cache.store(w);
+  auto const ref = cache.load<2>(1);
+  // mesh indices are stored without loss of precision
+  BOOST_CHECK_EQUAL(ref.ind, w.ind);
+  BOOST_CHECK_EQUAL(ref.w_x[1], 0.75);
+  BOOST_CHECK_EQUAL(ref.w_z[0], static_cast<double>(1.f / 3.f));
+
+  // the buffer is reused after a reset
+  cache.reset(2);
+  BOOST_CHECK_EQUAL(cache.size(), 0u);
+  cache.resize(1u);
+  cache.store_at(0u, w);
+  BOOST_CHECK_EQUAL(cache.load<2>(0).ind, w.ind);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_database) {
+  auto const filename =
+      (std::filesystem::temp_directory_path() / "p3m_test_tuning.txt")
+          .string();
+  std::filesystem::remove(filename);
+
+  auto const make_entry = [](double box_l, int mesh, double r_cut) {
+    TuningDatabase::Entry entry{};
+    entry.key = {"CoulombP3M", "double", "pencil_r2c", {1, 1, 2},
+                 {box_l, box_l, box_l}, 1000, 1000., 1e-4, 0.4};
+    entry.mesh = {mesh, mesh, mesh};
+    entry.cao = 5;
+    entry.r_cut = r_cut;
+    entry.time = 1.5;
+    return entry;
+  };
+
+  // a missing file is an empty database
+  BOOST_CHECK(TuningDatabase{filename}.entries().empty());
+  {
+    TuningDatabase db{filename};
+    db.insert(make_entry(10., 32, 2.5));
+    db.insert(make_entry(11., 40, 3.5));
+    db.save();
+  }
+  {
+    // entries are merged with the ones already on disk
+    TuningDatabase db{filename};
+    db.insert(make_entry(10., 32, 3.));
+    db.save();
+  }
+  {
+    // concurrent saves don't lose entries
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 8; ++i) {
+      writers.emplace_back([&filename, &make_entry, i]() {
+        TuningDatabase db{filename};
+        db.insert(make_entry(20. + i, 64, 4.));
+        db.save();
+      });
+    }
+    for (auto &writer : writers) {
+      writer.join();
+    }
+    BOOST_CHECK_EQUAL(TuningDatabase{filename}.entries().size(), 10u);
+  }
+  TuningDatabase const db{filename};
+  BOOST_REQUIRE_EQUAL(db.entries().size(), 10u);
+
+  // exact match
+  auto const exact = db.find(make_entry(10., 0, 0.).key);
+  BOOST_REQUIRE(exact.has_value());
+  BOOST_CHECK_EQUAL(exact->mesh, Utils::Vector3i::broadcast(32));
+  BOOST_CHECK_EQUAL(exact->r_cut, 3.);
+  BOOST_CHECK_EQUAL(exact->time, 1.5);
+
+  // interpolation between the two neighbors, weighted by inverse distance
+  auto const key = make_entry(10.25, 0, 0.).key;
+  auto const d0 = TuningDatabase::distance(key, make_entry(10., 0, 0.).key);
+  auto const d1 = TuningDatabase::distance(key, make_entry(11., 0, 0.).key);
+  auto const w0 = (1. / d0) / (1. / d0 + 1. / d1);
+  auto const interpolated = db.find(key);
+  BOOST_REQUIRE(interpolated.has_value());
+  BOOST_CHECK_CLOSE(interpolated->r_cut, w0 * 3. + (1. - w0) * 3.5, 1e-10);
+  BOOST_CHECK_EQUAL(interpolated->mesh[0] % 2, 0);
+  BOOST_CHECK_GT(interpolated->mesh[0], 32);
+  BOOST_CHECK_LT(interpolated->mesh[0], 40);
+  BOOST_CHECK_EQUAL(interpolated->cao, 5);
+
+  // incompatible or distant systems are not matched
+  auto other = make_entry(10., 0, 0.).key;
+  other.node_grid = {2, 1, 1};
+  BOOST_CHECK(not db.find(other).has_value());
+  other = make_entry(10., 0, 0.).key;
+  other.precision = "float";
+  BOOST_CHECK(not db.find(other).has_value());
+  other = make_entry(10., 0, 0.).key;
+  other.fft_backend = "pencil";
+  BOOST_CHECK(not db.find(other).has_value());
+  other = make_entry(10., 0, 0.).key;
+  other.accuracy = 1e-5;
+  BOOST_CHECK(not db.find(other).has_value());
+  BOOST_CHECK(not db.find(make_entry(40., 0, 0.).key).has_value());
+
+  // the file starts with the format version
+  {
+    std::ifstream stream(filename);
+    std::string line;
+    std::getline(stream, line);
+    BOOST_CHECK_EQUAL(line, "# tuning database format " +
+                                std::to_string(TuningDatabase::format_version));
+  }
+
+  // malformed files are rejected
+  std::ofstream(filename, std::ios::app) << "CoulombP3M double 1 1\n";
+  BOOST_CHECK_THROW(TuningDatabase{filename}, std::runtime_error);
+
+  // files without the current format version are ignored
+  std::ofstream(filename)
+      << "# solver precision node_grid[3] box_l[3] n_particles sum_prop "
+         "accuracy skin mesh[3] cao r_cut time\n"
+      << "CoulombP3M double 1 1 2 10 10 10 1000 1000 0.0001 0.4 32 32 32 5 "
+         "2.5 1.5\n";
+  BOOST_CHECK(TuningDatabase{filename}.entries().empty());
+  {
+    TuningDatabase db{filename};
+    db.insert(make_entry(10., 32, 2.5));
+    db.save();
+  }
+  BOOST_CHECK_EQUAL(TuningDatabase{filename}.entries().size(), 1u);
+  std::ofstream(filename) << "# tuning database format 1\n";
+  BOOST_CHECK(TuningDatabase{filename}.entries().empty());
+  std::filesystem::remove(filename);
+  std::filesystem::remove(filename + ".lock");
+}
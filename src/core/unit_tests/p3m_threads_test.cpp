@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2025 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Thread-parallel P3M test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/data/monomorphic.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/unit_test.hpp>
+namespace bdata = boost::unit_test::data;
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#include "BoxGeometry.hpp"
+#include "Particle.hpp"
+#include "actor/registration.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "electrostatics/coulomb.hpp"
+#include "electrostatics/p3m.hpp"
+#include "electrostatics/p3m.impl.hpp"
+#include "p3m/FFTBackendLegacy.hpp"
+#include "p3m/FFTBuffersLegacy.hpp"
+#include "p3m/common.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#if defined(P3M) and defined(OPENMP)
+/* With a mesh of one point per unit length, the local mesh of each rank
+ * is only a few interpolation orders thick, such that the threaded
+ * charge assignment works on a handful of chunks. */
+auto const interpolation_orders = std::vector<int>{3, 5, 7};
+
+BOOST_DATA_TEST_CASE_F(SystemFixture, p3m_threads_test,
+                       bdata::make(interpolation_orders), cao) {
+  auto const comm = boost::mpi::communicator();
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+
+  system.set_box_l(box_per_node(8.));
+  system.set_time_step(0.01);
+  cell_structure.set_verlet_skin(0.4);
+
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  auto const box_l = system.box_geo->length();
+  std::vector<int> pids;
+  for (int pid = 0; pid < 300; ++pid) {
+    create_particle(Utils::Vector3d{uniform(engine) * box_l[0],
+                                    uniform(engine) * box_l[1],
+                                    uniform(engine) * box_l[2]},
+                    pid, 0);
+    set_particle_property(pid, &Particle::q, (pid % 2 == 0) ? 1. : -1.);
+    pids.emplace_back(pid);
+  }
+
+  auto p3m = P3MParameters{false,
+                           0.0,
+                           2.5,
+                           static_cast<Utils::Vector3i>(box_l),
+                           Utils::Vector3d::broadcast(0.5),
+                           cao,
+                           1.2,
+                           1e-3};
+  auto const solver =
+      new_p3m_handle<double, Arch::CPU, FFTBackendLegacy, FFTBuffersLegacy>(
+          std::move(p3m), 1., 1, false, true, false);
+  add_actor(comm, espresso::system, system.coulomb.impl->solver, solver,
+            [&system]() { system.on_coulomb_change(); });
+  auto &impl = dynamic_cast<CoulombP3MImpl<double, Arch::CPU> &>(*solver);
+
+  auto const charge_mesh = [&](int n_threads) {
+    cell_structure.set_n_threads(n_threads);
+    impl.charge_assign(cell_structure.local_particles());
+    auto const &rs_scalar = impl.p3m.mesh.rs_scalar;
+    return std::vector<double>(rs_scalar.begin(), rs_scalar.end());
+  };
+  auto const p3m_forces = [&](int n_threads) {
+    cell_structure.set_n_threads(n_threads);
+    return get_forces(pids);
+  };
+
+  // the threads spread the same charges in a different order
+  auto const ref_mesh = charge_mesh(1);
+  auto const ref_forces = p3m_forces(1);
+  auto const rho_max = std::ranges::max(ref_mesh, {}, [](double rho) {
+    return std::abs(rho);
+  });
+  BOOST_REQUIRE_GT(std::abs(rho_max), 0.);
+  for (auto const n_threads : {2, 3, 4}) {
+    auto const mesh = charge_mesh(n_threads);
+    BOOST_REQUIRE_EQUAL(mesh.size(), ref_mesh.size());
+    for (std::size_t i = 0u; i < mesh.size(); ++i) {
+      BOOST_CHECK_SMALL(mesh[i] - ref_mesh[i], 1e-14 * std::abs(rho_max));
+    }
+    check_forces(ref_forces, p3m_forces(n_threads));
+  }
+
+  cell_structure.set_n_threads(1);
+  solver->detach_system(espresso::system);
+  system.coulomb.impl->solver = std::nullopt;
+  system.on_coulomb_change();
+}
+#endif // P3M and OPENMP
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Space-filling curve particle reordering test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/data/monomorphic.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/unit_test.hpp>
+namespace bdata = boost::unit_test::data;
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#include "LocalBox.hpp"
+#include "cell_system/Cell.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/SpaceFillingCurve.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef LENNARD_JONES
+BOOST_TEST_DONT_PRINT_LOG_VALUE(SpaceFillingCurve)
+
+auto const curves =
+    std::vector<SpaceFillingCurve>{SpaceFillingCurve::MORTON,
+                                   SpaceFillingCurve::HILBERT};
+
+BOOST_DATA_TEST_CASE_F(SystemFixture, reordering_test, bdata::make(curves),
+                       curve) {
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+
+  // each rank holds a cubic cell grid of 4x4x4 cells
+  set_lj_system(box_per_node(5.), 0.2, LJ_Parameters{1., 0.3, 1., 0., 0., 0.});
+
+  // jittered lattice with a lattice constant of 0.5
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> jitter(-0.1, 0.1);
+  auto const n_sites = 10 * ::communicator.node_grid;
+  std::vector<int> pids;
+  for (int i = 0; i < n_sites[0]; ++i) {
+    for (int j = 0; j < n_sites[1]; ++j) {
+      for (int k = 0; k < n_sites[2]; ++k) {
+        auto const pid = static_cast<int>(pids.size());
+        auto const pos = 0.5 * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5} +
+                         Utils::Vector3d{jitter(engine), jitter(engine),
+                                         jitter(engine)};
+        create_particle(pos, pid, 0);
+        pids.emplace_back(pid);
+      }
+    }
+  }
+
+  cell_structure.set_space_filling_curve(SpaceFillingCurve::NONE);
+  auto const ref_forces = get_forces(pids);
+
+  cell_structure.set_space_filling_curve(curve);
+  BOOST_REQUIRE(cell_structure.get_space_filling_curve() == curve);
+  cell_structure.resort_particles(true);
+
+  auto const &decomposition = std::as_const(cell_structure).decomposition();
+  auto const cells = decomposition.local_cells();
+  BOOST_REQUIRE_EQUAL(cells.size(), 64u);
+  if (curve == SpaceFillingCurve::HILBERT) {
+    // consecutive cells along the Hilbert curve share a face
+    for (std::size_t i = 1u; i < cells.size(); ++i) {
+      auto const neighbors = cells[i - 1u]->neighbors().all();
+      BOOST_CHECK(std::ranges::find(neighbors, cells[i]) != neighbors.end());
+    }
+  }
+
+  // particles are sorted along the curve in each cell
+  auto const &local_geo = *system.local_geo;
+  for (auto const cell : cells) {
+    std::vector<std::uint64_t> keys;
+    for (auto const &p : cell->particles()) {
+      keys.emplace_back(curve_index(curve, p.pos(), local_geo.my_left(),
+                                    local_geo.length()));
+    }
+    BOOST_CHECK(std::ranges::is_sorted(keys));
+  }
+
+  // the particle index is up-to-date
+  for (auto &p : cell_structure.local_particles()) {
+    BOOST_CHECK_EQUAL(cell_structure.get_local_particle(p.id()), &p);
+  }
+
+  // forces don't depend on the particle order
+  check_forces(ref_forces, get_forces(pids));
+
+  // particles stay sorted during integration
+  system.integrate(20, INTEG_REUSE_FORCES_CONDITIONALLY);
+  for (auto &p : cell_structure.local_particles()) {
+    BOOST_CHECK_EQUAL(cell_structure.get_local_particle(p.id()), &p);
+  }
+
+  // reordering interval
+  BOOST_CHECK_THROW(cell_structure.set_reordering_interval(-1),
+                    std::domain_error);
+  cell_structure.set_reordering_interval(0);
+  BOOST_CHECK_EQUAL(cell_structure.get_reordering_interval(), 0);
+  cell_structure.set_reordering_interval(1);
+  cell_structure.set_space_filling_curve(SpaceFillingCurve::NONE);
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Thread-parallel propagation test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/data/monomorphic.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/unit_test.hpp>
+namespace bdata = boost::unit_test::data;
+
+#include "SystemFixture.hpp"
+#include "particle_management.hpp"
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "integrate.hpp"
+#include "integrators/Propagation.hpp"
+#include "system/System.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#ifdef OPENMP
+auto const integrators = std::vector<int>{INTEG_METHOD_NVT, INTEG_METHOD_BD};
+
+BOOST_DATA_TEST_CASE_F(SystemFixture, propagation_threads_test,
+                       bdata::make(integrators), integrator) {
+  auto const comm = boost::mpi::communicator();
+  auto const rank = comm.rank();
+  auto &system = *espresso::system;
+  auto &thermostat = *system.thermostat;
+
+  system.set_box_l(box_per_node(8.));
+  system.set_time_step(0.01);
+  system.cell_structure->set_verlet_skin(0.4);
+
+#ifdef PARTICLE_ANISOTROPY
+  auto const gamma = Utils::Vector3d::broadcast(1.);
+#else
+  auto const gamma = 1.;
+#endif
+  thermostat.kT = 1.;
+  if (integrator == INTEG_METHOD_NVT) {
+    thermostat.langevin = std::make_shared<LangevinThermostat>();
+    thermostat.langevin->gamma = gamma;
+    thermostat.langevin->rng_initialize(42u);
+    thermostat.thermo_switch = THERMO_LANGEVIN;
+  } else {
+    thermostat.brownian = std::make_shared<BrownianThermostat>();
+    thermostat.brownian->gamma = gamma;
+    thermostat.brownian->rng_initialize(42u);
+    thermostat.thermo_switch = THERMO_BROWNIAN;
+  }
+  system.propagation->set_integ_switch(integrator);
+  system.on_thermostat_param_change();
+
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  auto const box_l = system.box_geo->length();
+  auto const n_part = 500;
+  std::vector<Utils::Vector3d> positions;
+  for (int pid = 0; pid < n_part; ++pid) {
+    positions.emplace_back(Utils::Vector3d{uniform(engine) * box_l[0],
+                                           uniform(engine) * box_l[1],
+                                           uniform(engine) * box_l[2]});
+  }
+
+  auto const run = [&](int n_threads) {
+    clear_particles();
+    for (int pid = 0; pid < n_part; ++pid) {
+      create_particle(positions[pid], pid, 0);
+    }
+    system.cell_structure->set_n_threads(n_threads);
+    if (thermostat.langevin) {
+      thermostat.langevin->set_rng_counter(0u);
+    }
+    if (thermostat.brownian) {
+      thermostat.brownian->set_rng_counter(0u);
+    }
+    system.integrate(20, INTEG_REUSE_FORCES_CONDITIONALLY);
+    std::unordered_map<int, Utils::Vector3d> trajectory;
+    for (int pid = 0; pid < n_part; ++pid) {
+      auto const p_opt = copy_particle_to_head_node(comm, system, pid);
+      if (rank == 0) {
+        trajectory[pid] = p_opt->pos();
+      }
+    }
+    return trajectory;
+  };
+
+  // the counter-based noise doesn't depend on the number of threads
+  auto const ref = run(1);
+  for (auto const n_threads : {2, 4}) {
+    auto const trajectory = run(n_threads);
+    if (rank == 0) {
+      for (int pid = 0; pid < n_part; ++pid) {
+        BOOST_CHECK_EQUAL(trajectory.at(pid), ref.at(pid));
+      }
+    }
+  }
+
+  system.cell_structure->set_n_threads(1);
+  thermostat.thermo_switch = THERMO_OFF;
+  thermostat.langevin.reset();
+  thermostat.brownian.reset();
+  system.propagation->set_integ_switch(INTEG_METHOD_NVT);
+}
+#endif // OPENMP
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
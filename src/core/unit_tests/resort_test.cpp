@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Regular decomposition resort test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "SystemFixture.hpp"
+
+#include "config/config.hpp"
+
+#include "BoxGeometry.hpp"
+#include "LocalBox.hpp"
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "communication.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifdef LENNARD_JONES
+BOOST_FIXTURE_TEST_CASE(local_resort, SystemFixture) {
+  auto const comm = boost::mpi::communicator();
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+
+  // each rank holds a cubic cell grid of 4x4x4 cells of length 1.25
+  set_lj_system(box_per_node(5.), 0.2, LJ_Parameters{1., 0.3, 1., 0., 0., 0.});
+
+  auto const n_sites = 8 * ::communicator.node_grid;
+  auto n_part = 0;
+  for (int i = 0; i < n_sites[0]; ++i) {
+    for (int j = 0; j < n_sites[1]; ++j) {
+      for (int k = 0; k < n_sites[2]; ++k) {
+        auto const pos = 0.625 * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5};
+        create_particle(pos, n_part++, 0);
+      }
+    }
+  }
+  cell_structure.resort_particles(true);
+
+  auto const &decomposition = std::as_const(cell_structure).decomposition();
+  auto const &box_geo = *system.box_geo;
+  auto const check_sorted = [&]() {
+    std::size_t n_local = 0u;
+    for (auto const *cell : decomposition.local_cells()) {
+      for (auto const &p : cell->particles()) {
+        BOOST_CHECK_EQUAL(decomposition.particle_to_cell(p), cell);
+        BOOST_CHECK_EQUAL(p.pos(), p.pos_at_last_verlet_update());
+        for (auto i = 0u; i < 3u; ++i) {
+          BOOST_CHECK_GE(p.pos()[i], 0.);
+          BOOST_CHECK_LT(p.pos()[i], box_geo.length()[i]);
+        }
+        BOOST_CHECK_EQUAL(cell_structure.get_local_particle(p.id()), &p);
+        ++n_local;
+      }
+    }
+    auto const n_total =
+        boost::mpi::all_reduce(comm, n_local, std::plus<std::size_t>());
+    BOOST_CHECK_EQUAL(n_total, static_cast<std::size_t>(n_part));
+  };
+
+  std::mt19937 engine(42u + static_cast<unsigned>(comm.rank()));
+  std::uniform_real_distribution<double> displacement(-0.7, 0.7);
+  std::uniform_int_distribution<int> face(0, 4 * ::communicator.node_grid[0]);
+  for (int round = 0; round < 5; ++round) {
+    // some particles cross cell, domain and box boundaries,
+    // others land exactly on a cell face
+    auto index = 0;
+    for (auto &p : cell_structure.local_particles()) {
+      if (++index % 7 == 0) {
+        p.pos()[0] = 1.25 * face(engine);
+      } else {
+        p.pos() += Utils::Vector3d{displacement(engine), displacement(engine),
+                                   displacement(engine)};
+      }
+    }
+    cell_structure.resort_particles(false);
+    check_sorted();
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(skip_undisplaced_cells, SystemFixture) {
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+  auto const &decomposition = std::as_const(cell_structure).decomposition();
+
+  set_lj_system(box_per_node(5.), 0.2, LJ_Parameters{1., 0.3, 1., 0., 0., 0.});
+
+  // on each rank, one particle close to a face of the first local cell,
+  // one particle in the middle of a cell and one particle that moves
+  // further than half the skin without leaving its cell
+  auto const comm = boost::mpi::communicator();
+  auto const rank = comm.rank();
+  std::vector<Utils::Vector3d> domains;
+  boost::mpi::all_gather(comm, system.local_geo->my_left(), domains);
+  for (int i = 0; i < comm.size(); ++i) {
+    create_particle(domains[i] + Utils::Vector3d{1.2, 0.5, 0.5}, 3 * i, 0);
+    create_particle(domains[i] + Utils::Vector3d{1.9, 1.9, 1.9}, 3 * i + 1, 0);
+    create_particle(domains[i] + Utils::Vector3d{3.1, 3.1, 3.1}, 3 * i + 2, 0);
+  }
+  cell_structure.resort_particles(true);
+  cell_structure.clear_resort_particles();
+
+  auto const find_cell = [&decomposition](Particle const &p) {
+    for (auto const *cell : decomposition.local_cells()) {
+      for (auto const &q : cell->particles()) {
+        if (q.id() == p.id()) {
+          return cell;
+        }
+      }
+    }
+    return static_cast<Cell const *>(nullptr);
+  };
+
+  // less than half the skin, but across the cell face
+  cell_structure.get_local_particle(3 * rank)->pos()[0] += 0.08;
+  // less than half the skin, inside the cell
+  cell_structure.get_local_particle(3 * rank + 1)->pos()[0] += 0.05;
+  // more than half the skin, inside the cell
+  cell_structure.get_local_particle(3 * rank + 2)->pos()[0] += 0.5;
+  cell_structure.resort_particles_if_displaced();
+  BOOST_REQUIRE_EQUAL(cell_structure.get_resort_particles(),
+                      Cells::RESORT_LOCAL);
+  cell_structure.resort_particles(false);
+  cell_structure.clear_resort_particles();
+
+  // all particles are sorted, the Verlet reference positions are reset
+  for (int i = 0; i < 3; ++i) {
+    auto const &p = *cell_structure.get_local_particle(3 * rank + i);
+    BOOST_CHECK_EQUAL(decomposition.particle_to_cell(p), find_cell(p));
+    BOOST_CHECK_EQUAL(p.pos(), p.pos_at_last_verlet_update());
+  }
+  BOOST_CHECK(not cell_structure.check_resort_required());
+}
+
+BOOST_FIXTURE_TEST_CASE(skipped_cells_verlet_lists, SystemFixture) {
+  auto &system = *espresso::system;
+  auto &cell_structure = *system.cell_structure;
+
+  // the pair is found in the Verlet lists up to a distance of 1.2
+  set_lj_system(box_per_node(5.), 0.2, LJ_Parameters{1., 0.9, 1., 0., 0., 0.});
+
+  // on each rank, a pair of particles in a cell that no particle leaves,
+  // and a particle that triggers the resort and leaves its cell
+  auto const comm = boost::mpi::communicator();
+  auto const rank = comm.rank();
+  std::vector<Utils::Vector3d> domains;
+  boost::mpi::all_gather(comm, system.local_geo->my_left(), domains);
+  std::vector<int> pids;
+  for (int i = 0; i < comm.size(); ++i) {
+    create_particle(domains[i] + Utils::Vector3d{1.36, 2., 2.}, 3 * i, 0);
+    create_particle(domains[i] + Utils::Vector3d{2.38, 2., 2.}, 3 * i + 1, 0);
+    create_particle(domains[i] + Utils::Vector3d{0.6, 3.6, 4.}, 3 * i + 2, 0);
+    pids.insert(pids.end(), {3 * i, 3 * i + 1, 3 * i + 2});
+  }
+  get_forces(pids);
+
+  auto const move = [&](double dx_pair, double dy_trigger) {
+    cell_structure.get_local_particle(3 * rank)->pos()[0] -= dx_pair;
+    cell_structure.get_local_particle(3 * rank + 1)->pos()[0] += dx_pair;
+    cell_structure.get_local_particle(3 * rank + 2)->pos()[1] += dy_trigger;
+    cell_structure.resort_particles_if_displaced();
+    return get_forces(pids);
+  };
+
+  // the pair separates to a distance of 1.21 while each particle moves
+  // less than half the skin, the Verlet lists are rebuilt without it
+  move(0.095, 0.5);
+  // the pair approaches to a distance of 0.86, each particle moved less
+  // than half the skin since the first Verlet list update, but more
+  // since the second one
+  auto const forces = move(-0.175, 0.);
+
+  cell_structure.use_verlet_list = false;
+  auto const ref_forces = get_forces(pids);
+  cell_structure.use_verlet_list = true;
+  if (rank == 0) {
+    BOOST_REQUIRE_GT(ref_forces.at(0).norm(), 1.);
+  }
+  check_forces(ref_forces, forces);
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
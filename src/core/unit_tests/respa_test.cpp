@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE RESPA integrator test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+
+#include "SystemFixture.hpp"
+#include "particle_management.hpp"
+
+#include "config/config.hpp"
+
+#include "Observable_stat.hpp"
+#include "Particle.hpp"
+#include "PropagationMode.hpp"
+#include "actor/registration.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "communication.hpp"
+#include "integrate.hpp"
+#include "integrators/Propagation.hpp"
+#include "magnetostatics/dipolar_direct_sum.hpp"
+#include "magnetostatics/dipoles.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "system/System.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#if defined(DIPOLES) and defined(LENNARD_JONES)
+BOOST_FIXTURE_TEST_CASE(respa_test, SystemFixture) {
+  auto const comm = boost::mpi::communicator();
+  auto const rank = comm.rank();
+  auto &system = *espresso::system;
+  auto &propagation = *system.propagation;
+
+  set_lj_system(box_per_node(4.), 0.4,
+                LJ_Parameters{1., 1., 1.12246, 0., 0., 0.25}, 0.002);
+
+  // jittered lattice of dipoles with random velocities
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<double> jitter(-0.1, 0.1);
+  std::normal_distribution<double> velocity(0., 1.);
+  auto const n_sites = 3 * ::communicator.node_grid;
+  std::vector<Utils::Vector3d> positions, velocities;
+  for (int i = 0; i < n_sites[0]; ++i) {
+    for (int j = 0; j < n_sites[1]; ++j) {
+      for (int k = 0; k < n_sites[2]; ++k) {
+        positions.emplace_back(
+            4. / 3. * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5} +
+            Utils::Vector3d{jitter(engine), jitter(engine), jitter(engine)});
+        velocities.emplace_back(Utils::Vector3d{
+            velocity(engine), velocity(engine), velocity(engine)});
+      }
+    }
+  }
+  auto const n_part = static_cast<int>(positions.size());
+
+  auto const reset_particles = [&]() {
+    clear_particles();
+    for (int pid = 0; pid < n_part; ++pid) {
+      create_particle(positions[pid], pid, 0);
+      set_particle_v(pid, velocities[pid]);
+      set_particle_property(pid, &Particle::dipm, 1.);
+    }
+  };
+
+  auto const gather = [&](Utils::Vector3d &(Particle::*getter)()) {
+    std::unordered_map<int, Utils::Vector3d> values;
+    for (int pid = 0; pid < n_part; ++pid) {
+      auto p_opt = copy_particle_to_head_node(comm, system, pid);
+      if (rank == 0) {
+        values[pid] = ((*p_opt).*getter)();
+      }
+    }
+    return values;
+  };
+
+  auto const set_integrator = [&](int integ_switch, int n_inner_steps) {
+    propagation.respa_n_inner_steps = n_inner_steps;
+    propagation.set_integ_switch(integ_switch);
+  };
+
+  auto const check_close = [&](auto const &values, auto const &ref) {
+    if (rank == 0) {
+      for (int pid = 0; pid < n_part; ++pid) {
+        auto const &value = values.at(pid);
+        auto const &value_ref = ref.at(pid);
+        BOOST_CHECK_SMALL((value - value_ref).norm(),
+                          1e-10 * (1. + value_ref.norm()));
+      }
+    }
+  };
+
+  auto solver = std::make_shared<DipolarDirectSum>(1., 0);
+  add_actor(comm, espresso::system, system.dipoles.impl->solver, solver,
+            [&system]() { system.on_dipoles_change(); });
+
+  // with a single inner step, RESPA reduces to velocity Verlet
+  reset_particles();
+  set_integrator(INTEG_METHOD_NVT, 1);
+  system.integrate(20, INTEG_REUSE_FORCES_CONDITIONALLY);
+  auto const pos_vv = gather(&Particle::pos);
+  reset_particles();
+  set_integrator(INTEG_METHOD_RESPA, 1);
+  system.integrate(20, INTEG_REUSE_FORCES_CONDITIONALLY);
+  check_close(gather(&Particle::pos), pos_vv);
+
+  // on outer steps, the long-range force is scaled by the number of
+  // inner steps: f(4) - f(1) = 3 * (f(2) - f(1))
+  std::unordered_map<int, std::unordered_map<int, Utils::Vector3d>> forces;
+  for (auto const n_inner_steps : {1, 2, 4}) {
+    reset_particles();
+    set_integrator(INTEG_METHOD_RESPA, n_inner_steps);
+    system.integrate(0, INTEG_REUSE_FORCES_NEVER);
+    forces[n_inner_steps] = gather(&Particle::force);
+  }
+  if (rank == 0) {
+    std::unordered_map<int, Utils::Vector3d> extrapolated;
+    for (int pid = 0; pid < n_part; ++pid) {
+      extrapolated[pid] = forces[1].at(pid) +
+                          3. * (forces[2].at(pid) - forces[1].at(pid));
+      BOOST_CHECK_GT((forces[2].at(pid) - forces[1].at(pid)).norm(), 0.);
+    }
+    check_close(forces[4], extrapolated);
+  }
+
+  // the total energy is conserved: sample it every two outer steps of
+  // RESPA(4), i.e. when both schemes are at an outer step boundary
+  auto const energy_trace = [&](int integ_switch, int n_inner_steps) {
+    reset_particles();
+    set_integrator(integ_switch, n_inner_steps);
+    std::vector<double> energies;
+    for (int i = 0; i <= 25; ++i) {
+      if (i != 0) {
+        system.integrate(8, INTEG_REUSE_FORCES_CONDITIONALLY);
+      }
+      energies.emplace_back(system.calculate_energy()->accumulate(0.));
+    }
+    return energies;
+  };
+  auto const energies_vv = energy_trace(INTEG_METHOD_NVT, 1);
+  auto const energies_respa_1 = energy_trace(INTEG_METHOD_RESPA, 1);
+  auto const energies_respa_4 = energy_trace(INTEG_METHOD_RESPA, 4);
+  if (rank == 0) {
+    auto const e0 = energies_vv.front();
+    BOOST_REQUIRE_GT(std::abs(e0), 0.);
+    for (std::size_t i = 0; i < energies_vv.size(); ++i) {
+      BOOST_CHECK_SMALL(energies_respa_1[i] - energies_vv[i],
+                        1e-10 * std::abs(e0));
+      BOOST_CHECK_SMALL(energies_vv[i] - e0, 1e-4 * std::abs(e0));
+      BOOST_CHECK_SMALL(energies_respa_4[i] - e0, 5e-4 * std::abs(e0));
+    }
+  }
+
+  // on inner steps, the long-range force is skipped
+  reset_particles();
+  set_integrator(INTEG_METHOD_RESPA, 4);
+  system.integrate(3, INTEG_REUSE_FORCES_CONDITIONALLY);
+  BOOST_CHECK_EQUAL(propagation.respa_inner_step, 0);
+  auto const forces_inner = gather(&Particle::force);
+  solver->detach_system(espresso::system);
+  system.dipoles.impl->solver = std::nullopt;
+  system.on_dipoles_change();
+  set_integrator(INTEG_METHOD_NVT, 1);
+  system.integrate(0, INTEG_REUSE_FORCES_NEVER);
+  check_close(gather(&Particle::force), forces_inner);
+}
+#endif // DIPOLES and LENNARD_JONES
+
+int main(int argc, char **argv) {
+  return run_system_unit_tests(argc, argv);
+}
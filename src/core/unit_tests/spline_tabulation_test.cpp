@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Spline tabulation of pair potentials
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config/config.hpp"
+
+#include "nonbonded_interactions/bmhtf-nacl.hpp"
+#include "nonbonded_interactions/gaussian.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "nonbonded_interactions/spline_tabulation.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(cubic_spline) {
+  /* cubic polynomials are interpolated exactly */
+  auto const f = [](double x) {
+    return 2. - x + 0.5 * x * x - 0.25 * x * x * x;
+  };
+  auto const spline = CubicSpline(f, 0.5, 2.5, 10);
+  BOOST_CHECK_EQUAL(spline.size(), 10u);
+  BOOST_CHECK(not spline.empty());
+  BOOST_CHECK(not spline.contains(0.4));
+  BOOST_CHECK(spline.contains(0.5));
+  BOOST_CHECK(not spline.contains(2.5));
+  for (double x = 0.5; x < 2.5; x += 0.0123) {
+    BOOST_CHECK_SMALL(spline(x) - f(x), 1e-9);
+  }
+  BOOST_CHECK(CubicSpline().empty());
+  BOOST_CHECK(not CubicSpline().contains(0.));
+}
+
+BOOST_AUTO_TEST_CASE(force_spline_accuracy) {
+  auto const f = [](double r) { return std::exp(-3. * r) / r; };
+  for (auto const accuracy : {1e-4, 1e-8}) {
+    auto const spline = make_force_spline(f, 0.5, 3., accuracy);
+    BOOST_REQUIRE(not spline.empty());
+    for (double r = 0.5; r < 3.; r += 0.001) {
+      BOOST_CHECK_LE(r * std::abs(spline(r) - f(r)), accuracy);
+    }
+  }
+  /* finer tables for higher accuracy */
+  BOOST_CHECK_LT(make_force_spline(f, 0.5, 3., 1e-4).size(),
+                 make_force_spline(f, 0.5, 3., 1e-8).size());
+  /* singular functions cannot be tabulated */
+  auto const singular = [](double r) { return 1. / (r - 1.); };
+  BOOST_CHECK(make_force_spline(singular, 0., 2., 1e-6).empty());
+}
+
+BOOST_AUTO_TEST_CASE(force_spline_lower_end) {
+  auto constexpr accuracy = 1e-6;
+  /* the table starts above the singularity */
+  auto const singular = [](double r) { return 1. / (r - 1.); };
+  auto const spline = make_force_spline_above(singular, 0., 2., accuracy);
+  BOOST_REQUIRE(not spline.empty());
+  BOOST_CHECK(not spline.contains(1.));
+  BOOST_CHECK(spline.contains(1.5));
+  BOOST_CHECK(spline.contains(1.99));
+  for (double r = 1.5; r < 2.; r += 0.001) {
+    BOOST_CHECK_LE(r * std::abs(spline(r) - singular(r)), accuracy);
+  }
+  /* tables that can be built from the requested lower end start there */
+  auto const smooth = [](double r) { return std::exp(-3. * r); };
+  BOOST_CHECK(make_force_spline_above(smooth, 0., 2., accuracy).contains(0.));
+}
+
+BOOST_AUTO_TEST_CASE(parameters) {
+  BOOST_CHECK(not SplineTabulation_Parameters().is_active());
+  BOOST_CHECK(SplineTabulation_Parameters(0., 1e-6).is_active());
+  BOOST_CHECK_THROW(SplineTabulation_Parameters(-1., 1e-6), std::domain_error);
+  BOOST_CHECK_THROW(SplineTabulation_Parameters(0., 0.), std::domain_error);
+}
+
+#ifdef GAUSSIAN
+BOOST_AUTO_TEST_CASE(gaussian_tabulation) {
+  auto constexpr accuracy = 1e-7;
+  IA_parameters ia_params;
+  ia_params.gaussian = Gaussian_Parameters{6.92, 0.8, 2.2};
+  update_spline_tabulation(ia_params);
+  BOOST_CHECK(ia_params.spline_tabulation.gaussian.empty());
+
+  ia_params.spline_tabulation = SplineTabulation_Parameters{0.1, accuracy};
+  update_spline_tabulation(ia_params);
+  auto const &spline = ia_params.spline_tabulation.gaussian;
+  BOOST_REQUIRE(not spline.empty());
+  BOOST_CHECK(not spline.contains(0.05));
+  BOOST_CHECK(not spline.contains(2.2));
+  for (double r = 0.1; r < 2.2; r += 0.0017) {
+    auto const value = splined_force_factor(spline, r, []() { return 0.; });
+    auto const ref = gaussian_pair_force_factor(ia_params, r);
+    BOOST_CHECK_LE(r * std::abs(value - ref), accuracy);
+  }
+
+  /* switching the tabulation off removes the tables */
+  ia_params.spline_tabulation.accuracy = INACTIVE_CUTOFF;
+  update_spline_tabulation(ia_params);
+  BOOST_CHECK(ia_params.spline_tabulation.gaussian.empty());
+}
+#endif // GAUSSIAN
+
+#ifdef BMHTF_NACL
+BOOST_AUTO_TEST_CASE(bmhtf_tabulation_default_min) {
+  auto constexpr accuracy = 1e-6;
+  auto constexpr cutoff = 1.253;
+  IA_parameters ia_params;
+  ia_params.bmhtf = BMHTF_Parameters{3.92, 2.43, 1.23, 3.33, 0.123, cutoff};
+  /* the force diverges at r = 0, the table starts at a larger distance */
+  ia_params.spline_tabulation = SplineTabulation_Parameters{0., accuracy};
+  update_spline_tabulation(ia_params);
+  auto const &spline = ia_params.spline_tabulation.bmhtf;
+  BOOST_REQUIRE(not spline.empty());
+  BOOST_CHECK(not spline.contains(0.));
+  BOOST_CHECK(spline.contains(0.9 * cutoff));
+  for (double r = 0.01; r < cutoff; r += 0.0017) {
+    auto const ref = BMHTF_pair_force_factor(ia_params, r);
+    auto const value = splined_force_factor(spline, r, [ref]() { return ref; });
+    BOOST_CHECK_LE(r * std::abs(value - ref), accuracy);
+  }
+}
+#endif // BMHTF_NACL
@@ -32,10 +32,57 @@ class CellSystem(ScriptInterfaceHelper):
         Name of the currently active particle decomposition.
     use_verlet_lists : :obj:`bool`
         Whether to use Verlet lists.
+    use_particle_arrays : :obj:`bool`
+        Whether to run the non-bonded force calculation on a packed copy
+        of the particle positions, types and charges. Only takes effect
+        when all short-range interactions are central pair potentials
+        or real-space electrostatics.
+    overlap_ghost_communication : :obj:`bool`
+        Whether to evaluate the non-bonded interactions of the inner cells
+        while the ghost positions are communicated. Only takes effect with
+        the regular decomposition and ``use_particle_arrays``.
+    load_balancing_interval : :obj:`int`
+        Number of integration steps between two rebalancings of the
+        regular decomposition, or 0 to disable dynamic load balancing.
+    load_balancing_metric : :obj:`str`
+        Cost of an MPI rank used for load balancing, either
+        ``'n_particles'`` (number of particles) or ``'force_time'``
+        (measured force calculation time).
+    load_imbalance : :obj:`dict`
+        Ratio of the largest to the mean cost of the MPI ranks before
+        the last rebalancing (key ``'before'``) and expected after it
+        (key ``'after'``).
+    space_filling_curve : :obj:`str`
+        Order of the local cells and of the particles in each cell, either
+        ``'none'`` (lexicographic order of the cells, particles in arrival
+        order), ``'morton'`` or ``'hilbert'``. Along a space-filling curve,
+        particles close in space are also close in memory. Changing it
+        rebuilds the cell system.
+    reordering_interval : :obj:`int`
+        Number of particle resorts between two reorderings of the particles
+        along the :attr:`space_filling_curve`, or 0 to only order the cells.
+    ghost_shell : :obj:`str`
+        Ghost import scheme of the regular decomposition, either ``'full'``
+        (all 26 neighbor regions) or ``'half'`` (the 13 upper neighbor
+        regions, see :ref:`Half-shell ghosts`). Changing it rebuilds the
+        cell system.
     skin : :obj:`float`
         Verlet list skin.
+    skin_tuning_interval : :obj:`int`
+        Number of integration steps per measurement window of the online
+        skin tuner, or 0 to disable online skin tuning.
+    skin_tuning_trace : (N, 2) :obj:`list` of :obj:`float`
+        Skins probed by the online skin tuner and the corresponding
+        wall time per integration step in ms.
+    tuned_skin : :obj:`float` or ``None``
+        Skin found by the online skin tuner, or ``None`` while the
+        search is running.
     node_grid : (3,) array_like of :obj:`int`
         MPI repartition for the regular decomposition cell system.
+    n_threads : :obj:`int`
+        Number of threads per MPI rank for the non-bonded force
+        calculation, the P3M charge assignment and the propagation.
+        Values larger than 1 require feature ``OPENMP``.
     max_cut_bonded : :obj:`float`
         Maximal range from bonded interactions.
     max_cut_nonbonded : :obj:`float`
@@ -85,6 +132,15 @@ class CellSystem(ScriptInterfaceHelper):
         :obj:`float` :
             The :attr:`skin`
 
+    rebalance()
+        Shift the domain boundaries of the regular decomposition to balance
+        the cost of the MPI ranks.
+
+        Returns
+        -------
+        :obj:`dict` :
+            The :attr:`load_imbalance`
+
     get_state()
         Get the current state of the cell system.
 
@@ -98,6 +154,10 @@ class CellSystem(ScriptInterfaceHelper):
     _so_creation_policy = "GLOBAL"
     _so_bind_methods = ("get_state", "tune_skin", "resort")
 
+    def rebalance(self):
+        return self.call_method(
+            "rebalance", handle_errors_message="Load balancing failed")
+
     def set_regular_decomposition(self, **kwargs):
         """
         Activate the regular decomposition cell system.
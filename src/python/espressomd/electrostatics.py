@@ -17,6 +17,8 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 
+import os
+
 from . import utils
 from .script_interface import ScriptInterfaceHelper, script_interface_register
 
@@ -141,9 +143,13 @@ class _P3MBase(ElectrostaticInteraction):
                 "prefactor": 0.,
                 "check_neutrality": True,
                 "check_complex_residuals": True,
+                "fft_backend": "legacy",
+                "fft_overlap": False,
                 "tune": True,
                 "timings": 10,
-                "verbose": True}
+                "verbose": True,
+                "tuning_database": "",
+                "tuning_verify": False}
 
     def validate_params(self, params):
         super().validate_params(params)
@@ -174,6 +180,10 @@ class _P3MBase(ElectrostaticInteraction):
             raise TypeError("Parameter 'timings' has to be an integer")
         if not utils.is_valid_type(params["tune"], bool):
             raise TypeError("Parameter 'tune' has to be a boolean")
+        params["tuning_database"] = os.fspath(params["tuning_database"])
+        if params["fft_backend"] not in ("legacy", "pencil", "pencil_r2c"):
+            raise ValueError(
+                "Parameter 'fft_backend' has to be 'legacy', 'pencil' or 'pencil_r2c'")
 
 
 @script_interface_register
@@ -213,12 +223,27 @@ class P3M(_P3MBase):
         Number of force calculations during tuning.
     verbose : :obj:`bool`, optional
         If ``False``, disable log output during tuning.
+    tuning_database : :obj:`str`, optional
+        Path to a tuning database file. Parameters tuned for the same
+        or a similar system are read from it instead of running the full
+        tuning, and newly tuned parameters are written to it.
+    tuning_verify : :obj:`bool`, optional
+        Time the parameters read from the tuning database and store
+        the measured time. Defaults to ``False``.
     check_neutrality : :obj:`bool`, optional
         Raise a warning if the system is not electrically neutral when
         set to ``True`` (default).
     check_complex_residuals: :obj:`bool`, optional
         Raise a warning if the backward Fourier transform has non-zero
         complex residuals when set to ``True`` (default).
+    fft_backend : :obj:`str`, optional
+        Distributed FFT algorithm: ``'legacy'`` (default) requires a node
+        grid sorted in decreasing order, ``'pencil'`` works with any node
+        grid and uses fewer data redistributions, ``'pencil_r2c'`` is
+        a ``'pencil'`` FFT which only stores half of the k-space mesh.
+    fft_overlap : :obj:`bool`, optional
+        Overlap the data redistributions of the ``'pencil'`` FFTs with
+        the 1D Fourier transforms. Defaults to ``False``.
     single_precision : :obj:`bool`
         Use single-precision floating-point arithmetic.
 
@@ -268,12 +293,27 @@ class P3MGPU(_P3MBase):
         Number of force calculations during tuning.
     verbose : :obj:`bool`, optional
         If ``False``, disable log output during tuning.
+    tuning_database : :obj:`str`, optional
+        Path to a tuning database file. Parameters tuned for the same
+        or a similar system are read from it instead of running the full
+        tuning, and newly tuned parameters are written to it.
+    tuning_verify : :obj:`bool`, optional
+        Time the parameters read from the tuning database and store
+        the measured time. Defaults to ``False``.
     check_neutrality : :obj:`bool`, optional
         Raise a warning if the system is not electrically neutral when
         set to ``True`` (default).
     check_complex_residuals: :obj:`bool`, optional
         Raise a warning if the backward Fourier transform has non-zero
         complex residuals when set to ``True`` (default).
+    fft_backend : :obj:`str`, optional
+        Distributed FFT algorithm: ``'legacy'`` (default) requires a node
+        grid sorted in decreasing order, ``'pencil'`` works with any node
+        grid and uses fewer data redistributions, ``'pencil_r2c'`` is
+        a ``'pencil'`` FFT which only stores half of the k-space mesh.
+    fft_overlap : :obj:`bool`, optional
+        Overlap the data redistributions of the ``'pencil'`` FFTs with
+        the 1D Fourier transforms. Defaults to ``False``.
 
     """
     _so_name = "Coulomb::CoulombP3MGPU"
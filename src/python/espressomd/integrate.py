@@ -72,6 +72,14 @@ class IntegratorHandle(ScriptInterfaceHelper):
         """
         self.integrator = VelocityVerletIsotropicNPT(**kwargs)
 
+    def set_respa(self, **kwargs):
+        """
+        Set the integration method to velocity Verlet with multiple time
+        stepping of the long-range forces (:class:`VelocityVerletRESPA`).
+
+        """
+        self.integrator = VelocityVerletRESPA(**kwargs)
+
     def set_brownian_dynamics(self):
         """
         Set the integration method to BD.
@@ -210,6 +218,24 @@ class VelocityVerletIsotropicNPT(Integrator):
         super().__init__(**kwargs)
 
 
+@script_interface_register
+class VelocityVerletRESPA(Integrator):
+    """
+    Velocity Verlet integrator with multiple time stepping (RESPA),
+    suitable for simulations in the NVT ensemble. Long-range forces
+    are only calculated every ``n_inner_steps`` time steps and applied
+    as an impulse, while all other forces are calculated every time step.
+
+    Parameters
+    ----------
+    n_inner_steps : :obj:`int`
+        Number of time steps between two long-range force calculations.
+
+    """
+    _so_name = "Integrators::VelocityVerletRESPA"
+    _so_creation_policy = "GLOBAL"
+
+
 @script_interface_register
 class BrownianDynamics(Integrator):
     """
@@ -664,6 +664,43 @@ class TholeInteraction(NonBondedInteraction):
         return {}
 
 
+@script_interface_register
+class SplineTabulationInteraction(NonBondedInteraction):
+    """Automatic spline tabulation of expensive potentials.
+
+    Replaces the force calculation of the Gaussian, BMHTF-NaCl, Morse
+    and Buckingham potentials of a pair of particle types by cubic
+    Hermite interpolation from a table. The tables are rebuilt whenever
+    the parameters of the potentials change. Energies are still
+    calculated analytically.
+
+    Methods
+    -------
+    set_params()
+        Set new parameters for the interaction.
+
+        Parameters
+        ----------
+        accuracy : :obj:`float`
+            Maximal absolute error of the force magnitude.
+        min : :obj:`float`, optional
+            Smallest tabulated distance. Below this distance, the
+            potentials are evaluated analytically. Tables of potentials
+            that diverge at short distances start at the smallest
+            distance above ``min`` where the accuracy can be reached.
+
+    """
+
+    _so_name = "Interactions::InteractionSplineTabulation"
+    _so_feature = []
+
+    def default_params(self):
+        """Python dictionary of default parameters.
+
+        """
+        return {"min": 0.}
+
+
 @script_interface_register
 class NonBondedInteractionHandle(ScriptInterfaceHelper):
 
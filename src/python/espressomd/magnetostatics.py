@@ -17,6 +17,8 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 
+import os
+
 from . import utils
 from .script_interface import ScriptInterfaceHelper, script_interface_register
 
@@ -106,8 +108,23 @@ class DipolarP3M(MagnetostaticInteraction):
         (default is ``True``, i.e., activated).
     timings : :obj:`int`
         Number of force calculations during tuning.
+    tuning_database : :obj:`str`, optional
+        Path to a tuning database file. Parameters tuned for the same
+        or a similar system are read from it instead of running the full
+        tuning, and newly tuned parameters are written to it.
+    tuning_verify : :obj:`bool`, optional
+        Time the parameters read from the tuning database and store
+        the measured time. Defaults to ``False``.
     single_precision : :obj:`bool`
         Use single-precision floating-point arithmetic.
+    fft_backend : :obj:`str`, optional
+        Distributed FFT algorithm: ``'legacy'`` (default) requires a node
+        grid sorted in decreasing order, ``'pencil'`` works with any node
+        grid and uses fewer data redistributions, ``'pencil_r2c'`` is
+        a ``'pencil'`` FFT which only stores half of the k-space mesh.
+    fft_overlap : :obj:`bool`, optional
+        Overlap the data redistributions of the ``'pencil'`` FFTs with
+        the 1D Fourier transforms. Defaults to ``False``.
 
     """
     _so_name = "Dipoles::DipolarP3M"
@@ -141,6 +158,10 @@ class DipolarP3M(MagnetostaticInteraction):
             raise TypeError("Parameter 'timings' has to be an integer")
         if not utils.is_valid_type(params["tune"], bool):
             raise TypeError("Parameter 'tune' has to be a boolean")
+        params["tuning_database"] = os.fspath(params["tuning_database"])
+        if params["fft_backend"] not in ("legacy", "pencil", "pencil_r2c"):
+            raise ValueError(
+                "Parameter 'fft_backend' has to be 'legacy', 'pencil' or 'pencil_r2c'")
 
     def required_keys(self):
         return {"accuracy"}
@@ -155,9 +176,13 @@ class DipolarP3M(MagnetostaticInteraction):
                 "mesh_off": [0.5, 0.5, 0.5],
                 "prefactor": 0.,
                 "single_precision": False,
+                "fft_backend": "legacy",
+                "fft_overlap": False,
                 "tune": True,
                 "timings": 10,
-                "verbose": True}
+                "verbose": True,
+                "tuning_database": "",
+                "tuning_verify": False}
 
 
 @script_interface_register
@@ -188,6 +213,39 @@ class DipolarDirectSumCpu(MagnetostaticInteraction):
         return {"prefactor"}
 
 
+@script_interface_register
+class DipolarBarnesHut(MagnetostaticInteraction):
+    """
+    Calculate magnetostatic interactions with a Barnes-Hut tree code.
+    See :ref:`Dipolar Barnes-Hut tree code` for more details.
+
+    Groups of distant dipoles are replaced by their multipole expansion,
+    which reduces the cost from :math:`O(N^2)` to :math:`O(N \\log N)`.
+    Periodic boundaries are handled like in :class:`DipolarDirectSumCpu`.
+
+    Parameters
+    ----------
+    prefactor : :obj:`float`
+        Magnetostatics prefactor (:math:`\\mu_0/(4\\pi)`)
+    theta : :obj:`float`, optional
+        Opening angle, in the range (0, 1). Smaller values are more
+        accurate and more expensive.
+    order : :obj:`int`, optional
+        Order of the multipole expansion, in the range [1, 8].
+        Order 1 only keeps the total dipole moment of a group.
+    n_replicas : :obj:`int`, optional
+        Number of replicas to be taken into account at periodic boundaries.
+
+    """
+    _so_name = "Dipoles::DipolarBarnesHut"
+
+    def default_params(self):
+        return {"theta": 0.5, "order": 3, "n_replicas": 0}
+
+    def required_keys(self):
+        return {"prefactor"}
+
+
 @script_interface_register
 class Scafacos(MagnetostaticInteraction):
 
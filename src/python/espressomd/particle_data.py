@@ -24,7 +24,7 @@ from .interactions import BondedInteraction
 from .utils import nesting_level, array_locked, is_valid_type
 from .utils import check_type_or_throw_except
 from .code_features import assert_features, has_features
-from .script_interface import script_interface_register, ScriptInterfaceHelper
+from .script_interface import script_interface_register, ScriptInterfaceHelper, array_variant
 from .propagation import Propagation
 import itertools
 
@@ -955,8 +955,7 @@ class ParticleSlice(ScriptInterfaceHelper):
         :meth:`espressomd.particle_data.ParticleList.add`
 
         """
-        for p_id in self.id_selection:
-            self.call_method("get_particle", p_id=p_id).remove()
+        self.call_method("remove_particles")
 
     def __setattr__(self, name, value):
         if name != "chunk_size" and name != "id_selection" and name not in particle_attributes:
@@ -1150,10 +1149,25 @@ class ParticleList(ScriptInterfaceHelper):
             first_id = self.highest_particle_id + 1
             p_list_dict["id"] = np.arange(first_id, first_id + n_parts)
 
-        # Place the particles
-        for i in range(n_parts):
-            p_dict = {k: v[i] for k, v in p_list_dict.items()}
-            self._place_new_particle(p_dict)
+        # Place the particles, in bulk when only basic properties are set
+        if n_parts and set(p_list_dict.keys()) <= {
+                "id", "pos", "type", "v", "q", "mass"}:
+            for k in ("id", "type"):
+                if k in p_list_dict:
+                    values = np.asarray(p_list_dict[k])
+                    if not (np.issubdtype(values.dtype, np.integer) or (
+                            np.issubdtype(values.dtype, np.number) and
+                            np.array_equal(values, values.astype(int)))):
+                        raise ValueError(
+                            f"attribute '{k}' of 'ParticleHandle' must be an integer")
+            dtypes = {"id": int, "type": int}
+            self.call_method("add_particles", **{
+                k: array_variant(np.asarray(v, dtype=dtypes.get(k, float)).flatten())
+                for k, v in p_list_dict.items()})
+        else:
+            for i in range(n_parts):
+                p_dict = {k: v[i] for k, v in p_list_dict.items()}
+                self._place_new_particle(p_dict)
 
         # Return slice of added particles
         return self.by_ids(p_list_dict["id"])
@@ -122,7 +122,10 @@ Variant Analysis::do_call_method(std::string const &name,
   if (name == "particle_energy") {
     auto &system = get_system();
     auto const pid = get_value<int>(parameters, "pid");
-    auto const local = system.particle_short_range_energy_contribution(pid);
+    auto local = 0.;
+    context()->parallel_try_catch([&]() {
+      local = system.particle_short_range_energy_contribution(pid);
+    });
     return mpi_reduce_sum(context()->get_comm(), local);
   }
 #ifdef DIPOLE_FIELD_TRACKING
@@ -27,7 +27,9 @@
 #include "core/bonded_interactions/bonded_interaction_data.hpp"
 #include "core/cell_system/CellStructure.hpp"
 #include "core/cell_system/HybridDecomposition.hpp"
+#include "core/cell_system/LoadBalancer.hpp"
 #include "core/cell_system/RegularDecomposition.hpp"
+#include "core/cell_system/VerletSkinTuner.hpp"
 #include "core/cells.hpp"
 #include "core/communication.hpp"
 #include "core/nonbonded_interactions/nonbonded_interaction_data.hpp"
@@ -43,6 +45,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <iterator>
 #include <optional>
 #include <set>
@@ -82,6 +85,16 @@ CellSystem::CellSystem() {
          get_cell_structure().use_verlet_list = get_value<bool>(v);
        },
        [this]() { return get_cell_structure().use_verlet_list; }},
+      {"use_particle_arrays",
+       [this](Variant const &v) {
+         get_cell_structure().use_particle_arrays = get_value<bool>(v);
+       },
+       [this]() { return get_cell_structure().use_particle_arrays; }},
+      {"overlap_ghost_communication",
+       [this](Variant const &v) {
+         get_cell_structure().overlap_ghost_communication = get_value<bool>(v);
+       },
+       [this]() { return get_cell_structure().overlap_ghost_communication; }},
       {"node_grid",
        [this](Variant const &v) {
          context()->parallel_try_catch([this, &v]() {
@@ -119,6 +132,126 @@ CellSystem::CellSystem() {
          get_cell_structure().set_verlet_skin(new_skin);
        },
        [this]() { return get_cell_structure().get_verlet_skin(); }},
+      {"skin_tuning_interval",
+       [this](Variant const &v) {
+         auto const interval = get_value<int>(v);
+         if (interval < 0) {
+           if (context()->is_head_node()) {
+             throw std::domain_error(
+                 "Parameter 'skin_tuning_interval' must be >= 0");
+           }
+           throw Exception("");
+         }
+         get_system().skin_tuner->set_interval(interval);
+       },
+       [this]() { return get_system().skin_tuner->get_interval(); }},
+      {"skin_tuning_trace", AutoParameter::read_only,
+       [this]() {
+         std::vector<Variant> trace;
+         for (auto const &sample : get_system().skin_tuner->get_trace()) {
+           trace.emplace_back(std::vector<double>{sample.skin, sample.time});
+         }
+         return trace;
+       }},
+      {"tuned_skin", AutoParameter::read_only,
+       [this]() {
+         auto const skin = get_system().skin_tuner->get_tuned_skin();
+         if (not skin) {
+           return Variant{none};
+         }
+         return Variant{*skin};
+       }},
+      {"n_threads",
+       [this](Variant const &v) {
+         context()->parallel_try_catch([this, &v]() {
+           get_cell_structure().set_n_threads(get_value<int>(v));
+         });
+       },
+       [this]() { return get_cell_structure().get_n_threads(); }},
+      {"load_balancing_interval",
+       [this](Variant const &v) {
+         auto const interval = get_value<int>(v);
+         if (interval < 0) {
+           if (context()->is_head_node()) {
+             throw std::domain_error(
+                 "Parameter 'load_balancing_interval' must be >= 0");
+           }
+           throw Exception("");
+         }
+         get_system().load_balancer->set_interval(interval);
+       },
+       [this]() { return get_system().load_balancer->get_interval(); }},
+      {"load_balancing_metric",
+       [this](Variant const &v) {
+         auto const name = get_value<std::string>(v);
+         if (not lb_metric_name_to_type.contains(name)) {
+           if (context()->is_head_node()) {
+             throw std::invalid_argument(
+                 "Parameter 'load_balancing_metric' must be one of "
+                 "'n_particles', 'force_time'");
+           }
+           throw Exception("");
+         }
+         get_system().load_balancer->set_metric(
+             lb_metric_name_to_type.at(name));
+       },
+       [this]() {
+         return lb_metric_type_to_name.at(
+             get_system().load_balancer->get_metric());
+       }},
+      {"space_filling_curve",
+       [this](Variant const &v) {
+         auto const name = get_value<std::string>(v);
+         if (not sfc_name_to_type.contains(name)) {
+           if (context()->is_head_node()) {
+             throw std::invalid_argument(
+                 "Parameter 'space_filling_curve' must be one of "
+                 "'none', 'morton', 'hilbert'");
+           }
+           throw Exception("");
+         }
+         context()->parallel_try_catch([this, &name]() {
+           get_cell_structure().set_space_filling_curve(
+               sfc_name_to_type.at(name));
+         });
+       },
+       [this]() {
+         return sfc_type_to_name.at(
+             get_cell_structure().get_space_filling_curve());
+       }},
+      {"ghost_shell",
+       [this](Variant const &v) {
+         auto const name = get_value<std::string>(v);
+         if (not ghost_shell_name_to_type.contains(name)) {
+           if (context()->is_head_node()) {
+             throw std::invalid_argument(
+                 "Parameter 'ghost_shell' must be one of 'full', 'half'");
+           }
+           throw Exception("");
+         }
+         context()->parallel_try_catch([this, &name]() {
+           get_cell_structure().set_ghost_shell(
+               ghost_shell_name_to_type.at(name));
+         });
+       },
+       [this]() {
+         return ghost_shell_type_to_name.at(
+             get_cell_structure().get_ghost_shell());
+       }},
+      {"reordering_interval",
+       [this](Variant const &v) {
+         context()->parallel_try_catch([this, &v]() {
+           get_cell_structure().set_reordering_interval(get_value<int>(v));
+         });
+       },
+       [this]() { return get_cell_structure().get_reordering_interval(); }},
+      {"load_imbalance", AutoParameter::read_only,
+       [this]() {
+         auto const &load_balancer = *get_system().load_balancer;
+         return Variant{std::unordered_map<std::string, Variant>{
+             {{"before", Variant{load_balancer.get_imbalance_before()}},
+              {"after", Variant{load_balancer.get_imbalance_after()}}}}};
+       }},
       {"decomposition_type", AutoParameter::read_only,
        [this]() {
          return cs_type_to_name.at(get_cell_structure().decomposition_type());
@@ -194,6 +327,7 @@ Variant CellSystem::do_call_method(std::string const &name,
               {"regular", hd.count_particles_in_regular()},
               {"n_square", hd.count_particles_in_n_square()}}};
     }
+    state["domain_bounds"] = get_domain_bounds();
     state["verlet_reuse"] = get_cell_structure().get_verlet_reuse();
     state["n_nodes"] = context()->get_comm().size();
     return state;
@@ -272,6 +406,10 @@ Variant CellSystem::do_call_method(std::string const &name,
         get_value_or<bool>(params, "adjust_max_skin", false));
     return get_cell_structure().get_verlet_skin();
   }
+  if (name == "rebalance") {
+    get_system().rebalance_domains();
+    return get_parameter("load_imbalance");
+  }
   if (name == "get_max_range") {
     return get_cell_structure().max_range();
   }
@@ -288,6 +426,24 @@ std::vector<int> CellSystem::mpi_resort_particles(bool global_flag) const {
   return n_part_per_node;
 }
 
+std::vector<Variant> CellSystem::get_domain_bounds() const {
+  auto const &box_l = get_system().box_geo->length();
+  auto const &node_grid = ::communicator.node_grid;
+  auto const &cuts = get_system().load_balancer->get_cuts();
+  std::vector<Variant> bounds;
+  for (auto dir = 0u; dir < 3u; ++dir) {
+    std::vector<double> dir_bounds;
+    for (int i = 0; i <= node_grid[dir]; ++i) {
+      auto const fraction = (cuts[dir].empty())
+                                ? static_cast<double>(i) / node_grid[dir]
+                                : cuts[dir][static_cast<std::size_t>(i)];
+      dir_bounds.emplace_back(fraction * box_l[dir]);
+    }
+    bounds.emplace_back(std::move(dir_bounds));
+  }
+  return bounds;
+}
+
 void CellSystem::initialize(CellStructureType const &cs_type,
                             VariantMap const &params) {
   auto const verlet = get_value_or<bool>(params, "use_verlet_lists", true);
@@ -26,8 +26,11 @@
 
 #include "core/cell_system/CellStructure.hpp"
 #include "core/cell_system/CellStructureType.hpp"
+#include "core/cell_system/GhostShell.hpp"
 #include "core/cell_system/HybridDecomposition.hpp"
+#include "core/cell_system/LoadBalancer.hpp"
 #include "core/cell_system/RegularDecomposition.hpp"
+#include "core/cell_system/SpaceFillingCurve.hpp"
 
 #include <memory>
 #include <string>
@@ -55,6 +58,44 @@ class CellSystem : public AutoParameters<CellSystem, System::Leaf> {
       {"hybrid_decomposition", CellStructureType::HYBRID},
   };
 
+  std::unordered_map<LoadBalancingMetric, std::string> const
+      lb_metric_type_to_name = {
+          {LoadBalancingMetric::N_PARTICLES, "n_particles"},
+          {LoadBalancingMetric::FORCE_TIME, "force_time"},
+      };
+
+  std::unordered_map<std::string, LoadBalancingMetric> const
+      lb_metric_name_to_type = {
+          {"n_particles", LoadBalancingMetric::N_PARTICLES},
+          {"force_time", LoadBalancingMetric::FORCE_TIME},
+      };
+
+  std::unordered_map<SpaceFillingCurve, std::string> const
+      sfc_type_to_name = {
+          {SpaceFillingCurve::NONE, "none"},
+          {SpaceFillingCurve::MORTON, "morton"},
+          {SpaceFillingCurve::HILBERT, "hilbert"},
+      };
+
+  std::unordered_map<std::string, SpaceFillingCurve> const
+      sfc_name_to_type = {
+          {"none", SpaceFillingCurve::NONE},
+          {"morton", SpaceFillingCurve::MORTON},
+          {"hilbert", SpaceFillingCurve::HILBERT},
+      };
+
+  std::unordered_map<GhostShell, std::string> const
+      ghost_shell_type_to_name = {
+          {GhostShell::FULL, "full"},
+          {GhostShell::HALF, "half"},
+      };
+
+  std::unordered_map<std::string, GhostShell> const
+      ghost_shell_name_to_type = {
+          {"full", GhostShell::FULL},
+          {"half", GhostShell::HALF},
+      };
+
   std::shared_ptr<::CellStructure> m_cell_structure;
   std::unique_ptr<VariantMap> m_params;
 
@@ -68,6 +109,25 @@ class CellSystem : public AutoParameters<CellSystem, System::Leaf> {
       initialize(cs_type, params);
       do_set_parameter("skin", params.at("skin"));
       do_set_parameter("node_grid", params.at("node_grid"));
+      if (params.contains("n_threads")) {
+        do_set_parameter("n_threads", params.at("n_threads"));
+      }
+      if (params.contains("use_particle_arrays")) {
+        do_set_parameter("use_particle_arrays",
+                         params.at("use_particle_arrays"));
+      }
+      if (params.contains("overlap_ghost_communication")) {
+        do_set_parameter("overlap_ghost_communication",
+                         params.at("overlap_ghost_communication"));
+      }
+      for (auto const *key :
+           {"load_balancing_interval", "load_balancing_metric",
+            "reordering_interval", "space_filling_curve",
+            "skin_tuning_interval", "ghost_shell"}) {
+        if (params.contains(key)) {
+          do_set_parameter(key, params.at(key));
+        }
+      }
     }
     m_params.reset();
   }
@@ -101,6 +161,9 @@ private:
 
   void initialize(CellStructureType const &cs_type, VariantMap const &params);
 
+  /** @brief Domain boundaries along each direction. */
+  std::vector<Variant> get_domain_bounds() const;
+
   auto const &get_regular_decomposition() const {
     return dynamic_cast<RegularDecomposition const &>(
         std::as_const(get_cell_structure()).decomposition());
@@ -28,6 +28,7 @@
 #include "core/electrostatics/p3m.hpp"
 #include "core/electrostatics/p3m.impl.hpp"
 #include "core/p3m/FFTBackendLegacy.hpp"
+#include "core/p3m/FFTBackendPencil.hpp"
 #include "core/p3m/FFTBuffersLegacy.hpp"
 
 #include "script_interface/get_value.hpp"
@@ -51,6 +52,8 @@ class CoulombP3M : public Actor<CoulombP3M<Architecture>, ::CoulombP3M> {
   bool m_tune_verbose;
   bool m_check_complex_residuals;
   bool m_single_precision;
+  std::string m_fft_backend;
+  bool m_fft_overlap;
 
 public:
   using Base = Actor<CoulombP3M<Architecture>, ::CoulombP3M>;
@@ -94,8 +97,16 @@ public:
         {"timings", AutoParameter::read_only,
          [this]() { return m_tune_timings; }},
         {"tune", AutoParameter::read_only, [this]() { return m_tune; }},
+        {"tuning_database", AutoParameter::read_only,
+         [this]() { return actor()->tuning_database; }},
+        {"tuning_verify", AutoParameter::read_only,
+         [this]() { return actor()->tuning_verify; }},
         {"check_complex_residuals", AutoParameter::read_only,
          [this]() { return m_check_complex_residuals; }},
+        {"fft_backend", AutoParameter::read_only,
+         [this]() { return m_fft_backend; }},
+        {"fft_overlap", AutoParameter::read_only,
+         [this]() { return m_fft_overlap; }},
     });
   }
 
@@ -105,6 +116,8 @@ public:
     m_tune_verbose = get_value<bool>(params, "verbose");
     m_check_complex_residuals =
         get_value<bool>(params, "check_complex_residuals");
+    m_fft_backend = get_value<std::string>(params, "fft_backend");
+    m_fft_overlap = get_value<bool>(params, "fft_overlap");
     auto const single_precision = get_value<bool>(params, "single_precision");
     context()->parallel_try_catch([&]() {
       if (Architecture == Arch::GPU and not single_precision) {
@@ -121,7 +134,11 @@ public:
                                get_value<double>(params, "accuracy")};
       make_handle(single_precision, std::move(p3m),
                   get_value<double>(params, "prefactor"), m_tune_timings,
-                  m_tune_verbose, m_check_complex_residuals);
+                  m_tune_verbose, m_check_complex_residuals, m_fft_overlap);
+      m_actor->tuning_database =
+          get_value_or<std::string>(params, "tuning_database", "");
+      m_actor->tuning_verify =
+          get_value_or<bool>(params, "tuning_verify", false);
     });
     set_charge_neutrality_tolerance(params);
   }
@@ -129,8 +146,19 @@ public:
 private:
   template <typename FloatType, class... Args>
   void make_handle_impl(Args &&...args) {
-    m_actor = new_p3m_handle<FloatType, Architecture, FFTBackendLegacy,
-                             FFTBuffersLegacy>(std::forward<Args>(args)...);
+    if (m_fft_backend == "legacy") {
+      m_actor = new_p3m_handle<FloatType, Architecture, FFTBackendLegacy,
+                               FFTBuffersLegacy>(std::forward<Args>(args)...);
+    } else if (m_fft_backend == "pencil") {
+      m_actor = new_p3m_handle<FloatType, Architecture, FFTBackendPencil,
+                               FFTBuffersLegacy>(std::forward<Args>(args)...);
+    } else if (m_fft_backend == "pencil_r2c") {
+      m_actor = new_p3m_handle<FloatType, Architecture, FFTBackendPencilR2C,
+                               FFTBuffersLegacy>(std::forward<Args>(args)...);
+    } else {
+      throw std::invalid_argument("Unknown FFT backend '" + m_fft_backend +
+                                  "'");
+    }
   }
   template <class... Args>
   void make_handle(bool single_precision, Args &&...args) {
@@ -26,6 +26,7 @@
 #include "StokesianDynamics.hpp"
 #include "VelocityVerlet.hpp"
 #include "VelocityVerletIsoNPT.hpp"
+#include "VelocityVerletRESPA.hpp"
 
 #include "core/PropagationMode.hpp"
 #include "core/integrators/Propagation.hpp"
@@ -78,6 +79,9 @@ IntegratorHandle::IntegratorHandle() {
          case INTEG_METHOD_BD:
            return Variant{
                std::dynamic_pointer_cast<BrownianDynamics>(m_instance)};
+         case INTEG_METHOD_RESPA:
+           return Variant{
+               std::dynamic_pointer_cast<VelocityVerletRESPA>(m_instance)};
 #ifdef STOKESIAN_DYNAMICS
          case INTEG_METHOD_SD:
            return Variant{
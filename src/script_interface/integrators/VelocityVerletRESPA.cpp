@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VelocityVerletRESPA.hpp"
+
+#include "script_interface/ScriptInterface.hpp"
+
+#include "core/PropagationMode.hpp"
+#include "core/integrators/Propagation.hpp"
+
+#include <stdexcept>
+
+namespace ScriptInterface {
+namespace Integrators {
+
+VelocityVerletRESPA::VelocityVerletRESPA() {
+  add_parameters({
+      {"n_inner_steps", AutoParameter::read_only,
+       [this]() { return m_n_inner_steps; }},
+  });
+}
+
+void VelocityVerletRESPA::do_construct(VariantMap const &params) {
+  auto const n_inner_steps = get_value<int>(params, "n_inner_steps");
+  context()->parallel_try_catch([&]() {
+    if (n_inner_steps < 1) {
+      throw std::domain_error("Parameter 'n_inner_steps' must be >= 1");
+    }
+  });
+  m_n_inner_steps = n_inner_steps;
+}
+
+void VelocityVerletRESPA::activate() {
+  auto &propagation = *get_system().propagation;
+  propagation.respa_n_inner_steps = m_n_inner_steps;
+  propagation.set_integ_switch(INTEG_METHOD_RESPA);
+}
+
+} // namespace Integrators
+} // namespace ScriptInterface
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Integrator.hpp"
+
+#include "script_interface/ScriptInterface.hpp"
+#include "script_interface/auto_parameters/AutoParameters.hpp"
+
+namespace ScriptInterface {
+namespace Integrators {
+
+class VelocityVerletRESPA
+    : public AutoParameters<VelocityVerletRESPA, Integrator> {
+  int m_n_inner_steps = 1;
+
+public:
+  VelocityVerletRESPA();
+
+  void do_construct(VariantMap const &params) override;
+  void activate() override;
+};
+
+} // namespace Integrators
+} // namespace ScriptInterface
@@ -25,6 +25,7 @@
 #include "StokesianDynamics.hpp"
 #include "VelocityVerlet.hpp"
 #include "VelocityVerletIsoNPT.hpp"
+#include "VelocityVerletRESPA.hpp"
 #include "config/config.hpp"
 
 namespace ScriptInterface {
@@ -41,6 +42,7 @@ void initialize(Utils::Factory<ObjectHandle> *om) {
 #ifdef NPT
   om->register_new<VelocityVerletIsoNPT>("Integrators::VelocityVerletIsoNPT");
 #endif // NPT
+  om->register_new<VelocityVerletRESPA>("Integrators::VelocityVerletRESPA");
 }
 
 } // namespace Integrators
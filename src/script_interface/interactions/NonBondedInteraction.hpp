@@ -704,6 +704,30 @@ private:
 };
 #endif // SMOOTH_STEP
 
+class InteractionSplineTabulation
+    : public InteractionPotentialInterface<::SplineTabulation_Parameters> {
+protected:
+  CoreInteraction IA_parameters::*get_ptr_offset() const override {
+    return &::IA_parameters::spline_tabulation;
+  }
+
+public:
+  InteractionSplineTabulation() {
+    add_parameters({
+        make_autoparameter(&CoreInteraction::min, "min"),
+        make_autoparameter(&CoreInteraction::accuracy, "accuracy"),
+    });
+  }
+
+private:
+  std::string inactive_parameter() const override { return "accuracy"; }
+
+  void make_new_instance(VariantMap const &params) override {
+    m_handle = make_shared_from_args<CoreInteraction, double, double>(
+        params, "min", "accuracy");
+  }
+};
+
 class NonBondedInteractionHandle
     : public AutoParameters<NonBondedInteractionHandle> {
   std::shared_ptr<::IA_parameters> m_handle;
@@ -760,6 +784,7 @@ class NonBondedInteractionHandle
 #ifdef SMOOTH_STEP
   std::shared_ptr<InteractionSmoothStep> m_smooth_step;
 #endif
+  std::shared_ptr<InteractionSplineTabulation> m_spline_tabulation;
 
 public:
   NonBondedInteractionHandle() {
@@ -879,6 +904,8 @@ private:
 #ifdef SMOOTH_STEP
     fun(m_smooth_step, "smooth_step", "Interactions::InteractionSmoothStep");
 #endif
+    fun(m_spline_tabulation, "spline_tabulation",
+        "Interactions::InteractionSplineTabulation");
   }
 
 public:
@@ -110,6 +110,8 @@ void initialize(Utils::Factory<ObjectHandle> *om) {
   om->register_new<InteractionSmoothStep>(
       "Interactions::InteractionSmoothStep");
 #endif
+  om->register_new<InteractionSplineTabulation>(
+      "Interactions::InteractionSplineTabulation");
 }
 } // namespace Interactions
 } // namespace ScriptInterface
@@ -28,6 +28,7 @@
 #include "core/magnetostatics/dp3m.hpp"
 #include "core/magnetostatics/dp3m.impl.hpp"
 #include "core/p3m/FFTBackendLegacy.hpp"
+#include "core/p3m/FFTBackendPencil.hpp"
 #include "core/p3m/FFTBuffersLegacy.hpp"
 
 #include "script_interface/get_value.hpp"
@@ -49,6 +50,8 @@ class DipolarP3M : public Actor<DipolarP3M<Architecture>, ::DipolarP3M> {
   int m_tune_timings;
   bool m_tune;
   bool m_tune_verbose;
+  std::string m_fft_backend;
+  bool m_fft_overlap;
 
 public:
   using Base = Actor<DipolarP3M<Architecture>, ::DipolarP3M>;
@@ -91,6 +94,14 @@ public:
         {"timings", AutoParameter::read_only,
          [this]() { return m_tune_timings; }},
         {"tune", AutoParameter::read_only, [this]() { return m_tune; }},
+        {"tuning_database", AutoParameter::read_only,
+         [this]() { return actor()->tuning_database; }},
+        {"tuning_verify", AutoParameter::read_only,
+         [this]() { return actor()->tuning_verify; }},
+        {"fft_backend", AutoParameter::read_only,
+         [this]() { return m_fft_backend; }},
+        {"fft_overlap", AutoParameter::read_only,
+         [this]() { return m_fft_overlap; }},
     });
   }
 
@@ -98,6 +109,8 @@ public:
     m_tune = get_value<bool>(params, "tune");
     m_tune_timings = get_value<int>(params, "timings");
     m_tune_verbose = get_value<bool>(params, "verbose");
+    m_fft_backend = get_value<std::string>(params, "fft_backend");
+    m_fft_overlap = get_value<bool>(params, "fft_overlap");
     auto const single_precision = get_value<bool>(params, "single_precision");
     static_assert(Architecture == Arch::CPU, "GPU not implemented");
     context()->parallel_try_catch([&]() {
@@ -111,15 +124,30 @@ public:
                                get_value<double>(params, "accuracy")};
       make_handle(single_precision, std::move(p3m),
                   get_value<double>(params, "prefactor"), m_tune_timings,
-                  m_tune_verbose);
+                  m_tune_verbose, m_fft_overlap);
+      m_actor->tuning_database =
+          get_value_or<std::string>(params, "tuning_database", "");
+      m_actor->tuning_verify =
+          get_value_or<bool>(params, "tuning_verify", false);
     });
   }
 
 private:
   template <typename FloatType, class... Args>
   void make_handle_impl(Args &&...args) {
-    m_actor = new_dp3m_handle<FloatType, Architecture, FFTBackendLegacy,
-                              FFTBuffersLegacy>(std::forward<Args>(args)...);
+    if (m_fft_backend == "legacy") {
+      m_actor = new_dp3m_handle<FloatType, Architecture, FFTBackendLegacy,
+                                FFTBuffersLegacy>(std::forward<Args>(args)...);
+    } else if (m_fft_backend == "pencil") {
+      m_actor = new_dp3m_handle<FloatType, Architecture, FFTBackendPencil,
+                                FFTBuffersLegacy>(std::forward<Args>(args)...);
+    } else if (m_fft_backend == "pencil_r2c") {
+      m_actor = new_dp3m_handle<FloatType, Architecture, FFTBackendPencilR2C,
+                                FFTBuffersLegacy>(std::forward<Args>(args)...);
+    } else {
+      throw std::invalid_argument("Unknown FFT backend '" + m_fft_backend +
+                                  "'");
+    }
   }
   template <class... Args>
   void make_handle(bool single_precision, Args &&...args) {
@@ -26,6 +26,7 @@
 #include "Actor.impl.hpp"
 
 #include "Container.hpp"
+#include "DipolarBarnesHut.hpp"
 #include "DipolarDirectSum.hpp"
 #include "DipolarDirectSumGpu.hpp"
 #include "DipolarLayerCorrection.hpp"
@@ -46,6 +47,7 @@ namespace Dipoles {
 void initialize(Utils::Factory<ObjectHandle> *om) {
 #ifdef DIPOLES
   om->register_new<DipolarDirectSum>("Dipoles::DipolarDirectSumCpu");
+  om->register_new<DipolarBarnesHut>("Dipoles::DipolarBarnesHut");
 #ifdef DIPOLAR_DIRECT_SUM
   om->register_new<DipolarDirectSumGpu>("Dipoles::DipolarDirectSumGpu");
 #endif
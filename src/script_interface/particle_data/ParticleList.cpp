@@ -17,6 +17,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "config/config.hpp"
+
 #include "ParticleList.hpp"
 #include "ParticleHandle.hpp"
 #include "ParticleSlice.hpp"
@@ -27,6 +29,7 @@
 
 #include "core/cell_system/CellStructure.hpp"
 #include "core/exclusions.hpp"
+#include "core/nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "core/particle_node.hpp"
 #include "core/system/System.hpp"
 
@@ -38,8 +41,10 @@
 #include <boost/mpi/communicator.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -140,6 +145,124 @@ static void auto_exclusions(boost::mpi::communicator const &comm,
 }
 #endif // EXCLUSIONS
 
+/** @brief Fetch an optional flat array with a fixed number of values. */
+template <typename T>
+static auto get_array(VariantMap const &params, std::string const &key,
+                      std::size_t n_values) {
+  std::optional<std::vector<T>> array;
+  if (params.contains(key)) {
+    array = get_value<std::vector<T>>(params, key);
+    if (array->size() != n_values) {
+      throw std::invalid_argument("Parameter '" + key + "' must have " +
+                                  std::to_string(n_values) + " values");
+    }
+  }
+  return array;
+}
+
+/**
+ * @brief Create many particles with a single collective operation.
+ * Particle properties are passed as flat arrays with one value (or one
+ * 3D vector) per particle. Only a subset of the properties is supported.
+ * The arrays are only read on the head node, which sends each particle
+ * to the rank that owns it.
+ */
+void ParticleList::add_particles(VariantMap const &params) {
+  auto const &comm = context()->get_comm();
+  std::vector<Particle> particles;
+  auto max_type = 0;
+  context()->parallel_try_catch([&]() {
+    if (not context()->is_head_node()) {
+      return;
+    }
+    auto const p_ids = get_value<std::vector<int>>(params, "id");
+    auto const n_part = p_ids.size();
+    auto const pos = get_array<double>(params, "pos", 3u * n_part);
+    auto const v = get_array<double>(params, "v", 3u * n_part);
+    auto const q = get_array<double>(params, "q", n_part);
+    auto const mass = get_array<double>(params, "mass", n_part);
+    auto const type = get_array<int>(params, "type", n_part);
+    if (not pos) {
+      throw std::invalid_argument("Parameter 'pos' is missing");
+    }
+    for (auto const p_id : p_ids) {
+      if (p_id < 0) {
+        throw std::domain_error("Invalid particle id: " +
+                                std::to_string(p_id));
+      }
+    }
+    auto sorted_ids = p_ids;
+    std::ranges::sort(sorted_ids);
+    auto const duplicate = std::ranges::adjacent_find(sorted_ids);
+    if (duplicate != sorted_ids.end()) {
+      throw std::invalid_argument("Particle " + std::to_string(*duplicate) +
+                                  " appears more than once");
+    }
+#ifndef __FAST_MATH__
+    if (not std::ranges::all_of(*pos, [](double x) {
+          return std::isfinite(x);
+        })) {
+      throw std::domain_error("Particle position must be finite");
+    }
+#endif // __FAST_MATH__
+    if (type and std::ranges::any_of(*type, [](int t) { return t < 0; })) {
+      throw std::domain_error(
+          "attribute 'type' of 'ParticleHandle' must be an integer >= 0");
+    }
+#ifdef MASS
+    if (mass and std::ranges::any_of(*mass, [](double m) {
+          return m <= 0.;
+        })) {
+      throw std::domain_error(
+          "attribute 'mass' of 'ParticleHandle' must be a float > 0");
+    }
+#else  // MASS
+    auto const default_mass = Particle().mass();
+    if (mass and std::ranges::any_of(*mass, [=](double m) {
+          return std::abs(m - default_mass) > 1e-10;
+        })) {
+      throw std::runtime_error("Feature MASS not compiled in");
+    }
+#endif // MASS
+#ifndef ELECTROSTATICS
+    if (q and std::ranges::any_of(*q, [](double x) { return x != 0.; })) {
+      throw std::runtime_error("Feature ELECTROSTATICS not compiled in");
+    }
+#endif // ELECTROSTATICS
+
+    particles.resize(n_part);
+    for (std::size_t i = 0u; i < n_part; ++i) {
+      auto &p = particles[i];
+      p.id() = p_ids[i];
+      p.pos() = {(*pos)[3u * i], (*pos)[3u * i + 1u], (*pos)[3u * i + 2u]};
+      if (type) {
+        p.type() = (*type)[i];
+      }
+      if (v) {
+        p.v() = {(*v)[3u * i], (*v)[3u * i + 1u], (*v)[3u * i + 2u]};
+      }
+#ifdef ELECTROSTATICS
+      if (q) {
+        p.q() = (*q)[i];
+      }
+#endif // ELECTROSTATICS
+#ifdef MASS
+      if (mass) {
+        p.mass() = (*mass)[i];
+      }
+#endif // MASS
+    }
+    if (type and n_part != 0u) {
+      max_type = std::ranges::max(*type);
+    }
+  });
+
+  boost::mpi::broadcast(comm, max_type, 0);
+  get_system().nonbonded_ias->make_particle_type_exist(max_type);
+  context()->parallel_try_catch(
+      [&]() { make_new_particles(std::move(particles)); });
+}
+
 Variant ParticleList::do_call_method(std::string const &name,
                                      VariantMap const &params) {
 #ifdef EXCLUSIONS
@@ -152,6 +275,10 @@ Variant ParticleList::do_call_method(std::string const &name,
   if (name == "get_highest_particle_id") {
     return get_maximal_particle_id();
   }
+  if (name == "add_particles") {
+    add_particles(params);
+    return {};
+  }
   if (name == "clear") {
     remove_all_particles();
     return {};
@@ -40,6 +40,8 @@ class ParticleList : public System::Leaf {
     return ptr;
   }
 
+  void add_particles(VariantMap const &params);
+
 public:
   Variant do_call_method(std::string const &name,
                          VariantMap const &params) override;
@@ -22,8 +22,13 @@
 
 #include "script_interface/ScriptInterface.hpp"
 
+#include "core/cell_system/CellStructure.hpp"
 #include "core/particle_node.hpp"
 
+#include <boost/mpi/collectives/all_reduce.hpp>
+
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -58,6 +63,28 @@ void ParticleSlice::do_construct(VariantMap const &params) {
 
 Variant ParticleSlice::do_call_method(std::string const &name,
                                       VariantMap const &params) {
+  if (name == "remove_particles") {
+    auto p_ids = m_id_selection;
+    std::ranges::sort(p_ids);
+    auto const [first, last] = std::ranges::unique(p_ids);
+    p_ids.erase(first, last);
+    context()->parallel_try_catch([&]() {
+      auto const &cell_structure =
+          m_cell_structure.lock()->get_cell_structure();
+      auto n_local = 0;
+      for (auto const p_id : p_ids) {
+        auto const p = cell_structure.get_local_particle(p_id);
+        n_local += (p != nullptr and not p->is_ghost()) ? 1 : 0;
+      }
+      auto const n_found = boost::mpi::all_reduce(context()->get_comm(),
+                                                  n_local, std::plus<int>());
+      if (n_found != static_cast<int>(p_ids.size())) {
+        throw std::runtime_error("Some particles no longer exist");
+      }
+    });
+    remove_particles(p_ids);
+    return {};
+  }
   if (not context()->is_head_node()) {
     return {};
   }
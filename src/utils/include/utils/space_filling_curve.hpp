@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/** \file
+ *  Position of the points of a 3D grid along space-filling curves.
+ *
+ *  The grid has @f$ 2^b @f$ points per direction, where @f$ b @f$ is the
+ *  number of bits per coordinate, and @f$ 3b @f$ must not exceed 64.
+ */
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace Utils {
+
+namespace detail {
+/** Interleave the bits of the coordinates, most significant bits first. */
+inline std::uint64_t interleave_bits(std::array<std::uint32_t, 3> const &x,
+                                     unsigned bits) {
+  std::uint64_t index = 0u;
+  for (auto bit = bits; bit-- > 0u;) {
+    for (auto const coordinate : x) {
+      index = (index << 1) | ((coordinate >> bit) & 1u);
+    }
+  }
+  return index;
+}
+} // namespace detail
+
+/**
+ * @brief Index of a grid point along the Morton (Z-order) curve.
+ * @param x     Grid point, each coordinate must be smaller than @f$ 2^b @f$.
+ * @param bits  Number of bits per coordinate @f$ b @f$.
+ */
+inline std::uint64_t morton_index(std::array<std::uint32_t, 3> const &x,
+                                  unsigned bits) {
+  assert(3u * bits <= 64u);
+  return detail::interleave_bits(x, bits);
+}
+
+/**
+ * @brief Index of a grid point along the Hilbert curve.
+ *
+ * Consecutive indices belong to adjacent grid points. Uses the
+ * coordinate transposition of @cite skilling04a.
+ *
+ * @param x     Grid point, each coordinate must be smaller than @f$ 2^b @f$.
+ * @param bits  Number of bits per coordinate @f$ b @f$.
+ */
+inline std::uint64_t hilbert_index(std::array<std::uint32_t, 3> x,
+                                   unsigned bits) {
+  assert(3u * bits <= 64u);
+  if (bits == 0u) {
+    return 0u;
+  }
+  auto const m = std::uint32_t{1u} << (bits - 1u);
+  /* inverse undo of the excess work */
+  for (auto q = m; q > 1u; q >>= 1) {
+    auto const p = q - 1u;
+    for (auto &coordinate : x) {
+      if (coordinate & q) {
+        x[0] ^= p;
+      } else {
+        auto const t = (x[0] ^ coordinate) & p;
+        x[0] ^= t;
+        coordinate ^= t;
+      }
+    }
+  }
+  /* Gray encoding */
+  x[1] ^= x[0];
+  x[2] ^= x[1];
+  std::uint32_t t = 0u;
+  for (auto q = m; q > 1u; q >>= 1) {
+    if (x[2] & q) {
+      t ^= q - 1u;
+    }
+  }
+  for (auto &coordinate : x) {
+    coordinate ^= t;
+  }
+  return detail::interleave_bits(x, bits);
+}
+
+} // namespace Utils
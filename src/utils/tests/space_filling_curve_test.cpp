@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2024 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Utils::space_filling_curve test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "utils/space_filling_curve.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using Point = std::array<std::uint32_t, 3>;
+
+/** Grid points in the order of their curve index. */
+template <class Curve> auto curve_points(Curve curve, unsigned bits) {
+  auto const n = std::uint32_t{1u} << bits;
+  std::vector<Point> points(std::size_t{n} * n * n);
+  std::vector<bool> visited(points.size(), false);
+  for (std::uint32_t i = 0u; i < n; ++i) {
+    for (std::uint32_t j = 0u; j < n; ++j) {
+      for (std::uint32_t k = 0u; k < n; ++k) {
+        auto const index = curve(Point{i, j, k}, bits);
+        BOOST_REQUIRE_LT(index, points.size());
+        BOOST_REQUIRE(not visited[index]);
+        visited[index] = true;
+        points[index] = Point{i, j, k};
+      }
+    }
+  }
+  return points;
+}
+
+BOOST_AUTO_TEST_CASE(morton) {
+  BOOST_CHECK_EQUAL(Utils::morton_index({0u, 0u, 0u}, 2u), 0u);
+  BOOST_CHECK_EQUAL(Utils::morton_index({0u, 0u, 1u}, 2u), 1u);
+  BOOST_CHECK_EQUAL(Utils::morton_index({0u, 1u, 0u}, 2u), 2u);
+  BOOST_CHECK_EQUAL(Utils::morton_index({1u, 0u, 0u}, 2u), 4u);
+  BOOST_CHECK_EQUAL(Utils::morton_index({0u, 0u, 2u}, 2u), 8u);
+  BOOST_CHECK_EQUAL(Utils::morton_index({3u, 3u, 3u}, 2u), 63u);
+  BOOST_CHECK_EQUAL(Utils::morton_index({1u, 1u, 1u}, 21u), 7u);
+
+  /* the curve is a bijection */
+  for (auto const bits : {0u, 1u, 2u, 3u}) {
+    curve_points(Utils::morton_index, bits);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(hilbert) {
+  BOOST_CHECK_EQUAL(Utils::hilbert_index({0u, 0u, 0u}, 3u), 0u);
+
+  /* the curve is a bijection and visits adjacent grid points */
+  for (auto const bits : {0u, 1u, 2u, 3u, 4u}) {
+    auto const points = curve_points(Utils::hilbert_index, bits);
+    for (std::size_t i = 1u; i < points.size(); ++i) {
+      auto distance = 0;
+      for (std::size_t j = 0u; j < 3u; ++j) {
+        distance += std::abs(static_cast<int>(points[i][j]) -
+                             static_cast<int>(points[i - 1u][j]));
+      }
+      BOOST_REQUIRE_EQUAL(distance, 1);
+    }
+  }
+
+  /* the largest coordinates are supported */
+  auto const max = (std::uint32_t{1u} << 21u) - 1u;
+  BOOST_CHECK_LT(Utils::hilbert_index({max, max, max}, 21u),
+                 std::uint64_t{1u} << 63u);
+}
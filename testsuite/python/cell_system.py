@@ -17,6 +17,7 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 import unittest as ut
+import unittest_decorators as utx
 import espressomd
 import numpy as np
 import tests_common
@@ -84,6 +85,13 @@ class CellSystem(ut.TestCase):
         np.testing.assert_array_equal(np.copy(system.cell_system.node_grid),
                                       np.copy(node_grid))
 
+        with self.assertRaisesRegex(ValueError, "Parameter 'n_threads' must be >= 1"):
+            system.cell_system.n_threads = 0
+        if not espressomd.has_features(["OPENMP"]):
+            with self.assertRaisesRegex(RuntimeError, "Parameter 'n_threads' must be 1 without feature OPENMP"):
+                system.cell_system.n_threads = 2
+        self.assertEqual(system.cell_system.n_threads, 1)
+
     def test_node_grid_regular(self):
         self.system.cell_system.set_regular_decomposition()
         self.check_node_grid()
@@ -93,6 +101,327 @@ class CellSystem(ut.TestCase):
             n_square_types={1}, cutoff_regular=0)
         self.check_node_grid()
 
+    @utx.skipIfMissingFeatures(["OPENMP", "LENNARD_JONES"])
+    def test_n_threads(self):
+        system = self.system
+        system.box_l = 3 * [8.]
+        system.cell_system.skin = 0.4
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=2.5, shift="auto")
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((400, 3)) * system.box_l)
+        for use_verlet_lists in [True, False]:
+            system.cell_system.set_regular_decomposition(
+                use_verlet_lists=use_verlet_lists)
+            system.cell_system.n_threads = 1
+            system.integrator.run(0, recalc_forces=True)
+            f_ref = np.copy(system.part.all().f)
+            for n_threads in [2, 4]:
+                system.cell_system.n_threads = n_threads
+                self.assertEqual(system.cell_system.n_threads, n_threads)
+                # run twice to replay the Verlet list
+                for _ in range(2):
+                    system.integrator.run(0, recalc_forces=True)
+                    np.testing.assert_allclose(
+                        np.copy(system.part.all().f), f_ref, atol=1e-10)
+        system.cell_system.n_threads = 1
+        system.part.clear()
+        system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        system.box_l = 3 * [5.]
+
+    @utx.skipIfMissingFeatures(["OPENMP"])
+    def test_n_threads_propagation(self):
+        system = self.system
+        system.box_l = 3 * [8.]
+        system.time_step = 0.01
+        system.cell_system.skin = 0.4
+        system.cell_system.set_regular_decomposition()
+        np.random.seed(42)
+        pos = np.random.random((400, 3)) * system.box_l
+        for integrator in ["langevin", "brownian"]:
+            if integrator == "langevin":
+                system.thermostat.set_langevin(kT=1., gamma=1., seed=42)
+                system.integrator.set_vv()
+                thermostat = system.thermostat.langevin
+            else:
+                system.thermostat.set_brownian(kT=1., gamma=1., seed=42)
+                system.integrator.set_brownian_dynamics()
+                thermostat = system.thermostat.brownian
+            trajectories = []
+            for n_threads in [1, 2, 4]:
+                system.cell_system.n_threads = n_threads
+                system.part.clear()
+                partcls = system.part.add(pos=pos)
+                thermostat.call_method("override_philox_counter", counter=0)
+                system.integrator.run(20)
+                trajectories.append(np.copy(partcls.pos))
+            # the counter-based noise doesn't depend on the number of threads
+            for trajectory in trajectories[1:]:
+                np.testing.assert_array_equal(trajectory, trajectories[0])
+            system.thermostat.turn_off()
+        system.integrator.set_vv()
+        system.cell_system.n_threads = 1
+        system.part.clear()
+        system.box_l = 3 * [5.]
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES", "EXCLUSIONS"])
+    def test_particle_arrays(self):
+        system = self.system
+        system.box_l = 3 * [8.]
+        system.cell_system.skin = 0.4
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=2.5, shift="auto")
+        system.non_bonded_inter[0, 1].lennard_jones.set_params(
+            epsilon=1.2, sigma=0.9, cutoff=2.0, shift="auto")
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((400, 3)) * system.box_l,
+                        type=np.random.randint(0, 2, 400))
+        self.assertFalse(system.cell_system.use_particle_arrays)
+        self.assertFalse(system.cell_system.overlap_ghost_communication)
+        for use_verlet_lists in [True, False]:
+            for set_decomposition in [
+                    system.cell_system.set_regular_decomposition,
+                    system.cell_system.set_n_square]:
+                set_decomposition(use_verlet_lists=use_verlet_lists)
+                system.cell_system.use_particle_arrays = False
+                system.integrator.run(0, recalc_forces=True)
+                f_ref = np.copy(system.part.all().f)
+                system.cell_system.use_particle_arrays = True
+                self.assertTrue(system.cell_system.use_particle_arrays)
+                # run twice to replay the Verlet list
+                for _ in range(2):
+                    system.integrator.run(0, recalc_forces=True)
+                    np.testing.assert_allclose(
+                        np.copy(system.part.all().f), f_ref, atol=1e-10)
+                # overlap the ghost update with the inner cells
+                system.cell_system.overlap_ghost_communication = True
+                self.assertTrue(system.cell_system.overlap_ghost_communication)
+                for _ in range(2):
+                    system.integrator.run(0, recalc_forces=True)
+                    np.testing.assert_allclose(
+                        np.copy(system.part.all().f), f_ref, atol=1e-10)
+                system.cell_system.overlap_ghost_communication = False
+                # exclusions fall back to the particle-based kernel
+                system.part.by_id(0).add_exclusion(1)
+                system.cell_system.use_particle_arrays = False
+                system.integrator.run(0, recalc_forces=True)
+                f_ref = np.copy(system.part.all().f)
+                system.cell_system.use_particle_arrays = True
+                system.integrator.run(0, recalc_forces=True)
+                np.testing.assert_allclose(
+                    np.copy(system.part.all().f), f_ref, atol=1e-10)
+                system.part.by_id(0).delete_exclusion(1)
+        system.cell_system.use_particle_arrays = False
+        system.part.clear()
+        system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        system.non_bonded_inter[0, 1].lennard_jones.deactivate()
+        system.box_l = 3 * [5.]
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_space_filling_curve(self):
+        system = self.system
+        system.box_l = 3 * [8.]
+        system.cell_system.skin = 0.4
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=2.5, shift="auto")
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((400, 3)) * system.box_l)
+        self.assertEqual(system.cell_system.space_filling_curve, "none")
+        self.assertEqual(system.cell_system.reordering_interval, 1)
+        for set_decomposition in [
+                system.cell_system.set_regular_decomposition,
+                system.cell_system.set_n_square]:
+            set_decomposition()
+            system.integrator.run(0, recalc_forces=True)
+            f_ref = np.copy(system.part.all().f)
+            for curve in ["morton", "hilbert"]:
+                system.cell_system.space_filling_curve = curve
+                self.assertEqual(system.cell_system.space_filling_curve, curve)
+                system.integrator.run(0, recalc_forces=True)
+                np.testing.assert_allclose(
+                    np.copy(system.part.all().f), f_ref, atol=1e-10)
+                self.assertEqual(
+                    system.cell_system.get_state()["decomposition_type"],
+                    set_decomposition.__name__[4:])
+            system.cell_system.space_filling_curve = "none"
+        system.cell_system.reordering_interval = 5
+        self.assertEqual(system.cell_system.reordering_interval, 5)
+        with self.assertRaisesRegex(ValueError, "Parameter 'reordering_interval' must be >= 0"):
+            system.cell_system.reordering_interval = -1
+        with self.assertRaisesRegex(ValueError, "Parameter 'space_filling_curve' must be one of 'none', 'morton', 'hilbert'"):
+            system.cell_system.space_filling_curve = "peano"
+        system.cell_system.reordering_interval = 1
+        system.cell_system.set_regular_decomposition()
+        system.part.clear()
+        system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        system.box_l = 3 * [5.]
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_skin_tuning(self):
+        system = self.system
+        system.box_l = 3 * [8.]
+        system.cell_system.skin = 0.4
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=1.5, shift="auto")
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((200, 3)) * system.box_l)
+        system.integrator.set_steepest_descent(
+            f_max=0., gamma=0.1, max_displacement=0.05)
+        system.integrator.run(50)
+        system.integrator.set_vv()
+        self.assertEqual(system.cell_system.skin_tuning_interval, 0)
+        self.assertEqual(system.cell_system.skin_tuning_trace, [])
+        self.assertIsNone(system.cell_system.tuned_skin)
+        system.cell_system.skin_tuning_interval = 2
+        self.assertEqual(system.cell_system.skin_tuning_interval, 2)
+        system.integrator.run(40)
+        trace = np.array(system.cell_system.skin_tuning_trace)
+        self.assertEqual(trace.shape[1], 2)
+        self.assertGreater(trace.shape[0], 1)
+        self.assertTrue(np.all(trace > 0.))
+        max_skin = min(system.box_l) / 2. - 1.5
+        skin = system.cell_system.skin
+        self.assertGreaterEqual(skin, 0.05 * 1.5 * (1. - 1e-12))
+        self.assertLessEqual(skin, max_skin * (1. + 1e-12))
+        # disabling the tuner clears the trace and keeps the skin
+        system.cell_system.skin_tuning_interval = 0
+        self.assertEqual(system.cell_system.skin_tuning_trace, [])
+        self.assertIsNone(system.cell_system.tuned_skin)
+        self.assertEqual(system.cell_system.skin, skin)
+        with self.assertRaisesRegex(ValueError, "Parameter 'skin_tuning_interval' must be >= 0"):
+            system.cell_system.skin_tuning_interval = -1
+        with self.assertRaisesRegex(RuntimeError, "Parameter 'skin_tuning_trace' is read-only"):
+            system.cell_system.skin_tuning_trace = []
+        with self.assertRaisesRegex(RuntimeError, "Parameter 'tuned_skin' is read-only"):
+            system.cell_system.tuned_skin = 0.1
+        system.part.clear()
+        system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        system.box_l = 3 * [5.]
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_load_balancing(self):
+        system = self.system
+        system.box_l = 3 * [10.]
+        system.cell_system.skin = 0.2
+        system.cell_system.set_regular_decomposition()
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.4, cutoff=1., shift="auto")
+        # dense cluster in a corner of the box
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((400, 3)) * [3., 4., 10.])
+        self.assertEqual(system.cell_system.load_balancing_interval, 0)
+        self.assertEqual(system.cell_system.load_balancing_metric,
+                         "n_particles")
+        system.integrator.run(0, recalc_forces=True)
+        f_ref = np.copy(system.part.all().f)
+        imbalance = system.cell_system.rebalance()
+        self.assertEqual(imbalance, system.cell_system.load_imbalance)
+        self.assertLessEqual(imbalance["after"], imbalance["before"])
+        bounds = system.cell_system.get_state()["domain_bounds"]
+        node_grid = system.cell_system.node_grid
+        range_ = system.cell_system.interaction_range
+        for i in range(3):
+            self.assertEqual(len(bounds[i]), node_grid[i] + 1)
+            self.assertEqual(bounds[i][0], 0.)
+            self.assertEqual(bounds[i][-1], system.box_l[i])
+            self.assertTrue(np.all(np.diff(bounds[i]) >= range_))
+        if self.n_nodes > 1:
+            self.assertGreater(imbalance["before"], 1.)
+            self.assertLess(imbalance["after"], imbalance["before"])
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(
+            np.copy(system.part.all().f), f_ref, atol=1e-10)
+        # rebalance during integration
+        for metric in ["n_particles", "force_time"]:
+            system.cell_system.load_balancing_metric = metric
+            system.cell_system.load_balancing_interval = 2
+            self.assertEqual(system.cell_system.load_balancing_metric, metric)
+            self.assertEqual(system.cell_system.load_balancing_interval, 2)
+            system.integrator.run(4)
+        system.cell_system.load_balancing_interval = 0
+        system.cell_system.load_balancing_metric = "n_particles"
+        with self.assertRaisesRegex(ValueError, "Parameter 'load_balancing_interval' must be >= 0"):
+            system.cell_system.load_balancing_interval = -1
+        with self.assertRaisesRegex(ValueError, "Parameter 'load_balancing_metric' must be one of 'n_particles', 'force_time'"):
+            system.cell_system.load_balancing_metric = "unknown"
+        with self.assertRaisesRegex(RuntimeError, "Parameter 'load_imbalance' is read-only"):
+            system.cell_system.load_imbalance = {}
+        # a node grid change restores domains of equal size
+        system.cell_system.node_grid = node_grid
+        bounds = system.cell_system.get_state()["domain_bounds"]
+        for i in range(3):
+            np.testing.assert_allclose(
+                bounds[i], np.linspace(0., system.box_l[i], node_grid[i] + 1))
+        system.part.clear()
+        system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        system.cell_system.skin = 0.
+        system.box_l = 3 * [5.]
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_ghost_shell(self):
+        system = self.system
+        system.box_l = 3 * [8.]
+        system.cell_system.skin = 0.4
+        system.cell_system.set_regular_decomposition()
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=2.5, shift="auto")
+        np.random.seed(42)
+        partcls = system.part.add(
+            pos=np.random.random((400, 3)) * system.box_l,
+            v=np.random.random((400, 3)) - 0.5)
+        self.assertEqual(system.cell_system.ghost_shell, "full")
+        system.integrator.run(0, recalc_forces=True)
+        f_ref = np.copy(partcls.f)
+        pairs_ref = sorted(system.cell_system.get_pairs(2.))
+        system.cell_system.ghost_shell = "half"
+        self.assertEqual(system.cell_system.ghost_shell, "half")
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(np.copy(partcls.f), f_ref, atol=1e-10)
+        self.assertEqual(sorted(system.cell_system.get_pairs(2.)), pairs_ref)
+        # the ghost layer follows the particles during integration
+        system.time_step = 0.001
+        system.integrator.run(20)
+        f_half = np.copy(partcls.f)
+        system.cell_system.ghost_shell = "full"
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(np.copy(partcls.f), f_half, atol=1e-8)
+        system.cell_system.ghost_shell = "half"
+        with self.assertRaisesRegex(RuntimeError, "Cannot search for neighbors with the half-shell ghost scheme"):
+            system.cell_system.get_neighbors(partcls[0], 1.)
+        with self.assertRaisesRegex(RuntimeError, "Cannot compute the energy of a particle with the half-shell ghost scheme"):
+            system.analysis.particle_energy(partcls[0])
+        with self.assertRaisesRegex(ValueError, "Parameter 'ghost_shell' must be one of 'full', 'half'"):
+            system.cell_system.ghost_shell = "eighth"
+        system.cell_system.ghost_shell = "full"
+        system.part.clear()
+        system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        system.cell_system.skin = 0.
+        system.box_l = 3 * [5.]
+
+    def test_ghost_shell_exceptions(self):
+        import espressomd.lees_edwards
+        system = self.system
+        system.time_step = 0.01
+        system.cell_system.set_regular_decomposition()
+        system.cell_system.ghost_shell = "half"
+        # Lees-Edwards enabled after the ghost shell was set
+        system.lees_edwards.set_boundary_conditions(
+            shear_direction="x", shear_plane_normal="y",
+            protocol=espressomd.lees_edwards.LinearShear(
+                initial_pos_offset=0., shear_velocity=1., time_0=0.))
+        with self.assertRaisesRegex(Exception, "The half-shell ghost scheme doesn't support Lees-Edwards"):
+            system.integrator.run(0)
+        system.lees_edwards.protocol = None
+        system.integrator.run(0)
+        if espressomd.has_features(["VIRTUAL_SITES_RELATIVE"]):
+            p1 = system.part.add(pos=[1., 1., 1.])
+            p2 = system.part.add(pos=[1., 1., 1.5])
+            p2.vs_auto_relate_to(p1)
+            with self.assertRaisesRegex(Exception, "The half-shell ghost scheme doesn't support virtual sites relative"):
+                system.integrator.run(0)
+            system.part.clear()
+        system.cell_system.ghost_shell = "full"
+
 
 if __name__ == "__main__":
     ut.main()
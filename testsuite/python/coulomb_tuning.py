@@ -17,6 +17,8 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 import numpy as np
+import pathlib
+import tempfile
 import unittest as ut
 import unittest_decorators as utx
 
@@ -53,6 +55,29 @@ class CoulombCloudWallTune(ut.TestCase):
             prefactor=1., accuracy=5e-4, tune=True)
         self.compare(actor)
 
+    def test_p3m_cpu_tuning_database(self):
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            database = pathlib.Path(tmp_dir) / "p3m_tuning.txt"
+            actor = espressomd.electrostatics.P3M(
+                prefactor=1., accuracy=5e-4, tuning_database=database)
+            self.compare(actor)
+            self.assertTrue(database.is_file())
+            ref_mesh = np.copy(actor.mesh)
+            ref_cao = actor.cao
+            ref_r_cut = actor.r_cut
+            self.system.electrostatics.clear()
+            # the tuned parameters are read from the database
+            for verify in (False, True):
+                actor = espressomd.electrostatics.P3M(
+                    prefactor=1., accuracy=5e-4, tuning_database=database,
+                    tuning_verify=verify)
+                self.compare(actor)
+                np.testing.assert_array_equal(np.copy(actor.mesh), ref_mesh)
+                self.assertEqual(actor.cao, ref_cao)
+                self.assertAlmostEqual(actor.r_cut, ref_r_cut, delta=1e-10)
+                self.assertEqual(actor.tuning_verify, verify)
+                self.system.electrostatics.clear()
+
     @utx.skipIfMissingGPU()
     def test_p3m_gpu(self):
         actor = espressomd.electrostatics.P3MGPU(
@@ -83,6 +83,22 @@ class Test(ut.TestCase):
 
         return (ref_e, ref_f, ref_t)
 
+    def barnes_hut_data(self):
+        system = self.system
+
+        bh = espressomd.magnetostatics.DipolarBarnesHut(
+            prefactor=1.2, theta=0.2, order=6)
+        system.magnetostatics.solver = bh
+
+        system.integrator.run(steps=0, recalc_forces=True)
+        ref_e = system.analysis.energy()["dipolar"]
+        ref_f = np.copy(self.particles.f)
+        ref_t = np.copy(self.particles.torque_lab)
+
+        system.magnetostatics.clear()
+
+        return (ref_e, ref_f, ref_t)
+
     def fcs_data(self):
         system = self.system
 
@@ -185,6 +201,13 @@ class Test(ut.TestCase):
             force_tol=1E-4,
             torque_tol=1E-4)
 
+    def test_barnes_hut(self):
+        self.check_open_bc(
+            self.barnes_hut_data,
+            energy_tol=1E-4,
+            force_tol=1E-3,
+            torque_tol=1E-3)
+
     @utx.skipIfMissingFeatures(["SCAFACOS_DIPOLES"])
     @utx.skipIfMissingScafacosMethod("direct")
     def test_dds_scafacos(self):
@@ -253,6 +276,10 @@ class Test(ut.TestCase):
         solver = espressomd.magnetostatics.DipolarDirectSumCpu(prefactor=1.)
         self.check_min_image_convention(solver, rtol=1e-10)
 
+    def test_min_image_convention_barnes_hut(self):
+        solver = espressomd.magnetostatics.DipolarBarnesHut(prefactor=1.)
+        self.check_min_image_convention(solver, rtol=1e-10)
+
     @utx.skipIfMissingFeatures("DIPOLAR_DIRECT_SUM")
     @utx.skipIfMissingGPU()
     def test_min_image_convention_gpu(self):
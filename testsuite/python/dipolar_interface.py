@@ -48,6 +48,11 @@ class Test(ut.TestCase):
             system.magnetostatics, espressomd.magnetostatics.DipolarDirectSumCpu,
             dict(prefactor=3.4, n_replicas=3))
 
+    if espressomd.has_features("DIPOLES"):
+        test_barnes_hut = tests_common.generate_test_for_actor_class(
+            system.magnetostatics, espressomd.magnetostatics.DipolarBarnesHut,
+            dict(prefactor=3.4, theta=0.4, order=4, n_replicas=1))
+
     if espressomd.has_features(
             "DIPOLAR_DIRECT_SUM") and espressomd.gpu_available():
         test_dds_gpu = tests_common.generate_test_for_actor_class(
@@ -98,6 +103,13 @@ class Test(ut.TestCase):
             DDSR(prefactor=1., n_replicas=-2)
         with self.assertRaisesRegex(ValueError, "Parameter 'prefactor' must be > 0"):
             DDSR(prefactor=-2., n_replicas=1)
+        BH = espressomd.magnetostatics.DipolarBarnesHut
+        with self.assertRaisesRegex(ValueError, "Parameter 'theta' must be in the range \\(0, 1\\)"):
+            BH(prefactor=1., theta=1.)
+        with self.assertRaisesRegex(ValueError, "Parameter 'order' must be in the range \\[1, 8\\]"):
+            BH(prefactor=1., order=0)
+        with self.assertRaisesRegex(ValueError, "Parameter 'n_replicas' must be >= 0"):
+            BH(prefactor=1., n_replicas=-1)
         # run sanity checks
         self.system.periodicity = [True, True, False]
         ddsr = DDSR(prefactor=1., n_replicas=1)
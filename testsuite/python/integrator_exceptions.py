@@ -176,6 +176,23 @@ class Test(ut.TestCase):
         self.system.lees_edwards.protocol = None
         self.system.integrator.run(0)
 
+    def test_respa_integrator(self):
+        self.system.cell_system.skin = 0.4
+        with self.assertRaisesRegex(RuntimeError, "Parameter 'n_inner_steps' is missing"):
+            self.system.integrator.set_respa()
+        with self.assertRaisesRegex(ValueError, "Parameter 'n_inner_steps' must be >= 1"):
+            self.system.integrator.set_respa(n_inner_steps=0)
+        self.system.integrator.set_respa(n_inner_steps=4)
+        self.assertEqual(self.system.integrator.integrator.n_inner_steps, 4)
+        with self.assertRaisesRegex(RuntimeError, "Parameter 'n_inner_steps' is read-only"):
+            self.system.integrator.integrator.n_inner_steps = 2
+        self.system.thermostat.set_brownian(kT=1.0, gamma=1.0, seed=42)
+        with self.assertRaisesRegex(Exception, self.msg + 'The RESPA integrator is incompatible with the currently active combination of thermostats'):
+            self.system.integrator.run(0)
+        self.system.thermostat.turn_off()
+        self.system.thermostat.set_langevin(kT=1.0, gamma=1.0, seed=42)
+        self.system.integrator.run(0)
+
     @utx.skipIfMissingFeatures("STOKESIAN_DYNAMICS")
     def test_stokesian_integrator(self):
         self.system.cell_system.skin = 0.4
@@ -496,6 +496,50 @@ class InteractionsNonBondedTest(ut.TestCase):
                       energy_kernel=gaussian_potential,
                       n_steps=125)
 
+    # Test the spline tabulation of expensive potentials
+    @utx.skipIfMissingFeatures("GAUSSIAN")
+    def test_spline_tabulation(self):
+        accuracy = 1e-8
+        params = {"eps": 6.92, "sig": 4.03, "cutoff": 1.243}
+        self.system.non_bonded_inter[0, 0].spline_tabulation.set_params(
+            accuracy=accuracy, min=0.05)
+        self.system.non_bonded_inter[0, 0].gaussian.set_params(**params)
+        p0, p1 = self.system.part.all()
+        for i in range(1, 126):
+            p1.pos = p0.pos + i * self.step
+            d = np.linalg.norm(p1.pos - p0.pos)
+            self.system.integrator.run(recalc_forces=True, steps=0)
+            E_sim = self.system.analysis.energy()["non_bonded"]
+            f1_ref = self.axis * gaussian_force(r=d, **params)
+            # energies are not tabulated ...
+            self.assertFractionAlmostEqual(
+                E_sim, gaussian_potential(r=d, **params))
+            # and forces are within the requested accuracy
+            np.testing.assert_allclose(
+                np.copy(p1.f), f1_ref, rtol=0., atol=accuracy)
+            np.testing.assert_array_equal(np.copy(p0.f), -np.copy(p1.f))
+
+    # Test the spline tabulation of a potential that diverges at r = 0
+    @utx.skipIfMissingFeatures("BMHTF_NACL")
+    def test_spline_tabulation_default_min(self):
+        accuracy = 1e-6
+        params = {"a": 3.92, "b": 2.43, "c": 1.23, "d": 3.33,
+                  "sig": 0.123, "cutoff": 1.253}
+        self.system.non_bonded_inter[0, 0].spline_tabulation.set_params(
+            accuracy=accuracy)
+        self.system.non_bonded_inter[0, 0].bmhtf.set_params(**params)
+        p0, p1 = self.system.part.all()
+        for i in range(1, 126):
+            p1.pos = p0.pos + i * self.step
+            d = np.linalg.norm(p1.pos - p0.pos)
+            self.system.integrator.run(recalc_forces=True, steps=0)
+            f1_ref = self.axis * bmhtf_force(r=d, **params)
+            # analytic forces at short distances, tabulated forces
+            # within the requested accuracy further out
+            np.testing.assert_allclose(
+                np.copy(p1.f), f1_ref, rtol=1e-7, atol=accuracy)
+            np.testing.assert_array_equal(np.copy(p0.f), -np.copy(p1.f))
+
     # Test the Gay-Berne potential and the resulting force and torque
     @utx.skipIfMissingFeatures("GAY_BERNE")
     def test_gb(self):
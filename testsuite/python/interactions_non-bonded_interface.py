@@ -297,6 +297,14 @@ class Test(ut.TestCase):
             ("eps", "sig", "cutoff")
         )
 
+    def test_spline_tabulation_exceptions(self):
+        self.assertEqual(
+            self.system.non_bonded_inter[0, 0].spline_tabulation.accuracy, -1.)
+        self.check_potential_exceptions(
+            espressomd.interactions.SplineTabulationInteraction,
+            {"accuracy": 1e-6, "min": 0.5},
+            ("accuracy", "min"))
+
     @utx.skipIfMissingFeatures("BMHTF_NACL")
     def test_bmhtf_exceptions(self):
         self.check_potential_exceptions(
@@ -103,6 +103,90 @@ class FFT_test(ut.TestCase):
             self.system.electrostatics.clear()
             np.testing.assert_allclose(p3m_energy, ref_energy, rtol=1e-4)
 
+    @ut.skipIf(n_nodes not in FFT_PLANS, f"no FFT plan for {n_nodes} threads")
+    def test_fft_pencil(self):
+        import espressomd.electrostatics
+        self.system.time_step = 0.01
+        self.add_charged_particles()
+        node_grids = [node_grid for node_grid, _ in FFT_PLANS[self.n_nodes]]
+        node_grids += [node_grid[::-1] for node_grid in node_grids]
+        p3m_params = FFT_PLANS[self.n_nodes][0][1]
+        for node_grid in node_grids:
+            self.system.cell_system.node_grid = node_grid
+            for fft_overlap in (False, True):
+                solver = espressomd.electrostatics.P3M(
+                    prefactor=2, accuracy=1e-6, tune=False,
+                    fft_backend="pencil", fft_overlap=fft_overlap,
+                    **p3m_params)
+                self.system.electrostatics.solver = solver
+                self.assertEqual(solver.fft_backend, "pencil")
+                self.assertEqual(solver.fft_overlap, fft_overlap)
+                ref_energy = -75.871906
+                p3m_energy = self.system.analysis.energy()['coulomb']
+                self.system.electrostatics.clear()
+                np.testing.assert_allclose(p3m_energy, ref_energy, rtol=1e-4)
+
+    @ut.skipIf(n_nodes not in FFT_PLANS, f"no FFT plan for {n_nodes} threads")
+    def test_fft_pencil_r2c(self):
+        import espressomd.electrostatics
+        self.system.time_step = 0.01
+        self.add_charged_particles()
+        p3m_params = FFT_PLANS[self.n_nodes][0][1]
+
+        def calc_observables(**kwargs):
+            solver = espressomd.electrostatics.P3M(
+                prefactor=2, accuracy=1e-6, tune=False, **kwargs,
+                **p3m_params)
+            self.system.electrostatics.solver = solver
+            self.system.integrator.run(0, recalc_forces=True)
+            energy = self.system.analysis.energy()['coulomb']
+            pressure = self.system.analysis.pressure_tensor()['coulomb']
+            forces = np.copy(self.system.part.all().f)
+            self.system.electrostatics.clear()
+            return energy, pressure, forces
+
+        ref_energy, ref_pressure, ref_forces = calc_observables()
+        sorted_node_grid = self.system.cell_system.node_grid
+        for node_grid in (sorted_node_grid, sorted_node_grid[::-1]):
+            self.system.cell_system.node_grid = node_grid
+            for fft_overlap in (False, True):
+                energy, pressure, forces = calc_observables(
+                    fft_backend="pencil_r2c", fft_overlap=fft_overlap)
+                np.testing.assert_allclose(energy, ref_energy, rtol=1e-8)
+                np.testing.assert_allclose(pressure, ref_pressure, atol=1e-8)
+                np.testing.assert_allclose(forces, ref_forces, atol=1e-8)
+
+    @utx.skipIfMissingFeatures("DP3M")
+    @ut.skipIf(n_nodes < 2 or n_nodes >= 8, "only runs for 2 <= n_nodes <= 7")
+    def test_fft_pencil_dp3m(self):
+        import espressomd.magnetostatics
+        self.system.time_step = 0.01
+        self.add_magnetic_particles()
+        energies = []
+        for fft_backend in ("legacy", "pencil", "pencil_r2c"):
+            solver = espressomd.magnetostatics.DipolarP3M(
+                prefactor=2, accuracy=1e-4, mesh=16, cao=7, r_cut=3.,
+                alpha=1., tune=False, fft_backend=fft_backend)
+            self.system.magnetostatics.solver = solver
+            energies.append(self.system.analysis.energy()['dipolar'])
+            self.system.magnetostatics.clear()
+        np.testing.assert_allclose(energies[1], energies[0], rtol=1e-8)
+        np.testing.assert_allclose(energies[2], energies[0], rtol=1e-8)
+        unsorted_node_grid = self.system.cell_system.node_grid[::-1]
+        self.system.cell_system.node_grid = unsorted_node_grid
+        solver = espressomd.magnetostatics.DipolarP3M(
+            prefactor=2, accuracy=1e-4, mesh=16, cao=7, r_cut=3., alpha=1.,
+            tune=False, fft_backend="pencil", fft_overlap=True)
+        self.system.magnetostatics.solver = solver
+        energy = self.system.analysis.energy()['dipolar']
+        np.testing.assert_allclose(energy, energies[0], rtol=1e-8)
+
+    def test_fft_backend_exceptions(self):
+        import espressomd.electrostatics
+        with self.assertRaisesRegex(ValueError, "Parameter 'fft_backend' has to be 'legacy', 'pencil' or 'pencil_r2c'"):
+            espressomd.electrostatics.P3M(
+                prefactor=2, accuracy=1e-2, fft_backend="unknown")
+
     @utx.skipIfMissingFeatures("P3M")
     @ut.skipIf(n_nodes < 2 or n_nodes >= 8, "only runs for 2 <= n_nodes <= 7")
     def test_unsorted_node_grid_exception_p3m(self):
@@ -435,6 +435,45 @@ class ParticleProperties(ut.TestCase):
         self.assertFalse(self.system.part.exists(self.pid))
         self.assertEqual(len(p2.bonds), 0)
 
+    def test_bulk_add_remove(self):
+        """Tests that several particles can be added and removed at once,
+        and that bonds to the removed particles are also removed."""
+
+        system = self.system
+        p1 = system.part.by_id(self.pid)
+        n_part = 10
+        props = {"id": np.arange(100, 100 + n_part),
+                 "pos": np.random.random((n_part, 3)) * system.box_l,
+                 "v": np.random.random((n_part, 3)),
+                 "type": np.arange(n_part) % 3}
+        if espressomd.has_features("ELECTROSTATICS"):
+            props["q"] = np.linspace(-1., 1., n_part)
+        if espressomd.has_features("MASS"):
+            props["mass"] = np.linspace(1., 2., n_part)
+        partcls = system.part.add(props)
+        for key, value in props.items():
+            np.testing.assert_allclose(np.copy(getattr(partcls, key)), value)
+        np.testing.assert_array_equal(
+            np.sort(system.part.select(type=2).id), [102, 105, 108])
+        self.assertEqual(system.part.highest_particle_id, 100 + n_part - 1)
+        with self.assertRaisesRegex(ValueError, "Particle 100 already exists"):
+            system.part.add(id=[99, 100], pos=np.zeros((2, 3)))
+        with self.assertRaisesRegex(ValueError, "Particle 98 appears more than once"):
+            system.part.add(id=[98, 98], pos=np.zeros((2, 3)))
+        with self.assertRaisesRegex(ValueError, "attribute 'id' of 'ParticleHandle' must be an integer"):
+            system.part.add(id=[98.5, 99.], pos=np.zeros((2, 3)))
+        with self.assertRaisesRegex(ValueError, "attribute 'type' of 'ParticleHandle' must be an integer"):
+            system.part.add(id=[98, 99], type=[0, 1.5], pos=np.zeros((2, 3)))
+        self.assertFalse(np.any(system.part.exists([98, 99])))
+
+        p1.add_bond((self.f1, 100))
+        partcls.remove()
+        self.assertFalse(np.any(system.part.exists(props["id"])))
+        self.assertEqual(len(p1.bonds), 0)
+        self.assertEqual(system.part.highest_particle_id, self.pid)
+        with self.assertRaisesRegex(RuntimeError, "Some particles no longer exist"):
+            partcls.remove()
+
     def test_bonds(self):
         """Tests bond addition and removal."""
 